@@ -190,6 +190,7 @@ set(
   ${CMAKE_SOURCE_DIR}/lib/api/include/atomic_apply_acl_operations.h
   ${CMAKE_SOURCE_DIR}/lib/api/include/atomic_apply_metadata_operations.h
   ${CMAKE_SOURCE_DIR}/lib/api/include/authenticate.h
+  ${CMAKE_SOURCE_DIR}/lib/api/include/bulk_checksum.h
   ${CMAKE_SOURCE_DIR}/lib/api/include/bulkDataObjPut.h
   ${CMAKE_SOURCE_DIR}/lib/api/include/bulkDataObjReg.h
   ${CMAKE_SOURCE_DIR}/lib/api/include/chkNVPathPerm.h
@@ -318,6 +319,7 @@ set(
   ${CMAKE_SOURCE_DIR}/lib/api/include/subStructFileUnlink.h
   ${CMAKE_SOURCE_DIR}/lib/api/include/subStructFileWrite.h
   ${CMAKE_SOURCE_DIR}/lib/api/include/syncMountedColl.h
+  ${CMAKE_SOURCE_DIR}/lib/api/include/remove_all.h
   ${CMAKE_SOURCE_DIR}/lib/api/include/replica_open.h
   ${CMAKE_SOURCE_DIR}/lib/api/include/replica_close.h
   ${CMAKE_SOURCE_DIR}/lib/api/include/ticketAdmin.h
@@ -339,9 +341,11 @@ set(
   IRODS_SERVER_API_INCLUDE_HEADERS
   ${CMAKE_SOURCE_DIR}/server/api/include/rs_atomic_apply_acl_operations.hpp
   ${CMAKE_SOURCE_DIR}/server/api/include/rs_atomic_apply_metadata_operations.hpp
+  ${CMAKE_SOURCE_DIR}/server/api/include/rs_bulk_checksum.hpp
   ${CMAKE_SOURCE_DIR}/server/api/include/rs_get_file_descriptor_info.hpp
   ${CMAKE_SOURCE_DIR}/server/api/include/rs_replica_open.hpp
   ${CMAKE_SOURCE_DIR}/server/api/include/rs_replica_close.hpp
+  ${CMAKE_SOURCE_DIR}/server/api/include/rs_remove_all.hpp
   ${CMAKE_SOURCE_DIR}/server/api/include/rs_touch.hpp
   ${CMAKE_SOURCE_DIR}/server/api/include/rsAuthCheck.hpp
   ${CMAKE_SOURCE_DIR}/server/api/include/rsAuthPluginRequest.hpp
@@ -486,6 +490,8 @@ set(
   ${CMAKE_SOURCE_DIR}/server/core/include/dataObjOpr.hpp
   ${CMAKE_SOURCE_DIR}/server/core/include/replica_access_table.hpp
   ${CMAKE_SOURCE_DIR}/server/core/include/replica_state_table.hpp
+  ${CMAKE_SOURCE_DIR}/server/core/include/resource_free_space_tracker.hpp
+  ${CMAKE_SOURCE_DIR}/server/core/include/server_load_digest_cache.hpp
   ${CMAKE_SOURCE_DIR}/server/core/include/fileOpr.hpp
   ${CMAKE_SOURCE_DIR}/server/core/include/finalize_utilities.hpp
   ${CMAKE_SOURCE_DIR}/server/core/include/initServer.hpp
@@ -608,6 +614,7 @@ install(
   COMPONENT ${IRODS_PACKAGE_COMPONENT_DEVELOPMENT_NAME}
   FILES_MATCHING
     PATTERN */filesystem.hpp
+    PATTERN */filesystem/cache.hpp
     PATTERN */filesystem/collection_entry.hpp
     PATTERN */filesystem/collection_iterator.hpp
     PATTERN */filesystem/config.hpp
@@ -656,6 +663,7 @@ install(
   FILES_MATCHING
     PATTERN */transport/transport.hpp
     PATTERN */transport/default_transport.hpp
+    PATTERN */transport/async_transport.hpp
   )
 
 install(
@@ -0,0 +1,108 @@
+#ifndef IRODS_BULK_CHECKSUM_H
+#define IRODS_BULK_CHECKSUM_H
+
+/// \file
+
+struct RcComm;
+struct CollectionOperationStat;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// \brief Computes or verifies the checksums of many replicas in a single request.
+///
+/// The replicas are gathered from the catalog by the catalog service provider and grouped
+/// by resource. Checksums are computed in parallel, with a limit on the number of replicas
+/// read from each resource at the same time, and new checksums are written to the catalog
+/// in batches. Only good replicas are processed. Replicas in bundle resources are skipped.
+/// Like ::rcDataObjChksum, the number of replicas skipped is reported for each data object.
+/// A checksum is only written if its replica is still good and unmodified when the batch is
+/// written; other replicas are reported.
+///
+/// Requests are rejected with SYS_NOT_SUPPORTED while policy for ::rcDataObjChksum or
+/// ::rcModDataObjMeta is configured, since that policy would not be invoked.
+///
+/// Progress is streamed back to the client as the operation proceeds. Problems found along
+/// the way (e.g. checksum mismatches) are reported in the error stack of the connection,
+/// one entry per problem. Like ::rcDataObjChksum, mismatches do not cause an error code to
+/// be returned.
+///
+/// \param[in] _comm       A pointer to a RcComm.
+/// \param[in] _json_input \parblock
+/// A JSON string describing the replicas to process.
+///
+/// The JSON string must have the following structure:
+/// \code{.js}
+/// {
+///   "logical_path": string,
+///   "data_objects": [string],
+///   "options": {
+///     "verify": boolean,
+///     "force": boolean,
+///     "admin": boolean,
+///     "thread_count": integer,
+///     "max_concurrent_per_resource": integer
+///   }
+/// }
+/// \endcode
+/// \endparblock
+///
+/// Exactly one of \p logical_path and \p data_objects must be present.
+///
+/// \p logical_path must be an absolute path to a collection. Every data object under the
+/// collection is processed.
+///
+/// \p data_objects is a list of absolute paths to data objects (a manifest).
+///
+/// \p options is the set of optional values for controlling the behavior
+/// of the operation. This field and all fields within are optional.
+///
+/// \p verify Instructs the system to compare the checksum of each replica against the
+/// checksum in the catalog instead of computing missing checksums. The catalog is not
+/// modified. Defaults to false.
+///
+/// \p force Instructs the system to recompute and update checksums that already exist.
+/// Cannot be combined with \p verify. Defaults to false.
+///
+/// \p admin Instructs the system to ignore permissions. The client must be an administrator.
+/// Defaults to false.
+///
+/// \p thread_count The number of workers used to compute checksums. Must be greater than
+/// zero. Defaults to 4.
+///
+/// \p max_concurrent_per_resource The maximum number of replicas read from a single resource
+/// at the same time. Must be greater than zero. Defaults to 2.
+///
+/// \param[in] _verbose Prints progress to stdout if greater than zero.
+///
+/// \return An integer.
+/// \retval 0        On success.
+/// \retval Non-zero On failure.
+///
+/// \since 4.3.0
+int rc_bulk_checksum(struct RcComm* _comm, const char* _json_input, int _verbose);
+
+/// \brief The raw form of ::rc_bulk_checksum.
+///
+/// Returns after the first progress message. Callers must keep reading progress
+/// messages via ::_cliGetCollOprStat while the return value is SYS_SVR_TO_CLI_COLL_STAT.
+/// The error stack of the connection only holds the report of the latest message.
+///
+/// \param[in]  _comm       A pointer to a RcComm.
+/// \param[in]  _json_input See ::rc_bulk_checksum.
+/// \param[out] _output     A pointer to the progress message. Must be freed by the caller.
+///
+/// \return An integer.
+/// \retval SYS_SVR_TO_CLI_COLL_STAT If more progress messages follow.
+/// \retval 0                        On success.
+/// \retval Non-zero                 On failure.
+///
+/// \since 4.3.0
+int _rc_bulk_checksum(struct RcComm* _comm, const char* _json_input, struct CollectionOperationStat** _output);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // IRODS_BULK_CHECKSUM_H
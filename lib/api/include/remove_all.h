@@ -0,0 +1,88 @@
+#ifndef IRODS_REMOVE_ALL_H
+#define IRODS_REMOVE_ALL_H
+
+/// \file
+
+struct RcComm;
+struct CollectionOperationStat;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// \brief Recursively removes a collection and everything under it.
+///
+/// The subtree is walked in the catalog by the catalog service provider. Physical replicas
+/// are unlinked as the client and catalog rows are deleted in batches. The client's
+/// permissions are checked again for every batch. Progress is streamed back to the client
+/// as the removal proceeds.
+///
+/// \param[in] _comm       A pointer to a RcComm.
+/// \param[in] _json_input \parblock
+/// A JSON string describing the collection to remove.
+///
+/// The JSON string must have the following structure:
+/// \code{.js}
+/// {
+///   "logical_path": string,
+///   "options": {
+///     "no_trash": boolean,
+///     "unregister": boolean
+///   }
+/// }
+/// \endcode
+/// \endparblock
+///
+/// \p logical_path must be an absolute path to a collection.
+///
+/// \p options is the set of optional values for controlling the behavior
+/// of the operation. This field and all fields within are optional.
+///
+/// \p no_trash Instructs the system to remove the collection permanently instead
+/// of moving it to the trash. Defaults to false. When false, the trash policy
+/// (::acTrashPolicy) decides whether the collection is moved to the trash.
+///
+/// \p unregister Instructs the system to unregister the replicas instead of
+/// deleting them from storage. Defaults to false.
+///
+/// Subtrees the server cannot remove in bulk (e.g. subtrees containing special
+/// collections or locked replicas) are removed the same way as ::rcRmColl.
+///
+/// The bulk path does not invoke the policy of the individual data objects and
+/// collections it removes. If any pre, post, except or finally PEP is configured for
+/// api_data_obj_unlink, database_unreg_replica, database_del_coll or
+/// database_del_coll_by_admin, the whole subtree is removed the same way as ::rcRmColl
+/// instead, so those PEPs fire for every object. Only the root collection goes through
+/// the collection removal policy in the bulk path.
+///
+/// \param[in] _verbose Prints progress to stdout if greater than zero.
+///
+/// \return An integer.
+/// \retval 0        On success.
+/// \retval Non-zero On failure.
+///
+/// \since 4.3.0
+int rc_remove_all(struct RcComm* _comm, const char* _json_input, int _verbose);
+
+/// \brief The raw form of ::rc_remove_all.
+///
+/// Returns after the first progress message. Callers must keep reading progress
+/// messages via ::cliGetCollOprStat while the return value is SYS_SVR_TO_CLI_COLL_STAT.
+///
+/// \param[in]  _comm       A pointer to a RcComm.
+/// \param[in]  _json_input See ::rc_remove_all.
+/// \param[out] _output     A pointer to the progress message. Must be freed by the caller.
+///
+/// \return An integer.
+/// \retval SYS_SVR_TO_CLI_COLL_STAT If more progress messages follow.
+/// \retval 0                        On success.
+/// \retval Non-zero                 On failure.
+///
+/// \since 4.3.0
+int _rc_remove_all(struct RcComm* _comm, const char* _json_input, struct CollectionOperationStat** _output);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // IRODS_REMOVE_ALL_H
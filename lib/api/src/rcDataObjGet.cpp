@@ -111,9 +111,20 @@ rcDataObjGet( rcComm_t *conn, dataObjInp_t *dataObjInp, char *locFilePath ) {
         }
     }
 
+    /* in main port mode the server is asked not to open portals. The data is
+     * received over this connection and additional ones to the main port. */
+    const int numThreads = dataObjInp->numThreads;
+    const int numStreams = getMainPortStreams( dataObjInp );
+    if ( numStreams > 0 ) {
+        dataObjInp->numThreads = NO_THREADING;
+        addKeyVal( &dataObjInp->condInput, MAIN_PORT_STREAMS_KW, std::to_string( numStreams ).c_str() );
+    }
+
     portalOprOut_t *portalOprOut = NULL;
     bytesBuf_t dataObjOutBBuf;
     int status = _rcDataObjGet( conn, dataObjInp, &portalOprOut, &dataObjOutBBuf );
+    dataObjInp->numThreads = numThreads;
+    rmKeyVal( &dataObjInp->condInput, MAIN_PORT_STREAMS_KW );
 
     if ( status < 0 ) {
         free( portalOprOut );
@@ -177,7 +188,11 @@ rcDataObjGet( rcComm_t *conn, dataObjInp_t *dataObjInp, char *locFilePath ) {
     }
     else {
 
-        if ( portalOprOut->numThreads <= 0 ) {
+        if ( portalOprOut->numThreads <= 0 && numStreams > 0 ) {
+            status = getFileFromStreams( conn, portalOprOut->l1descInx, locFilePath,
+                                         dataObjInp->objPath, dataObjInp->dataSize, numStreams );
+        }
+        else if ( portalOprOut->numThreads <= 0 ) {
             status = getFile( conn, portalOprOut->l1descInx,
                               locFilePath, dataObjInp->objPath, dataObjInp->dataSize );
         }
@@ -145,7 +145,18 @@ rcDataObjPut( rcComm_t *conn, dataObjInp_t *dataObjInp, char *locFilePath ) {
 
     dataObjInp->oprType = PUT_OPR;
 
+    /* in main port mode the server is asked not to open portals. The data is
+     * sent over this connection and additional ones to the main port. */
+    const int numThreads = dataObjInp->numThreads;
+    const int numStreams = getMainPortStreams( dataObjInp );
+    if ( numStreams > 0 ) {
+        dataObjInp->numThreads = NO_THREADING;
+        addKeyVal( &dataObjInp->condInput, MAIN_PORT_STREAMS_KW, std::to_string( numStreams ).c_str() );
+    }
+
     status = _rcDataObjPut( conn, dataObjInp, &dataObjInpBBuf, &portalOprOut );
+    dataObjInp->numThreads = numThreads;
+    rmKeyVal( &dataObjInp->condInput, MAIN_PORT_STREAMS_KW );
 
     clearBBuf( &dataObjInpBBuf );
 
@@ -157,7 +168,11 @@ rcDataObjPut( rcComm_t *conn, dataObjInp_t *dataObjInp, char *locFilePath ) {
         return status;
     }
 
-    if ( portalOprOut->numThreads <= 0 ) {
+    if ( portalOprOut->numThreads <= 0 && numStreams > 0 ) {
+        status = putFileToStreams( conn, portalOprOut->l1descInx, locFilePath,
+                                   dataObjInp->objPath, dataObjInp->dataSize, numStreams );
+    }
+    else if ( portalOprOut->numThreads <= 0 ) {
         status = putFile( conn, portalOprOut->l1descInx,
                           locFilePath, dataObjInp->objPath, dataObjInp->dataSize );
     }
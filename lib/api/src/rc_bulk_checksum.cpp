@@ -0,0 +1,73 @@
+#include "bulk_checksum.h"
+
+#include "api_plugin_number.h"
+#include "procApiRequest.h"
+#include "rcMisc.h"
+#include "rodsErrorTable.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+auto _rc_bulk_checksum(RcComm* _comm, const char* _json_input, CollectionOperationStat** _output) -> int
+{
+    if (!_json_input) {
+        return SYS_INVALID_INPUT_PARAM;
+    }
+
+    bytesBuf_t input{};
+    input.buf = const_cast<char*>(_json_input);
+    input.len = static_cast<int>(std::strlen(_json_input));
+
+    return procApiRequest(_comm, BULK_CHECKSUM_APN, &input, nullptr, reinterpret_cast<void**>(_output), nullptr);
+}
+
+auto rc_bulk_checksum(RcComm* _comm, const char* _json_input, int _verbose) -> int
+{
+    // Every message replaces the error stack of the connection, so the report carried by
+    // each message is gathered here and handed to the caller at the end.
+    rError_t report{};
+
+    const auto take_report = [_comm, &report] {
+        if (_comm->rError) {
+            replErrorStack(_comm->rError, &report);
+            freeRError(_comm->rError);
+            _comm->rError = nullptr;
+        }
+    };
+
+    collOprStat_t* stat{};
+
+    auto ec = _rc_bulk_checksum(_comm, _json_input, &stat);
+    take_report();
+
+    while (ec == SYS_SVR_TO_CLI_COLL_STAT) {
+        if (stat && _verbose > 0) {
+            if (stat->totalFileCnt <= 0) {
+                std::printf("num replicas done = %d, totalReplicaCnt = UNKNOWN, ", stat->filesCnt);
+            }
+            else {
+                std::printf("num replicas done = %d, totalReplicaCnt = %d, ", stat->filesCnt, stat->totalFileCnt);
+            }
+
+            std::printf("bytesChecksummed = %lld, last data object done: %s\n", stat->bytesWritten, stat->lastObjPath);
+        }
+
+        std::free(stat);
+        stat = nullptr;
+
+        ec = _cliGetCollOprStat(_comm, &stat);
+        take_report();
+    }
+
+    std::free(stat);
+
+    if (report.len > 0) {
+        _comm->rError = static_cast<rError_t*>(std::calloc(1, sizeof(rError_t)));
+        replErrorStack(&report, _comm->rError);
+    }
+
+    freeRErrorContent(&report);
+
+    return ec;
+}
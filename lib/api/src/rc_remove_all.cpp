@@ -0,0 +1,29 @@
+#include "remove_all.h"
+
+#include "api_plugin_number.h"
+#include "procApiRequest.h"
+#include "rodsErrorTable.h"
+
+#include <cstring>
+
+auto _rc_remove_all(RcComm* _comm, const char* _json_input, CollectionOperationStat** _output) -> int
+{
+    if (!_json_input) {
+        return SYS_INVALID_INPUT_PARAM;
+    }
+
+    bytesBuf_t input{};
+    input.buf = const_cast<char*>(_json_input);
+    input.len = static_cast<int>(std::strlen(_json_input));
+
+    return procApiRequest(_comm, REMOVE_ALL_APN, &input, nullptr, reinterpret_cast<void**>(_output), nullptr);
+}
+
+auto rc_remove_all(RcComm* _comm, const char* _json_input, int _verbose) -> int
+{
+    collOprStat_t* stat{};
+
+    const auto ec = _rc_remove_all(_comm, _json_input, &stat);
+
+    return cliGetCollOprStat(_comm, stat, _verbose, ec);
+}
@@ -6,7 +6,7 @@
 
 #include <streambuf>
 #include <type_traits>
-#include <array>
+#include <vector>
 #include <string>
 #include <stdexcept>
 #include <algorithm>
@@ -40,7 +40,7 @@ namespace irods::experimental::io
         using base_type = std::basic_streambuf<CharT, Traits>;
 
         // clang-format off
-        inline static constexpr auto buffer_size          = 4096;
+        inline static constexpr auto default_buffer_size  = 4096;
 
         // Errors
         inline static constexpr auto external_write_error = -1;
@@ -50,7 +50,7 @@ namespace irods::experimental::io
     public:
         basic_data_object_buf()
             : base_type{}
-            , buf_{}
+            , buf_(default_buffer_size)
             , transport_{}
         {
         }
@@ -233,7 +233,40 @@ namespace irods::experimental::io
             return transport_->replica_token();
         }
 
+        /// The number of bytes exchanged with the transport per request.
+        std::streamsize buffer_size() const noexcept
+        {
+            return static_cast<std::streamsize>(buf_.size());
+        }
+
     protected:
+        // Resizes the internal buffer to \p _buffer_size bytes (e.g. stream.rdbuf()->pubsetbuf(nullptr, 4 * 1024 * 1024)).
+        // Larger buffers mean fewer round trips to the server. The caller supplied buffer is not used.
+        //
+        // Returns nullptr if the size is not positive, pending output cannot be flushed, or
+        // buffered input has not been consumed yet.
+        base_type* setbuf(char_type*, std::streamsize _buffer_size) override
+        {
+            if (_buffer_size <= 0 || this->sync() != 0 || this->gptr() < this->egptr()) {
+                return nullptr;
+            }
+
+            const bool get_area_active = this->gptr() != nullptr;
+            const bool put_area_active = this->pptr() != nullptr;
+
+            buf_.assign(_buffer_size, char_type{});
+            auto* pbase = buf_.data();
+
+            if (get_area_active) {
+                this->setg(pbase, pbase, pbase);
+            }
+            else if (put_area_active) {
+                this->setp(pbase, pbase + buf_.size());
+            }
+
+            return this;
+        }
+
         int_type underflow() override
         {
             prepare_for_input();
@@ -415,7 +448,7 @@ namespace irods::experimental::io
             return 0;
         }
 
-        std::array<char_type, buffer_size> buf_;
+        std::vector<char_type> buf_;
         transport<char_type>* transport_;
     }; // basic_data_object_buf
 
@@ -52,6 +52,8 @@ typedef struct RodsEnvironment {
     int irodsDefaultNumberTransferThreads;
     int irodsTransBufferSizeForParaTrans;
     int irodsConnectionPoolRefreshTime;
+    char irodsParallelTransferMode[NAME_LEN];
+    int irodsRsyncTransferWorkers;
 
     // =-=-=-=-=-=-=-
     // override of plugin installation directory
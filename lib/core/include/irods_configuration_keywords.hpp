@@ -19,6 +19,12 @@ namespace irods
     extern const std::string CFG_DB_SSLROOTCERT_KW;
     extern const std::string CFG_DB_SSLCERT_KW;
     extern const std::string CFG_DB_SSLKEY_KW;
+    extern const std::string CFG_DB_READ_REPLICA_KW;
+    extern const std::string CFG_DB_ODBC_DSN_KW;
+    extern const std::string CFG_DB_READ_YOUR_WRITES_KW;
+    extern const std::string CFG_DB_EFFECTIVE_ACCESS_INDEX_KW;
+    extern const std::string CFG_DB_MAX_CONNECTIONS_KW;
+    extern const std::string CFG_DB_CONNECTION_WAIT_TIMEOUT_KW;
     extern const std::string CFG_ZONE_NAME_KW;
     extern const std::string CFG_ZONE_KEY_KW;
     extern const std::string CFG_NEGOTIATION_KEY_KW;
@@ -63,6 +69,8 @@ namespace irods
     extern const std::string CFG_DEF_TEMP_PASSWORD_LIFETIME;
     extern const std::string CFG_MAX_TEMP_PASSWORD_LIFETIME;
     extern const std::string CFG_MAX_NUMBER_OF_CONCURRENT_RE_PROCS;
+    extern const std::string CFG_MAX_NUMBER_OF_BULK_CHECKSUM_THREADS;
+    extern const std::string CFG_MAX_NUMBER_OF_CONCURRENT_CHECKSUMS_PER_RESOURCE;
     extern const std::string DEFAULT_LOG_ROTATION_IN_DAYS;
 
     extern const std::string CFG_RE_CACHE_SALT_KW;
@@ -113,6 +121,8 @@ namespace irods
     extern const std::string CFG_IRODS_MAX_NUMBER_TRANSFER_THREADS;
     extern const std::string CFG_IRODS_TRANS_BUFFER_SIZE_FOR_PARA_TRANS;
     extern const std::string CFG_IRODS_CONNECTION_POOL_REFRESH_TIME;
+    extern const std::string CFG_IRODS_PARALLEL_TRANSFER_MODE;
+    extern const std::string CFG_IRODS_RSYNC_TRANSFER_WORKERS;
 
     // legacy ssl environment variables
     extern const std::string CFG_IRODS_SSL_CA_CERTIFICATE_PATH;
@@ -31,6 +31,7 @@
 #include <functional>
 #include <memory>
 #include <atomic>
+#include <optional>
 
 namespace irods::experimental::io
 {
@@ -93,8 +94,17 @@ namespace irods::experimental::io
         using sink_stream_close_handler_type = std::function<void (sink_stream_type&, bool)>;
         // clang-format on
 
+        /// The default number of bytes in each unit of work handed out to channels.
+        ///
+        /// \since 4.3.0
+        inline static constexpr std::int64_t default_chunk_size = 4 * 1024 * 1024;
+
         /// Constructs an instance of the parallel_transfer_engine and starts transferring data.
         ///
+        /// The bytes to transfer are split into chunks of \p _chunk_size bytes. Each channel takes
+        /// the next unclaimed chunk from a shared queue whenever it finishes one, so a slow channel
+        /// never holds up work that an idle channel could do.
+        ///
         /// \throws parallel_transfer_engine_error
         /// \throws stream_error
         ///
@@ -106,6 +116,10 @@ namespace irods::experimental::io
         /// \param[in] _offset                    The offset within the source and sink streams.
         /// \param[in] _transfer_buffer_size      The buffer size used by each stream to move bytes.
         /// \param[in] _restart_file_directory    The directory that will be used to store restart information.
+        /// \param[in] _chunk_size                The number of bytes in each unit of work. \since 4.3.0
+        /// \param[in] _adapt_channel_count       Whether the number of busy channels should follow the measured
+        ///                                       throughput. \p _number_of_channels becomes the upper bound.
+        ///                                       \since 4.3.0
         parallel_transfer_engine(source_stream_factory_type _source_stream_factory,
                                  sink_stream_factory_type _sink_stream_factory,
                                  sink_stream_close_handler_type _sink_stream_close_handler,
@@ -113,16 +127,26 @@ namespace irods::experimental::io
                                  std::int16_t _number_of_channels,
                                  std::int64_t _offset,
                                  std::int64_t _transfer_buffer_size,
-                                 std::string _restart_file_directory)
+                                 std::string _restart_file_directory,
+                                 std::int64_t _chunk_size = default_chunk_size,
+                                 bool _adapt_channel_count = false)
             : thread_pool_{std::make_unique<irods::thread_pool>(_number_of_channels)}
             , stop_{}
             , file_mapping_{}
             , mapped_region_{}
-            , progress_(_number_of_channels)
+            , chunk_progress_{}
+            , next_chunk_{}
             , tasks_running_(_number_of_channels)
             , errors_{}
             , errors_mutex_{}
             , latch_{std::make_unique<latch>(_number_of_channels - 1)}
+            , scheduler_mutex_{}
+            , scheduler_cond_var_{}
+            , active_channels_{}
+            , sampled_bytes_{}
+            , sample_start_{}
+            , last_throughput_{}
+            , adjustment_{1}
             , source_stream_factory_{_source_stream_factory}
             , sink_stream_factory_{_sink_stream_factory}
             , sink_stream_close_handler_{_sink_stream_close_handler}
@@ -130,6 +154,9 @@ namespace irods::experimental::io
             , number_of_channels_{_number_of_channels}
             , offset_{_offset}
             , transfer_buffer_size_{_transfer_buffer_size}
+            , chunk_size_{_chunk_size}
+            , number_of_chunks_{}
+            , adapt_channel_count_{_adapt_channel_count}
             , restart_file_dir_{std::move(_restart_file_directory)}
             , restart_handle_{make_restart_handle()}
             , restart_file_exists_{}
@@ -141,6 +168,8 @@ namespace irods::experimental::io
         /// Constructs an instance of the parallel_transfer_engine and continues transferring data from the
         /// the previous position based on the information referenced by the restart handle.
         ///
+        /// Only the chunks that were not completely transferred are scheduled.
+        ///
         /// \throws parallel_transfer_engine_error
         /// \throws stream_error
         ///
@@ -157,11 +186,19 @@ namespace irods::experimental::io
             , stop_{}
             , file_mapping_{}
             , mapped_region_{}
-            , progress_{}
+            , chunk_progress_{}
+            , next_chunk_{}
             , tasks_running_{}
             , errors_{}
             , errors_mutex_{}
             , latch_{}
+            , scheduler_mutex_{}
+            , scheduler_cond_var_{}
+            , active_channels_{}
+            , sampled_bytes_{}
+            , sample_start_{}
+            , last_throughput_{}
+            , adjustment_{1}
             , source_stream_factory_{_source_stream_factory}
             , sink_stream_factory_{_sink_stream_factory}
             , sink_stream_close_handler_{_sink_stream_close_handler}
@@ -169,6 +206,9 @@ namespace irods::experimental::io
             , number_of_channels_{}
             , offset_{}
             , transfer_buffer_size_{}
+            , chunk_size_{}
+            , number_of_chunks_{}
+            , adapt_channel_count_{}
             , restart_file_dir_{}
             , restart_handle_{_restart_handle}
             , restart_file_exists_{}
@@ -209,7 +249,13 @@ namespace irods::experimental::io
         /// Requests the transfer to stop in a graceful manner.
         auto stop() -> void
         {
-            stop_.store(true);
+            {
+                std::lock_guard lock{scheduler_mutex_};
+                stop_.store(true);
+            }
+
+            // Wake up channels parked by the adaptive channel count.
+            scheduler_cond_var_.notify_all();
             thread_pool_->stop();
         }
 
@@ -231,12 +277,40 @@ namespace irods::experimental::io
         /// \retval false Otherwise.
         auto success() -> bool
         {
-            return errors_.empty() && std::all_of(std::cbegin(progress_), std::cend(progress_), [](auto& _p) {
-                using namespace std::chrono_literals;
-                return _p.running->valid() &&
-                       _p.running->wait_for(0s) == std::future_status::ready &&
-                       _p.progress->sent == _p.progress->chunk_size;
+            using namespace std::chrono_literals;
+
+            const auto tasks_finished = std::all_of(std::cbegin(tasks_running_), std::cend(tasks_running_), [](auto& _f) {
+                return _f.valid() && _f.wait_for(0s) == std::future_status::ready;
             });
+
+            return errors_.empty() && tasks_finished && completed_chunks() == number_of_chunks_;
+        }
+
+        /// Returns the number of chunks that have been completely transferred.
+        ///
+        /// This function should only be called when the transfer has completely stopped. Consider
+        /// calling stop_and_wait() before invoking this function.
+        ///
+        /// \since 4.3.0
+        auto completed_chunks() const noexcept -> std::int64_t
+        {
+            std::int64_t count = 0;
+
+            for (decltype(number_of_chunks_) i = 0; i < number_of_chunks_; ++i) {
+                if (chunk_progress_[i] == chunk_length(i)) {
+                    ++count;
+                }
+            }
+
+            return count;
+        }
+
+        /// Returns the number of chunks the transfer is split into.
+        ///
+        /// \since 4.3.0
+        auto number_of_chunks() const noexcept -> std::int64_t
+        {
+            return number_of_chunks_;
         }
 
         /// Returns information about errors encountered during the transfer.
@@ -257,6 +331,17 @@ namespace irods::experimental::io
         }
 
     private:
+        using clock_type = std::chrono::steady_clock;
+
+        // Bump this whenever the layout of the restart file changes.
+        inline static constexpr std::int64_t restart_file_version = 2;
+
+        // How long the adaptive channel count measures throughput before adjusting.
+        inline static constexpr auto throughput_sample_interval = std::chrono::seconds{1};
+
+        // The relative throughput gain required to keep moving the channel count in the same direction.
+        inline static constexpr double throughput_gain_threshold = 0.05;
+
         class latch
         {
         public:
@@ -298,32 +383,30 @@ namespace irods::experimental::io
             std::condition_variable cond_var_;
         }; // class latch
 
+        // The restart file holds this header followed by one std::int64_t per chunk. Each
+        // element holds the number of bytes of that chunk that have reached the sink.
         struct restart_header
         {
+            std::int64_t version;
             std::int64_t total_bytes_to_transfer;
             std::int64_t number_of_streams;
             std::int64_t offset;
             std::int64_t transfer_buffer_size;
-        };
-
-        struct progress
-        {
             std::int64_t chunk_size;
-            std::int64_t sent;
+            std::int64_t number_of_chunks;
+            std::int64_t adapt_channel_count;
         };
 
-        struct transfer_progress
+        auto restart_file_size() const noexcept -> std::size_t
         {
-            std::future<void>* running;
-            progress* progress;
-        };
+            return sizeof(restart_header) + number_of_chunks_ * sizeof(std::int64_t);
+        }
 
         auto init_memory_mapped_progress_file(const std::string& _filename, bool _create_file) -> std::byte*
         {
             if (_create_file) {
                 if (std::ofstream out{_filename}; out) {
-                    const std::size_t storage_size = sizeof(restart_header) + number_of_channels_ * sizeof(progress) - 1;
-                    out.seekp(storage_size, std::ios_base::beg);
+                    out.seekp(restart_file_size() - 1, std::ios_base::beg);
                     out.put(0);
                 }
                 else {
@@ -345,10 +428,14 @@ namespace irods::experimental::io
         {
             auto* header = new (_storage) restart_header{};
 
+            header->version = restart_file_version;
             header->total_bytes_to_transfer = total_bytes_to_transfer_;
             header->number_of_streams = number_of_channels_;
             header->offset = offset_;
             header->transfer_buffer_size = transfer_buffer_size_;
+            header->chunk_size = chunk_size_;
+            header->number_of_chunks = number_of_chunks_;
+            header->adapt_channel_count = adapt_channel_count_;
 
             return header;
         }
@@ -380,67 +467,78 @@ namespace irods::experimental::io
 
                 constexpr auto create_new_file = false;
                 auto* storage = init_memory_mapped_progress_file(restart_handle_, create_new_file);
+
+                if (mapped_region_->get_size() < sizeof(restart_header)) {
+                    throw parallel_transfer_engine_error{"Invalid restart file"};
+                }
+
                 auto* header = new (storage) restart_header;
 
+                if (header->version != restart_file_version) {
+                    throw parallel_transfer_engine_error{"Incompatible restart file version"};
+                }
+
                 total_bytes_to_transfer_ = header->total_bytes_to_transfer;
                 number_of_channels_ = header->number_of_streams;
                 offset_ = header->offset;
                 transfer_buffer_size_ = header->transfer_buffer_size;
+                chunk_size_ = header->chunk_size;
+                number_of_chunks_ = header->number_of_chunks;
+                adapt_channel_count_ = header->adapt_channel_count;
+
+                if (mapped_region_->get_size() < restart_file_size()) {
+                    throw parallel_transfer_engine_error{"Invalid restart file"};
+                }
 
                 thread_pool_ = std::make_unique<irods::thread_pool>(number_of_channels_);
-                progress_.resize(number_of_channels_);
                 tasks_running_.resize(number_of_channels_);
                 latch_ = std::make_unique<latch>(number_of_channels_ - 1);
 
-                auto* task_progress_storage = storage + sizeof(restart_header);
-
-                for (decltype(number_of_channels_) i = 0; i < number_of_channels_; ++i) {
-                    progress_[i].running = &tasks_running_[i];
-                    progress_[i].progress = new (task_progress_storage + (i * sizeof(progress))) progress;
-                }
+                chunk_progress_ = reinterpret_cast<std::int64_t*>(storage + sizeof(restart_header));
             }
             else {
+                number_of_chunks_ = (total_bytes_to_transfer_ + chunk_size_ - 1) / chunk_size_;
+
                 constexpr auto create_new_file = true;
                 auto* storage = init_memory_mapped_progress_file(restart_handle_, create_new_file);
                 construct_progress_header(storage);
 
-                auto* task_progress_storage = storage + sizeof(restart_header);
-                const auto chunk_size = total_bytes_to_transfer_ / number_of_channels_;
-
-                for (decltype(number_of_channels_) i = 0; i < number_of_channels_; ++i) {
-                    progress_[i].running = &tasks_running_[i];
-                    progress_[i].progress = new (task_progress_storage + i * sizeof(progress)) progress{};
-                    progress_[i].progress->chunk_size = chunk_size;
-                }
-
-                // Add any remaining bytes to the last stream's chunk size.
-                progress_.back().progress->chunk_size += (total_bytes_to_transfer_ % number_of_channels_);
+                chunk_progress_ = reinterpret_cast<std::int64_t*>(storage + sizeof(restart_header));
+                std::fill_n(chunk_progress_, number_of_chunks_, 0);
             }
         }
 
+        // Returns the number of bytes covered by the chunk. Only the last chunk may be shorter
+        // than the chunk size.
+        auto chunk_length(std::int64_t _chunk) const noexcept -> std::int64_t
+        {
+            return std::min(chunk_size_, total_bytes_to_transfer_ - _chunk * chunk_size_);
+        }
+
         auto start_transfer() -> void
         {
+            // With the adaptive channel count, the transfer starts with a single channel and adds
+            // more as long as doing so improves the throughput.
+            active_channels_ = adapt_channel_count_ ? 1 : number_of_channels_;
+            sample_start_ = clock_type::now();
+
             // Triggering a restart means the caller has verified that the source object exists.
             // The parallel transfer engine makes no attempts to verify existence of any source.
             // That is the sole responsibility of the caller.
             const auto mode = std::ios_base::out | (restart_file_exists_ ? std::ios_base::in : 0);
-            const auto offset = offset_ + progress_[0].progress->sent;
-            auto primary_in_stream = create_source_stream(offset);
-            auto primary_out_stream = create_sink_stream(mode, offset);
-
-            const auto chunk_size = total_bytes_to_transfer_ / number_of_channels_;
+            auto primary_in_stream = create_source_stream(offset_);
+            auto primary_out_stream = create_sink_stream(mode, offset_);
 
             for (decltype(number_of_channels_) i = 1; i < number_of_channels_; ++i) {
                 constexpr auto wait_for_sibling_tasks_to_finish = false;
                 const auto mode = std::ios_base::in | std::ios_base::out;
-                const auto offset = i * chunk_size + offset_ + progress_[i].progress->sent;
 
-                auto secondary_in_stream = create_source_stream(offset, &primary_in_stream);
-                auto secondary_out_stream = create_sink_stream(mode, offset, &primary_out_stream);
+                auto secondary_in_stream = create_source_stream(offset_, &primary_in_stream);
+                auto secondary_out_stream = create_sink_stream(mode, offset_, &primary_out_stream);
 
                 schedule_transfer_task_on_thread_pool(secondary_in_stream,
                                                       secondary_out_stream,
-                                                      progress_[i],
+                                                      i,
                                                       tasks_running_[i],
                                                       wait_for_sibling_tasks_to_finish);
             }
@@ -448,7 +546,7 @@ namespace irods::experimental::io
             constexpr auto wait_for_sibling_tasks_to_finish = true;
             schedule_transfer_task_on_thread_pool(primary_in_stream,
                                                   primary_out_stream,
-                                                  progress_[0],
+                                                  0,
                                                   tasks_running_[0],
                                                   wait_for_sibling_tasks_to_finish);
         }
@@ -486,39 +584,147 @@ namespace irods::experimental::io
             return out;
         }
 
+        // Returns the index of the next chunk that still has bytes to transfer, or an empty
+        // optional if every chunk has been handed out.
+        auto claim_chunk() -> std::optional<std::int64_t>
+        {
+            for (auto i = next_chunk_.fetch_add(1); i < number_of_chunks_; i = next_chunk_.fetch_add(1)) {
+                // Chunks completed before a restart are skipped.
+                if (chunk_progress_[i] < chunk_length(i)) {
+                    return i;
+                }
+            }
+
+            // Parked channels have nothing left to wait for.
+            if (adapt_channel_count_) {
+                std::lock_guard lock{scheduler_mutex_};
+                scheduler_cond_var_.notify_all();
+            }
+
+            return std::nullopt;
+        }
+
+        // Blocks while the adaptive channel count has parked the channel.
+        // Returns false if the transfer was stopped.
+        auto wait_until_active(std::int64_t _channel) -> bool
+        {
+            if (!adapt_channel_count_) {
+                return !stop_.load();
+            }
+
+            std::unique_lock lock{scheduler_mutex_};
+
+            scheduler_cond_var_.wait(lock, [this, _channel] {
+                return stop_.load() || _channel < active_channels_ || next_chunk_.load() >= number_of_chunks_;
+            });
+
+            return !stop_.load();
+        }
+
+        // Records bytes written by a channel and, once per sample interval, moves the number of
+        // active channels one step in the direction that last improved the throughput.
+        auto record_throughput(std::int64_t _bytes) -> void
+        {
+            if (!adapt_channel_count_) {
+                return;
+            }
+
+            sampled_bytes_.fetch_add(_bytes);
+
+            std::unique_lock lock{scheduler_mutex_, std::try_to_lock};
+
+            if (!lock) {
+                return;
+            }
+
+            const auto now = clock_type::now();
+            const std::chrono::duration<double> elapsed = now - sample_start_;
+
+            if (elapsed < throughput_sample_interval) {
+                return;
+            }
+
+            const auto throughput = sampled_bytes_.exchange(0) / elapsed.count();
+
+            if (throughput < last_throughput_ * (1 + throughput_gain_threshold)) {
+                adjustment_ = -adjustment_;
+            }
+
+            active_channels_ = std::clamp<std::int64_t>(active_channels_ + adjustment_, 1, number_of_channels_);
+            last_throughput_ = throughput;
+            sample_start_ = now;
+
+            lock.unlock();
+            scheduler_cond_var_.notify_all();
+        }
+
         auto schedule_transfer_task_on_thread_pool(source_stream_type& _source_stream,
                                                    sink_stream_type& _sink_stream,
-                                                   transfer_progress& _progress,
+                                                   std::int64_t _channel,
                                                    std::future<void>& _result,
                                                    bool _wait_for_sibling_tasks_to_finish) -> void
         {
             std::packaged_task<void()> task{[this,
                                              in = std::move(_source_stream),
                                              out = std::move(_sink_stream),
-                                             &_progress,
+                                             _channel,
                                              _wait_for_sibling_tasks_to_finish]() mutable
             {
                 try {
                     std::vector<typename source_stream_type::char_type> buf(transfer_buffer_size_);
 
-                    while (!stop_.load() && _progress.progress->sent < _progress.progress->chunk_size) {
-                        if (!in) {
-                            std::lock_guard lock{errors_mutex_};
-                            errors_.emplace_back(parallel_transfer_error::stream_read, "Source stream in bad state");
+                    // The position of both streams. Consecutive chunks do not require a seek.
+                    auto position = offset_;
+                    auto failed = false;
+
+                    while (!failed && wait_until_active(_channel)) {
+                        const auto chunk = claim_chunk();
+
+                        if (!chunk) {
                             break;
                         }
 
-                        if (!out) {
-                            std::lock_guard lock{errors_mutex_};
-                            errors_.emplace_back(parallel_transfer_error::stream_write, "Sink stream in bad state");
-                            break;
+                        auto& sent = chunk_progress_[*chunk];
+                        const auto length = chunk_length(*chunk);
+
+                        if (const auto pos = offset_ + *chunk * chunk_size_ + sent; pos != position) {
+                            if (!in.seekg(pos)) {
+                                std::lock_guard lock{errors_mutex_};
+                                errors_.emplace_back(parallel_transfer_error::stream_seek, "Seek error on input stream");
+                                break;
+                            }
+
+                            if (!out.seekp(pos)) {
+                                std::lock_guard lock{errors_mutex_};
+                                errors_.emplace_back(parallel_transfer_error::stream_seek, "Seek error on output stream");
+                                break;
+                            }
+
+                            position = pos;
                         }
 
-                        in.read(buf.data(), std::min({_progress.progress->chunk_size - _progress.progress->sent,
-                                                      static_cast<std::int64_t>(buf.size()),
-                                                      _progress.progress->chunk_size}));
-                        out.write(buf.data(), in.gcount());
-                        _progress.progress->sent += in.gcount();
+                        while (!stop_.load() && sent < length) {
+                            if (!in) {
+                                std::lock_guard lock{errors_mutex_};
+                                errors_.emplace_back(parallel_transfer_error::stream_read, "Source stream in bad state");
+                                failed = true;
+                                break;
+                            }
+
+                            if (!out) {
+                                std::lock_guard lock{errors_mutex_};
+                                errors_.emplace_back(parallel_transfer_error::stream_write, "Sink stream in bad state");
+                                failed = true;
+                                break;
+                            }
+
+                            in.read(buf.data(), std::min(length - sent, static_cast<std::int64_t>(buf.size())));
+                            out.write(buf.data(), in.gcount());
+                            sent += in.gcount();
+                            position += in.gcount();
+
+                            record_throughput(in.gcount());
+                        }
                     }
 
                     if (_wait_for_sibling_tasks_to_finish) {
@@ -563,12 +769,24 @@ namespace irods::experimental::io
         std::unique_ptr<boost::interprocess::file_mapping> file_mapping_;
         std::unique_ptr<boost::interprocess::mapped_region> mapped_region_;
 
-        std::vector<transfer_progress> progress_;
+        // Points into the mapped restart file. Each chunk is owned by one channel at a time.
+        std::int64_t* chunk_progress_;
+        std::atomic<std::int64_t> next_chunk_;
+
         std::vector<std::future<void>> tasks_running_;
         error_type errors_;
         std::mutex errors_mutex_;
         std::unique_ptr<latch> latch_;
 
+        // State for the adaptive channel count. Guarded by scheduler_mutex_.
+        std::mutex scheduler_mutex_;
+        std::condition_variable scheduler_cond_var_;
+        std::int64_t active_channels_;
+        std::atomic<std::int64_t> sampled_bytes_;
+        clock_type::time_point sample_start_;
+        double last_throughput_;
+        std::int64_t adjustment_;
+
         source_stream_factory_type source_stream_factory_;
         sink_stream_factory_type sink_stream_factory_;
         sink_stream_close_handler_type sink_stream_close_handler_;
@@ -577,12 +795,16 @@ namespace irods::experimental::io
         std::int64_t number_of_channels_;
         std::int64_t offset_;
         std::int64_t transfer_buffer_size_;
+        std::int64_t chunk_size_;
+        std::int64_t number_of_chunks_;
+        bool adapt_channel_count_;
 
         std::string restart_file_dir_;
         std::string restart_handle_;
         bool restart_file_exists_;
     }; // class parallel_transfer_engine
 
+
     /// A class that makes construction of parallel transfer engine instances easier.
     ///
     /// Instances of this class are not copyable or moveable.
@@ -620,6 +842,8 @@ namespace irods::experimental::io
             , offset_{}
             , transfer_buffer_size_{8192}
             , number_of_channels_{3}
+            , chunk_size_{parallel_transfer_engine_type::default_chunk_size}
+            , adapt_channel_count_{}
             , restart_file_dir_{default_restart_file_directory()}
         {
         }
@@ -675,6 +899,40 @@ namespace irods::experimental::io
             return *this;
         }
 
+        /// \brief Sets the number of bytes in each unit of work handed out to channels.
+        ///
+        /// Smaller chunks spread the work more evenly across channels at the cost of more seeks.
+        ///
+        /// Defaults to 4 MiB.
+        ///
+        /// \throws parallel_transfer_engine_builder_error If the value is less than or equal to zero.
+        ///
+        /// \return A reference to the builder object.
+        ///
+        /// \since 4.3.0
+        auto chunk_size(std::int64_t _chunk_size) -> parallel_transfer_engine_builder&
+        {
+            chunk_size_ = _chunk_size;
+            return *this;
+        }
+
+        /// \brief Sets whether the number of busy channels should follow the measured throughput.
+        ///
+        /// When enabled, the transfer starts with one busy channel and adds or parks channels,
+        /// one at a time, depending on whether the last change improved the throughput. The
+        /// number of channels becomes the upper bound.
+        ///
+        /// Defaults to false.
+        ///
+        /// \return A reference to the builder object.
+        ///
+        /// \since 4.3.0
+        auto adapt_channel_count(bool _value) -> parallel_transfer_engine_builder&
+        {
+            adapt_channel_count_ = _value;
+            return *this;
+        }
+
         /// \brief Sets the offset of the source and sink streams' read/write position.
         ///
         /// Defaults to 0.
@@ -702,6 +960,7 @@ namespace irods::experimental::io
             throw_if_less_than_zero(total_bytes_to_transfer_, "total bytes to transfer");
             throw_if_less_than_or_equal_to_zero(transfer_buffer_size_, "transfer buffer size");
             throw_if_less_than_zero(offset_, "offset");
+            throw_if_less_than_or_equal_to_zero(chunk_size_, "chunk size");
 
             return {source_stream_factory_,
                     sink_stream_factory_,
@@ -710,7 +969,9 @@ namespace irods::experimental::io
                     number_of_channels_,
                     offset_,
                     transfer_buffer_size_,
-                    restart_file_dir_};
+                    restart_file_dir_,
+                    chunk_size_,
+                    adapt_channel_count_};
         }
 
     private:
@@ -749,6 +1010,8 @@ namespace irods::experimental::io
         std::int64_t offset_;
         std::int64_t transfer_buffer_size_;
         std::int16_t number_of_channels_;
+        std::int64_t chunk_size_;
+        bool adapt_channel_count_;
 
         std::string restart_file_dir_;
     }; // class parallel_transfer_engine_builder
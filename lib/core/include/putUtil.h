@@ -31,6 +31,7 @@ typedef struct {
     char cachedSubPhyBunDir[MAX_NAME_LEN];
     char phyBunPath[MAX_NUM_BULK_OPR_FILES][MAX_NAME_LEN];
     bytesBuf_t bytesBuf;
+    void *pipeline; // batch in flight when uploads are pipelined, see bulkPutDirUtil
 } bulkOprInfo_t;
 
 int
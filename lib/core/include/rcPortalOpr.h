@@ -18,6 +18,12 @@
 
 #define MAX_PROGRESS_CNT	8
 
+/* values of irods_parallel_transfer_mode. In main_port mode large files are
+ * transferred over the connection of the request and additional connections
+ * to the main port instead of portals opened by the server. */
+#define PARALLEL_TRANSFER_MODE_PORTAL       "portal"
+#define PARALLEL_TRANSFER_MODE_MAIN_PORT    "main_port"
+
 typedef struct RcPortalTransferInp {
     rcComm_t *conn;
     int destFd;
@@ -68,6 +74,14 @@ int
 getFile( rcComm_t *conn, int l1descInx, char *locFilePath, char *objPath,
          rodsLong_t dataSize );
 int
+getMainPortStreams( dataObjInp_t *dataObjInp );
+int
+putFileToStreams( rcComm_t *conn, int l1descInx, char *locFilePath, char *objPath,
+                  rodsLong_t dataSize, int numStreams );
+int
+getFileFromStreams( rcComm_t *conn, int l1descInx, char *locFilePath, char *objPath,
+                    rodsLong_t dataSize, int numStreams );
+int
 putFileToPortalRbudp( portalOprOut_t *portalOprOut,
                       char *locFilePath, int locFd,
                       int veryVerbose, int sendRate, int packetSize );
@@ -91,16 +105,6 @@ lfRestartPutWithInfo( rcComm_t *conn, fileRestartInfo_t *info );
 int
 lfRestartGetWithInfo( rcComm_t *conn, fileRestartInfo_t *info );
 int
-putSeg( rcComm_t *conn, rodsLong_t segSize, int localFd,
-        openedDataObjInp_t *dataObjWriteInp, bytesBuf_t *dataObjWriteInpBBuf,
-        int bufLen, int *writtenSinceUpdated, fileRestartInfo_t *info,
-        rodsLong_t *dataSegLen );
-int
-getSeg( rcComm_t *conn, rodsLong_t segSize, int localFd,
-        openedDataObjInp_t *dataObjReadInp, bytesBuf_t *dataObjReadInpBBuf,
-        int bufLen, int *writtenSinceUpdated, fileRestartInfo_t *info,
-        rodsLong_t *dataSegLen );
-int
 catDataObj( rcComm_t *conn, char *objPath );
 #ifdef __cplusplus
 }
@@ -314,6 +314,11 @@
 // fileModified notification should be sent to the resource plugins.
 #define FILE_MODIFIED_KW "file_modified"
 
+// Asks the server to decide how many streams to the main port a transfer may use,
+// at most the given number. The answer is reported as the number of threads of the
+// open data object.
+#define MAIN_PORT_STREAMS_KW "main_port_streams"
+
 // clang-format on
 
 #endif  // RODS_KEYWD_DEF_H__
@@ -0,0 +1,488 @@
+#ifndef IRODS_IO_ASYNC_TRANSPORT_HPP
+#define IRODS_IO_ASYNC_TRANSPORT_HPP
+
+/// \file
+
+#include "transport/transport.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace irods::experimental::io
+{
+    /// \brief A transport that moves bytes on a background thread.
+    ///
+    /// This type wraps another transport. Replicas opened for reading only are read ahead
+    /// of the consumer: the background thread keeps up to \p queue_depth chunks of
+    /// \p chunk_size bytes in flight. Replicas opened for writing only are written behind
+    /// the producer: send() queues the bytes and returns immediately. A write error is
+    /// reported by the next call to send(), seekpos() or close(). Replicas opened for
+    /// reading and writing are passed through to the wrapped transport unchanged.
+    ///
+    /// A seek to a position that has already been read ahead is served from the prefetched
+    /// data, and the read-ahead requests already issued beyond it are kept. Any other seek
+    /// discards the data read ahead, and prefetching restarts from the new position.
+    ///
+    /// While a replica is open, the background thread is the only user of the wrapped
+    /// transport. The connection behind the wrapped transport must not be used for anything
+    /// else until the replica is closed, so give it a connection of its own.
+    ///
+    /// \since 4.3.0
+    template <typename CharT>
+    class basic_async_transport : public transport<CharT>
+    {
+    public:
+        // clang-format off
+        using char_type   = typename transport<CharT>::char_type;
+        using traits_type = typename transport<CharT>::traits_type;
+        using int_type    = typename traits_type::int_type;
+        using pos_type    = typename traits_type::pos_type;
+        using off_type    = typename traits_type::off_type;
+        // clang-format on
+
+    private:
+        // clang-format off
+        inline static constexpr std::streamsize default_chunk_size  = 4 * 1024 * 1024;
+        inline static constexpr std::size_t     default_queue_depth = 4;
+
+        // Errors
+        inline static constexpr std::streamsize io_error   = -1;
+        inline static const     auto            seek_error = pos_type{off_type{-1}};
+        // clang-format on
+
+        enum class mode
+        {
+            passthrough,
+            read_ahead,
+            write_behind
+        };
+
+    public:
+        /// \param[in] _transport   The transport that performs the actual I/O.
+        /// \param[in] _chunk_size  The number of bytes per request issued by the background thread.
+        /// \param[in] _queue_depth The maximum number of chunks in flight.
+        explicit basic_async_transport(transport<CharT>& _transport,
+                                       std::streamsize _chunk_size = default_chunk_size,
+                                       std::size_t _queue_depth = default_queue_depth)
+            : transport<CharT>{}
+            , tp_{&_transport}
+            , chunk_size_{std::max<std::streamsize>(1, _chunk_size)}
+            , queue_depth_{std::max<std::size_t>(1, _queue_depth)}
+            , mode_{mode::passthrough}
+            , worker_{}
+            , mtx_{}
+            , cv_{}
+            , chunks_{}
+            , front_offset_{}
+            , read_pos_{}
+            , busy_{}
+            , paused_{}
+            , stop_{}
+            , eof_{}
+            , error_{}
+        {
+        }
+
+        basic_async_transport(const basic_async_transport&) = delete;
+        auto operator=(const basic_async_transport&) -> basic_async_transport& = delete;
+
+        ~basic_async_transport()
+        {
+            stop_worker();
+        }
+
+        bool open(const irods::experimental::filesystem::path& _path,
+                  std::ios_base::openmode _mode) override
+        {
+            return start_if(tp_->open(_path, _mode), _mode);
+        }
+
+        bool open(const irods::experimental::filesystem::path& _path,
+                  const replica_number& _replica_number,
+                  std::ios_base::openmode _mode) override
+        {
+            return start_if(tp_->open(_path, _replica_number, _mode), _mode);
+        }
+
+        bool open(const irods::experimental::filesystem::path& _path,
+                  const root_resource_name& _root_resource_name,
+                  std::ios_base::openmode _mode) override
+        {
+            return start_if(tp_->open(_path, _root_resource_name, _mode), _mode);
+        }
+
+        bool open(const irods::experimental::filesystem::path& _path,
+                  const leaf_resource_name& _leaf_resource_name,
+                  std::ios_base::openmode _mode) override
+        {
+            return start_if(tp_->open(_path, _leaf_resource_name, _mode), _mode);
+        }
+
+        bool open(const replica_token& _replica_token,
+                  const irods::experimental::filesystem::path& _path,
+                  const replica_number& _replica_number,
+                  std::ios_base::openmode _mode) override
+        {
+            return start_if(tp_->open(_replica_token, _path, _replica_number, _mode), _mode);
+        }
+
+        bool open(const replica_token& _replica_token,
+                  const irods::experimental::filesystem::path& _path,
+                  const leaf_resource_name& _leaf_resource_name,
+                  std::ios_base::openmode _mode) override
+        {
+            return start_if(tp_->open(_replica_token, _path, _leaf_resource_name, _mode), _mode);
+        }
+
+        bool close(const on_close_success* _on_close_success = nullptr) override
+        {
+            const bool write_error = stop_worker();
+            const bool closed = tp_->close(_on_close_success);
+            return closed && !write_error;
+        }
+
+        std::streamsize receive(char_type* _buffer, std::streamsize _buffer_size) override
+        {
+            if (mode::read_ahead != mode_) {
+                return tp_->receive(_buffer, _buffer_size);
+            }
+
+            std::unique_lock lk{mtx_};
+
+            // Like the wrapped transport, only return fewer bytes than requested at the
+            // end of the replica.
+            std::streamsize bytes_copied = 0;
+
+            while (bytes_copied < _buffer_size) {
+                cv_.wait(lk, [this] { return !chunks_.empty() || eof_ || error_; });
+
+                if (chunks_.empty()) {
+                    if (error_ && bytes_copied == 0) {
+                        return io_error;
+                    }
+
+                    break;
+                }
+
+                auto& chunk = chunks_.front();
+                const auto n = std::min<std::streamsize>(_buffer_size - bytes_copied, chunk.size() - front_offset_);
+
+                std::memcpy(_buffer + bytes_copied, chunk.data() + front_offset_, n * sizeof(char_type));
+                bytes_copied += n;
+                front_offset_ += n;
+
+                if (front_offset_ == static_cast<std::streamsize>(chunk.size())) {
+                    chunks_.pop_front();
+                    front_offset_ = 0;
+                    cv_.notify_all();
+                }
+            }
+
+            return bytes_copied;
+        }
+
+        std::streamsize send(const char_type* _buffer, std::streamsize _buffer_size) override
+        {
+            if (mode::write_behind != mode_) {
+                return tp_->send(_buffer, _buffer_size);
+            }
+
+            std::unique_lock lk{mtx_};
+
+            // Coalesce small writes into the last queued chunk.
+            if (!chunks_.empty() && static_cast<std::streamsize>(chunks_.back().size()) + _buffer_size <= chunk_size_) {
+                chunks_.back().insert(chunks_.back().end(), _buffer, _buffer + _buffer_size);
+            }
+            else {
+                cv_.wait(lk, [this] { return chunks_.size() < queue_depth_ || error_; });
+                chunks_.emplace_back(_buffer, _buffer + _buffer_size);
+            }
+
+            if (error_) {
+                return io_error;
+            }
+
+            cv_.notify_all();
+
+            return _buffer_size;
+        }
+
+        pos_type seekpos(off_type _offset, std::ios_base::seekdir _dir) override
+        {
+            if (mode::passthrough == mode_) {
+                return tp_->seekpos(_offset, _dir);
+            }
+
+            std::unique_lock lk{mtx_};
+
+            if (mode::read_ahead == mode_) {
+                if (const auto pos = seek_within_read_ahead(_offset, _dir); pos != seek_error) {
+                    return pos;
+                }
+            }
+
+            // Park the background thread. For writes, this also waits for queued bytes to land.
+            paused_ = true;
+            cv_.wait(lk, [this] { return !busy_ && (mode::read_ahead == mode_ || chunks_.empty() || error_); });
+
+            if (error_ && mode::write_behind == mode_) {
+                paused_ = false;
+                cv_.notify_all();
+                return seek_error;
+            }
+
+            // The wrapped transport is ahead of the consumer by the bytes read but not consumed.
+            if (std::ios_base::cur == _dir) {
+                for (auto&& chunk : chunks_) {
+                    _offset -= chunk.size();
+                }
+
+                _offset += front_offset_;
+            }
+
+            const auto pos = tp_->seekpos(_offset, _dir);
+
+            if (pos != seek_error) {
+                read_pos_ = pos;
+            }
+
+            chunks_.clear();
+            front_offset_ = 0;
+            eof_ = false;
+            error_ = false;
+            paused_ = false;
+            cv_.notify_all();
+
+            return pos;
+        }
+
+        bool is_open() const noexcept override
+        {
+            return tp_->is_open();
+        }
+
+        int file_descriptor() const noexcept override
+        {
+            return tp_->file_descriptor();
+        }
+
+        const root_resource_name& root_resource_name() const override
+        {
+            return tp_->root_resource_name();
+        }
+
+        const leaf_resource_name& leaf_resource_name() const override
+        {
+            return tp_->leaf_resource_name();
+        }
+
+        const replica_number& replica_number() const override
+        {
+            return tp_->replica_number();
+        }
+
+        const replica_token& replica_token() const override
+        {
+            return tp_->replica_token();
+        }
+
+    private:
+        bool start_if(bool _opened, std::ios_base::openmode _mode)
+        {
+            if (!_opened) {
+                return false;
+            }
+
+            using std::ios_base;
+
+            const auto rw = _mode & (ios_base::in | ios_base::out);
+
+            if (ios_base::in == rw) {
+                mode_ = mode::read_ahead;
+            }
+            else if (ios_base::out == rw || (!rw && (_mode & ios_base::app))) {
+                mode_ = mode::write_behind;
+            }
+            else {
+                mode_ = mode::passthrough;
+                return true;
+            }
+
+            chunks_.clear();
+            front_offset_ = 0;
+            read_pos_ = 0;
+            busy_ = paused_ = stop_ = eof_ = error_ = false;
+
+            worker_ = std::thread{[this] { run(); }};
+
+            return true;
+        }
+
+        // Stops the background thread after flushing queued writes.
+        // Returns true if any write failed.
+        bool stop_worker()
+        {
+            if (!worker_.joinable()) {
+                return false;
+            }
+
+            {
+                std::lock_guard lk{mtx_};
+                stop_ = true;
+                cv_.notify_all();
+            }
+
+            worker_.join();
+
+            const bool write_error = mode::write_behind == mode_ && error_;
+
+            chunks_.clear();
+            mode_ = mode::passthrough;
+
+            return write_error;
+        }
+
+        void run()
+        {
+            std::unique_lock lk{mtx_};
+
+            while (true) {
+                // Writes keep draining while a seek waits for them to land.
+                cv_.wait(lk, [this] { return stop_ || ((!paused_ || mode::write_behind == mode_) && has_work()); });
+
+                if (mode::read_ahead == mode_) {
+                    if (stop_) {
+                        return;
+                    }
+
+                    busy_ = true;
+                    lk.unlock();
+
+                    std::vector<char_type> chunk(chunk_size_);
+                    const auto bytes_read = tp_->receive(chunk.data(), chunk_size_);
+
+                    lk.lock();
+                    busy_ = false;
+
+                    if (bytes_read < 0) {
+                        error_ = true;
+                    }
+                    else if (bytes_read == 0) {
+                        eof_ = true;
+                    }
+                    else {
+                        chunk.resize(bytes_read);
+                        chunks_.push_back(std::move(chunk));
+                        read_pos_ += bytes_read;
+                    }
+                }
+                else {
+                    // Queued writes are always flushed, even when stopping.
+                    if (chunks_.empty() || error_) {
+                        if (stop_) {
+                            return;
+                        }
+
+                        continue;
+                    }
+
+                    auto chunk = std::move(chunks_.front());
+                    chunks_.pop_front();
+
+                    busy_ = true;
+                    lk.unlock();
+
+                    const auto bytes_written = tp_->send(chunk.data(), chunk.size());
+
+                    lk.lock();
+                    busy_ = false;
+
+                    if (bytes_written != static_cast<std::streamsize>(chunk.size())) {
+                        error_ = true;
+                    }
+                }
+
+                cv_.notify_all();
+            }
+        }
+
+        // Moves the consumer to a position within the chunks read ahead without touching
+        // the wrapped transport. Returns seek_error if the position is not buffered.
+        // The caller must hold the lock.
+        pos_type seek_within_read_ahead(off_type _offset, std::ios_base::seekdir _dir)
+        {
+            off_type buffered = 0;
+            for (auto&& chunk : chunks_) {
+                buffered += chunk.size();
+            }
+
+            // The front chunk is kept until it is consumed, so the consumer may also
+            // seek back within it.
+            const off_type first = read_pos_ - buffered;
+            const off_type current = first + front_offset_;
+
+            off_type target;
+
+            if (std::ios_base::beg == _dir) {
+                target = _offset;
+            }
+            else if (std::ios_base::cur == _dir) {
+                target = current + _offset;
+            }
+            else {
+                return seek_error;
+            }
+
+            // The end of the buffered data is where the next chunk read ahead will start.
+            if (target < first || target > read_pos_) {
+                return seek_error;
+            }
+
+            auto offset_in_chunks = target - first;
+
+            while (!chunks_.empty() && offset_in_chunks >= static_cast<off_type>(chunks_.front().size())) {
+                offset_in_chunks -= chunks_.front().size();
+                chunks_.pop_front();
+            }
+
+            front_offset_ = offset_in_chunks;
+            cv_.notify_all();
+
+            return pos_type{target};
+        }
+
+        bool has_work() const noexcept
+        {
+            if (mode::read_ahead == mode_) {
+                return !eof_ && !error_ && chunks_.size() < queue_depth_;
+            }
+
+            return !chunks_.empty() && !error_;
+        }
+
+        transport<CharT>* tp_;
+        const std::streamsize chunk_size_;
+        const std::size_t queue_depth_;
+        mode mode_;
+        std::thread worker_;
+        std::mutex mtx_;
+        std::condition_variable cv_;
+        std::deque<std::vector<char_type>> chunks_;
+        std::streamsize front_offset_;
+        off_type read_pos_; // The position of the wrapped transport while reading ahead.
+        bool busy_;
+        bool paused_;
+        bool stop_;
+        bool eof_;
+        bool error_;
+    }; // basic_async_transport
+
+    using async_transport = basic_async_transport<char>;
+} // namespace irods::experimental::io
+
+#endif // IRODS_IO_ASYNC_TRANSPORT_HPP
@@ -5,6 +5,9 @@
 #include "rodsLog.h"
 #include "chksumUtil.h"
 #include "rcGlobalExtern.h"
+#include "bulk_checksum.h"
+
+#include "json.hpp"
 
 #ifndef windows_platform
     #include <sys/time.h>
@@ -15,6 +18,62 @@
 static int ChksumCnt = 0;
 static int FailedChksumCnt = 0;
 
+namespace
+{
+    // Verifies every replica under a collection with a single request. The server checksums
+    // the replicas in parallel and reports problems in the error stack of the connection.
+    // Returns SYS_NOT_SUPPORTED if the collection must be verified one data object at a time.
+    //
+    // The output differs from chksumCollUtil: a single header is printed for the collection
+    // and the report follows it. Each entry names its data object because the entries of
+    // nested collections are not grouped under their own headers. Like rcDataObjChksum, the
+    // number of replicas skipped is reported for each data object.
+    int verifyCollInBulk(rcComm_t* conn, rodsPath_t* srcPath, rodsArguments_t* rodsArgs)
+    {
+        if (rodsArgs->verifyChecksum != True && rodsArgs->verify != True) {
+            return SYS_NOT_SUPPORTED;
+        }
+
+        // Targeting specific replicas and skipping the checksum are only supported by
+        // rcDataObjChksum. Special collections are not in the catalog.
+        if (rodsArgs->replNum == True || rodsArgs->resource == True || rodsArgs->noCompute == True ||
+            (srcPath->rodsObjStat && srcPath->rodsObjStat->specColl))
+        {
+            return SYS_NOT_SUPPORTED;
+        }
+
+        const auto input = nlohmann::json{
+            {"logical_path", srcPath->outPath},
+            {"options", {
+                {"verify", true},
+                {"admin", rodsArgs->admin == True}
+            }}
+        }.dump();
+
+        const int status = rc_bulk_checksum(conn, input.c_str(), rodsArgs->verbose == True ? 1 : 0);
+
+        // Servers without the API and collections the API cannot handle fall back to the
+        // per data object path.
+        if (status == SYS_NOT_SUPPORTED || status == SYS_UNMATCHED_API_NUM) {
+            freeRError(conn->rError);
+            conn->rError = nullptr;
+            return SYS_NOT_SUPPORTED;
+        }
+
+        if (rodsArgs->silent == False) {
+            fprintf(stdout, "C- %s:\n", srcPath->outPath);
+        }
+
+        if (conn->rError) {
+            printErrorStack(conn->rError);
+            freeRError(conn->rError);
+            conn->rError = nullptr;
+        }
+
+        return status;
+    }
+} // anonymous namespace
+
 int chksumUtil(rcComm_t* conn,
                rodsEnv* myRodsEnv,
                rodsArguments_t* myRodsArgs,
@@ -49,7 +108,10 @@ int chksumUtil(rcComm_t* conn,
         }
         else if ( rodsPathInp->srcPath[i].objType ==  COLL_OBJ_T ) {
             addKeyVal( &dataObjInp.condInput, TRANSLATED_PATH_KW, "" );
-            status = chksumCollUtil( conn, rodsPathInp->srcPath[i].outPath, myRodsEnv, myRodsArgs, &dataObjInp, &collInp );
+            status = verifyCollInBulk( conn, &rodsPathInp->srcPath[i], myRodsArgs );
+            if ( status == SYS_NOT_SUPPORTED ) {
+                status = chksumCollUtil( conn, rodsPathInp->srcPath[i].outPath, myRodsEnv, myRodsArgs, &dataObjInp, &collInp );
+            }
         }
         else {
             /* should not be here */
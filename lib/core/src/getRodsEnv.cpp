@@ -186,6 +186,7 @@ extern "C" {
         _env->irodsDefaultNumberTransferThreads = 4;
         _env->irodsTransBufferSizeForParaTrans  = 4;
         _env->irodsConnectionPoolRefreshTime    = 300;
+        _env->irodsRsyncTransferWorkers         = 4;
 
         // default auth scheme
         snprintf(
@@ -345,6 +346,14 @@ extern "C" {
             irods::CFG_IRODS_CONNECTION_POOL_REFRESH_TIME,
             _env->irodsConnectionPoolRefreshTime );
 
+        capture_string_property(
+            irods::CFG_IRODS_PARALLEL_TRANSFER_MODE,
+            _env->irodsParallelTransferMode );
+
+        capture_integer_property(
+            irods::CFG_IRODS_RSYNC_TRANSFER_WORKERS,
+            _env->irodsRsyncTransferWorkers );
+
         capture_string_property(
             irods::CFG_IRODS_PLUGINS_HOME_KW,
             _env->irodsPluginHome );
@@ -621,6 +630,16 @@ extern "C" {
             env_var,
             _env->irodsTransBufferSizeForParaTrans );
 
+        env_var = irods::CFG_IRODS_PARALLEL_TRANSFER_MODE;
+        capture_string_env_var(
+            env_var,
+            _env->irodsParallelTransferMode );
+
+        env_var = irods::CFG_IRODS_RSYNC_TRANSFER_WORKERS;
+        capture_integer_env_var(
+            env_var,
+            _env->irodsRsyncTransferWorkers );
+
         env_var = irods::CFG_IRODS_PLUGINS_HOME_KW;
         capture_string_env_var(
             env_var,
@@ -16,6 +16,12 @@ namespace irods
     const std::string CFG_DB_SSLROOTCERT_KW( "db_sslrootcert" );
     const std::string CFG_DB_SSLCERT_KW( "db_sslcert" );
     const std::string CFG_DB_SSLKEY_KW( "db_sslkey" );
+    const std::string CFG_DB_READ_REPLICA_KW( "db_read_replica" );
+    const std::string CFG_DB_ODBC_DSN_KW( "db_odbc_dsn" );
+    const std::string CFG_DB_READ_YOUR_WRITES_KW( "db_read_your_writes" );
+    const std::string CFG_DB_EFFECTIVE_ACCESS_INDEX_KW( "db_effective_access_index" );
+    const std::string CFG_DB_MAX_CONNECTIONS_KW( "db_max_connections" );
+    const std::string CFG_DB_CONNECTION_WAIT_TIMEOUT_KW( "db_connection_wait_timeout" );
     const std::string CFG_ZONE_NAME_KW( "zone_name" );
     const std::string CFG_ZONE_KEY_KW( "zone_key" );
     const std::string CFG_NEGOTIATION_KEY_KW( "negotiation_key" );
@@ -60,6 +66,8 @@ namespace irods
     const std::string CFG_DEF_TEMP_PASSWORD_LIFETIME( "default_temporary_password_lifetime_in_seconds" );
     const std::string CFG_MAX_TEMP_PASSWORD_LIFETIME( "maximum_temporary_password_lifetime_in_seconds" );
     const std::string CFG_MAX_NUMBER_OF_CONCURRENT_RE_PROCS( "maximum_number_of_concurrent_rule_engine_server_processes" );
+    const std::string CFG_MAX_NUMBER_OF_BULK_CHECKSUM_THREADS( "maximum_number_of_bulk_checksum_threads" );
+    const std::string CFG_MAX_NUMBER_OF_CONCURRENT_CHECKSUMS_PER_RESOURCE( "maximum_number_of_concurrent_checksums_per_resource" );
     const std::string DEFAULT_LOG_ROTATION_IN_DAYS("default_log_rotation_in_days");
 
     const std::string CFG_RE_CACHE_SALT_KW("reCacheSalt");
@@ -110,6 +118,8 @@ namespace irods
     const std::string CFG_IRODS_MAX_NUMBER_TRANSFER_THREADS( "irods_maximum_number_of_transfer_threads" );
     const std::string CFG_IRODS_TRANS_BUFFER_SIZE_FOR_PARA_TRANS( "irods_transfer_buffer_size_for_parallel_transfer_in_megabytes" );
     const std::string CFG_IRODS_CONNECTION_POOL_REFRESH_TIME( "irods_connection_pool_refresh_time_in_seconds");
+    const std::string CFG_IRODS_PARALLEL_TRANSFER_MODE( "irods_parallel_transfer_mode" );
+    const std::string CFG_IRODS_RSYNC_TRANSFER_WORKERS( "irods_rsync_transfer_workers" );
 
     // legacy ssl environment variables
     const std::string CFG_IRODS_SSL_CA_CERTIFICATE_PATH( "irods_ssl_ca_certificate_path" );
@@ -24,6 +24,141 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/filesystem/convenience.hpp>
 
+#include <future>
+#include <utility>
+
+namespace
+{
+    // A batch of small files being uploaded by rcBulkDataObjPut on a background
+    // thread. While it is in flight, the next batch is read into the other buffer,
+    // so local I/O and checksumming overlap with the transfer and the server-side
+    // processing of the previous batch.
+    //
+    // This reuses rcBulkDataObjPut and its MAX_NUM_BULK_OPR_FILES batch limit,
+    // which are part of the wire format shared with existing servers. It is not
+    // a streaming ingest API.
+    struct bulk_put_pipeline
+    {
+        bulkOprInp_t bulkOprInp{};
+        bytesBuf_t bytesBuf{};
+        int count{};
+        int size{};
+        char cachedTargPath[MAX_NAME_LEN]{};
+        struct timeval startTime{};
+        std::future<int> result;
+    };
+
+    void reportBulkPut( rcComm_t *conn, int count, int size, char *cachedTargPath,
+                        rodsArguments_t *rodsArgs, struct timeval *startTime ) {
+        struct timeval endTime;
+
+        if ( rodsArgs->verbose == True ) {
+            printf( "Bulk upload %d files.\n", count );
+            ( void ) gettimeofday( &endTime, ( struct timezone * )0 );
+            printTiming( conn, cachedTargPath, size, cachedTargPath,
+                         startTime, &endTime );
+        }
+        if ( gGuiProgressCB != NULL ) {
+            rstrcpy( conn->operProgress.curFileName, cachedTargPath, MAX_NAME_LEN );
+            conn->operProgress.totalNumFilesDone += count;
+            conn->operProgress.totalFileSizeDone += size;
+            gGuiProgressCB( &conn->operProgress );
+        }
+    }
+
+    /* createBulkPutPipeline - the attribute arrays of the pipeline and bulkOprInp are
+     * swapped per batch, so both must have the same columns. The checksum column is
+     * only added when the checksum keywords are already in condInput. */
+    bulk_put_pipeline *createBulkPutPipeline( bulkOprInp_t *bulkOprInp ) {
+        auto *pipeline = new bulk_put_pipeline{};
+        copyKeyVal( &bulkOprInp->condInput, &pipeline->bulkOprInp.condInput );
+        initAttriArrayOfBulkOprInp( &pipeline->bulkOprInp );
+        pipeline->bytesBuf.buf = malloc( BULK_OPR_BUF_SIZE );
+        return pipeline;
+    }
+
+    /* waitForBulkPut - wait for the batch in flight, if any, and return its status */
+    int waitForBulkPut( rcComm_t *conn, bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs ) {
+        if ( bulkOprInfo == NULL || bulkOprInfo->pipeline == NULL ) {
+            return 0;
+        }
+
+        auto& pipeline = *static_cast<bulk_put_pipeline*>( bulkOprInfo->pipeline );
+
+        if ( !pipeline.result.valid() ) {
+            return 0;
+        }
+
+        const int status = pipeline.result.get();
+        if ( status >= 0 ) {
+            reportBulkPut( conn, pipeline.count, pipeline.size, pipeline.cachedTargPath,
+                           rodsArgs, &pipeline.startTime );
+        }
+        else {
+            // The batch has been replaced in bulkOprInfo by the time its status is
+            // known, so the failed files are reported here from the pipeline's copy.
+            rodsLogError( LOG_ERROR, status,
+                          "waitForBulkPut: bulk upload of %d files failed", pipeline.count );
+            const sqlResult_t *objPath = getSqlResultByInx( &pipeline.bulkOprInp.attriArray, COL_DATA_NAME );
+            for ( int i = 0; objPath != NULL && i < pipeline.bulkOprInp.attriArray.rowCnt; ++i ) {
+                rodsLog( LOG_ERROR, "waitForBulkPut: %s was in the failed batch",
+                         &objPath->value[MAX_NAME_LEN * i] );
+            }
+        }
+
+        return status;
+    }
+
+    /* queueBulkPut - start the upload of the current batch once the previous one is done.
+     * Returns the status of the previous batch. */
+    int queueBulkPut( rcComm_t *conn, bulkOprInp_t *bulkOprInp,
+                      bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs ) {
+        // Only one request may be outstanding on a connection.
+        const int status = waitForBulkPut( conn, bulkOprInfo, rodsArgs );
+
+        auto& pipeline = *static_cast<bulk_put_pipeline*>( bulkOprInfo->pipeline );
+
+        // Swap the attribute arrays and the buffers instead of copying the batch.
+        std::swap( pipeline.bulkOprInp.attriArray, bulkOprInp->attriArray );
+        std::swap( pipeline.bytesBuf.buf, bulkOprInfo->bytesBuf.buf );
+        pipeline.bytesBuf.len = bulkOprInfo->bytesBuf.len;
+        rstrcpy( pipeline.bulkOprInp.objPath, bulkOprInp->objPath, MAX_NAME_LEN );
+        clearKeyVal( &pipeline.bulkOprInp.condInput );
+        copyKeyVal( &bulkOprInp->condInput, &pipeline.bulkOprInp.condInput );
+        pipeline.count = bulkOprInfo->count;
+        pipeline.size = bulkOprInfo->size;
+        rstrcpy( pipeline.cachedTargPath, bulkOprInfo->cachedTargPath, MAX_NAME_LEN );
+
+        /* reset the row count */
+        bulkOprInp->attriArray.rowCnt = 0;
+        if ( bulkOprInfo->forceFlagAdded == 1 ) {
+            rmKeyVal( &bulkOprInp->condInput, FORCE_FLAG_KW );
+            bulkOprInfo->forceFlagAdded = 0;
+        }
+
+        ( void ) gettimeofday( &pipeline.startTime, ( struct timezone * )0 );
+        pipeline.result = std::async( std::launch::async, [conn, &pipeline] {
+            return rcBulkDataObjPut( conn, &pipeline.bulkOprInp, &pipeline.bytesBuf );
+        } );
+
+        return status;
+    }
+
+    void freeBulkPutPipeline( bulkOprInfo_t *bulkOprInfo ) {
+        if ( bulkOprInfo == NULL || bulkOprInfo->pipeline == NULL ) {
+            return;
+        }
+
+        auto *pipeline = static_cast<bulk_put_pipeline*>( bulkOprInfo->pipeline );
+        if ( pipeline->result.valid() ) {
+            pipeline->result.wait();
+        }
+        clearBulkOprInp( &pipeline->bulkOprInp );
+        free( pipeline->bytesBuf.buf );
+        delete pipeline;
+        bulkOprInfo->pipeline = NULL;
+    }
+} // anonymous namespace
 
 /* checkStateForResume - check the state for resume operation
  * return 0 - skip
@@ -898,12 +1033,16 @@ putDirUtil( rcComm_t **myConn, char *srcDir, char *targColl,
                 }
             }
             else {        /* a directory */
-                status = mkColl( conn, targChildPath );
-                if ( status < 0 ) {
-                    rodsLogError( LOG_ERROR, status, "putDirUtil: mkColl error for %s", targChildPath );
-                    if (status == SYS_INVALID_INPUT_PARAM)
-                    {
-                        return status;
+                /* the large files pass of bulkPutDirUtil has already made the
+                 * collections, and the connection may be busy with a bulk upload */
+                if ( bulkFlag != BULK_OPR_SMALL_FILES ) {
+                    status = mkColl( conn, targChildPath );
+                    if ( status < 0 ) {
+                        rodsLogError( LOG_ERROR, status, "putDirUtil: mkColl error for %s", targChildPath );
+                        if (status == SYS_INVALID_INPUT_PARAM)
+                        {
+                            return status;
+                        }
                     }
                 }
                 status = putDirUtil( myConn, srcChildPath, targChildPath,
@@ -952,16 +1091,20 @@ bulkPutDirUtil( rcComm_t **myConn, char *srcDir, char *targColl,
     bulkOprInfo.bytesBuf.len = 0;
     bulkOprInfo.bytesBuf.buf = malloc( BULK_OPR_BUF_SIZE );
 
+    /* pipeline the batches unless a restart file is used. The restart file
+     * may only record files that are known to have been stored. */
+    if ( rodsRestart->fd <= 0 ) {
+        bulkOprInfo.pipeline = createBulkPutPipeline( bulkOprInp );
+    }
+
     status = putDirUtil( myConn, srcDir, targColl, myRodsEnv, rodsArgs,
                          dataObjOprInp, bulkOprInp, rodsRestart, &bulkOprInfo );
 
     if ( status < 0 ) {
         rodsLogError( LOG_ERROR, status,
                       "bulkPutDirUtil: Small files bulkPut error for %s", srcDir );
-        return status;
     }
-
-    if ( bulkOprInfo.count > 0 ) {
+    else if ( bulkOprInfo.count > 0 ) {
         status = sendBulkPut( *myConn, bulkOprInp, &bulkOprInfo, rodsArgs );
         if ( status >= 0 ) {
             if ( rodsRestart->fd > 0 ) {
@@ -970,18 +1113,28 @@ bulkPutDirUtil( rcComm_t **myConn, char *srcDir, char *targColl,
                 writeRestartFile( rodsRestart, bulkOprInfo.cachedTargPath );
             }
         }
-        else {
+        else if ( bulkOprInfo.pipeline == NULL ) {
+            /* a pipelined failure belongs to an earlier batch and has
+             * been reported with its files by waitForBulkPut */
             rodsLogError( LOG_ERROR, status,
                           "bulkPutDirUtil: tarAndBulkPut error for %s",
                           bulkOprInfo.phyBunDir );
         }
         clearBulkOprInfo( &bulkOprInfo );
-        if ( bulkOprInfo.bytesBuf.buf != NULL ) {
-            free( bulkOprInfo.bytesBuf.buf );
-            bulkOprInfo.bytesBuf.buf = NULL;
-        }
+    }
+
+    /* the last batch may still be in flight */
+    const int pipelineStatus = waitForBulkPut( *myConn, &bulkOprInfo, rodsArgs );
+    if ( pipelineStatus < 0 && status >= 0 ) {
+        status = pipelineStatus;
+    }
+    freeBulkPutPipeline( &bulkOprInfo );
 
+    if ( bulkOprInfo.bytesBuf.buf != NULL ) {
+        free( bulkOprInfo.bytesBuf.buf );
+        bulkOprInfo.bytesBuf.buf = NULL;
     }
+
     return status;
 }
 
@@ -1086,7 +1239,9 @@ bulkPutFileUtil( rcComm_t *conn, char *srcPath, char *targPath,
             /* return the count */
             status = bulkOprInfo->count;
         }
-        else {
+        else if ( bulkOprInfo->pipeline == NULL ) {
+            /* a pipelined failure belongs to an earlier batch and has
+             * been reported with its files by waitForBulkPut */
             rodsLogError( LOG_ERROR, status,
                           "bulkPutFileUtil: tarAndBulkPut error for %s", srcPath );
         }
@@ -1098,13 +1253,17 @@ bulkPutFileUtil( rcComm_t *conn, char *srcPath, char *targPath,
 int
 sendBulkPut( rcComm_t *conn, bulkOprInp_t *bulkOprInp,
              bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs ) {
-    struct timeval startTime, endTime;
+    struct timeval startTime;
     int status = 0;
 
     if ( bulkOprInfo == NULL || bulkOprInfo->count <= 0 ) {
         return 0;
     }
 
+    if ( bulkOprInfo->pipeline != NULL ) {
+        return queueBulkPut( conn, bulkOprInp, bulkOprInfo, rodsArgs );
+    }
+
     if ( rodsArgs->verbose == True ) {
         ( void ) gettimeofday( &startTime, ( struct timezone * )0 );
     }
@@ -1120,20 +1279,8 @@ sendBulkPut( rcComm_t *conn, bulkOprInp_t *bulkOprInp,
         bulkOprInfo->forceFlagAdded = 0;
     }
     if ( status >= 0 ) {
-        if ( rodsArgs->verbose == True ) {
-            printf( "Bulk upload %d files.\n", bulkOprInfo->count );
-            ( void ) gettimeofday( &endTime, ( struct timezone * )0 );
-            printTiming( conn, bulkOprInfo->cachedTargPath,
-                         bulkOprInfo->size, bulkOprInfo->cachedTargPath,
-                         &startTime, &endTime );
-        }
-        if ( gGuiProgressCB != NULL ) {
-            rstrcpy( conn->operProgress.curFileName,
-                     bulkOprInfo->cachedTargPath, MAX_NAME_LEN );
-            conn->operProgress.totalNumFilesDone +=  bulkOprInfo->count;
-            conn->operProgress.totalFileSizeDone += bulkOprInfo->size;
-            gGuiProgressCB( &conn->operProgress );
-        }
+        reportBulkPut( conn, bulkOprInfo->count, bulkOprInfo->size,
+                       bulkOprInfo->cachedTargPath, rodsArgs, &startTime );
     }
 
     return status;
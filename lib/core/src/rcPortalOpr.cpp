@@ -12,11 +12,14 @@
 #include "rodsLog.h"
 #include "rcGlobalExtern.h"
 #include "sockComm.h"
+#include "get_file_descriptor_info.h"
+#include "replica_close.h"
 
 // =-=-=-=-=-=-=-
 #include "irods_stacktrace.hpp"
 #include "irods_buffer_encryption.hpp"
 #include "irods_client_server_negotiation.hpp"
+#include "connection_pool.hpp"
 
 #include <openssl/md5.h>
 
@@ -28,6 +31,13 @@
 #include <fstream>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/convenience.hpp>
+#include "json.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
 using namespace boost::filesystem;
 
 
@@ -96,7 +106,7 @@ fillBBufWithFile( rcComm_t *conn, bytesBuf_t *myBBuf, char *locFilePath,
 
     rodsEnv rods_env;
     if ( int status = getRodsEnv( &rods_env ) ) {
-        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %s", __FUNCTION__, status );
+        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %d", __FUNCTION__, status );
         return status;
     }
     int single_buff_sz = rods_env.irodsMaxSizeForSingleBuffer * 1024 * 1024;
@@ -115,7 +125,7 @@ fillBBufWithFile( rcComm_t *conn, bytesBuf_t *myBBuf, char *locFilePath,
     if ( in_fd < 0 ) { /* error */
         status = UNIX_FILE_OPEN_ERR - errno;
         rodsLogError( LOG_ERROR, status,
-                      "cannot open file %s", locFilePath, status );
+                      "cannot open file %s", locFilePath );
         return status;
     }
 
@@ -524,6 +534,489 @@ rcPartialDataPut( rcPortalTransferInp_t *myInput ) {
     mySockClose( destFd );
 }
 
+namespace
+{
+    // A resumed transfer uses at least restart_min_streams streams even if the interrupted
+    // transfer was single-threaded, and never more than restart_max_streams.
+    constexpr int restart_min_streams = 4;
+    constexpr int restart_max_streams = 16;
+
+    // The smallest range worth a stream of its own when a file is transferred in streams.
+    constexpr rodsLong_t min_stream_size = 32 * 1024 * 1024;
+
+    // A byte range of a file transferred in streams. When the transfer is restartable,
+    // progress on the range is credited to "dataSegLen", the length of the segment that
+    // ends where the range begins. A range must therefore be copied in order by a single
+    // stream.
+    struct transfer_range
+    {
+        rodsLong_t offset;
+        rodsLong_t len;
+        rodsLong_t *dataSegLen;
+    };
+
+    // The state shared by the streams of a transfer.
+    struct stream_progress
+    {
+        const char *fileName;
+        const char *objPath;
+        const char *infoFile;
+        fileRestartInfo_t *info;    // NULL if the transfer is not restartable
+        boost::mutex mutex;
+        rodsLong_t writtenSinceUpdated = 0;
+        rodsLong_t totalWritten = 0;
+        int status = 0;
+
+        // Credits "len" bytes to a segment and rewrites the restart file every
+        // RESTART_FILE_UPDATE_SIZE bytes.
+        int advance( rodsLong_t *dataSegLen, rodsLong_t len ) {
+            boost::mutex::scoped_lock lock( mutex );
+            totalWritten += len;
+            if ( info == NULL ) {
+                return 0;
+            }
+            *dataSegLen += len;
+            writtenSinceUpdated += len;
+            if ( writtenSinceUpdated < RESTART_FILE_UPDATE_SIZE ) {
+                return 0;
+            }
+            writtenSinceUpdated = 0;
+            int status = writeLfRestartFile( ( char * ) infoFile, info );
+            if ( status < 0 ) {
+                rodsLog( LOG_ERROR,
+                         "stream_progress: writeLfRestartFile for %s, status = %d",
+                         fileName, status );
+            }
+            return status;
+        }
+
+        void fail( int _status ) {
+            boost::mutex::scoped_lock lock( mutex );
+            if ( status == 0 ) {
+                status = _status;
+            }
+        }
+
+        bool failed() {
+            boost::mutex::scoped_lock lock( mutex );
+            return status < 0;
+        }
+    };
+
+    // Connections for additional streams come from a pool that lives as long as the
+    // process, so transfers of many files do not pay for connection setup and TCP slow
+    // start every time. The pool is replaced by a larger one when a transfer is granted
+    // more streams than it holds. A transfer that finds the pool in use gets a pool of
+    // its own.
+    struct stream_connections
+    {
+        boost::unique_lock<boost::mutex> lock;
+        std::shared_ptr<irods::connection_pool> pool;
+        int size;
+    };
+
+    stream_connections
+    acquireStreamConnections( int count ) {
+        static boost::mutex mutex;
+        boost::unique_lock<boost::mutex> lock( mutex, boost::try_to_lock );
+        if ( !lock.owns_lock() ) {
+            return { std::move( lock ), irods::make_connection_pool( count ), count };
+        }
+        // initialized after the first connection so it is destroyed before the
+        // network plugins are
+        static std::shared_ptr<irods::connection_pool> pool;
+        static int size = 0;
+        if ( count > size ) {
+            pool.reset();
+            pool = irods::make_connection_pool( count );
+            size = count;
+        }
+        return { std::move( lock ), pool, size };
+    }
+
+    // Adds empty segments to the restart info so that the missing data is split into
+    // enough ranges to keep "streams" streams busy. The restart info remains a sorted
+    // list of completed segments, so older clients can still resume from it.
+    void
+    splitRestartSegments( fileRestartInfo_t *info, int streams ) {
+        // Every range must follow a segment for its progress to be recorded.
+        if ( info->numSeg < MAX_NUM_CONFIG_TRAN_THR &&
+                ( info->numSeg == 0 || info->dataSeg[0].offset > 0 ) ) {
+            memmove( &info->dataSeg[1], &info->dataSeg[0], info->numSeg * sizeof( dataSeg_t ) );
+            info->dataSeg[0].offset = 0;
+            info->dataSeg[0].len = 0;
+            info->numSeg++;
+        }
+
+        while ( info->numSeg < MAX_NUM_CONFIG_TRAN_THR ) {
+            int numRanges = 0, largest = -1;
+            rodsLong_t largestLen = 0;
+            for ( int i = 0; i < info->numSeg; i++ ) {
+                rodsLong_t end = info->dataSeg[i].offset + info->dataSeg[i].len;
+                rodsLong_t next = i + 1 < info->numSeg ? info->dataSeg[i + 1].offset : info->fileSize;
+                if ( next > end ) {
+                    numRanges++;
+                    if ( next - end > largestLen ) {
+                        largestLen = next - end;
+                        largest = i;
+                    }
+                }
+            }
+            if ( numRanges >= streams || largestLen < 2 * MIN_RESTART_SIZE ) {
+                break;
+            }
+            dataSeg_t *seg = &info->dataSeg[largest + 1];
+            memmove( seg + 1, seg, ( info->numSeg - largest - 1 ) * sizeof( dataSeg_t ) );
+            seg->offset = info->dataSeg[largest].offset + info->dataSeg[largest].len + largestLen / 2;
+            seg->len = 0;
+            info->numSeg++;
+        }
+    }
+
+    std::vector<transfer_range>
+    missingRanges( fileRestartInfo_t *info ) {
+        std::vector<transfer_range> ranges;
+        for ( int i = 0; i < info->numSeg; i++ ) {
+            rodsLong_t end = info->dataSeg[i].offset + info->dataSeg[i].len;
+            rodsLong_t next = i + 1 < info->numSeg ? info->dataSeg[i + 1].offset : info->fileSize;
+            if ( next > end ) {
+                ranges.push_back( { end, next - end, &info->dataSeg[i].len } );
+            }
+        }
+        return ranges;
+    }
+
+    // Splits a file into "streams" ranges of nearly equal size, the way the server
+    // splits a portal transfer between its threads. If the transfer is restartable,
+    // range i is recorded as segment i.
+    std::vector<transfer_range>
+    splitFile( rodsLong_t dataSize, int streams, fileRestartInfo_t *info ) {
+        std::vector<transfer_range> ranges;
+        const rodsLong_t size0 = dataSize / streams;
+        for ( int i = 0; i < streams; i++ ) {
+            const rodsLong_t offset = size0 * i;
+            const rodsLong_t len = i < streams - 1 ? size0 : dataSize - offset;
+            rodsLong_t *dataSegLen = NULL;
+            if ( info != NULL ) {
+                info->dataSeg[i].offset = offset;
+                info->dataSeg[i].len = 0;
+                dataSegLen = &info->dataSeg[i].len;
+            }
+            ranges.push_back( { offset, len, dataSegLen } );
+        }
+        return ranges;
+    }
+
+    int
+    seekDataObj( rcComm_t *conn, int irodsFd, rodsLong_t offset, const char *objPath ) {
+        openedDataObjInp_t dataObjLseekInp;
+        fileLseekOut_t *dataObjLseekOut = NULL;
+
+        memset( &dataObjLseekInp, 0, sizeof( dataObjLseekInp ) );
+        dataObjLseekInp.l1descInx = irodsFd;
+        dataObjLseekInp.offset = offset;
+        dataObjLseekInp.whence = SEEK_SET;
+        int status = rcDataObjLseek( conn, &dataObjLseekInp, &dataObjLseekOut );
+        if ( status < 0 ) {
+            rodsLogError( LOG_ERROR, status,
+                          "seekDataObj: rcDataObjLseek to %lld error for %s",
+                          offset, objPath );
+        }
+        free( dataObjLseekOut );
+        return status;
+    }
+
+    int
+    putRange( rcComm_t *conn, int irodsFd, int localFd, const transfer_range& range,
+              int bufLen, stream_progress& progress ) {
+        int status = seekDataObj( conn, irodsFd, range.offset, progress.objPath );
+        if ( status < 0 ) {
+            return status;
+        }
+
+        bytesBuf_t dataObjWriteInpBBuf;
+        dataObjWriteInpBBuf.buf = malloc( bufLen );
+        openedDataObjInp_t dataObjWriteInp;
+        memset( &dataObjWriteInp, 0, sizeof( dataObjWriteInp ) );
+        dataObjWriteInp.l1descInx = irodsFd;
+
+        rodsLong_t offset = range.offset;
+        rodsLong_t gap = range.len;
+        while ( gap > 0 && !progress.failed() ) {
+            int toRead = gap > bufLen ? bufLen : ( int ) gap;
+            ssize_t bytesRead = pread( localFd, dataObjWriteInpBBuf.buf, toRead, offset );
+            if ( bytesRead != toRead ) {
+                status = bytesRead < 0 ? UNIX_FILE_READ_ERR - errno : SYS_COPY_LEN_ERR;
+                rodsLogError( LOG_ERROR, status,
+                              "putRange: read at %lld error for %s",
+                              offset, progress.fileName );
+                break;
+            }
+            dataObjWriteInp.len = dataObjWriteInpBBuf.len = toRead;
+            int bytesWritten = rcDataObjWrite( conn, &dataObjWriteInp, &dataObjWriteInpBBuf );
+            if ( bytesWritten < toRead ) {
+                rodsLog( LOG_ERROR,
+                         "putRange: Read %d bytes, Wrote %d bytes.\n ",
+                         toRead, bytesWritten );
+                status = SYS_COPY_LEN_ERR;
+                break;
+            }
+            offset += toRead;
+            gap -= toRead;
+            status = progress.advance( range.dataSegLen, toRead );
+            if ( status < 0 ) {
+                break;
+            }
+        }
+        free( dataObjWriteInpBBuf.buf );
+        return status;
+    }
+
+    int
+    getRange( rcComm_t *conn, int irodsFd, int localFd, const transfer_range& range,
+              int bufLen, stream_progress& progress ) {
+        int status = seekDataObj( conn, irodsFd, range.offset, progress.objPath );
+        if ( status < 0 ) {
+            return status;
+        }
+
+        bytesBuf_t dataObjReadInpBBuf;
+        dataObjReadInpBBuf.buf = malloc( bufLen );
+        openedDataObjInp_t dataObjReadInp;
+        memset( &dataObjReadInp, 0, sizeof( dataObjReadInp ) );
+        dataObjReadInp.l1descInx = irodsFd;
+
+        rodsLong_t offset = range.offset;
+        rodsLong_t gap = range.len;
+        while ( gap > 0 && !progress.failed() ) {
+            int toRead = gap > bufLen ? bufLen : ( int ) gap;
+            dataObjReadInp.len = dataObjReadInpBBuf.len = toRead;
+            int bytesRead = rcDataObjRead( conn, &dataObjReadInp, &dataObjReadInpBBuf );
+            if ( bytesRead < 0 ) {
+                rodsLog( LOG_ERROR,
+                         "getRange: rcDataObjRead error. status = %d", bytesRead );
+                status = bytesRead;
+                break;
+            }
+            else if ( bytesRead == 0 ) {
+                rodsLog( LOG_ERROR,
+                         "getRange: rcDataObjRead error. EOF reached. toRead = %d", toRead );
+                status = SYS_COPY_LEN_ERR;
+                break;
+            }
+            ssize_t bytesWritten = pwrite( localFd, dataObjReadInpBBuf.buf, bytesRead, offset );
+            if ( bytesWritten != bytesRead ) {
+                status = bytesWritten < 0 ? UNIX_FILE_WRITE_ERR - errno : SYS_COPY_LEN_ERR;
+                rodsLogError( LOG_ERROR, status,
+                              "getRange: write at %lld error for %s",
+                              offset, progress.fileName );
+                break;
+            }
+            offset += bytesRead;
+            gap -= bytesRead;
+            status = progress.advance( range.dataSegLen, bytesRead );
+            if ( status < 0 ) {
+                break;
+            }
+        }
+        free( dataObjReadInpBBuf.buf );
+        return status;
+    }
+
+    // Copies "ranges" on "conn" and on up to "streams - 1" additional connections, each
+    // stream taking the next range that has not been started. "openStream" opens the data
+    // object on an additional connection and "closeStream" closes it. If no additional
+    // connection can be made, every range is copied on "conn".
+    template <typename OpenFn, typename CloseFn, typename CopyFn>
+    int
+    runStreams( rcComm_t *conn, int irodsFd, const std::vector<transfer_range>& ranges,
+                int streams, stream_progress& progress,
+                OpenFn openStream, CloseFn closeStream, CopyFn copyRange ) {
+        std::atomic<std::size_t> nextRange{0};
+        const auto stream = [&]( rcComm_t *streamConn, int streamFd ) {
+            for ( auto i = nextRange++; i < ranges.size() && !progress.failed(); i = nextRange++ ) {
+                int status = copyRange( streamConn, streamFd, ranges[i] );
+                if ( status < 0 ) {
+                    progress.fail( status );
+                }
+            }
+        };
+
+        int extraStreams = std::min<int>( streams, ranges.size() ) - 1;
+        stream_connections connections;
+        if ( extraStreams > 0 ) {
+            try {
+                connections = acquireStreamConnections( extraStreams );
+                extraStreams = std::min( extraStreams, connections.size );
+            }
+            catch ( const std::exception& e ) {
+                rodsLog( LOG_NOTICE,
+                         "runStreams: transferring %s on a single stream: %s",
+                         progress.objPath, e.what() );
+                extraStreams = 0;
+            }
+        }
+
+        std::vector<irods::connection_pool::connection_proxy> streamConns;
+        std::vector<int> streamFds;
+        for ( int i = 0; i < extraStreams; i++ ) {
+            auto streamConn = connections.pool->get_connection();
+            int streamFd = openStream( static_cast<rcComm_t*>( streamConn ) );
+            if ( streamFd < 0 ) {
+                break;
+            }
+            streamConns.push_back( std::move( streamConn ) );
+            streamFds.push_back( streamFd );
+        }
+
+        std::vector<boost::thread> threads;
+        for ( std::size_t i = 0; i < streamConns.size(); i++ ) {
+            threads.emplace_back( stream, static_cast<rcComm_t*>( streamConns[i] ), streamFds[i] );
+        }
+        stream( conn, irodsFd );
+        for ( auto& t : threads ) {
+            t.join();
+        }
+
+        for ( std::size_t i = 0; i < streamConns.size(); i++ ) {
+            closeStream( static_cast<rcComm_t*>( streamConns[i] ), streamFds[i] );
+        }
+
+        // Record the progress made since the last update so the next attempt
+        // does not resend it.
+        if ( progress.status < 0 && progress.info != NULL ) {
+            writeLfRestartFile( ( char * ) progress.infoFile, progress.info );
+        }
+
+        return progress.status;
+    }
+
+    // What the server reports about an open data object: the replica being read or
+    // written, and the number of streams it allows for the transfer.
+    struct open_replica
+    {
+        std::string token;
+        std::string replNum;
+        std::string rescHier;
+        int streams = 1;
+    };
+
+    // Fetches the replica and stream count of an open data object so that additional
+    // streams use the same replica. Servers which do not decide the stream count allow
+    // a single stream.
+    bool
+    getOpenReplica( rcComm_t *conn, int irodsFd, open_replica& replica ) {
+        const auto input = nlohmann::json{{"fd", irodsFd}}.dump();
+        char *output = NULL;
+        int status = rc_get_file_descriptor_info( conn, input.c_str(), &output );
+        if ( status < 0 ) {
+            rodsLogError( LOG_NOTICE, status,
+                          "getOpenReplica: rc_get_file_descriptor_info failed" );
+            return false;
+        }
+
+        bool found = true;
+        try {
+            const auto info = nlohmann::json::parse( output );
+            const auto& dataObjInfo = info.at( "data_object_info" );
+            replica.token = info.at( "replica_token" ).get<std::string>();
+            replica.replNum = std::to_string( dataObjInfo.at( "replica_number" ).get<int>() );
+            replica.rescHier = dataObjInfo.at( "resource_hierarchy" ).get<std::string>();
+            replica.streams = std::max( 1, info.at( "data_object_input" ).at( "number_of_threads" ).get<int>() );
+        }
+        catch ( const nlohmann::json::exception& e ) {
+            rodsLog( LOG_NOTICE, "getOpenReplica: cannot read replica information: %s", e.what() );
+            found = false;
+        }
+        free( output );
+        return found;
+    }
+
+    // Opens the replica written through "replicaToken" for another stream.
+    int
+    openWriteStream( rcComm_t *streamConn, const char *objPath,
+                     const std::string& replicaToken, const std::string& replNum ) {
+        dataObjInp_t streamOpenInp;
+        bzero( &streamOpenInp, sizeof( streamOpenInp ) );
+        rstrcpy( streamOpenInp.objPath, objPath, MAX_NAME_LEN );
+        streamOpenInp.openFlags = O_WRONLY;
+        addKeyVal( &streamOpenInp.condInput, REPLICA_TOKEN_KW, replicaToken.c_str() );
+        addKeyVal( &streamOpenInp.condInput, REPL_NUM_KW, replNum.c_str() );
+        int streamFd = rcDataObjOpen( streamConn, &streamOpenInp );
+        clearKeyVal( &streamOpenInp.condInput );
+        if ( streamFd < 0 ) {
+            rodsLogError( LOG_NOTICE, streamFd,
+                          "openWriteStream: cannot open another stream to %s", objPath );
+        }
+        return streamFd;
+    }
+
+    // Only the open that created the stream finalizes the replica.
+    void
+    closeWriteStream( rcComm_t *streamConn, int streamFd ) {
+        const auto input = nlohmann::json{
+            {"fd", streamFd},
+            {"update_size", false},
+            {"update_status", false},
+            {"compute_checksum", false},
+            {"send_notifications", false}
+        }.dump();
+        rc_replica_close( streamConn, input.c_str() );
+    }
+
+    // Opens the replica read by the first stream for another stream.
+    int
+    openReadStream( rcComm_t *streamConn, const char *objPath, const open_replica& replica ) {
+        dataObjInp_t streamOpenInp;
+        bzero( &streamOpenInp, sizeof( streamOpenInp ) );
+        rstrcpy( streamOpenInp.objPath, objPath, MAX_NAME_LEN );
+        streamOpenInp.openFlags = O_RDONLY;
+        addKeyVal( &streamOpenInp.condInput, REPL_NUM_KW, replica.replNum.c_str() );
+        addKeyVal( &streamOpenInp.condInput, RESC_HIER_STR_KW, replica.rescHier.c_str() );
+        int streamFd = rcDataObjOpen( streamConn, &streamOpenInp );
+        clearKeyVal( &streamOpenInp.condInput );
+        if ( streamFd < 0 ) {
+            rodsLogError( LOG_NOTICE, streamFd,
+                          "openReadStream: cannot open another stream to %s", objPath );
+        }
+        return streamFd;
+    }
+
+    void
+    closeReadStream( rcComm_t *streamConn, int streamFd ) {
+        openedDataObjInp_t streamCloseInp;
+        memset( &streamCloseInp, 0, sizeof( streamCloseInp ) );
+        streamCloseInp.l1descInx = streamFd;
+        rcDataObjClose( streamConn, &streamCloseInp );
+    }
+
+    int
+    restartStreams( const fileRestartInfo_t *info ) {
+        return std::max( restart_min_streams, std::min( info->numSeg, restart_max_streams ) );
+    }
+
+    // Asks the server to decide how many streams a transfer opened with "dataObjInp"
+    // may use, at most "streams". The answer is read back with getOpenReplica.
+    void
+    requestStreams( dataObjInp_t *dataObjInp, int streams ) {
+        dataObjInp->numThreads = NO_THREADING;
+        addKeyVal( &dataObjInp->condInput, MAIN_PORT_STREAMS_KW, std::to_string( streams ).c_str() );
+    }
+
+    // The number of streams worth using for a file of "dataSize" bytes.
+    int
+    usefulStreams( rodsLong_t dataSize, int numStreams ) {
+        rodsLong_t streams = dataSize / min_stream_size;
+        if ( streams > numStreams ) {
+            streams = numStreams;
+        }
+        if ( streams > MAX_NUM_CONFIG_TRAN_THR ) {
+            streams = MAX_NUM_CONFIG_TRAN_THR;
+        }
+        return streams < 1 ? 1 : ( int ) streams;
+    }
+} // anonymous namespace
+
 int
 putFile( rcComm_t *conn, int l1descInx, char *locFilePath, char *objPath,
          rodsLong_t dataSize ) {
@@ -546,13 +1039,13 @@ putFile( rcComm_t *conn, int l1descInx, char *locFilePath, char *objPath,
     if ( in_fd < 0 ) { /* error */
         status = UNIX_FILE_OPEN_ERR - errno;
         rodsLogError( LOG_ERROR, status,
-                      "cannot open file %s", locFilePath, status );
+                      "cannot open file %s", locFilePath );
         return status;
     }
 
     rodsEnv rods_env;
     if ( int status = getRodsEnv( &rods_env ) ) {
-        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %s", __FUNCTION__, status );
+        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %d", __FUNCTION__, status );
         return status;
     }
     size_t trans_buff_sz = rods_env.irodsTransBufferSizeForParaTrans * 1024 * 1024;
@@ -658,7 +1151,7 @@ getIncludeFile( rcComm_t *conn, bytesBuf_t *dataObjOutBBuf, char *locFilePath )
         if ( out_fd < 0 ) { /* error */
             status = UNIX_FILE_OPEN_ERR - errno;
             rodsLogError( LOG_ERROR, status,
-                          "cannot open file %s", locFilePath, status );
+                          "cannot open file %s", locFilePath );
             return status;
         }
 
@@ -711,13 +1204,13 @@ getFile( rcComm_t *conn, int l1descInx, char *locFilePath, char *objPath,
     if ( out_fd < 0 ) { /* error */
         status = UNIX_FILE_OPEN_ERR - errno;
         rodsLogError( LOG_ERROR, status,
-                      "cannot open file %s", locFilePath, status );
+                      "cannot open file %s", locFilePath );
         return status;
     }
 
     rodsEnv rods_env;
     if ( int status = getRodsEnv( &rods_env ) ) {
-        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %s", __FUNCTION__, status );
+        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %d", __FUNCTION__, status );
         return status;
     }
     size_t trans_buff_sz = rods_env.irodsTransBufferSizeForParaTrans * 1024 * 1024;
@@ -829,6 +1322,157 @@ getFile( rcComm_t *conn, int l1descInx, char *locFilePath, char *objPath,
     }
 }
 
+int
+getMainPortStreams( dataObjInp_t *dataObjInp ) {
+    rodsEnv rods_env;
+    if ( getRodsEnv( &rods_env ) < 0 ||
+            strcmp( rods_env.irodsParallelTransferMode, PARALLEL_TRANSFER_MODE_MAIN_PORT ) != 0 ) {
+        return 0;
+    }
+    if ( dataObjInp->numThreads == NO_THREADING ||
+            getValByKey( &dataObjInp->condInput, RBUDP_TRANSFER_KW ) != NULL ) {
+        return 0;
+    }
+    return dataObjInp->numThreads > 0 ?
+           dataObjInp->numThreads : rods_env.irodsDefaultNumberTransferThreads;
+}
+
+int
+putFileToStreams( rcComm_t *conn, int l1descInx, char *locFilePath, char *objPath,
+                  rodsLong_t dataSize, int numStreams ) {
+    /* the additional streams write to the replica opened by the server
+     * for this put by presenting its replica token */
+    open_replica replica;
+    if ( usefulStreams( dataSize, numStreams ) <= 1 || !getOpenReplica( conn, l1descInx, replica ) ) {
+        return putFile( conn, l1descInx, locFilePath, objPath, dataSize );
+    }
+    const int streams = usefulStreams( dataSize, std::min( numStreams, replica.streams ) );
+    if ( streams <= 1 ) {
+        return putFile( conn, l1descInx, locFilePath, objPath, dataSize );
+    }
+
+    int in_fd = open( locFilePath, O_RDONLY, 0 );
+    if ( in_fd < 0 ) { /* error */
+        int status = UNIX_FILE_OPEN_ERR - errno;
+        rodsLogError( LOG_ERROR, status,
+                      "cannot open file %s", locFilePath );
+        return status;
+    }
+
+    rodsEnv rods_env;
+    if ( int status = getRodsEnv( &rods_env ) ) {
+        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %d", __FUNCTION__, status );
+        close( in_fd );
+        return status;
+    }
+    size_t trans_buff_sz = rods_env.irodsTransBufferSizeForParaTrans * 1024 * 1024;
+
+    initFileRestart( conn, locFilePath, objPath, dataSize, streams );
+    fileRestartInfo_t *info = conn->fileRestart.info.numSeg > 0 ? &conn->fileRestart.info : NULL;
+    const auto ranges = splitFile( dataSize, streams, info );
+    stream_progress progress{locFilePath, objPath, conn->fileRestart.infoFile, info};
+
+    if ( gGuiProgressCB != NULL ) {
+        conn->operProgress.flag = 1;
+    }
+    conn->transStat.numThreads = streams;
+
+    int status = runStreams( conn, l1descInx, ranges, streams, progress,
+    [&]( rcComm_t *streamConn ) {
+        return openWriteStream( streamConn, objPath, replica.token, replica.replNum );
+    },
+    closeWriteStream,
+    [&]( rcComm_t *streamConn, int streamFd, const transfer_range& range ) {
+        return putRange( streamConn, streamFd, in_fd, range, trans_buff_sz, progress );
+    } );
+
+    close( in_fd );
+    conn->transStat.bytesWritten = progress.totalWritten;
+
+    if ( status < 0 ) {
+        return status;
+    }
+    if ( progress.totalWritten != dataSize ) {
+        rodsLog( LOG_ERROR,
+                 "putFileToStreams: totalWritten %lld dataSize %lld mismatch",
+                 progress.totalWritten, dataSize );
+        return SYS_COPY_LEN_ERR;
+    }
+    if ( gGuiProgressCB != NULL ) {
+        conn->operProgress.curFileSizeDone = conn->operProgress.curFileSize;
+        gGuiProgressCB( &conn->operProgress );
+    }
+    return 0;
+}
+
+int
+getFileFromStreams( rcComm_t *conn, int l1descInx, char *locFilePath, char *objPath,
+                    rodsLong_t dataSize, int numStreams ) {
+    /* the additional streams read the replica opened by the server for this get */
+    open_replica replica;
+    if ( usefulStreams( dataSize, numStreams ) <= 1 || strcmp( locFilePath, STDOUT_FILE_NAME ) == 0 ||
+            !getOpenReplica( conn, l1descInx, replica ) ) {
+        return getFile( conn, l1descInx, locFilePath, objPath, dataSize );
+    }
+    const int streams = usefulStreams( dataSize, std::min( numStreams, replica.streams ) );
+    if ( streams <= 1 ) {
+        return getFile( conn, l1descInx, locFilePath, objPath, dataSize );
+    }
+
+    int out_fd = open( locFilePath, O_WRONLY | O_CREAT | O_TRUNC, 0640 );
+    if ( out_fd < 0 ) { /* error */
+        int status = UNIX_FILE_OPEN_ERR - errno;
+        rodsLogError( LOG_ERROR, status,
+                      "cannot open file %s", locFilePath );
+        return status;
+    }
+
+    rodsEnv rods_env;
+    if ( int status = getRodsEnv( &rods_env ) ) {
+        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %d", __FUNCTION__, status );
+        close( out_fd );
+        return status;
+    }
+    size_t trans_buff_sz = rods_env.irodsTransBufferSizeForParaTrans * 1024 * 1024;
+
+    initFileRestart( conn, locFilePath, objPath, dataSize, streams );
+    fileRestartInfo_t *info = conn->fileRestart.info.numSeg > 0 ? &conn->fileRestart.info : NULL;
+    const auto ranges = splitFile( dataSize, streams, info );
+    stream_progress progress{locFilePath, objPath, conn->fileRestart.infoFile, info};
+
+    if ( gGuiProgressCB != NULL ) {
+        conn->operProgress.flag = 1;
+    }
+    conn->transStat.numThreads = streams;
+
+    int status = runStreams( conn, l1descInx, ranges, streams, progress,
+    [&]( rcComm_t *streamConn ) {
+        return openReadStream( streamConn, objPath, replica );
+    },
+    closeReadStream,
+    [&]( rcComm_t *streamConn, int streamFd, const transfer_range& range ) {
+        return getRange( streamConn, streamFd, out_fd, range, trans_buff_sz, progress );
+    } );
+
+    close( out_fd );
+    conn->transStat.bytesWritten = progress.totalWritten;
+
+    if ( status < 0 ) {
+        return status;
+    }
+    if ( progress.totalWritten != dataSize ) {
+        rodsLog( LOG_ERROR,
+                 "getFileFromStreams: totalWritten %lld dataSize %lld mismatch",
+                 progress.totalWritten, dataSize );
+        return SYS_COPY_LEN_ERR;
+    }
+    if ( gGuiProgressCB != NULL ) {
+        conn->operProgress.curFileSizeDone = conn->operProgress.curFileSize;
+        gGuiProgressCB( &conn->operProgress );
+    }
+    return 0;
+}
+
 int
 getFileFromPortal( rcComm_t *conn, portalOprOut_t *portalOprOut,
                    char *locFilePath, char *objPath, rodsLong_t dataSize ) {
@@ -1541,17 +2185,10 @@ clearLfRestartFile( fileRestart_t *fileRestart ) {
 
 int
 lfRestartPutWithInfo( rcComm_t *conn, fileRestartInfo_t *info ) {
-    rodsLong_t curOffset = 0;
-    bytesBuf_t dataObjWriteInpBBuf;
-    int status = 0, i = 0;
+    int status = 0;
     int localFd = 0, irodsFd = 0;
     dataObjInp_t dataObjOpenInp;
-    openedDataObjInp_t dataObjWriteInp;
-    openedDataObjInp_t dataObjLseekInp;
     openedDataObjInp_t dataObjCloseInp;
-    fileLseekOut_t *dataObjLseekOut = NULL;
-    int writtenSinceUpdated = 0;
-    rodsLong_t gap;
 
 #ifdef windows_platform
     localFd = iRODSNt_bopen( info->fileName, O_RDONLY, 0 );
@@ -1561,16 +2198,19 @@ lfRestartPutWithInfo( rcComm_t *conn, fileRestartInfo_t *info ) {
     if ( localFd < 0 ) { /* error */
         status = UNIX_FILE_OPEN_ERR - errno;
         rodsLogError( LOG_ERROR, status,
-                      "cannot open file %s", info->fileName, status );
+                      "cannot open file %s", info->fileName );
         return status;
     }
 
     bzero( &dataObjOpenInp, sizeof( dataObjOpenInp ) );
     rstrcpy( dataObjOpenInp.objPath, info->objPath, MAX_NAME_LEN );
     dataObjOpenInp.openFlags = O_WRONLY;
+    dataObjOpenInp.dataSize = info->fileSize;
     addKeyVal( &dataObjOpenInp.condInput, FORCE_FLAG_KW, "" );
+    requestStreams( &dataObjOpenInp, restartStreams( info ) );
 
     irodsFd = rcDataObjOpen( conn, &dataObjOpenInp );
+    clearKeyVal( &dataObjOpenInp.condInput );
     if ( irodsFd < 0 ) { /* error */
         rodsLogError( LOG_ERROR, irodsFd,
                       "cannot open target file %s, status = %d", info->objPath, irodsFd );
@@ -1580,76 +2220,32 @@ lfRestartPutWithInfo( rcComm_t *conn, fileRestartInfo_t *info ) {
 
     rodsEnv rods_env;
     if ( int status = getRodsEnv( &rods_env ) ) {
-        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %s", __FUNCTION__, status );
+        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %d", __FUNCTION__, status );
         return status;
     }
     size_t trans_buff_sz = rods_env.irodsTransBufferSizeForParaTrans * 1024 * 1024;
 
-    bzero( &dataObjWriteInp, sizeof( dataObjWriteInp ) );
-    dataObjWriteInpBBuf.buf = malloc( trans_buff_sz + 1 );
-    dataObjWriteInpBBuf.len = 0;
-    dataObjWriteInp.l1descInx = irodsFd;
-
-    memset( &dataObjLseekInp, 0, sizeof( dataObjLseekInp ) );
-    dataObjLseekInp.whence = SEEK_SET;
-    for ( i = 0; i < info->numSeg; i++ ) {
-        gap = info->dataSeg[i].offset - curOffset;
-        if ( gap < 0 ) {
-            /* should not be here */
-        }
-        else if ( gap > 0 ) {
-            rodsLong_t tmpLen, *lenToUpdate;
-            if ( i == 0 ) {
-                /* should not be here */
-                tmpLen = 0;
-                lenToUpdate = &tmpLen;
-            }
-            else {
-                lenToUpdate = &info->dataSeg[i - 1].len;
-            }
+    /* resume every missing range in parallel. The additional streams write to
+     * the replica opened above by presenting its replica token. */
+    splitRestartSegments( info, restartStreams( info ) );
+    const auto ranges = missingRanges( info );
+    stream_progress progress{info->fileName, info->objPath, conn->fileRestart.infoFile, info};
 
-            status = putSeg( conn, gap, localFd, &dataObjWriteInp,
-                             &dataObjWriteInpBBuf, trans_buff_sz, &writtenSinceUpdated,
-                             info, lenToUpdate );
-            if ( status < 0 ) {
-                break;
-            }
-            curOffset += gap;
-        }
-        if ( info->dataSeg[i].len > 0 ) {
-            curOffset += info->dataSeg[i].len;
-            if ( lseek( localFd, curOffset, SEEK_SET ) < 0 ) {
-                status = UNIX_FILE_LSEEK_ERR - errno;
-                rodsLogError( LOG_ERROR, status,
-                              "lfRestartWithInfo: lseek to %lld error for %s",
-                              curOffset, info->fileName );
-                break;
-            }
-            dataObjLseekInp.l1descInx = irodsFd;
-            dataObjLseekInp.offset = curOffset;
-            status = rcDataObjLseek( conn, &dataObjLseekInp, &dataObjLseekOut );
-            if ( status < 0 ) {
-                rodsLogError( LOG_ERROR, status,
-                              "lfRestartWithInfo: rcDataObjLseek to %lld error for %s",
-                              curOffset, info->objPath );
-                break;
-            }
-            else {
-                if ( dataObjLseekOut != NULL ) {
-                    free( dataObjLseekOut );
-                }
-            }
-        }
-    }
-    if ( status >= 0 ) {
-        gap = info->fileSize - curOffset;
-        if ( gap > 0 ) {
-            status = putSeg( conn, gap, localFd, &dataObjWriteInp,
-                             &dataObjWriteInpBBuf, trans_buff_sz,  &writtenSinceUpdated,
-                             info, &info->dataSeg[i - 1].len );
-        }
+    open_replica replica;
+    int streams = 1;
+    if ( ranges.size() > 1 && getOpenReplica( conn, irodsFd, replica ) ) {
+        streams = std::min( restartStreams( info ), replica.streams );
     }
-    free( dataObjWriteInpBBuf.buf );
+
+    status = runStreams( conn, irodsFd, ranges, streams, progress,
+    [&]( rcComm_t *streamConn ) {
+        return openWriteStream( streamConn, info->objPath, replica.token, replica.replNum );
+    },
+    closeWriteStream,
+    [&]( rcComm_t *streamConn, int streamFd, const transfer_range& range ) {
+        return putRange( streamConn, streamFd, localFd, range, trans_buff_sz, progress );
+    } );
+
     close( localFd );
     memset( &dataObjCloseInp, 0, sizeof( dataObjCloseInp ) );
     dataObjCloseInp.l1descInx = irodsFd;
@@ -1657,68 +2253,12 @@ lfRestartPutWithInfo( rcComm_t *conn, fileRestartInfo_t *info ) {
     return status;
 }
 
-int
-putSeg( rcComm_t *conn, rodsLong_t segSize, int localFd,
-        openedDataObjInp_t *dataObjWriteInp, bytesBuf_t *dataObjWriteInpBBuf,
-        int bufLen, int *writtenSinceUpdated, fileRestartInfo_t *info,
-        rodsLong_t *dataSegLen ) {
-    rodsLong_t gap = segSize;
-    int bytesWritten;
-    int status;
-
-    while ( gap > 0 ) {
-        int toRead;
-        if ( gap > bufLen ) {
-            toRead = bufLen;
-        }
-        else {
-            toRead = ( int ) gap;
-        }
-
-        dataObjWriteInpBBuf->len = myRead( localFd,
-                                           dataObjWriteInpBBuf->buf, toRead, NULL, NULL );
-        /* Write to the data object */
-        dataObjWriteInp->len = dataObjWriteInpBBuf->len;
-        bytesWritten = rcDataObjWrite( conn, dataObjWriteInp,
-                                       dataObjWriteInpBBuf );
-        if ( bytesWritten < dataObjWriteInp->len ) {
-            rodsLog( LOG_ERROR,
-                     "putFile: Read %d bytes, Wrote %d bytes.\n ",
-                     dataObjWriteInp->len, bytesWritten );
-            return SYS_COPY_LEN_ERR;
-        }
-        else {
-            gap -= toRead;
-            *writtenSinceUpdated += toRead;
-            *dataSegLen += toRead;
-            if ( *writtenSinceUpdated >= RESTART_FILE_UPDATE_SIZE ) {
-                status = writeLfRestartFile( conn->fileRestart.infoFile, info );
-                if ( status < 0 ) {
-                    rodsLog( LOG_ERROR,
-                             "putSeg: writeLfRestartFile for %s, status = %d",
-                             info->fileName, status );
-                    return status;
-                }
-                *writtenSinceUpdated = 0;
-            }
-        }
-    }
-    return 0;
-}
-
 int
 lfRestartGetWithInfo( rcComm_t *conn, fileRestartInfo_t *info ) {
-    rodsLong_t curOffset = 0;
-    bytesBuf_t dataObjReadInpBBuf;
-    int status = 0, i = 0;
+    int status = 0;
     int localFd = 0, irodsFd = 0;
     dataObjInp_t dataObjOpenInp;
-    openedDataObjInp_t dataObjReadInp;
-    openedDataObjInp_t dataObjLseekInp;
     openedDataObjInp_t dataObjCloseInp;
-    fileLseekOut_t *dataObjLseekOut = NULL;
-    int writtenSinceUpdated = 0;
-    rodsLong_t gap;
 
 #ifdef windows_platform
     localFd = iRODSNt_bopen( info->fileName, O_RDONLY, 0 );
@@ -1735,7 +2275,9 @@ lfRestartGetWithInfo( rcComm_t *conn, fileRestartInfo_t *info ) {
     bzero( &dataObjOpenInp, sizeof( dataObjOpenInp ) );
     rstrcpy( dataObjOpenInp.objPath, info->objPath, MAX_NAME_LEN );
     dataObjOpenInp.openFlags = O_RDONLY;
+    requestStreams( &dataObjOpenInp, restartStreams( info ) );
     irodsFd = rcDataObjOpen( conn, &dataObjOpenInp );
+    clearKeyVal( &dataObjOpenInp.condInput );
     if ( irodsFd < 0 ) { /* error */
         rodsLogError( LOG_ERROR, irodsFd,
                       "cannot open iRODS src file %s, status = %d", info->objPath, irodsFd );
@@ -1745,76 +2287,32 @@ lfRestartGetWithInfo( rcComm_t *conn, fileRestartInfo_t *info ) {
 
     rodsEnv rods_env;
     if ( int status = getRodsEnv( &rods_env ) ) {
-        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %s", __FUNCTION__, status );
+        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %d", __FUNCTION__, status );
         return status;
     }
     size_t trans_buff_sz = rods_env.irodsTransBufferSizeForParaTrans * 1024 * 1024;
 
-    bzero( &dataObjReadInp, sizeof( dataObjReadInp ) );
-    dataObjReadInpBBuf.buf = malloc( trans_buff_sz );
-    dataObjReadInpBBuf.len = 0;
-    dataObjReadInp.l1descInx = irodsFd;
-
-    memset( &dataObjLseekInp, 0, sizeof( dataObjLseekInp ) );
-    dataObjLseekInp.whence = SEEK_SET;
-    dataObjLseekInp.l1descInx = irodsFd;
+    /* resume every missing range in parallel, each stream reading the same
+     * replica through its own open of the data object */
+    splitRestartSegments( info, restartStreams( info ) );
+    const auto ranges = missingRanges( info );
+    stream_progress progress{info->fileName, info->objPath, conn->fileRestart.infoFile, info};
 
-    for ( i = 0; i < info->numSeg; i++ ) {
-        gap = info->dataSeg[i].offset - curOffset;
-        if ( gap < 0 ) {
-            /* should not be here */
-        }
-        else if ( gap > 0 ) {
-            rodsLong_t tmpLen, *lenToUpdate;
-            if ( i == 0 ) {
-                /* should not be here */
-                tmpLen = 0;
-                lenToUpdate = &tmpLen;
-            }
-            else {
-                lenToUpdate = &info->dataSeg[i - 1].len;
-            }
-            status = getSeg( conn, gap, localFd, &dataObjReadInp,
-                             &dataObjReadInpBBuf, trans_buff_sz, &writtenSinceUpdated,
-                             info, lenToUpdate );
-            if ( status < 0 ) {
-                break;
-            }
-            curOffset += gap;
-        }
-        if ( info->dataSeg[i].len > 0 ) {
-            curOffset += info->dataSeg[i].len;
-            if ( lseek( localFd, curOffset, SEEK_SET ) < 0 ) {
-                status = UNIX_FILE_LSEEK_ERR - errno;
-                rodsLogError( LOG_ERROR, status,
-                              "lfRestartWithInfo: lseek to %lld error for %s",
-                              curOffset, info->fileName );
-                break;
-            }
-            dataObjLseekInp.offset = curOffset;
-            status = rcDataObjLseek( conn, &dataObjLseekInp, &dataObjLseekOut );
-            if ( status < 0 ) {
-                rodsLogError( LOG_ERROR, status,
-                              "lfRestartWithInfo: rcDataObjLseek to %lld error for %s",
-                              curOffset, info->objPath );
-                break;
-            }
-            else {
-                if ( dataObjLseekOut != NULL ) {
-                    free( dataObjLseekOut );
-                }
-            }
-        }
-    }
-    if ( status >= 0 ) {
-        gap = info->fileSize - curOffset;
-        if ( gap > 0 ) {
-            status = getSeg( conn, gap, localFd, &dataObjReadInp,
-                             &dataObjReadInpBBuf, trans_buff_sz,  &writtenSinceUpdated,
-                             info, &info->dataSeg[i - 1].len );
-        }
+    open_replica replica;
+    int streams = 1;
+    if ( ranges.size() > 1 && getOpenReplica( conn, irodsFd, replica ) ) {
+        streams = std::min( restartStreams( info ), replica.streams );
     }
-    free( dataObjReadInpBBuf.buf );
+
+    status = runStreams( conn, irodsFd, ranges, streams, progress,
+    [&]( rcComm_t *streamConn ) {
+        return openReadStream( streamConn, info->objPath, replica );
+    },
+    closeReadStream,
+    [&]( rcComm_t *streamConn, int streamFd, const transfer_range& range ) {
+        return getRange( streamConn, streamFd, localFd, range, trans_buff_sz, progress );
+    } );
+
     close( localFd );
     memset( &dataObjCloseInp, 0, sizeof( dataObjCloseInp ) );
     dataObjCloseInp.l1descInx = irodsFd;
@@ -1822,66 +2320,6 @@ lfRestartGetWithInfo( rcComm_t *conn, fileRestartInfo_t *info ) {
     return status;
 }
 
-int
-getSeg( rcComm_t *conn, rodsLong_t segSize, int localFd,
-        openedDataObjInp_t *dataObjReadInp, bytesBuf_t *dataObjReadInpBBuf,
-        int bufLen, int *writtenSinceUpdated, fileRestartInfo_t *info,
-        rodsLong_t *dataSegLen ) {
-    rodsLong_t gap = segSize;
-    int bytesWritten,  bytesRead;
-    int status;
-
-    while ( gap > 0 ) {
-        int toRead;
-        if ( gap > bufLen ) {
-            toRead = bufLen;
-        }
-        else {
-            toRead = ( int ) gap;
-        }
-        dataObjReadInp->len = dataObjReadInpBBuf->len = toRead;
-        bytesRead = rcDataObjRead( conn, dataObjReadInp,
-                                   dataObjReadInpBBuf );
-
-        if ( bytesRead < 0 ) {
-            rodsLog( LOG_ERROR,
-                     "getSeg: rcDataObjRead error. status = %d", bytesRead );
-            return bytesRead;
-        }
-        else if ( bytesRead == 0 ) {
-            /* EOF */
-            rodsLog( LOG_ERROR,
-                     "getSeg: rcDataObjRead error. EOF reached. toRead = %d", toRead );
-            return SYS_COPY_LEN_ERR;
-        }
-        bytesWritten = myWrite( localFd, dataObjReadInpBBuf->buf,
-                                bytesRead, NULL );
-
-        if ( bytesWritten != bytesRead ) {
-            rodsLog( LOG_ERROR,
-                     "getSeg: Read %d bytes, Wrote %d bytes.\n ",
-                     bytesRead, bytesWritten );
-            return SYS_COPY_LEN_ERR;
-        }
-        else {
-            gap -= bytesWritten;
-            *writtenSinceUpdated += bytesWritten;
-            *dataSegLen += bytesWritten;
-            if ( *writtenSinceUpdated >= RESTART_FILE_UPDATE_SIZE ) {
-                status = writeLfRestartFile( conn->fileRestart.infoFile, info );
-                if ( status < 0 ) {
-                    rodsLog( LOG_ERROR,
-                             "getSeg: writeLfRestartFile for %s, status = %d",
-                             info->fileName, status );
-                    return status;
-                }
-                *writtenSinceUpdated = 0;
-            }
-        }
-    }
-    return 0;
-}
-
 int
 catDataObj( rcComm_t *conn, char *objPath ) {
     dataObjInp_t dataObjOpenInp;
@@ -1905,7 +2343,7 @@ catDataObj( rcComm_t *conn, char *objPath ) {
 
     rodsEnv rods_env;
     if ( int status = getRodsEnv( &rods_env ) ) {
-        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %s", __FUNCTION__, status );
+        rodsLog( LOG_ERROR, "getRodsEnv failed in %s with status %d", __FUNCTION__, status );
         return status;
     }
     size_t trans_buff_sz = rods_env.irodsTransBufferSizeForParaTrans * 1024 * 1024;
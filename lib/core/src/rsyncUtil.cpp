@@ -21,12 +21,492 @@
 #include "irods_hasher_factory.hpp"
 #include "irods_path_recursion.hpp"
 #include "irods_exception.hpp"
+#include "irods_query.hpp"
+#include "connection_pool.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 static int CurrentTime = 0;
 int
 ageExceeded( int ageLimit, int myTime, char *objPath,
              rodsLong_t fileSize );
 
+namespace
+{
+    // The catalog information of a data object under the remote collection.
+    struct remote_entry
+    {
+        std::string data_id;
+        rodsLong_t size{};
+        uint mode{};
+        std::string chksum;
+        int modify_time{};
+        bool good_replica{};
+    };
+
+    // The remote side of a recursive sync, keyed by logical path.
+    struct remote_manifest
+    {
+        std::unordered_set<std::string> collections;
+        std::unordered_map<std::string, remote_entry> data_objects;
+        bool has_special_collections{};
+    };
+
+    // A single file that may need to be synchronized. "remote" is null when
+    // the data object does not exist yet.
+    struct transfer
+    {
+        std::string src_path;
+        std::string targ_path;
+        rodsLong_t size{};
+        int create_mode{};
+        const remote_entry* remote{};
+    };
+
+    bool starts_with( const std::string& _s, const std::string& _prefix )
+    {
+        return _s.compare( 0, _prefix.size(), _prefix ) == 0;
+    }
+
+    // GenQuery cannot express a single quote within a condition. Such trees are
+    // left to the per-object engine.
+    bool is_manifest_path( const std::string& _p )
+    {
+        return !_p.empty() && _p != "/" && _p.find( '\'' ) == std::string::npos;
+    }
+
+    // Fetches every collection and data object under "_coll" (inclusive) with two
+    // queries. When a data object has several replicas, the size and checksum of
+    // a good replica are preferred.
+    int fetch_remote_manifest( rcComm_t* _conn, const std::string& _coll, remote_manifest& _manifest )
+    {
+        using query = irods::query<rcComm_t>;
+
+        char zone[NAME_LEN]{};
+        getZoneNameFromHint( _coll.c_str(), zone, sizeof( zone ) );
+
+        // The LIKE pattern may match collections outside of the tree (e.g. when the
+        // path contains an underscore), so every row is checked against the prefix.
+        const auto prefix = _coll + '/';
+        const auto cond = " where COLL_NAME = '" + _coll + "' || like '" + prefix + "%'";
+        const auto in_tree = [&_coll, &prefix]( const std::string& _p ) {
+            return _p == _coll || starts_with( _p, prefix );
+        };
+
+        try {
+            for ( auto&& row : query{_conn, "select COLL_NAME, COLL_TYPE" + cond, nullptr, zone, 0, 0, query::GENERAL} ) {
+                if ( in_tree( row[0] ) ) {
+                    _manifest.collections.insert( row[0] );
+                    // Mounted and linked collections are not described by the catalog.
+                    _manifest.has_special_collections |= !row[1].empty();
+                }
+            }
+
+            const auto gql = "select COLL_NAME, DATA_NAME, DATA_ID, DATA_SIZE, DATA_MODE, "
+                             "DATA_CHECKSUM, DATA_MODIFY_TIME, DATA_REPL_STATUS" + cond;
+
+            for ( auto&& row : query{_conn, gql, nullptr, zone, 0, 0, query::GENERAL} ) {
+                if ( !in_tree( row[0] ) ) {
+                    continue;
+                }
+
+                const bool good_replica = ( row[7] == "1" );
+                auto [iter, inserted] = _manifest.data_objects.try_emplace( row[0] + '/' + row[1] );
+
+                if ( !inserted && ( iter->second.good_replica || !good_replica ) ) {
+                    continue;
+                }
+
+                auto& e = iter->second;
+                e.data_id = row[2];
+                e.size = row[3].empty() ? 0 : std::stoll( row[3] );
+                e.mode = row[4].empty() ? 0 : std::stoul( row[4] );
+                e.chksum = row[5];
+                e.modify_time = row[6].empty() ? 0 : std::stoi( row[6] );
+                e.good_replica = good_replica;
+            }
+        }
+        catch ( const irods::exception& _e ) {
+            rodsLogError( LOG_ERROR, _e.code(),
+                          "fetch_remote_manifest: query failed for %s", _coll.c_str() );
+            return _e.code();
+        }
+
+        return 0;
+    }
+
+    // Runs "_sync" for every transfer on at most irods_rsync_transfer_workers threads
+    // (4 unless set in the client environment). Each worker uses its own connection and
+    // takes transfers from a shared index so that a few large files do not hold up the
+    // rest. With a single worker, or if the additional connections cannot be established,
+    // the transfers are run one after another over "_conn".
+    template <typename Function>
+    int run_transfers( rcComm_t* _conn, const std::vector<transfer>& _transfers,
+                       const char* _caller, Function _sync )
+    {
+        std::atomic<std::size_t> next{0};
+        std::atomic<int> savedStatus{0};
+
+        const auto run = [&]( rcComm_t& _worker_conn ) {
+            for ( auto i = next++; i < _transfers.size(); i = next++ ) {
+                const auto& t = _transfers[i];
+                int status = 0;
+
+                try {
+                    status = _sync( _worker_conn, t );
+                }
+                catch ( const std::exception& _e ) {
+                    rodsLog( LOG_ERROR, "%s: %s", _caller, _e.what() );
+                    status = SYS_INTERNAL_ERR;
+                }
+
+                if ( status < 0 &&
+                        status != CAT_NO_ROWS_FOUND &&
+                        status != SYS_SPEC_COLL_OBJ_NOT_EXIST ) {
+                    rodsLogError( LOG_ERROR, status,
+                                  "%s: rsync of %s failed. status = %d",
+                                  _caller, t.src_path.c_str(), status );
+                    savedStatus = status;
+                }
+            }
+        };
+
+        rodsEnv env;
+        getRodsEnv( &env );
+
+        const auto worker_count = static_cast<int>(
+            std::min<std::size_t>( std::max( env.irodsRsyncTransferWorkers, 1 ), _transfers.size() ) );
+
+        std::shared_ptr<irods::connection_pool> conn_pool;
+
+        if ( worker_count > 1 ) {
+            try {
+                conn_pool = irods::make_connection_pool( worker_count );
+            }
+            catch ( const std::exception& _e ) {
+                rodsLog( LOG_NOTICE,
+                         "%s: could not open %d connections [%s]. Transferring sequentially.",
+                         _caller, worker_count, _e.what() );
+            }
+        }
+
+        if ( !conn_pool ) {
+            run( *_conn );
+            return savedStatus;
+        }
+
+        irods::thread_pool workers{worker_count};
+
+        for ( int i = 0; i < worker_count; ++i ) {
+            irods::thread_pool::post( workers, [&] {
+                try {
+                    auto worker_conn = conn_pool->get_connection();
+                    run( worker_conn );
+                }
+                catch ( const std::exception& _e ) {
+                    rodsLog( LOG_ERROR, "%s: %s", _caller, _e.what() );
+                    savedStatus = SYS_INTERNAL_ERR;
+                }
+            } );
+        }
+
+        workers.join();
+
+        return savedStatus;
+    }
+
+    // Walks the local tree the same way rsyncDirToCollUtil does and creates the
+    // missing collections. Every regular file that may differ from its data object
+    // is added to "_transfers".
+    int collect_put_transfers( rcComm_t* _conn, const std::string& _src_dir,
+                               const std::string& _targ_coll, rodsArguments_t* rodsArgs,
+                               remote_manifest& _manifest, std::vector<transfer>& _transfers )
+    {
+        namespace fs = boost::filesystem;
+
+        if ( rodsArgs->verbose == True ) {
+            fprintf( stdout, "C- %s:\n", _targ_coll.c_str() );
+        }
+
+        int savedStatus = 0;
+        fs::directory_iterator end_itr;
+
+        for ( fs::directory_iterator itr( _src_dir ); itr != end_itr; ++itr ) {
+            fs::path p = itr->path();
+            std::string src_path = p.string();
+
+            try {
+                if ( !irods::is_path_valid_for_recursion( rodsArgs, src_path.c_str() ) ) {
+                    continue;
+                }
+            }
+            catch ( const irods::exception& _e ) {
+                rodsLog( LOG_ERROR, _e.client_display_what() );
+                return USER_INPUT_PATH_ERR;
+            }
+
+            if ( !exists( p ) ) {
+                rodsLog( LOG_ERROR, "rsyncDirToCollUtil: stat error for %s, errno = %d\n", src_path.c_str(), errno );
+                return USER_INPUT_PATH_ERR;
+            }
+
+            if ( ( is_regular_file( p ) && rodsArgs->age == True ) &&
+                    ageExceeded( rodsArgs->agevalue, last_write_time( p ), src_path.data(), file_size( p ) ) ) {
+                continue;
+            }
+
+            const auto targ_path = _targ_coll + '/' + p.filename().string();
+
+            if ( is_symlink( p ) ) {
+                const fs::path cp = read_symlink( p );
+                // Issue 3663 - If the path is FQDN, do not add srcDir on path
+                src_path = cp.is_relative() ? _src_dir + '/' + cp.string() : cp.string();
+                p = src_path;
+            }
+
+            int status = 0;
+
+            if ( is_regular_file( p ) ) {
+                transfer t{src_path, targ_path, static_cast<rodsLong_t>( file_size( p ) ), getPathStMode( p.c_str() )};
+
+                if ( const auto iter = _manifest.data_objects.find( targ_path ); iter != std::end( _manifest.data_objects ) ) {
+                    t.remote = &iter->second;
+
+                    // Sync by size does not need any help from the workers.
+                    if ( rodsArgs->sizeFlag == True && t.remote->size == t.size ) {
+                        if ( rodsArgs->verbose == True ) {
+                            printNoSync( t.src_path.data(), t.size, "a match" );
+                        }
+                        continue;
+                    }
+                }
+
+                _transfers.push_back( std::move( t ) );
+            }
+            else if ( is_directory( p ) ) {
+                /* only do the sync if no -l option specified */
+                if ( rodsArgs->longOption != True && _manifest.collections.count( targ_path ) == 0 ) {
+                    std::string start_coll = _targ_coll;
+                    std::string dest_coll = targ_path;
+                    status = mkCollR( _conn, start_coll.data(), dest_coll.data() );
+                }
+
+                if ( status < 0 ) {
+                    rodsLogError( LOG_ERROR, status,
+                                  "rsyncDirToCollUtil: mkColl error for %s",
+                                  targ_path.c_str() );
+                }
+                else {
+                    status = collect_put_transfers( _conn, src_path, targ_path, rodsArgs, _manifest, _transfers );
+                }
+            }
+            else {
+                rodsLog( LOG_ERROR,
+                         "rsyncDirToCollUtil: unknown local path %s",
+                         src_path.c_str() );
+                status = USER_INPUT_PATH_ERR;
+            }
+
+            if ( status < 0 &&
+                    status != CAT_NO_ROWS_FOUND &&
+                    status != SYS_SPEC_COLL_OBJ_NOT_EXIST ) {
+                savedStatus = status;
+                rodsLogError( LOG_ERROR, status,
+                              "rsyncDirToCollUtil: put %s failed. status = %d",
+                              src_path.c_str(), status );
+            }
+        }
+
+        return savedStatus;
+    }
+
+    // Synchronizes a local directory tree to a collection. The data objects under the
+    // target are fetched with bulk queries instead of one stat per file, and the files
+    // are checksummed and transferred by a pool of workers. Returns std::nullopt if the
+    // tree must be handled by rsyncDirToCollUtil instead.
+    std::optional<int> rsyncDirToCollParallel( rcComm_t* conn, rodsPath_t* srcPath,
+                                               rodsPath_t* targPath, rodsArguments_t* rodsArgs,
+                                               dataObjInp_t* dataObjOprInp )
+    {
+        namespace fs = boost::filesystem;
+
+        const std::string src_dir = srcPath->outPath;
+        const std::string targ_coll = targPath->outPath;
+
+        if ( rodsArgs->recursive != True || !is_manifest_path( targ_coll ) ||
+                ( targPath->rodsObjStat != NULL && targPath->rodsObjStat->specColl != NULL ) ) {
+            return std::nullopt;
+        }
+
+        // Leave the error reporting for invalid sources to rsyncDirToCollUtil.
+        const fs::path src_dir_path( src_dir );
+        if ( !exists( src_dir_path ) || !is_directory( src_dir_path ) ) {
+            return std::nullopt;
+        }
+
+        try {
+            if ( !irods::is_path_valid_for_recursion( rodsArgs, src_dir.c_str() ) ) {
+                return 0;
+            }
+        }
+        catch ( const irods::exception& ) {
+            return std::nullopt;
+        }
+
+        remote_manifest manifest;
+
+        if ( fetch_remote_manifest( conn, targ_coll, manifest ) < 0 || manifest.has_special_collections ) {
+            return std::nullopt;
+        }
+
+        std::vector<transfer> transfers;
+        int savedStatus = collect_put_transfers( conn, src_dir, targ_coll, rodsArgs, manifest, transfers );
+
+        const int status = run_transfers( conn, transfers, "rsyncDirToCollUtil",
+            [rodsArgs, dataObjOprInp]( rcComm_t& _conn, const transfer& _t ) {
+                rodsPath_t mySrcPath{};
+                mySrcPath.objType = LOCAL_FILE_T;
+                mySrcPath.objState = EXIST_ST;
+                mySrcPath.size = _t.size;
+                rstrcpy( mySrcPath.outPath, _t.src_path.c_str(), MAX_NAME_LEN );
+
+                rodsPath_t myTargPath{};
+                myTargPath.objType = DATA_OBJ_T;
+                myTargPath.objState = NOT_EXIST_ST;
+                rstrcpy( myTargPath.outPath, _t.targ_path.c_str(), MAX_NAME_LEN );
+
+                if ( _t.remote ) {
+                    myTargPath.objState = EXIST_ST;
+                    myTargPath.size = _t.remote->size;
+                    rstrcpy( myTargPath.dataId, _t.remote->data_id.c_str(), NAME_LEN );
+                    rstrcpy( myTargPath.chksum, _t.remote->chksum.c_str(), NAME_LEN );
+                }
+
+                // rsyncFileToDataUtil modifies the keywords, so every transfer gets its own copy.
+                dataObjInp_t myDataObjInp = *dataObjOprInp;
+                memset( &myDataObjInp.condInput, 0, sizeof( myDataObjInp.condInput ) );
+                copyKeyVal( &dataObjOprInp->condInput, &myDataObjInp.condInput );
+                myDataObjInp.createMode = _t.create_mode;
+
+                const int status = rsyncFileToDataUtil( &_conn, &mySrcPath, &myTargPath,
+                                                        rodsArgs, &myDataObjInp );
+                clearKeyVal( &myDataObjInp.condInput );
+
+                return status;
+            } );
+
+        if ( status < 0 ) {
+            savedStatus = status;
+        }
+
+        return savedStatus;
+    }
+
+    // Synchronizes a collection tree to a local directory. The counterpart of
+    // rsyncDirToCollParallel. Returns std::nullopt if the tree must be handled by
+    // rsyncCollToDirUtil instead.
+    std::optional<int> rsyncCollToDirParallel( rcComm_t* conn, rodsPath_t* srcPath,
+                                               rodsPath_t* targPath, rodsArguments_t* rodsArgs,
+                                               dataObjInp_t* dataObjOprInp )
+    {
+        const std::string src_coll = srcPath->outPath;
+        const std::string targ_dir = targPath->outPath;
+
+        if ( rodsArgs->recursive != True || !is_manifest_path( src_coll ) ) {
+            return std::nullopt;
+        }
+
+        remote_manifest manifest;
+
+        if ( fetch_remote_manifest( conn, src_coll, manifest ) < 0 || manifest.has_special_collections ) {
+            return std::nullopt;
+        }
+
+        const auto to_local_path = [&src_coll, &targ_dir]( const std::string& _logical_path ) {
+            return targ_dir + _logical_path.substr( src_coll.size() );
+        };
+
+        // Parents sort before their children.
+        std::vector<std::string> collections( std::begin( manifest.collections ), std::end( manifest.collections ) );
+        std::sort( std::begin( collections ), std::end( collections ) );
+
+        /* only do the sync if no -l option specified */
+        if ( rodsArgs->longOption != True ) {
+            for ( const auto& coll : collections ) {
+                if ( coll != src_coll ) {
+                    std::string start_dir = targ_dir;
+                    std::string dest_dir = to_local_path( coll );
+                    mkdirR( start_dir.data(), dest_dir.data(), 0750 );
+                }
+            }
+        }
+
+        std::vector<transfer> transfers;
+
+        for ( const auto& [logical_path, e] : manifest.data_objects ) {
+            std::string src_path = logical_path;
+
+            if ( rodsArgs->age == True &&
+                    ageExceeded( rodsArgs->agevalue, e.modify_time, src_path.data(), e.size ) ) {
+                continue;
+            }
+
+            transfer t{src_path, to_local_path( logical_path ), e.size, 0, &e};
+
+            // Sync by size does not need any help from the workers.
+            if ( rodsArgs->sizeFlag == True ) {
+                rodsPath_t myTargPath{};
+                rstrcpy( myTargPath.outPath, t.targ_path.c_str(), MAX_NAME_LEN );
+
+                if ( getFileType( &myTargPath ) == LOCAL_FILE_T && myTargPath.size == e.size ) {
+                    if ( rodsArgs->verbose == True ) {
+                        printNoSync( src_path.data(), e.size, "a match" );
+                    }
+                    continue;
+                }
+            }
+
+            transfers.push_back( std::move( t ) );
+        }
+
+        return run_transfers( conn, transfers, "rsyncCollToDirUtil",
+            [rodsArgs, dataObjOprInp]( rcComm_t& _conn, const transfer& _t ) {
+                rodsPath_t mySrcPath{};
+                mySrcPath.objType = DATA_OBJ_T;
+                mySrcPath.objState = EXIST_ST;
+                mySrcPath.size = _t.size;
+                mySrcPath.objMode = _t.remote->mode;
+                rstrcpy( mySrcPath.outPath, _t.src_path.c_str(), MAX_NAME_LEN );
+                rstrcpy( mySrcPath.dataId, _t.remote->data_id.c_str(), NAME_LEN );
+                rstrcpy( mySrcPath.chksum, _t.remote->chksum.c_str(), NAME_LEN );
+
+                rodsPath_t myTargPath{};
+                myTargPath.objType = LOCAL_FILE_T;
+                rstrcpy( myTargPath.outPath, _t.targ_path.c_str(), MAX_NAME_LEN );
+                getFileType( &myTargPath );
+
+                // rsyncDataToFileUtil modifies the keywords, so every transfer gets its own copy.
+                dataObjInp_t myDataObjInp = *dataObjOprInp;
+                memset( &myDataObjInp.condInput, 0, sizeof( myDataObjInp.condInput ) );
+                copyKeyVal( &dataObjOprInp->condInput, &myDataObjInp.condInput );
+
+                const int status = rsyncDataToFileUtil( &_conn, &mySrcPath, &myTargPath,
+                                                        rodsArgs, &myDataObjInp );
+                clearKeyVal( &myDataObjInp.condInput );
+
+                return status;
+            } );
+    }
+} // anonymous namespace
+
 int
 rsyncUtil( rcComm_t *conn, rodsEnv *myRodsEnv, rodsArguments_t *myRodsArgs,
            rodsPathInp_t *rodsPathInp ) {
@@ -127,19 +607,35 @@ rsyncUtil( rcComm_t *conn, rodsEnv *myRodsEnv, rodsArguments_t *myRodsArgs,
         }
         else if ( srcType == COLL_OBJ_T && targType == LOCAL_DIR_T ) {
             addKeyVal( &dataObjOprInp.condInput, TRANSLATED_PATH_KW, "" );
-            status = rsyncCollToDirUtil( conn, srcPath, targPath,
-                                         myRodsEnv, myRodsArgs, &dataObjOprInp );
-            if ( status >= 0 && dataObjOprInp.specColl != NULL &&
-                    dataObjOprInp.specColl->collClass == STRUCT_FILE_COLL ) {
-                dataObjOprInp.specColl = NULL;
+            std::optional<int> parallel_status;
+            if ( dataObjOprInp.specColl == NULL ) {
+                parallel_status = rsyncCollToDirParallel( conn, srcPath, targPath,
+                                                          myRodsArgs, &dataObjOprInp );
+            }
+            if ( parallel_status ) {
+                status = *parallel_status;
+            }
+            else {
                 status = rsyncCollToDirUtil( conn, srcPath, targPath,
                                              myRodsEnv, myRodsArgs, &dataObjOprInp );
+                if ( status >= 0 && dataObjOprInp.specColl != NULL &&
+                        dataObjOprInp.specColl->collClass == STRUCT_FILE_COLL ) {
+                    dataObjOprInp.specColl = NULL;
+                    status = rsyncCollToDirUtil( conn, srcPath, targPath,
+                                                 myRodsEnv, myRodsArgs, &dataObjOprInp );
+                }
             }
         }
         else if ( srcType == LOCAL_DIR_T && targType == COLL_OBJ_T )
         {
-            status = rsyncDirToCollUtil( conn, srcPath, targPath,
-                                 myRodsEnv, myRodsArgs, &dataObjOprInp );
+            if ( const auto parallel_status = rsyncDirToCollParallel( conn, srcPath, targPath,
+                                                                      myRodsArgs, &dataObjOprInp ) ) {
+                status = *parallel_status;
+            }
+            else {
+                status = rsyncDirToCollUtil( conn, srcPath, targPath,
+                                             myRodsEnv, myRodsArgs, &dataObjOprInp );
+            }
         }
         else if ( srcType == COLL_OBJ_T && targType == COLL_OBJ_T ) {
             addKeyVal( &dataObjCopyInp.srcDataObjInp.condInput,
@@ -6,5 +6,6 @@
 #include "filesystem/path.hpp"
 #include "filesystem/collection_iterator.hpp"
 #include "filesystem/recursive_collection_iterator.hpp"
+#include "filesystem/cache.hpp"
 
 #endif // IRODS_FILESYSTEM_HPP
@@ -0,0 +1,107 @@
+#ifndef IRODS_FILESYSTEM_CACHE_HPP
+#define IRODS_FILESYSTEM_CACHE_HPP
+
+#include "filesystem/config.hpp"
+#include "filesystem/filesystem.hpp"
+#include "filesystem/object_status.hpp"
+
+#include <cstdint>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+namespace irods::experimental::filesystem
+{
+    struct cache_options
+    {
+        // The maximum number of paths held by the cache. The least recently used
+        // path is evicted when a new path would exceed this limit.
+        std::size_t max_entries = 10000;
+
+        // How long information about a path is trusted after it is fetched.
+        std::chrono::milliseconds time_to_live{5000};
+    };
+
+    struct cache_statistics
+    {
+        std::uintmax_t hits      = 0;
+        std::uintmax_t misses    = 0;
+        std::uintmax_t evictions = 0;
+        std::size_t entries      = 0;
+    };
+
+    namespace NAMESPACE_IMPL::cache
+    {
+        /// \brief Enables caching of object status, data object sizes, mtimes and metadata.
+        ///
+        /// The cache is disabled by default and is shared by every connection in the process.
+        /// Entries are keyed by logical path and by the client user of the connection.
+        ///
+        /// Only information about existing objects is cached. Mutating operations of this
+        /// library (e.g. rename, remove, permissions and the metadata functions) invalidate the
+        /// paths they affect. Changes made through other means become visible once the
+        /// affected entries expire.
+        ///
+        /// Calling this function while the cache is enabled clears the cache and applies the
+        /// new options.
+        ///
+        /// \param[in] _opts The options for the cache.
+        ///
+        /// \since 4.3.0
+        auto enable(const cache_options& _opts = {}) -> void;
+
+        /// \brief Disables the cache and discards every entry.
+        ///
+        /// \since 4.3.0
+        auto disable() -> void;
+
+        /// \brief Checks if the cache is enabled.
+        ///
+        /// \since 4.3.0
+        auto enabled() noexcept -> bool;
+
+        /// \brief Discards every entry. The statistics are not reset.
+        ///
+        /// \since 4.3.0
+        auto clear() -> void;
+
+        /// \brief Discards the entries for a path and everything under it.
+        ///
+        /// \param[in] _p The path to invalidate.
+        ///
+        /// \since 4.3.0
+        auto invalidate(const path& _p) -> void;
+
+        /// \brief Returns the hit and miss counters of the cache.
+        ///
+        /// \since 4.3.0
+        auto statistics() -> cache_statistics;
+
+        /// \brief Resets the hit, miss and eviction counters to zero.
+        ///
+        /// \since 4.3.0
+        auto reset_statistics() -> void;
+
+        // The following functions are used by the library to read and populate the cache.
+        // They do nothing when the cache is disabled.
+        namespace detail
+        {
+            // Discards the entries for a path, but not the entries under it.
+            auto erase(const path& _p) -> void;
+
+            auto get_type(rxComm& _comm, const path& _p) -> std::optional<object_type>;
+            auto get_status(rxComm& _comm, const path& _p) -> std::optional<object_status>;
+            auto get_data_object_size(rxComm& _comm, const path& _p) -> std::optional<std::uintmax_t>;
+            auto get_last_write_time(rxComm& _comm, const path& _p) -> std::optional<object_time_type>;
+            auto get_metadata(rxComm& _comm, const path& _p) -> std::optional<std::vector<metadata>>;
+
+            auto put_type(rxComm& _comm, const path& _p, object_type _type) -> void;
+            auto put_status(rxComm& _comm, const path& _p, const object_status& _status) -> void;
+            auto put_data_object_size(rxComm& _comm, const path& _p, std::uintmax_t _size) -> void;
+            auto put_last_write_time(rxComm& _comm, const path& _p, object_time_type _mtime) -> void;
+            auto put_metadata(rxComm& _comm, const path& _p, const std::vector<metadata>& _metadata) -> void;
+        } // namespace detail
+    } // namespace NAMESPACE_IMPL::cache
+} // namespace irods::experimental::filesystem
+
+#endif // IRODS_FILESYSTEM_CACHE_HPP
@@ -18,7 +18,12 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
     enum class collection_options
     {
         none,
-        skip_permission_denied
+        skip_permission_denied,
+
+        // Instructs recursive_collection_iterator to list the whole subtree with a
+        // small number of catalog queries instead of opening each collection. Every
+        // collection in the subtree is held in memory while iterating.
+        bulk_listing
     };
 
     class collection_iterator
@@ -17,6 +17,7 @@
 #undef rxDataObjChksum
 #undef rxModAccessControl
 #undef rxModAVUMetadata
+#undef rx_remove_all
 
 // clang-format off
 #ifdef IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
@@ -40,6 +41,7 @@
     #define rxModAVUMetadata                        rsModAVUMetadata
     #define rxModDataObjMeta                        rsModDataObjMeta
     #define rx_atomic_apply_metadata_operations     rs_atomic_apply_metadata_operations
+    #define rx_remove_all                           rs_remove_all
 
     struct RsComm;
 #else
@@ -63,6 +65,7 @@
     #define rxModAVUMetadata                        rcModAVUMetadata
     #define rxModDataObjMeta                        rc_data_object_modify_info
     #define rx_atomic_apply_metadata_operations     rc_atomic_apply_metadata_operations
+    #define rx_remove_all                           rc_remove_all
 
     struct RcComm;
 #endif // IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
@@ -193,6 +193,12 @@ namespace irods::experimental::filesystem
                   typename = std::enable_if_t<std::is_same_v<std::decay_t<typename Container::value_type>, metadata>>>
         auto remove_metadata(rxComm& _comm, const path& _p, const Container& _container) -> void;
 
+        // Cache functions used by the templates below. See filesystem/cache.hpp.
+        namespace cache::detail
+        {
+            auto erase(const path& _p) -> void;
+        } // namespace cache::detail
+
         #include "filesystem/filesystem.tpp"
     } // namespace NAMESPACE_IMPL
 } // namespace irods::experimental::filesystem
@@ -43,7 +43,11 @@ namespace
 
         char* json_error_string{};
 
-        if (const auto ec = rx_atomic_apply_metadata_operations(&_comm, json_input.data(), &json_error_string); ec) {
+        const auto ec = rx_atomic_apply_metadata_operations(&_comm, json_input.data(), &json_error_string);
+
+        cache::detail::erase(_path);
+
+        if (ec) {
             throw filesystem_error{"cannot apply metadata operations", _path, make_error_code(ec)};
         }
     }
@@ -8,6 +8,8 @@
 #include <iterator>
 #include <stack>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace irods::experimental::filesystem::NAMESPACE_IMPL
 {
@@ -40,14 +42,21 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
         // Observers
 
-        auto connection() -> rxComm* { return ctx_->stack.empty() ? nullptr : (*this).connection(); }
+        auto connection() -> rxComm*
+        {
+            if (ctx_->bulk) {
+                return ctx_->bulk->comm;
+            }
+
+            return ctx_->stack.empty() ? nullptr : ctx_->stack.top().connection();
+        }
 
         // clang-format off
-        auto operator*() const -> reference { return *ctx_->stack.top(); }
-        auto operator->() const -> pointer  { return &*ctx_->stack.top(); }
+        auto operator*() const -> reference { return ctx_->bulk ? ctx_->bulk->current() : *ctx_->stack.top(); }
+        auto operator->() const -> pointer  { return &**this; }
 
         auto options() const noexcept -> collection_options { return ctx_->opts; }
-        auto depth() const noexcept -> int                  { return static_cast<int>(ctx_->stack.size()) - 1; }
+        auto depth() const noexcept -> int                  { return ctx_->bulk ? ctx_->bulk->depth() : static_cast<int>(ctx_->stack.size()) - 1; }
         auto recursion_pending() const noexcept -> bool     { return ctx_->recurse; }
         // clang-format on
 
@@ -66,13 +75,63 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
         // clang-format on
 
     private:
+        // Holds the state for collection_options::bulk_listing.
+        //
+        // Collections are sorted so that every subtree is contiguous and each collection
+        // precedes its members. The data objects of a collection are listed before its
+        // subcollections and are fetched for a window of collections at a time.
+        struct bulk_context
+        {
+            struct collection
+            {
+                value_type entry;
+                std::string id;
+                int depth; // Zero for the root, otherwise the depth of the collection's members.
+            };
+
+            rxComm* comm{};
+            std::string zone;
+            std::vector<collection> collections;
+
+            // The collection being visited. If "listing_data_objects" is false, the iterator
+            // points to the collection itself, otherwise it points to one of its data objects.
+            std::size_t index{};
+            bool listing_data_objects{};
+            std::size_t data_object_index{};
+
+            // The data objects of the collections in [window_begin, window_begin + data_objects.size()).
+            std::size_t window_begin{};
+            std::vector<std::vector<value_type>> data_objects;
+
+            auto current() const -> reference
+            {
+                if (listing_data_objects) {
+                    return data_objects[index - window_begin][data_object_index];
+                }
+
+                return collections[index].entry;
+            }
+
+            auto depth() const noexcept -> int
+            {
+                return listing_data_objects ? collections[index].depth : collections[index].depth - 1;
+            }
+        };
+
         struct context
         {
             std::stack<collection_iterator> stack;
+            std::unique_ptr<bulk_context> bulk;
             collection_options opts = collection_options::none;
             bool recurse = true;
         };
 
+        auto bulk_list(rxComm& _comm, const path& _p) -> void;
+        auto bulk_enter_collection(std::size_t _index) -> void;
+        auto bulk_move_to_collection(std::size_t _index) -> void;
+        auto bulk_fetch_data_objects(std::size_t _index) -> void;
+        auto bulk_end_of_subtree(std::size_t _index) const -> std::size_t;
+
         std::shared_ptr<context> ctx_;
     };
 
@@ -0,0 +1,347 @@
+#include "filesystem/cache.hpp"
+
+#include "filesystem/path.hpp"
+
+#include "rcConnect.h"
+
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace irods::experimental::filesystem::NAMESPACE_IMPL::cache
+{
+    namespace
+    {
+        using clock_type = std::chrono::steady_clock;
+
+        // Entries are ordered by path first so that a path and everything under it
+        // form a contiguous range.
+        struct key_type
+        {
+            std::string path;
+            std::string user;
+
+            auto operator<(const key_type& _rhs) const noexcept -> bool
+            {
+                return std::tie(path, user) < std::tie(_rhs.path, _rhs.user);
+            }
+        };
+
+        struct entry_type
+        {
+            clock_type::time_point expires;
+            std::list<key_type>::iterator lru_position;
+
+            std::optional<object_type> type;
+            std::optional<object_status> status;
+            std::optional<std::uintmax_t> data_object_size;
+            std::optional<object_time_type> last_write_time;
+            std::optional<std::vector<filesystem::metadata>> metadata;
+        };
+
+        struct cache_state
+        {
+            std::mutex mutex;
+            cache_options options;
+            std::map<key_type, entry_type> entries;
+            std::list<key_type> lru; // Most recently used at the front.
+            cache_statistics stats;
+        };
+
+        std::atomic<bool> is_enabled{false};
+
+        auto state() -> cache_state&
+        {
+            static cache_state s;
+            return s;
+        }
+
+        auto make_key(rxComm& _comm, const path& _p) -> key_type
+        {
+            auto p = _p.string();
+
+            while (p.size() > 1 && filesystem::detail::is_separator(p.back())) {
+                p.pop_back();
+            }
+
+            std::string user = _comm.clientUser.userName;
+            user += '#';
+            user += _comm.clientUser.rodsZone;
+
+            return {std::move(p), std::move(user)};
+        }
+
+        auto erase(cache_state& _s, std::map<key_type, entry_type>::iterator _iter) -> void
+        {
+            _s.lru.erase(_iter->second.lru_position);
+            _s.entries.erase(_iter);
+        }
+
+        // Erases the entries of every user for "_p".
+        auto erase_path(cache_state& _s, const std::string& _p) -> void
+        {
+            auto iter = _s.entries.lower_bound({_p, {}});
+
+            while (iter != std::end(_s.entries) && iter->first.path == _p) {
+                erase(_s, iter++);
+            }
+        }
+
+        // Returns the member of the entry for "_p" selected by "_member" and updates the
+        // counters. Expired entries are discarded.
+        template <typename T>
+        auto get(rxComm& _comm, const path& _p, std::optional<T> entry_type::*_member) -> std::optional<T>
+        {
+            if (!is_enabled) {
+                return std::nullopt;
+            }
+
+            auto& s = state();
+            const auto key = make_key(_comm, _p);
+
+            std::lock_guard lk{s.mutex};
+
+            auto iter = s.entries.find(key);
+
+            if (iter == std::end(s.entries)) {
+                ++s.stats.misses;
+                return std::nullopt;
+            }
+
+            if (iter->second.expires <= clock_type::now()) {
+                erase(s, iter);
+                ++s.stats.misses;
+                return std::nullopt;
+            }
+
+            const auto& value = iter->second.*_member;
+
+            if (!value) {
+                ++s.stats.misses;
+                return std::nullopt;
+            }
+
+            s.lru.splice(std::begin(s.lru), s.lru, iter->second.lru_position);
+            ++s.stats.hits;
+
+            return value;
+        }
+
+        // Stores "_value" in the entry for "_p". The expiration time of an entry is set
+        // when the entry is created and is not extended by later updates.
+        template <typename T>
+        auto put(rxComm& _comm, const path& _p, std::optional<T> entry_type::*_member, T _value) -> void
+        {
+            if (!is_enabled) {
+                return;
+            }
+
+            auto& s = state();
+            auto key = make_key(_comm, _p);
+
+            std::lock_guard lk{s.mutex};
+
+            if (0 == s.options.max_entries) {
+                return;
+            }
+
+            const auto now = clock_type::now();
+            auto iter = s.entries.find(key);
+
+            if (iter != std::end(s.entries) && iter->second.expires <= now) {
+                erase(s, iter);
+                iter = std::end(s.entries);
+            }
+
+            if (iter == std::end(s.entries)) {
+                while (s.entries.size() >= s.options.max_entries) {
+                    erase(s, s.entries.find(s.lru.back()));
+                    ++s.stats.evictions;
+                }
+
+                iter = s.entries.emplace(key, entry_type{}).first;
+                iter->second.expires = now + s.options.time_to_live;
+                s.lru.push_front(std::move(key));
+                iter->second.lru_position = std::begin(s.lru);
+            }
+            else {
+                s.lru.splice(std::begin(s.lru), s.lru, iter->second.lru_position);
+            }
+
+            iter->second.*_member = std::move(_value);
+        }
+    } // anonymous namespace
+
+    auto enable(const cache_options& _opts) -> void
+    {
+        auto& s = state();
+
+        std::lock_guard lk{s.mutex};
+
+        s.options = _opts;
+        s.entries.clear();
+        s.lru.clear();
+
+        is_enabled = true;
+    }
+
+    auto disable() -> void
+    {
+        auto& s = state();
+
+        std::lock_guard lk{s.mutex};
+
+        is_enabled = false;
+
+        s.entries.clear();
+        s.lru.clear();
+    }
+
+    auto enabled() noexcept -> bool
+    {
+        return is_enabled;
+    }
+
+    auto clear() -> void
+    {
+        auto& s = state();
+
+        std::lock_guard lk{s.mutex};
+
+        s.entries.clear();
+        s.lru.clear();
+    }
+
+    auto invalidate(const path& _p) -> void
+    {
+        if (!is_enabled) {
+            return;
+        }
+
+        auto p = _p.string();
+
+        if (p.empty()) {
+            return;
+        }
+
+        while (p.size() > 1 && filesystem::detail::is_separator(p.back())) {
+            p.pop_back();
+        }
+
+        const auto prefix = filesystem::detail::is_separator(p.back()) ? p : p + path::preferred_separator;
+
+        auto& s = state();
+
+        std::lock_guard lk{s.mutex};
+
+        // Entries for the path itself (one per user) come first, followed by the
+        // entries under it.
+        erase_path(s, p);
+
+        auto iter = s.entries.lower_bound({prefix, {}});
+
+        while (iter != std::end(s.entries) && std::string_view{iter->first.path}.substr(0, prefix.size()) == prefix) {
+            erase(s, iter++);
+        }
+    }
+
+    auto statistics() -> cache_statistics
+    {
+        auto& s = state();
+
+        std::lock_guard lk{s.mutex};
+
+        auto stats = s.stats;
+        stats.entries = s.entries.size();
+
+        return stats;
+    }
+
+    auto reset_statistics() -> void
+    {
+        auto& s = state();
+
+        std::lock_guard lk{s.mutex};
+
+        s.stats = {};
+    }
+
+    namespace detail
+    {
+        auto erase(const path& _p) -> void
+        {
+            if (!is_enabled) {
+                return;
+            }
+
+            auto p = _p.string();
+
+            while (p.size() > 1 && filesystem::detail::is_separator(p.back())) {
+                p.pop_back();
+            }
+
+            auto& s = state();
+
+            std::lock_guard lk{s.mutex};
+
+            erase_path(s, p);
+        }
+
+        auto get_type(rxComm& _comm, const path& _p) -> std::optional<object_type>
+        {
+            return get(_comm, _p, &entry_type::type);
+        }
+
+        auto get_status(rxComm& _comm, const path& _p) -> std::optional<object_status>
+        {
+            return get(_comm, _p, &entry_type::status);
+        }
+
+        auto get_data_object_size(rxComm& _comm, const path& _p) -> std::optional<std::uintmax_t>
+        {
+            return get(_comm, _p, &entry_type::data_object_size);
+        }
+
+        auto get_last_write_time(rxComm& _comm, const path& _p) -> std::optional<object_time_type>
+        {
+            return get(_comm, _p, &entry_type::last_write_time);
+        }
+
+        auto get_metadata(rxComm& _comm, const path& _p) -> std::optional<std::vector<metadata>>
+        {
+            return get(_comm, _p, &entry_type::metadata);
+        }
+
+        auto put_type(rxComm& _comm, const path& _p, object_type _type) -> void
+        {
+            put(_comm, _p, &entry_type::type, _type);
+        }
+
+        auto put_status(rxComm& _comm, const path& _p, const object_status& _status) -> void
+        {
+            put(_comm, _p, &entry_type::type, _status.type());
+            put(_comm, _p, &entry_type::status, _status);
+        }
+
+        auto put_data_object_size(rxComm& _comm, const path& _p, std::uintmax_t _size) -> void
+        {
+            put(_comm, _p, &entry_type::data_object_size, _size);
+        }
+
+        auto put_last_write_time(rxComm& _comm, const path& _p, object_time_type _mtime) -> void
+        {
+            put(_comm, _p, &entry_type::last_write_time, _mtime);
+        }
+
+        auto put_metadata(rxComm& _comm, const path& _p, const std::vector<metadata>& _metadata) -> void
+        {
+            put(_comm, _p, &entry_type::metadata, _metadata);
+        }
+    } // namespace detail
+} // namespace irods::experimental::filesystem::NAMESPACE_IMPL::cache
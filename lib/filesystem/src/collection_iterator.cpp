@@ -1,5 +1,6 @@
 #include "filesystem/collection_iterator.hpp"
 
+#include "filesystem/cache.hpp"
 #include "filesystem/detail.hpp"
 #include "filesystem/filesystem_error.hpp"
 
@@ -113,6 +114,10 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
                 break;
         }
 
+        if (exists(entry.status_)) {
+            cache::detail::put_type(*ctx_->comm, entry.path_, entry.status_.type());
+        }
+
         return *this;
     }
 
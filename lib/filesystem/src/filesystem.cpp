@@ -2,6 +2,7 @@
 
 #include "filesystem/path.hpp"
 #include "filesystem/collection_iterator.hpp"
+#include "filesystem/cache.hpp"
 
 // clang-format off
 #ifdef IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
@@ -21,6 +22,7 @@
     #include "rsRmColl.hpp"
     #include "rsModAVUMetadata.hpp"
     #include "rsModDataObjMeta.hpp"
+    #include "rs_remove_all.hpp"
 #else
     #include "rodsClient.h"
     #include "specificQuery.h"
@@ -35,6 +37,7 @@
     #include "rmColl.h"
     #include "modAVUMetadata.h"
     #include "data_object_modify_info.h"
+    #include "remove_all.h"
 #endif // IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
 // clang-format on
 
@@ -48,6 +51,7 @@
 #include "query_builder.hpp"
 
 #include "fmt/format.h"
+#include "json.hpp"
 
 #include <cctype>
 #include <cstring>
@@ -83,6 +87,12 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
             collOprStat_t* stat{};
             return ::rsRmColl(_comm, _rmCollInp, _track_progress ? &stat : nullptr);
         };
+
+        // Progress is never streamed to server-side callers.
+        const auto rs_remove_all = [](rsComm_t* _comm, const char* _json_input, bool) -> int
+        {
+            return ::rs_remove_all(_comm, _json_input);
+        };
 #endif // IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
 
         struct stat
@@ -209,6 +219,76 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
             return s;
         }
 
+        // Returns the status of "_p" without consulting the cache.
+        auto fetch_status(rxComm& _comm, const path& _p) -> object_status
+        {
+            const auto s = stat(_comm, _p);
+
+            if (s.error < 0) {
+                throw filesystem_error{"cannot get status", _p, make_error_code(s.error)};
+            }
+
+            object_status status;
+
+            status.permissions(s.prms);
+
+            // XXX This does not handle the case of object_type::unknown.
+            // This type means a file exists, but the type is unknown.
+            // Maybe this case is not possible in iRODS.
+            switch (s.type) {
+                case DATA_OBJ_T:
+                    status.type(object_type::data_object);
+                    break;
+
+                case COLL_OBJ_T:
+                    status.type(object_type::collection);
+                    break;
+
+                // This case indicates that iRODS does not contain a data object or
+                // collection at path "_p".
+                case UNKNOWN_OBJ_T:
+                    status.type(object_type::not_found);
+                    break;
+
+                /*
+                case ?:
+                    status.type(object_type::unknown);
+                    break;
+                */
+
+                default:
+                    status.type(object_type::none);
+                    break;
+            }
+
+            // Paths that do not exist are never cached so that objects created through
+            // other means (e.g. dstream) are visible immediately.
+            if (exists(status)) {
+                cache::detail::put_status(_comm, _p, status);
+            }
+
+            return status;
+        }
+
+        // Returns a status that is only guaranteed to hold the object type. This allows
+        // type checks to be answered by entries populated during collection iteration.
+        auto type_status(rxComm& _comm, const path& _p) -> object_status
+        {
+            if (const auto type = cache::detail::get_type(_comm, _p); type) {
+                return object_status{*type};
+            }
+
+            return fetch_status(_comm, _p);
+        }
+
+        // Discards cached information about "_p" and everything under it. The parent is
+        // discarded as well because its mtime changes when its members change.
+        auto invalidate_cache(const path& _p) -> void
+        {
+            cache::invalidate(_p);
+            cache::detail::erase(_p.parent_path());
+        }
+
         auto is_collection_empty(rxComm& _comm, const path& _p) -> bool
         {
             return collection_iterator{} == collection_iterator{_comm, _p};
@@ -224,6 +304,8 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
                 return false;
             }
 
+            at_scope_exit invalidate{[&_p] { invalidate_cache(_p); }};
+
             if (is_data_object(s)) {
                 dataObjInp_t input{};
                 at_scope_exit free_memory{[&input] { clearKeyVal(&input.condInput); }};
@@ -244,6 +326,21 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
                     throw filesystem_error{"cannot remove non-empty collection", _p, make_error_code(SYS_COLLECTION_NOT_EMPTY)};
                 }
 
+                if (_opts.recursive) {
+                    const auto json_input = nlohmann::json{
+                        {"logical_path", _p.string()},
+                        {"options", {
+                            {"no_trash", _opts.no_trash},
+                            {"unregister", _opts.unregister}
+                        }}
+                    }.dump();
+
+                    // Servers without the remove_all API fall through to rmColl.
+                    if (const auto ec = rx_remove_all(&_comm, json_input.c_str(), _opts.progress); ec != SYS_UNMATCHED_API_NUM) {
+                        return ec >= 0;
+                    }
+                }
+
                 collInp_t input{};
                 at_scope_exit free_memory{[&input] { clearKeyVal(&input.condInput); }};
 
@@ -321,7 +418,11 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
             std::strncpy(units_buf, _metadata.units.c_str(), _metadata.units.size());
             input.arg5 = units_buf;
 
-            if (const auto ec = rxModAVUMetadata(&_comm, &input); ec != 0) {
+            const auto ec = rxModAVUMetadata(&_comm, &input);
+
+            cache::detail::erase(_p);
+
+            if (ec != 0) {
                 std::string_view op_full_name = (op == "rm") ? "remove" : op;
                 throw filesystem_error{fmt::format("cannot {} metadata", op_full_name), _p, make_error_code(ec)};
             }
@@ -433,7 +534,11 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
         std::strncpy(input.destDataObjInp.objPath, _to.c_str(), std::strlen(_to.c_str()));
         addKeyVal(&input.destDataObjInp.condInput, DEST_RESC_NAME_KW, "");
 
-        if (const auto ec = rxDataObjCopy(&_comm, &input); ec < 0) {
+        const auto ec = rxDataObjCopy(&_comm, &input);
+
+        invalidate_cache(_to);
+
+        if (ec < 0) {
             throw filesystem_error{"cannot copy data object", _from, _to, make_error_code(ec)};
         }
 
@@ -455,7 +560,11 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
         collInp_t input{};
         std::strncpy(input.collName, _p.c_str(), std::strlen(_p.c_str()));
 
-        if (const auto ec = rxCollCreate(&_comm, &input); ec != 0) {
+        const auto ec = rxCollCreate(&_comm, &input);
+
+        invalidate_cache(_p);
+
+        if (ec != 0) {
             throw filesystem_error{"cannot create collection", _p, make_error_code(ec)};
         }
 
@@ -497,7 +606,11 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
         std::strncpy(input.collName, _p.c_str(), std::strlen(_p.c_str()));
         addKeyVal(&input.condInput, RECURSIVE_OPR__KW, "");
 
-        return rxCollCreate(&_comm, &input) == 0;
+        const auto ec = rxCollCreate(&_comm, &input);
+
+        invalidate_cache(_p);
+
+        return ec == 0;
     }
 
     auto exists(const object_status& _s) noexcept -> bool
@@ -507,7 +620,7 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
     auto exists(rxComm& _comm, const path& _p) -> bool
     {
-        return exists(status(_comm, _p));
+        return exists(type_status(_comm, _p));
     }
 
     auto is_collection_registered(rxComm& _comm, const path& _p) -> bool
@@ -581,6 +694,10 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
             throw filesystem_error{"path does not point to a data object", _p, make_error_code(SYS_INVALID_INPUT_PARAM)};
         }
 
+        if (const auto size = cache::detail::get_data_object_size(_comm, _p); size) {
+            return *size;
+        }
+
         // Fetch information for good replicas only (i.e. DATA_REPL_STATUS = '1').
         const auto gql = fmt::format("select DATA_SIZE, DATA_MODIFY_TIME "
                                      "where"
@@ -618,6 +735,8 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
             }
         }
 
+        cache::detail::put_data_object_size(_comm, _p, size);
+
         return size;
     }
 
@@ -628,7 +747,7 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
     auto is_collection(rxComm& _comm, const path& _p) -> bool
     {
-        return is_collection(status(_comm, _p));
+        return is_collection(type_status(_comm, _p));
     }
 
     auto is_special_collection(rxComm& _comm, const path& _p) -> bool
@@ -670,7 +789,7 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
     auto is_other(rxComm& _comm, const path& _p) -> bool
     {
-        return is_other(status(_comm, _p));
+        return is_other(type_status(_comm, _p));
     }
 
     auto is_data_object(const object_status& _s) noexcept -> bool
@@ -680,14 +799,18 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
     auto is_data_object(rxComm& _comm, const path& _p) -> bool
     {
-        return is_data_object(status(_comm, _p));
+        return is_data_object(type_status(_comm, _p));
     }
 
     auto last_write_time(rxComm& _comm, const path& _p) -> object_time_type
     {
+        if (const auto mtime = cache::detail::get_last_write_time(_comm, _p); mtime) {
+            return *mtime;
+        }
+
         std::string gql;
 
-        if (const auto s = status(_comm, _p); is_data_object(s)) {
+        if (const auto s = type_status(_comm, _p); is_data_object(s)) {
             // Fetch information for good replicas only (i.e. DATA_REPL_STATUS = '1').
             gql = fmt::format("select max(DATA_MODIFY_TIME) "
                               "where"
@@ -711,7 +834,9 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
         }
 
         for (auto&& row : qb.build(_comm, gql)) {
-            return object_time_type{std::chrono::seconds{std::stoull(row[0])}};
+            const auto mtime = object_time_type{std::chrono::seconds{std::stoull(row[0])}};
+            cache::detail::put_last_write_time(_comm, _p, mtime);
+            return mtime;
         }
 
         throw filesystem_error{"cannot get mtime", _p, make_error_code(CAT_NO_ROWS_FOUND)};
@@ -732,7 +857,11 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
         std::strncpy(input.collName, _p.c_str(), std::strlen(_p.c_str()));
         addKeyVal(&input.condInput, COLLECTION_MTIME_KW, timestamp.c_str());
 
-        if (const auto ec = rxModColl(&_comm, &input); ec != 0) {
+        const auto ec = rxModColl(&_comm, &input);
+
+        cache::detail::erase(_p);
+
+        if (ec != 0) {
             throw filesystem_error{"cannot set mtime", _p, make_error_code(ec)};
         }
     }
@@ -876,7 +1005,11 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
         input.accessLevel = access;
 
-        if (const auto ec = rxModAccessControl(&_comm, &input); ec != 0) {
+        const auto ec = rxModAccessControl(&_comm, &input);
+
+        cache::detail::erase(_p);
+
+        if (ec != 0) {
             throw filesystem_error{"cannot set permissions", _p, make_error_code(ec)};
         }
     }
@@ -946,7 +1079,12 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
         std::strncpy(input.srcDataObjInp.objPath, _old_p.c_str(), std::strlen(_old_p.c_str()));
         std::strncpy(input.destDataObjInp.objPath, _new_p.c_str(), std::strlen(_new_p.c_str()));
 
-        if (const auto ec = rxDataObjRename(&_comm, &input); ec < 0) {
+        const auto ec = rxDataObjRename(&_comm, &input);
+
+        invalidate_cache(_old_p);
+        invalidate_cache(_new_p);
+
+        if (ec < 0) {
             throw filesystem_error{"cannot rename object", _old_p, _new_p, make_error_code(ec)};
         }
     }
@@ -1001,46 +1139,11 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
     auto status(rxComm& _comm, const path& _p) -> object_status
     {
-        const auto s = stat(_comm, _p);
-
-        if (s.error < 0) {
-            throw filesystem_error{"cannot get status", _p, make_error_code(s.error)};
+        if (auto s = cache::detail::get_status(_comm, _p); s) {
+            return *std::move(s);
         }
 
-        object_status status;
-
-        status.permissions(s.prms);
-
-        // XXX This does not handle the case of object_type::unknown.
-        // This type means a file exists, but the type is unknown.
-        // Maybe this case is not possible in iRODS.
-        switch (s.type) {
-            case DATA_OBJ_T:
-                status.type(object_type::data_object);
-                break;
-
-            case COLL_OBJ_T:
-                status.type(object_type::collection);
-                break;
-
-            // This case indicates that iRODS does not contain a data object or
-            // collection at path "_p".
-            case UNKNOWN_OBJ_T:
-                status.type(object_type::not_found);
-                break;
-
-            /*
-            case ?:
-                status.type(object_type::unknown);
-                break;
-            */
-
-            default:
-                status.type(object_type::none);
-                break;
-        }
-        
-        return status;
+        return fetch_status(_comm, _p);
     }
 
     auto status_known(const object_status& _s) noexcept -> bool
@@ -1053,9 +1156,13 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
         detail::throw_if_path_is_empty(_p);
         detail::throw_if_path_length_exceeds_limit(_p);
 
+        if (auto md = cache::detail::get_metadata(_comm, _p); md) {
+            return *std::move(md);
+        }
+
         std::string sql;
 
-        if (const auto s = status(_comm, _p); is_data_object(s)) {
+        if (const auto s = type_status(_comm, _p); is_data_object(s)) {
             sql = "select META_DATA_ATTR_NAME, META_DATA_ATTR_VALUE, META_DATA_ATTR_UNITS where DATA_NAME = '";
             sql += _p.object_name();
             sql += "' and COLL_NAME = '";
@@ -1083,6 +1190,8 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
             results.push_back({row[0], row[1], row[2]});
         }
 
+        cache::detail::put_metadata(_comm, _p, results);
+
         return results;
     }
 
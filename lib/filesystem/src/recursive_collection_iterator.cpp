@@ -1,7 +1,62 @@
 #include "filesystem/recursive_collection_iterator.hpp"
 
+#include "filesystem/cache.hpp"
+#include "filesystem/detail.hpp"
+#include "filesystem/filesystem_error.hpp"
+
+// clang-format off
+#ifdef IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
+    #define IRODS_QUERY_ENABLE_SERVER_SIDE_API
+
+    #include "rsGenQuery.hpp"
+#else
+    #include "genQuery.h"
+#endif // IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
+// clang-format on
+
+#include "irods_query.hpp"
+#include "query_builder.hpp"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace irods::experimental::filesystem::NAMESPACE_IMPL
 {
+    namespace
+    {
+        // The number of collections whose data objects are fetched by a single query.
+        constexpr std::size_t collections_per_data_object_query = 64;
+
+        auto starts_with(std::string_view _s, std::string_view _prefix) noexcept -> bool
+        {
+            return _s.size() >= _prefix.size() && _s.compare(0, _prefix.size(), _prefix) == 0;
+        }
+
+        // Orders paths as if the separator were the smallest character. This places
+        // every collection immediately before its subtree and keeps subtrees contiguous
+        // (e.g. "/a", "/a/b", "/a-b" instead of "/a", "/a-b", "/a/b").
+        auto depth_first_less(const std::string& _lhs, const std::string& _rhs) noexcept -> bool
+        {
+            const auto rank = [](char _c) noexcept -> int {
+                return detail::is_separator(_c) ? 0 : static_cast<unsigned char>(_c) + 1;
+            };
+
+            return std::lexicographical_compare(std::begin(_lhs), std::end(_lhs),
+                                                std::begin(_rhs), std::end(_rhs),
+                                                [&rank](char _a, char _b) { return rank(_a) < rank(_b); });
+        }
+
+        auto to_object_time(const std::string& _seconds) -> object_time_type
+        {
+            return object_time_type{std::chrono::seconds{_seconds.empty() ? 0 : std::stoll(_seconds)}};
+        }
+    } // anonymous namespace
+
     // Constructors and destructor
 
     recursive_collection_iterator::recursive_collection_iterator(rxComm& _comm,
@@ -9,8 +64,14 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
                                                                  collection_options _opts)
         : ctx_{}
     {
+        if (collection_options::bulk_listing == _opts) {
+            bulk_list(_comm, _p);
+            return;
+        }
+
         if (collection_iterator iter{_comm, _p, _opts}; collection_iterator{} != iter) {
             ctx_.reset(new context{});
+            ctx_->opts = _opts;
             ctx_->stack.push(std::move(iter));
         }
     }
@@ -19,6 +80,31 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
     auto recursive_collection_iterator::operator++() -> recursive_collection_iterator&
     {
+        if (ctx_->bulk) {
+            auto& bulk = *ctx_->bulk;
+
+            if (!bulk.listing_data_objects) {
+                if (ctx_->recurse) {
+                    bulk_enter_collection(bulk.index);
+                }
+                else {
+                    bulk_move_to_collection(bulk_end_of_subtree(bulk.index));
+                }
+            }
+            else if (bulk.data_object_index + 1 < bulk.data_objects[bulk.index - bulk.window_begin].size()) {
+                ++bulk.data_object_index;
+            }
+            else {
+                bulk_move_to_collection(bulk.index + 1);
+            }
+
+            if (ctx_) {
+                ctx_->recurse = true;
+            }
+
+            return *this;
+        }
+
         auto& iter = ctx_->stack.top();
         bool added_new_collection = false;
 
@@ -59,6 +145,32 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
     auto recursive_collection_iterator::pop() -> void
     {
+        if (ctx_->bulk) {
+            const auto& bulk = *ctx_->bulk;
+
+            if (depth() == 0) {
+                *this = {};
+                return;
+            }
+
+            // Find the collection the iterator is currently listing. Because collections
+            // are sorted depth-first, the parent of a collection is the closest preceding
+            // collection that is one level above it.
+            auto parent = bulk.index;
+
+            if (!bulk.listing_data_objects) {
+                const auto parent_depth = bulk.collections[bulk.index].depth - 1;
+
+                while (bulk.collections[parent].depth != parent_depth) {
+                    --parent;
+                }
+            }
+
+            bulk_move_to_collection(bulk_end_of_subtree(parent));
+
+            return;
+        }
+
         // If there is only a single iterator on the stack, then popping it must
         // produce the end iterator.
         if (ctx_->stack.size() == 1) {
@@ -68,5 +180,189 @@ namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
         ctx_->stack.pop();
     }
-} // namespace irods::experimental::filesystem::NAMESPACE_IMPL
 
+    // Bulk listing
+
+    auto recursive_collection_iterator::bulk_list(rxComm& _comm, const path& _p) -> void
+    {
+        detail::throw_if_path_length_exceeds_limit(_p);
+
+        // Trailing separators are ignored just like in non-bulk mode.
+        auto root = _p.string();
+
+        while (root.size() > 1 && detail::is_separator(root.back())) {
+            root.pop_back();
+        }
+
+        auto bulk = std::make_unique<bulk_context>();
+        bulk->comm = &_comm;
+
+        if (const auto zone = zone_name(root); zone) {
+            bulk->zone = *zone;
+        }
+
+        irods::experimental::query_builder qb;
+
+        if (!bulk->zone.empty()) {
+            qb.zone_hint(bulk->zone);
+        }
+
+        const auto columns = "COLL_ID, COLL_NAME, COLL_OWNER_NAME, COLL_CREATE_TIME, COLL_MODIFY_TIME";
+
+        const auto add_collection = [&_comm, &bulk](const std::vector<std::string>& _row, int _depth) {
+            auto& c = bulk->collections.emplace_back();
+            c.id = _row[0];
+            c.depth = _depth;
+            c.entry.path_ = _row[1];
+            c.entry.owner_ = _row[2];
+            c.entry.ctime_ = to_object_time(_row[3]);
+            c.entry.mtime_ = to_object_time(_row[4]);
+            c.entry.status_.type(object_type::collection);
+
+            cache::detail::put_type(_comm, c.entry.path_, object_type::collection);
+            cache::detail::put_last_write_time(_comm, c.entry.path_, c.entry.mtime_);
+        };
+
+        for (auto&& row : qb.build(_comm, fmt::format("select {} where COLL_NAME = '{}'", columns, root))) {
+            add_collection(row, 0);
+        }
+
+        if (bulk->collections.empty()) {
+            const auto ec = is_data_object(_comm, root) ? CAT_NAME_EXISTS_AS_DATAOBJ : OBJ_PATH_DOES_NOT_EXIST;
+            throw filesystem_error{"could not open collection for reading", _p, detail::make_error_code(ec)};
+        }
+
+        // The LIKE pattern may match collections outside of the subtree (e.g. when the path
+        // contains an underscore), so every row is checked against the actual prefix.
+        const auto prefix = detail::is_separator(root.back()) ? root : root + path::preferred_separator;
+
+        for (auto&& row : qb.build(_comm, fmt::format("select {} where COLL_NAME like '{}%'", columns, prefix))) {
+            if (starts_with(row[1], prefix) && row[1].size() > prefix.size()) {
+                const auto relative = std::string_view{row[1]}.substr(prefix.size());
+                add_collection(row, static_cast<int>(std::count(std::begin(relative), std::end(relative), '/')) + 1);
+            }
+        }
+
+        std::sort(std::next(std::begin(bulk->collections)), std::end(bulk->collections),
+                  [](const auto& _lhs, const auto& _rhs) {
+                      return depth_first_less(_lhs.entry.path_.string(), _rhs.entry.path_.string());
+                  });
+
+        ctx_.reset(new context{});
+        ctx_->opts = collection_options::bulk_listing;
+        ctx_->bulk = std::move(bulk);
+
+        // Point to the first entry.
+        bulk_enter_collection(0);
+    }
+
+    auto recursive_collection_iterator::bulk_enter_collection(std::size_t _index) -> void
+    {
+        auto& bulk = *ctx_->bulk;
+
+        bulk_fetch_data_objects(_index);
+
+        if (bulk.data_objects[_index - bulk.window_begin].empty()) {
+            bulk_move_to_collection(_index + 1);
+            return;
+        }
+
+        bulk.index = _index;
+        bulk.listing_data_objects = true;
+        bulk.data_object_index = 0;
+    }
+
+    auto recursive_collection_iterator::bulk_move_to_collection(std::size_t _index) -> void
+    {
+        auto& bulk = *ctx_->bulk;
+
+        if (_index >= bulk.collections.size()) {
+            *this = {};
+            return;
+        }
+
+        bulk.index = _index;
+        bulk.listing_data_objects = false;
+        bulk.data_object_index = 0;
+    }
+
+    auto recursive_collection_iterator::bulk_fetch_data_objects(std::size_t _index) -> void
+    {
+        auto& bulk = *ctx_->bulk;
+
+        if (_index >= bulk.window_begin && _index < bulk.window_begin + bulk.data_objects.size()) {
+            return;
+        }
+
+        const auto window_end = std::min(_index + collections_per_data_object_query, bulk.collections.size());
+
+        bulk.window_begin = _index;
+        bulk.data_objects.clear();
+        bulk.data_objects.resize(window_end - _index);
+
+        std::unordered_map<std::string_view, std::size_t> offsets;
+        std::string ids;
+
+        for (auto i = _index; i < window_end; ++i) {
+            const auto& id = bulk.collections[i].id;
+            offsets.emplace(id, i - _index);
+
+            if (!ids.empty()) {
+                ids += ", ";
+            }
+
+            ids += fmt::format("'{}'", id);
+        }
+
+        const auto gql = fmt::format("select DATA_COLL_ID, DATA_NAME, DATA_ID, DATA_MODE, DATA_SIZE, "
+                                     "DATA_CREATE_TIME, DATA_MODIFY_TIME "
+                                     "where DATA_COLL_ID in ({})", ids);
+
+        irods::experimental::query_builder qb;
+
+        if (!bulk.zone.empty()) {
+            qb.zone_hint(bulk.zone);
+        }
+
+        // Each replica produces a row. Only the first row of a data object is kept.
+        std::unordered_set<std::string> seen;
+
+        for (auto&& row : qb.build(*bulk.comm, gql)) {
+            const auto offset = offsets.find(row[0]);
+
+            if (offset == std::end(offsets) || !seen.insert(row[2]).second) {
+                continue;
+            }
+
+            auto& e = bulk.data_objects[offset->second].emplace_back();
+            e.path_ = bulk.collections[_index + offset->second].entry.path_ / row[1];
+            e.data_id_ = row[2];
+            e.data_mode_ = row[3].empty() ? 0 : static_cast<unsigned>(std::stoul(row[3]));
+            e.data_size_ = row[4].empty() ? 0 : static_cast<std::uintmax_t>(std::stoull(row[4]));
+            e.ctime_ = to_object_time(row[5]);
+            e.mtime_ = to_object_time(row[6]);
+            e.status_.type(object_type::data_object);
+
+            cache::detail::put_type(*bulk.comm, e.path_, object_type::data_object);
+        }
+    }
+
+    auto recursive_collection_iterator::bulk_end_of_subtree(std::size_t _index) const -> std::size_t
+    {
+        const auto& collections = ctx_->bulk->collections;
+
+        // The root contains every other collection.
+        if (_index == 0) {
+            return collections.size();
+        }
+
+        const auto prefix = collections[_index].entry.path_.string() + path::preferred_separator;
+        auto i = _index + 1;
+
+        while (i < collections.size() && starts_with(collections[i].entry.path_.string(), prefix)) {
+            ++i;
+        }
+
+        return i;
+    }
+} // namespace irods::experimental::filesystem::NAMESPACE_IMPL
@@ -7,4 +7,6 @@ API_PLUGIN_NUMBER(REPLICA_CLOSE_APN,                            20004)
 API_PLUGIN_NUMBER(ATOMIC_APPLY_ACL_OPERATIONS_APN,              20005)
 API_PLUGIN_NUMBER(DATA_OBJECT_FINALIZE_APN,                     20006)
 API_PLUGIN_NUMBER(TOUCH_APN,                                    20007)
+API_PLUGIN_NUMBER(REMOVE_ALL_APN,                               20008)
+API_PLUGIN_NUMBER(BULK_CHECKSUM_APN,                            20009)
 API_PLUGIN_NUMBER(ADAPTER_APN,                                  120000)
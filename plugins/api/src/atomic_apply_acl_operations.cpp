@@ -94,10 +94,13 @@ namespace
 
     auto remove_acl(nanodbc::connection& _db_conn, int _object_id, int _entity_id) -> void;
 
+    auto refresh_effective_access(nanodbc::connection& _db_conn, int _object_id, int _entity_id) -> void;
+
     auto execute_acl_operation(nanodbc::connection& _db_conn,
                                int _object_id,
                                const json& _operation,
-                               int _op_index) -> std::tuple<int, bytesBuf_t*>;
+                               int _op_index,
+                               bool _maintain_effective_access) -> std::tuple<int, bytesBuf_t*>;
 
     auto rs_atomic_apply_acl_operations(rsComm_t*, bytesBuf_t*, bytesBuf_t**) -> int;
 
@@ -317,6 +320,31 @@ namespace
         execute(stmt);
     }
 
+    auto refresh_effective_access(nanodbc::connection& _db_conn, int _object_id, int _entity_id) -> void
+    {
+        // Recompute the access the entity (or the members of the group) has to the object.
+        nanodbc::statement stmt{_db_conn};
+
+        prepare(stmt, "delete from R_OBJT_ACCESS_EFFECTIVE "
+                      "where object_id = ? and user_id in (select user_id from R_USER_GROUP where group_user_id = ?)");
+
+        stmt.bind(0, &_object_id);
+        stmt.bind(1, &_entity_id);
+
+        execute(stmt);
+
+        prepare(stmt, "insert into R_OBJT_ACCESS_EFFECTIVE (user_id, object_id, access_type_id) "
+                      "select UG.user_id, OA.object_id, max(OA.access_type_id) from R_OBJT_ACCESS OA, R_USER_GROUP UG, R_USER_MAIN UM "
+                      "where UG.group_user_id = OA.user_id and UM.user_id = UG.user_id and UM.user_type_name != 'rodsgroup' "
+                      "and OA.object_id = ? and UG.user_id in (select user_id from R_USER_GROUP where group_user_id = ?) "
+                      "group by UG.user_id, OA.object_id");
+
+        stmt.bind(0, &_object_id);
+        stmt.bind(1, &_entity_id);
+
+        execute(stmt);
+    }
+
     // TODO This function should probably deal with remote zones.
     auto get_entity_id(nanodbc::connection& _db_conn, std::string_view _entity_name) -> int
     {
@@ -336,7 +364,8 @@ namespace
     auto execute_acl_operation(nanodbc::connection& _db_conn,
                                int _object_id,
                                const json& _op,
-                               int _op_index) -> std::tuple<int, bytesBuf_t*>
+                               int _op_index,
+                               bool _maintain_effective_access) -> std::tuple<int, bytesBuf_t*>
     {
         try {
             log::api::trace("Checking if ACL is valid ...");
@@ -357,6 +386,10 @@ namespace
                 insert_acl(_db_conn, _object_id, entity_id, acl);
             }
 
+            if (_maintain_effective_access) {
+                refresh_effective_access(_db_conn, _object_id, entity_id);
+            }
+
             return {0, to_bytes_buffer("{}")};
         }
         catch (const irods::exception& e) {
@@ -474,6 +507,8 @@ namespace
 
         log::api::trace("Executing ACL operations ...");
 
+        const auto maintain_effective_access = ic::effective_access_index_enabled();
+
         return ic::execute_transaction(db_conn, [&](auto& _trans) -> int
         {
             try {
@@ -483,7 +518,8 @@ namespace
                     const auto [ec, bbuf] = execute_acl_operation(_trans.connection(),
                                                                   object_id,
                                                                   operations[i],
-                                                                  i);
+                                                                  i,
+                                                                  maintain_effective_access);
 
                     if (ec != 0) {
                         *_output = bbuf;
@@ -48,6 +48,11 @@
 #include <tuple>
 #include <chrono>
 #include <system_error>
+#include <vector>
+#include <map>
+#include <optional>
+#include <set>
+#include <algorithm>
 
 namespace
 {
@@ -58,8 +63,29 @@ namespace
     using log       = irods::experimental::log;
     using json      = nlohmann::json;
     using operation = std::function<int(rsComm_t*, bytesBuf_t*, bytesBuf_t**)>;
+
+    using metadata_key = std::tuple<std::string, std::string, std::string>;
     // clang-format on
 
+    // The maximum number of rows affected by a single generated SQL statement. This
+    // keeps the number of bind parameters well below the limits of every supported
+    // database while still collapsing large requests into a handful of round trips.
+    constexpr std::size_t max_rows_per_statement = 100;
+
+    struct metadata_operation
+    {
+        std::string op_code;
+        fs::metadata metadata;
+    };
+
+    // Holds the AVUs that must be attached to or detached from the target object once
+    // all operations in the request have been applied, in the order they first appeared.
+    struct grouped_metadata_operations
+    {
+        std::vector<fs::metadata> add;
+        std::vector<fs::metadata> remove;
+    };
+
     //
     // Function Prototypes
     //
@@ -76,21 +102,38 @@ namespace
 
     auto get_object_id(rsComm_t& _comm, const std::string& _entity_name, const ic::entity_type _entity_type) -> int;
 
-    auto get_meta_id(nanodbc::connection& _db_conn, const fs::metadata& _metadata) -> int;
+    auto to_metadata_key(const fs::metadata& _metadata) -> metadata_key;
+
+    auto make_timestamp() -> std::string;
+
+    auto parse_metadata_operation(const json& _op) -> metadata_operation;
+
+    auto group_metadata_operations(const std::vector<metadata_operation>& _ops) -> grouped_metadata_operations;
 
-    auto is_metadata_attached_to_object(nanodbc::connection& _db_conn, int _object_id, int _meta_id) -> bool;
+    auto get_meta_ids(nanodbc::connection& _db_conn, const std::vector<fs::metadata>& _metadata) -> std::map<metadata_key, int>;
 
-    auto insert_metadata(nanodbc::connection& _db_conn, std::string_view _db_instance_name, const fs::metadata& _metadata) -> int;
+    auto insert_metadata(nanodbc::connection& _db_conn,
+                         std::string_view _db_instance_name,
+                         const std::vector<fs::metadata>& _metadata) -> void;
 
-    auto attach_metadata_to_object(nanodbc::connection& _db_conn, int _object_id, int _meta_id) -> void;
+    auto get_attached_meta_ids(nanodbc::connection& _db_conn, int _object_id, const std::vector<int>& _meta_ids) -> std::set<int>;
 
-    auto detach_metadata_from_object(nanodbc::connection& _db_conn, int _object_id, int _meta_id) -> void;
+    auto attach_metadata_to_object(nanodbc::connection& _db_conn,
+                                   std::string_view _db_instance_name,
+                                   int _object_id,
+                                   const std::vector<int>& _meta_ids) -> void;
 
-    auto execute_metadata_operation(nanodbc::connection& _db_conn,
-                                    std::string_view _db_instance_name,
-                                    int _object_id,
-                                    const json& _operation,
-                                    int _op_index) -> std::tuple<int, bytesBuf_t*>;
+    auto detach_metadata_from_object(nanodbc::connection& _db_conn, int _object_id, const std::vector<int>& _meta_ids) -> void;
+
+    auto execute_metadata_operations(nanodbc::connection& _db_conn,
+                                     std::string_view _db_instance_name,
+                                     int _object_id,
+                                     const grouped_metadata_operations& _ops) -> void;
+
+    auto find_failing_operation(nanodbc::connection& _db_conn,
+                                std::string_view _db_instance_name,
+                                int _object_id,
+                                const std::vector<metadata_operation>& _ops) -> std::optional<std::tuple<int, std::string>>;
 
     auto rs_atomic_apply_metadata_operations(rsComm_t*, bytesBuf_t*, bytesBuf_t**) -> int;
 
@@ -187,193 +230,339 @@ namespace
         throw std::runtime_error{fmt::format("Entity does not exist [entity_name => {}]", _entity_name)};
     }
 
-    auto get_meta_id(nanodbc::connection& _db_conn, const fs::metadata& _metadata) -> int
+    auto to_metadata_key(const fs::metadata& _metadata) -> metadata_key
+    {
+        return {_metadata.attribute, _metadata.value, _metadata.units};
+    }
+
+    auto make_timestamp() -> std::string
+    {
+        using std::chrono::system_clock;
+        using std::chrono::duration_cast;
+        using std::chrono::seconds;
+
+        return fmt::format("{:011}", duration_cast<seconds>(system_clock::now().time_since_epoch()).count());
+    }
+
+    auto parse_metadata_operation(const json& _op) -> metadata_operation
     {
-        nanodbc::statement stmt{_db_conn};
+        metadata_operation op;
+
+        op.op_code = _op.at("operation").get<std::string>();
+        op.metadata.attribute = _op.at("attribute").get<std::string>();
+        op.metadata.value = _op.at("value").get<std::string>();
+
+        // "units" are optional.
+        if (_op.count("units")) {
+            op.metadata.units = _op.at("units").get<std::string>();
+        }
+
+        if (op.op_code != "add" && op.op_code != "remove") {
+            throw std::invalid_argument{"Invalid metadata operation."};
+        }
+
+        return op;
+    }
 
-        prepare(stmt, "select meta_id from R_META_MAIN "
-                      "where"
-                      " meta_attr_name = ? and"
-                      " meta_attr_value = ? and"
-                      " meta_attr_unit = ?");
+    auto group_metadata_operations(const std::vector<metadata_operation>& _ops) -> grouped_metadata_operations
+    {
+        // Only the last operation targeting a specific AVU determines whether that AVU is
+        // attached to the object when the transaction commits. Collapsing the operations this
+        // way allows them to be applied as sets while producing the same final state as
+        // applying them one at a time.
+        std::vector<metadata_key> order;
+        std::map<metadata_key, const metadata_operation*> last_op;
+
+        for (auto&& op : _ops) {
+            auto key = to_metadata_key(op.metadata);
+
+            if (auto [iter, inserted] = last_op.try_emplace(key, &op); !inserted) {
+                iter->second = &op;
+            }
+            else {
+                order.push_back(std::move(key));
+            }
+        }
 
-        stmt.bind(0, _metadata.attribute.c_str());
-        stmt.bind(1, _metadata.value.c_str());
-        stmt.bind(2, _metadata.units.c_str());
+        grouped_metadata_operations grouped;
 
-        if (auto row = execute(stmt); row.next()) {
-            return row.get<int>(0);
+        for (auto&& key : order) {
+            const auto* op = last_op.at(key);
+            auto& group = (op->op_code == "add") ? grouped.add : grouped.remove;
+            group.push_back(op->metadata);
         }
 
-        return -1;
+        return grouped;
     }
 
-    auto is_metadata_attached_to_object(nanodbc::connection& _db_conn, int _object_id, int _meta_id) -> bool
+    auto get_meta_ids(nanodbc::connection& _db_conn, const std::vector<fs::metadata>& _metadata) -> std::map<metadata_key, int>
     {
-        nanodbc::statement stmt{_db_conn};
+        std::map<metadata_key, int> meta_ids;
+
+        for (std::size_t offset = 0; offset < _metadata.size(); offset += max_rows_per_statement) {
+            const auto count = std::min(max_rows_per_statement, _metadata.size() - offset);
+
+            std::string sql = "select meta_id, meta_attr_name, meta_attr_value, meta_attr_unit from R_META_MAIN where ";
+
+            for (std::size_t i = 0; i < count; ++i) {
+                if (i > 0) {
+                    sql += " or ";
+                }
+
+                sql += "(meta_attr_name = ? and meta_attr_value = ? and meta_attr_unit = ?)";
+            }
 
-        prepare(stmt, "select count(*) from R_OBJT_METAMAP where object_id = ? and meta_id = ?");
+            nanodbc::statement stmt{_db_conn};
 
-        stmt.bind(0, &_object_id);
-        stmt.bind(1, &_meta_id);
+            prepare(stmt, sql);
 
-        if (auto row = execute(stmt); row.next()) {
-            return row.get<int>(0) > 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto& md = _metadata[offset + i];
+                const auto param = static_cast<short>(i * 3);
+
+                stmt.bind(param, md.attribute.c_str());
+                stmt.bind(param + 1, md.value.c_str());
+                stmt.bind(param + 2, md.units.c_str());
+            }
+
+            for (auto row = execute(stmt); row.next();) {
+                // Duplicate AVUs may exist in R_META_MAIN. The first one found wins.
+                meta_ids.try_emplace({row.get<std::string>(1), row.get<std::string>(2), row.get<std::string>(3, "")},
+                                     row.get<int>(0));
+            }
         }
 
-        return false;
+        return meta_ids;
     }
 
-    auto insert_metadata(nanodbc::connection& _db_conn, std::string_view _db_instance_name, const fs::metadata& _metadata) -> int
+    auto insert_metadata(nanodbc::connection& _db_conn,
+                         std::string_view _db_instance_name,
+                         const std::vector<fs::metadata>& _metadata) -> void
     {
-        nanodbc::statement stmt{_db_conn};
+        std::string_view next_object_id;
 
         if (_db_instance_name == "oracle") {
-            prepare(stmt, "insert into R_META_MAIN (meta_id, meta_attr_name, meta_attr_value, meta_attr_unit, create_ts, modify_ts) "
-                          "values (select R_OBJECTID.nextval from DUAL, ?, ?, ?, ?, ?)");
+            next_object_id = "R_OBJECTID.nextval";
         }
         else if (_db_instance_name == "mysql") {
-            prepare(stmt, "insert into R_META_MAIN (meta_id, meta_attr_name, meta_attr_value, meta_attr_unit, create_ts, modify_ts) "
-                          "values (R_OBJECTID_nextval(), ?, ?, ?, ?, ?)");
+            next_object_id = "R_OBJECTID_nextval()";
         }
         else if (_db_instance_name == "postgres") {
-            prepare(stmt, "insert into R_META_MAIN (meta_id, meta_attr_name, meta_attr_value, meta_attr_unit, create_ts, modify_ts) "
-                          "values (nextval('R_OBJECTID'), ?, ?, ?, ?, ?)");
+            next_object_id = "nextval('R_OBJECTID')";
         }
         else {
             throw std::runtime_error{"Invalid database plugin configuration"};
         }
 
-        using std::chrono::system_clock;
-        using std::chrono::duration_cast;
-        using std::chrono::seconds;
+        // Oracle does not support multi-row VALUES clauses and evaluates NEXTVAL only once
+        // per INSERT ALL statement, so its rows must be inserted one at a time.
+        const auto rows_per_statement = (_db_instance_name == "oracle") ? 1 : max_rows_per_statement;
+        const auto timestamp = make_timestamp();
+
+        for (std::size_t offset = 0; offset < _metadata.size(); offset += rows_per_statement) {
+            const auto count = std::min(rows_per_statement, _metadata.size() - offset);
 
-        const auto timestamp = fmt::format("{:011}", duration_cast<seconds>(system_clock::now().time_since_epoch()).count());
+            std::string sql = "insert into R_META_MAIN (meta_id, meta_attr_name, meta_attr_value, meta_attr_unit, create_ts, modify_ts) values ";
 
-        stmt.bind(0, _metadata.attribute.c_str());
-        stmt.bind(1, _metadata.value.c_str());
-        stmt.bind(2, _metadata.units.c_str());
-        stmt.bind(3, timestamp.c_str());
-        stmt.bind(4, timestamp.c_str());
+            for (std::size_t i = 0; i < count; ++i) {
+                if (i > 0) {
+                    sql += ", ";
+                }
+
+                sql += fmt::format("({}, ?, ?, ?, ?, ?)", next_object_id);
+            }
 
-        execute(stmt);
+            nanodbc::statement stmt{_db_conn};
+
+            prepare(stmt, sql);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto& md = _metadata[offset + i];
+                const auto param = static_cast<short>(i * 5);
+
+                stmt.bind(param, md.attribute.c_str());
+                stmt.bind(param + 1, md.value.c_str());
+                stmt.bind(param + 2, md.units.c_str());
+                stmt.bind(param + 3, timestamp.c_str());
+                stmt.bind(param + 4, timestamp.c_str());
+            }
 
-        return get_meta_id(_db_conn, _metadata);
+            execute(stmt);
+        }
     }
 
-    auto attach_metadata_to_object(nanodbc::connection& _db_conn, int _object_id, int _meta_id) -> void
+    auto get_attached_meta_ids(nanodbc::connection& _db_conn, int _object_id, const std::vector<int>& _meta_ids) -> std::set<int>
     {
-        nanodbc::statement stmt{_db_conn};
+        std::set<int> attached;
 
-        prepare(stmt, "insert into R_OBJT_METAMAP (object_id, meta_id, create_ts, modify_ts) "
-                      "values (?, ?, ?, ?)");
+        for (std::size_t offset = 0; offset < _meta_ids.size(); offset += max_rows_per_statement) {
+            const auto count = std::min(max_rows_per_statement, _meta_ids.size() - offset);
 
-        using std::chrono::system_clock;
-        using std::chrono::duration_cast;
-        using std::chrono::seconds;
+            const auto sql = fmt::format("select meta_id from R_OBJT_METAMAP where object_id = ? and meta_id in ({})",
+                                         fmt::join(std::vector<std::string_view>(count, "?"), ", "));
+
+            nanodbc::statement stmt{_db_conn};
 
-        const auto timestamp = fmt::format("{:011}", duration_cast<seconds>(system_clock::now().time_since_epoch()).count());
+            prepare(stmt, sql);
 
-        stmt.bind(0, &_object_id);
-        stmt.bind(1, &_meta_id);
-        stmt.bind(2, timestamp.c_str());
-        stmt.bind(3, timestamp.c_str());
+            stmt.bind(0, &_object_id);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                stmt.bind(static_cast<short>(i + 1), &_meta_ids[offset + i]);
+            }
+
+            for (auto row = execute(stmt); row.next();) {
+                attached.insert(row.get<int>(0));
+            }
+        }
 
-        execute(stmt);
+        return attached;
     }
 
-    auto detach_metadata_from_object(nanodbc::connection& _db_conn, int _object_id, int _meta_id) -> void
+    auto attach_metadata_to_object(nanodbc::connection& _db_conn,
+                                   std::string_view _db_instance_name,
+                                   int _object_id,
+                                   const std::vector<int>& _meta_ids) -> void
     {
-        nanodbc::statement stmt{_db_conn};
+        // AVUs already attached to the object are skipped, so adding them again is not an error.
+        const auto attached = get_attached_meta_ids(_db_conn, _object_id, _meta_ids);
+
+        std::vector<int> meta_ids;
+        meta_ids.reserve(_meta_ids.size());
+
+        for (auto id : _meta_ids) {
+            if (attached.count(id) == 0) {
+                meta_ids.push_back(id);
+            }
+        }
+
+        // Oracle does not support multi-row VALUES clauses, so its rows must be inserted one at a time.
+        const auto rows_per_statement = (_db_instance_name == "oracle") ? 1 : max_rows_per_statement;
+        const auto timestamp = make_timestamp();
+
+        for (std::size_t offset = 0; offset < meta_ids.size(); offset += rows_per_statement) {
+            const auto count = std::min(rows_per_statement, meta_ids.size() - offset);
+
+            const auto sql = fmt::format("insert into R_OBJT_METAMAP (object_id, meta_id, create_ts, modify_ts) values {}",
+                                         fmt::join(std::vector<std::string_view>(count, "(?, ?, ?, ?)"), ", "));
+
+            nanodbc::statement stmt{_db_conn};
 
-        prepare(stmt, "delete from R_OBJT_METAMAP where object_id = ? and meta_id = ?");
+            prepare(stmt, sql);
 
-        stmt.bind(0, &_object_id);
-        stmt.bind(1, &_meta_id);
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto param = static_cast<short>(i * 4);
 
-        execute(stmt);
+                stmt.bind(param, &_object_id);
+                stmt.bind(param + 1, &meta_ids[offset + i]);
+                stmt.bind(param + 2, timestamp.c_str());
+                stmt.bind(param + 3, timestamp.c_str());
+            }
+
+            execute(stmt);
+        }
     }
 
-    auto execute_metadata_operation(nanodbc::connection& _db_conn,
-                                    std::string_view _db_instance_name,
-                                    int _object_id,
-                                    const json& _op,
-                                    int _op_index) -> std::tuple<int, bytesBuf_t*>
+    auto detach_metadata_from_object(nanodbc::connection& _db_conn, int _object_id, const std::vector<int>& _meta_ids) -> void
     {
-        try {
-            fs::metadata md;
+        for (std::size_t offset = 0; offset < _meta_ids.size(); offset += max_rows_per_statement) {
+            const auto count = std::min(max_rows_per_statement, _meta_ids.size() - offset);
+
+            const auto sql = fmt::format("delete from R_OBJT_METAMAP where object_id = ? and meta_id in ({})",
+                                         fmt::join(std::vector<std::string_view>(count, "?"), ", "));
 
-            md.attribute = _op.at("attribute").get<std::string>();
-            md.value = _op.at("value").get<std::string>();
+            nanodbc::statement stmt{_db_conn};
 
-            // "units" are optional.
-            if (_op.count("units")) {
-                md.units = _op.at("units").get<std::string>();
+            prepare(stmt, sql);
+
+            stmt.bind(0, &_object_id);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                stmt.bind(static_cast<short>(i + 1), &_meta_ids[offset + i]);
             }
 
-            if (const auto op_code = _op.at("operation").get<std::string>(); op_code == "add") {
-                if (auto meta_id = get_meta_id(_db_conn, md); meta_id > -1) {
-                    if (!is_metadata_attached_to_object(_db_conn, _object_id, meta_id)) {
-                        attach_metadata_to_object(_db_conn, _object_id, meta_id);
-                    }
-                }
-                else if (meta_id = insert_metadata(_db_conn, _db_instance_name, md); meta_id > -1) {
-                    attach_metadata_to_object(_db_conn, _object_id, meta_id);
-                }
-                else {
-                    const auto msg = fmt::format("Failed to insert metadata [attribute => {}, value => {}, units => {}]",
-                                                 md.attribute, md.value, md.units);
-                    return {SYS_INTERNAL_ERR, to_bytes_buffer(make_error_object(_op, _op_index, msg).dump())};
+            execute(stmt);
+        }
+    }
+
+    auto execute_metadata_operations(nanodbc::connection& _db_conn,
+                                     std::string_view _db_instance_name,
+                                     int _object_id,
+                                     const grouped_metadata_operations& _ops) -> void
+    {
+        if (!_ops.remove.empty()) {
+            const auto meta_ids = get_meta_ids(_db_conn, _ops.remove);
+
+            std::vector<int> ids;
+            ids.reserve(meta_ids.size());
+
+            // AVUs missing from R_META_MAIN cannot be attached to the object, so there is nothing to detach.
+            for (auto&& md : _ops.remove) {
+                if (auto iter = meta_ids.find(to_metadata_key(md)); iter != std::end(meta_ids)) {
+                    ids.push_back(iter->second);
                 }
             }
-            else if (op_code == "remove") {
-                if (const auto meta_id = get_meta_id(_db_conn, md); meta_id > -1) {
-                    detach_metadata_from_object(_db_conn, _object_id, meta_id);
+
+            detach_metadata_from_object(_db_conn, _object_id, ids);
+        }
+
+        if (!_ops.add.empty()) {
+            auto meta_ids = get_meta_ids(_db_conn, _ops.add);
+
+            std::vector<fs::metadata> missing;
+
+            for (auto&& md : _ops.add) {
+                if (meta_ids.find(to_metadata_key(md)) == std::end(meta_ids)) {
+                    missing.push_back(md);
                 }
             }
-            else {
-                // clang-format off
-                log::api::error({{"log_message", "Invalid metadata operation"},
-                                 {"metadata_operation", _op.dump()}});
-                // clang-format on
 
-                return {INVALID_OPERATION, to_bytes_buffer(make_error_object(_op, _op_index, "Invalid metadata operation.").dump())};
+            if (!missing.empty()) {
+                insert_metadata(_db_conn, _db_instance_name, missing);
+                meta_ids.merge(get_meta_ids(_db_conn, missing));
             }
 
-            return {0, to_bytes_buffer("{}")};
-        }
-        catch (const fs::filesystem_error& e) {
-            // clang-format off
-            log::api::error({{"log_message", e.what()},
-                             {"metadata_operation", _op.dump()}});
-            // clang-format on
+            std::vector<int> ids;
+            ids.reserve(_ops.add.size());
 
-            return {e.code().value(), to_bytes_buffer(make_error_object(_op, _op_index, e.what()).dump())};
-        }
-        catch (const json::out_of_range& e) {
-            // clang-format off
-            log::api::error({{"log_message", e.what()},
-                             {"metadata_operation", _op.dump()}});
-            // clang-format on
+            for (auto&& md : _ops.add) {
+                if (auto iter = meta_ids.find(to_metadata_key(md)); iter != std::end(meta_ids)) {
+                    ids.push_back(iter->second);
+                }
+                else {
+                    throw std::runtime_error{fmt::format("Failed to insert metadata [attribute => {}, value => {}, units => {}]",
+                                                         md.attribute, md.value, md.units)};
+                }
+            }
 
-            return {SYS_INTERNAL_ERR, to_bytes_buffer(make_error_object(_op, _op_index, e.what()).dump())};
+            attach_metadata_to_object(_db_conn, _db_instance_name, _object_id, ids);
         }
-        catch (const json::type_error& e) {
-            // clang-format off
-            log::api::error({{"log_message", e.what()},
-                             {"metadata_operation", _op.dump()}});
-            // clang-format on
+    }
 
-            return {SYS_INTERNAL_ERR, to_bytes_buffer(make_error_object(_op, _op_index, e.what()).dump())};
-        }
-        catch (const std::system_error& e) {
-            // clang-format off
-            log::api::error({{"log_message", e.what()},
-                             {"metadata_operation", _op.dump()}});
-            // clang-format on
+    auto find_failing_operation(nanodbc::connection& _db_conn,
+                                std::string_view _db_instance_name,
+                                int _object_id,
+                                const std::vector<metadata_operation>& _ops) -> std::optional<std::tuple<int, std::string>>
+    {
+        // The operations are replayed one at a time, in the order they were requested, within
+        // a transaction that is never committed. The first one rejected by the database is
+        // the one reported to the client.
+        nanodbc::transaction trans{_db_conn};
 
-            return {e.code().value(), to_bytes_buffer(make_error_object(_op, _op_index, e.what()).dump())};
+        for (std::size_t i = 0; i < _ops.size(); ++i) {
+            grouped_metadata_operations single;
+            auto& group = (_ops[i].op_code == "add") ? single.add : single.remove;
+            group.push_back(_ops[i].metadata);
+
+            try {
+                execute_metadata_operations(_db_conn, _db_instance_name, _object_id, single);
+            }
+            catch (const std::exception& e) {
+                return std::make_tuple(static_cast<int>(i), std::string{e.what()});
+            }
         }
+
+        return std::nullopt;
     }
 
     auto rs_atomic_apply_metadata_operations(rsComm_t* _comm, bytesBuf_t* _input, bytesBuf_t** _output) -> int
@@ -459,23 +648,50 @@ namespace
             return CAT_NO_ACCESS_PERMISSION;
         }
 
-        return ic::execute_transaction(db_conn, [&](auto& _trans) -> int
+        std::vector<metadata_operation> operations;
+
+        try {
+            const auto& ops = input.at("operations");
+
+            operations.reserve(ops.size());
+
+            for (json::size_type i = 0; i < ops.size(); ++i) {
+                try {
+                    operations.push_back(parse_metadata_operation(ops[i]));
+                }
+                catch (const std::invalid_argument& e) {
+                    // clang-format off
+                    log::api::error({{"log_message", e.what()},
+                                     {"metadata_operation", ops[i].dump()}});
+                    // clang-format on
+
+                    *_output = to_bytes_buffer(make_error_object(ops[i], i, e.what()).dump());
+                    return INVALID_OPERATION;
+                }
+                catch (const json::exception& e) {
+                    // clang-format off
+                    log::api::error({{"log_message", e.what()},
+                                     {"metadata_operation", ops[i].dump()}});
+                    // clang-format on
+
+                    *_output = to_bytes_buffer(make_error_object(ops[i], i, e.what()).dump());
+                    return SYS_INTERNAL_ERR;
+                }
+            }
+        }
+        catch (const json::exception& e) {
+            *_output = to_bytes_buffer(make_error_object(json{}, 0, e.what()).dump());
+            return SYS_INTERNAL_ERR;
+        }
+
+        const auto grouped_ops = group_metadata_operations(operations);
+
+        std::string error_msg;
+
+        const auto ec = ic::execute_transaction(db_conn, [&](auto& _trans) -> int
         {
             try {
-                const auto& operations = input.at("operations");
-
-                for (json::size_type i = 0; i < operations.size(); ++i) {
-                    const auto [ec, bbuf] = execute_metadata_operation(_trans.connection(),
-                                                                       db_instance_name,
-                                                                       object_id,
-                                                                       operations[i],
-                                                                       i);
-
-                    if (ec != 0) {
-                        *_output = bbuf;
-                        return ec;
-                    }
-                }
+                execute_metadata_operations(_trans.connection(), db_instance_name, object_id, grouped_ops);
 
                 _trans.commit();
 
@@ -483,11 +699,39 @@ namespace
 
                 return 0;
             }
-            catch (const json::type_error& e) {
-                *_output = to_bytes_buffer(make_error_object(json{}, 0, e.what()).dump());
+            catch (const std::system_error& e) {
+                log::api::error(e.what());
+                error_msg = e.what();
+                return e.code().value();
+            }
+            catch (const std::exception& e) {
+                log::api::error(e.what());
+                error_msg = e.what();
                 return SYS_INTERNAL_ERR;
             }
         });
+
+        if (ec == 0) {
+            return 0;
+        }
+
+        // The operations were applied as sets, so the error cannot be traced back to a single
+        // operation directly. Now that the transaction has been rolled back, the operations are
+        // replayed to find the one that failed.
+        try {
+            if (const auto failure = find_failing_operation(db_conn, db_instance_name, object_id, operations)) {
+                const auto& [op_index, op_error_msg] = *failure;
+                *_output = to_bytes_buffer(make_error_object(input.at("operations").at(op_index), op_index, op_error_msg).dump());
+                return ec;
+            }
+        }
+        catch (const std::exception& e) {
+            log::api::error(e.what());
+        }
+
+        *_output = to_bytes_buffer(make_error_object(json{}, 0, error_msg).dump());
+
+        return ec;
     }
 
     const operation op = rs_atomic_apply_metadata_operations;
@@ -0,0 +1,1278 @@
+#include "api_plugin_number.h"
+#include "rodsDef.h"
+#include "rcConnect.h"
+#include "rodsPackInstruct.h"
+#include "apiHandler.hpp"
+#include "client_api_whitelist.hpp"
+
+#include <functional>
+
+#ifdef RODS_SERVER
+
+//
+// Server-side Implementation
+//
+
+#include "bulk_checksum.h"
+
+#include "rcMisc.h"
+#include "rodsErrorTable.h"
+#include "rodsConnect.h"
+#include "objInfo.h"
+#include "procApiRequest.h"
+#include "fileChksum.h"
+#include "fileStat.h"
+#include "rsApiHandler.hpp"
+#include "rsFileChksum.hpp"
+#include "rsFileStat.hpp"
+#include "rsGlobalExtern.hpp"
+#include "icatDefines.h"
+#include "sockComm.h"
+#include "sslSockComm.h"
+#include "catalog.hpp"
+#include "catalog_utilities.hpp"
+#include "connection_pool.hpp"
+#include "thread_pool.hpp"
+#include "irods_client_server_negotiation.hpp"
+#include "irods_configuration_keywords.hpp"
+#include "irods_database_constants.hpp"
+#include "irods_exception.hpp"
+#include "irods_logger.hpp"
+#include "irods_re_namespaceshelper.hpp"
+#include "irods_re_plugin.hpp"
+#include "irods_re_ruleexistshelper.hpp"
+#include "irods_re_structs.hpp"
+#include "irods_resource_backport.hpp"
+#include "irods_resource_constants.hpp"
+#include "irods_rs_comm_query.hpp"
+#include "irods_server_api_call.hpp"
+#include "irods_server_properties.hpp"
+
+#define IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
+#include "filesystem.hpp"
+
+#include "fmt/format.h"
+#include "json.hpp"
+#include "nanodbc/nanodbc.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+/*
+ The expected JSON format:
+ ~~~~~~~~~~~~~~~~~~~~~~~~~
+ {
+     // Must be an absolute path to a collection.
+     // Cannot be used with "data_objects".
+     "logical_path": string,
+
+     // Absolute paths to data objects.
+     // Cannot be used with "logical_path".
+     "data_objects": [string],
+
+     // Optional set of options.
+     // Allowed to be empty.
+     // Not required to exist.
+     "options": {
+         // Defaults to false.
+         "verify": boolean,
+
+         // Defaults to false.
+         "force": boolean,
+
+         // Defaults to false.
+         "admin": boolean,
+
+         // Must be greater than zero.
+         // Defaults to 4.
+         "thread_count": integer,
+
+         // Must be greater than zero.
+         // Defaults to 2.
+         "max_concurrent_per_resource": integer
+     }
+ }
+*/
+
+namespace
+{
+    // clang-format off
+    namespace fs = irods::experimental::filesystem;
+    namespace ic = irods::experimental::catalog;
+
+    using json      = nlohmann::json;
+    using log       = irods::experimental::log;
+    using operation = std::function<int(rsComm_t*, bytesBuf_t*, collOprStat_t**)>;
+
+    using rule_engine_context_manager_type = irods::rule_engine_context_manager<irods::unit, ruleExecInfo_t*, irods::AUDIT_RULE>;
+
+    // JSON Input Properties
+    constexpr std::string_view prop_logical_path                = "logical_path";
+    constexpr std::string_view prop_data_objects                = "data_objects";
+    constexpr std::string_view prop_options                     = "options";
+    constexpr std::string_view prop_verify                      = "verify";
+    constexpr std::string_view prop_force                       = "force";
+    constexpr std::string_view prop_admin                       = "admin";
+    constexpr std::string_view prop_thread_count                = "thread_count";
+    constexpr std::string_view prop_max_concurrent_per_resource = "max_concurrent_per_resource";
+    // clang-format on
+
+    constexpr int default_thread_count = 4;
+
+    constexpr int default_max_concurrent_per_resource = 2;
+
+    // Upper bounds applied to the client's options unless the server configuration sets others.
+    constexpr int default_maximum_thread_count = 16;
+
+    constexpr int default_maximum_concurrent_per_resource = 4;
+
+    // The maximum number of rows affected by a single generated SQL statement.
+    constexpr std::size_t max_rows_per_statement = 100;
+
+    // The number of replicas read from the catalog and checksummed per round. Progress
+    // is reported to the client once per round.
+    constexpr std::size_t replicas_per_batch = 1000;
+
+    // Batches with fewer checksums than this are handled on the agent's own connection.
+    // Connecting the workers costs more than it saves.
+    constexpr std::size_t min_checksums_for_worker_pool = 8;
+
+    // The character used to escape LIKE wildcards in logical paths.
+    constexpr char like_escape_char = '!';
+
+    // Policy the bulk path never invokes because it does not go through rsDataObjChksum or
+    // rsModDataObjMeta. Requests are left to rsDataObjChksum while any of these are configured.
+    const std::array<std::string, 3> bypassed_policy{
+        "api_data_obj_chksum",
+        "api_mod_data_obj_meta",
+        irods::DATABASE_OP_MOD_DATA_OBJ_META
+    };
+
+    struct checksum_options
+    {
+        bool verify = false;
+        bool force = false;
+        bool admin = false;
+        int thread_count = default_thread_count;
+        int max_concurrent_per_resource = default_max_concurrent_per_resource;
+    }; // struct checksum_options
+
+    struct replica_info
+    {
+        std::string data_id;
+        std::string replica_number;
+        std::string logical_path;
+        std::string physical_path;
+        rodsLong_t resource_id = 0;
+        rodsLong_t size = 0;
+        std::string checksum;
+        std::string modify_time;
+        std::string resource_hierarchy;
+
+        // Set for replicas that are not good or live in a bundle resource. Like
+        // rsDataObjChksum, these are only counted.
+        bool skipped = false;
+    }; // struct replica_info
+
+    struct checksum_task
+    {
+        replica_info* replica{};
+        fileChksumInp_t input;
+        std::string checksum;
+        int status = SYS_INTERNAL_ERR;
+
+        // Only set when verifying.
+        rodsLong_t physical_size = -1;
+        int stat_status = 0;
+    }; // struct checksum_task
+
+    // State shared by all batches of a single request.
+    struct checksum_context
+    {
+        rsComm_t& comm;
+        nanodbc::connection& db_conn;
+        std::string_view db_instance_name;
+        const checksum_options& options;
+        collOprStat_t** output;
+        int total_replicas = 0;
+        int replicas_done = 0;
+        rodsLong_t bytes_done = 0;
+        int error = 0;
+
+        // Created on first use so that small requests never pay for extra connections.
+        std::shared_ptr<irods::connection_pool> conn_pool;
+        std::size_t conn_pool_size = 0;
+    }; // struct checksum_context
+
+    //
+    // Function Prototypes
+    //
+
+    auto call_bulk_checksum(irods::api_entry* _api, rsComm_t* _comm, bytesBuf_t* _input, collOprStat_t** _output) -> int;
+
+    auto parse_json(const bytesBuf_t* _bbuf) -> json;
+
+    auto get_advanced_setting_or(const std::string& _name, int _default) -> int;
+
+    auto parse_options(const json& _json_input) -> checksum_options;
+
+    auto make_limit_clause(std::string_view _db_instance_name, std::size_t _count) -> std::string;
+
+    auto escape_like_pattern(std::string_view _s) -> std::string;
+
+    auto subtree_condition(std::string_view _alias) -> std::string;
+
+    auto access_condition(checksum_context& _ctx, std::vector<std::string>& _bind_args) -> std::string;
+
+    auto bypassed_policy_is_configured(rsComm_t& _comm) -> bool;
+
+    auto count_rows(checksum_context& _ctx, const std::string& _sql, const std::vector<std::string>& _bind_args) -> int;
+
+    auto read_replicas(checksum_context& _ctx, const std::string& _sql, const std::vector<std::string>& _bind_args)
+        -> std::vector<replica_info>;
+
+    auto fetch_replicas(checksum_context& _ctx, const fs::path& _path, const std::string& _last_data_id)
+        -> std::vector<replica_info>;
+
+    auto fetch_replicas(checksum_context& _ctx, const std::vector<std::string>& _paths) -> std::vector<replica_info>;
+
+    auto report(checksum_context& _ctx, int _ec, const std::string& _msg) -> void;
+
+    auto make_checksum_task(checksum_context& _ctx, replica_info& _replica) -> std::optional<checksum_task>;
+
+    auto compute_checksum(rsComm_t* _rs_comm, rcComm_t* _rc_comm, bool _verify, checksum_task& _task) -> void;
+
+    auto compute_checksums(checksum_context& _ctx, std::vector<checksum_task*>& _tasks) -> void;
+
+    auto update_checksums(checksum_context& _ctx, const std::vector<checksum_task*>& _tasks) -> int;
+
+    auto send_progress(checksum_context& _ctx, const std::string& _last_path) -> int;
+
+    auto checksum_batch(checksum_context& _ctx, std::vector<replica_info>& _replicas) -> int;
+
+    auto checksum_subtree(checksum_context& _ctx, const fs::path& _path) -> int;
+
+    auto checksum_data_objects(checksum_context& _ctx, const std::vector<std::string>& _paths) -> int;
+
+    auto forward_progress(rsComm_t& _comm, rcComm_t& _conn, collOprStat_t* _stat, int _ec) -> int;
+
+    auto rs_bulk_checksum(rsComm_t* _comm, bytesBuf_t* _input, collOprStat_t** _output) -> int;
+
+    //
+    // Function Implementations
+    //
+
+    auto call_bulk_checksum(irods::api_entry* _api, rsComm_t* _comm, bytesBuf_t* _input, collOprStat_t** _output) -> int
+    {
+        return _api->call_handler<bytesBuf_t*, collOprStat_t**>(_comm, _input, _output);
+    } // call_bulk_checksum
+
+    auto parse_json(const bytesBuf_t* _bbuf) -> json
+    {
+        if (!_bbuf || !_bbuf->buf) {
+            THROW(SYS_NULL_INPUT, "Could not parse string (null pointer) into JSON.");
+        }
+
+        try {
+            const std::string_view json_string(static_cast<const char*>(_bbuf->buf), _bbuf->len);
+            return json::parse(json_string);
+        }
+        catch (const json::exception& e) {
+            THROW(INPUT_ARG_NOT_WELL_FORMED_ERR, "Could not parse string into JSON.");
+        }
+    } // parse_json
+
+    auto get_advanced_setting_or(const std::string& _name, int _default) -> int
+    {
+        try {
+            const auto value = irods::get_advanced_setting<const int>(_name);
+            return value > 0 ? value : _default;
+        }
+        catch (const irods::exception&) {
+            return _default;
+        }
+    } // get_advanced_setting_or
+
+    auto parse_options(const json& _json_input) -> checksum_options
+    {
+        const auto lp_iter = _json_input.find(prop_logical_path.data());
+        const auto do_iter = _json_input.find(prop_data_objects.data());
+
+        if ((lp_iter == _json_input.end()) == (do_iter == _json_input.end())) {
+            THROW(INPUT_ARG_NOT_WELL_FORMED_ERR, fmt::format("Exactly one of [{}] and [{}] must be present.",
+                                                             prop_logical_path, prop_data_objects));
+        }
+
+        if (lp_iter != _json_input.end() && (!lp_iter->is_string() || lp_iter->get<std::string>().empty())) {
+            THROW(INPUT_ARG_NOT_WELL_FORMED_ERR, fmt::format("[{}] must be a non-empty string.", prop_logical_path));
+        }
+
+        if (do_iter != _json_input.end()) {
+            const auto is_valid_path = [](const json& _p) { return _p.is_string() && !_p.get<std::string>().empty(); };
+
+            if (!do_iter->is_array() || !std::all_of(do_iter->begin(), do_iter->end(), is_valid_path)) {
+                THROW(INPUT_ARG_NOT_WELL_FORMED_ERR, fmt::format("[{}] must be an array of non-empty strings.", prop_data_objects));
+            }
+        }
+
+        checksum_options opts;
+
+        const auto opts_iter = _json_input.find(prop_options.data());
+
+        if (opts_iter == _json_input.end()) {
+            return opts;
+        }
+
+        if (!opts_iter->is_object()) {
+            THROW(INPUT_ARG_NOT_WELL_FORMED_ERR, fmt::format("[{}] must be a JSON object.", prop_options));
+        }
+
+        try {
+            opts.verify = opts_iter->value(prop_verify.data(), false);
+            opts.force = opts_iter->value(prop_force.data(), false);
+            opts.admin = opts_iter->value(prop_admin.data(), false);
+            opts.thread_count = opts_iter->value(prop_thread_count.data(), default_thread_count);
+            opts.max_concurrent_per_resource = opts_iter->value(prop_max_concurrent_per_resource.data(),
+                                                                default_max_concurrent_per_resource);
+        }
+        catch (const json::exception&) {
+            THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Incorrect value type in [{}].", prop_options));
+        }
+
+        if (opts.verify && opts.force) {
+            THROW(USER_INCOMPATIBLE_PARAMS, fmt::format("[{}] and [{}] cannot be used together.", prop_verify, prop_force));
+        }
+
+        if (opts.thread_count <= 0) {
+            THROW(INPUT_ARG_NOT_WELL_FORMED_ERR, fmt::format("[{}] must be greater than zero.", prop_thread_count));
+        }
+
+        if (opts.max_concurrent_per_resource <= 0) {
+            THROW(INPUT_ARG_NOT_WELL_FORMED_ERR, fmt::format("[{}] must be greater than zero.", prop_max_concurrent_per_resource));
+        }
+
+        // Every worker holds a connection to this server, so the client cannot ask for more
+        // than the administrator allows.
+        opts.thread_count = std::min(opts.thread_count,
+                                     get_advanced_setting_or(irods::CFG_MAX_NUMBER_OF_BULK_CHECKSUM_THREADS,
+                                                             default_maximum_thread_count));
+        opts.max_concurrent_per_resource = std::min(opts.max_concurrent_per_resource,
+                                                    get_advanced_setting_or(irods::CFG_MAX_NUMBER_OF_CONCURRENT_CHECKSUMS_PER_RESOURCE,
+                                                                            default_maximum_concurrent_per_resource));
+
+        return opts;
+    } // parse_options
+
+    auto make_limit_clause(std::string_view _db_instance_name, std::size_t _count) -> std::string
+    {
+        if (_db_instance_name == "oracle") {
+            return fmt::format(" fetch first {} rows only", _count);
+        }
+
+        return fmt::format(" limit {}", _count);
+    } // make_limit_clause
+
+    auto escape_like_pattern(std::string_view _s) -> std::string
+    {
+        std::string escaped;
+        escaped.reserve(_s.size());
+
+        for (auto c : _s) {
+            if (c == like_escape_char || c == '%' || c == '_') {
+                escaped += like_escape_char;
+            }
+
+            escaped += c;
+        }
+
+        return escaped;
+    } // escape_like_pattern
+
+    // Matches the collection itself and every collection under it. Takes two bind
+    // arguments: the logical path and the LIKE pattern built from it.
+    auto subtree_condition(std::string_view _alias) -> std::string
+    {
+        return fmt::format("({0}.coll_name = ? or {0}.coll_name like ? escape '{1}')", _alias, like_escape_char);
+    } // subtree_condition
+
+    // Limits the replicas to those the client is allowed to read. Appends the bind arguments
+    // of the condition to "_bind_args".
+    auto access_condition(checksum_context& _ctx, std::vector<std::string>& _bind_args) -> std::string
+    {
+        if (_ctx.options.admin) {
+            return "1 = 1";
+        }
+
+        _bind_args.push_back(_ctx.comm.clientUser.userName);
+        _bind_args.push_back(_ctx.comm.clientUser.rodsZone);
+
+        return fmt::format("exists (select a.object_id from R_OBJT_ACCESS a, R_USER_GROUP ug, R_USER_MAIN u, R_TOKN_MAIN t "
+                           "where a.object_id = d.data_id and a.user_id = ug.group_user_id and ug.user_id = u.user_id and "
+                           "u.user_name = ? and u.zone_name = ? and a.access_type_id >= t.token_id and "
+                           "t.token_namespace = 'access_type' and t.token_name = '{}')",
+                           ACCESS_READ_OBJECT);
+    } // access_condition
+
+    auto bypassed_policy_is_configured(rsComm_t& _comm) -> bool
+    {
+        ruleExecInfo_t rei{};
+        rei.rsComm = &_comm;
+        rei.uoic = &_comm.clientUser;
+        rei.uoip = &_comm.proxyUser;
+
+        rule_engine_context_manager_type re_ctx_mgr(irods::re_plugin_globals->global_re_mgr, &rei);
+
+        for (auto&& ns : NamespacesHelper::Instance()->getNamespaces()) {
+            for (auto&& op : bypassed_policy) {
+                for (std::string_view cls : {"pre", "post", "except", "finally"}) {
+                    const auto rule_name = fmt::format("{}pep_{}_{}", ns, op, cls);
+                    bool exists = false;
+
+                    if (RuleExistsHelper::Instance()->checkOperation(rule_name) &&
+                        re_ctx_mgr.rule_exists(rule_name, exists).ok() && exists)
+                    {
+                        log::api::debug("Policy prevents bulk checksum [rule_name={}].", rule_name);
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    } // bypassed_policy_is_configured
+
+    auto count_rows(checksum_context& _ctx, const std::string& _sql, const std::vector<std::string>& _bind_args) -> int
+    {
+        nanodbc::statement stmt{_ctx.db_conn};
+
+        prepare(stmt, _sql);
+
+        for (std::size_t i = 0; i < _bind_args.size(); ++i) {
+            stmt.bind(static_cast<short>(i), _bind_args[i].c_str());
+        }
+
+        if (auto row = execute(stmt); row.next()) {
+            return row.get<int>(0);
+        }
+
+        return 0;
+    } // count_rows
+
+    // Runs a query built around the columns below and returns the replicas it finds. Replicas
+    // that are not good are marked as skipped. Replicas in bundle resources are left to the caller.
+    auto read_replicas(checksum_context& _ctx, const std::string& _sql, const std::vector<std::string>& _bind_args)
+        -> std::vector<replica_info>
+    {
+        nanodbc::statement stmt{_ctx.db_conn};
+
+        prepare(stmt, _sql);
+
+        for (std::size_t i = 0; i < _bind_args.size(); ++i) {
+            stmt.bind(static_cast<short>(i), _bind_args[i].c_str());
+        }
+
+        std::vector<replica_info> replicas;
+
+        for (auto row = execute(stmt); row.next();) {
+            auto& r = replicas.emplace_back();
+
+            r.data_id = row.get<std::string>(0);
+            r.replica_number = row.get<std::string>(1);
+            r.logical_path = (fs::path{row.get<std::string>(3)} / row.get<std::string>(2)).string();
+            r.physical_path = row.get<std::string>(4);
+            r.resource_id = std::stoll(row.get<std::string>(5));
+            r.size = std::stoll(row.get<std::string>(6, "0"));
+            r.checksum = row.get<std::string>(7, "");
+            r.modify_time = row.get<std::string>(8, "");
+            r.skipped = row.get<int>(9, GOOD_REPLICA) != GOOD_REPLICA;
+        }
+
+        return replicas;
+    } // read_replicas
+
+    // Returns the next batch of replicas under "_path" ordered by data id. All replicas of a
+    // data object are always returned in the same batch.
+    auto fetch_replicas(checksum_context& _ctx, const fs::path& _path, const std::string& _last_data_id)
+        -> std::vector<replica_info>
+    {
+        const auto query = [&](std::string_view _data_id_condition, std::string_view _limit_clause) {
+            std::vector<std::string> args{_path.string(), escape_like_pattern(_path.string()) + "/%", _last_data_id};
+            const auto access = access_condition(_ctx, args);
+
+            const auto sql = fmt::format("select d.data_id, d.data_repl_num, d.data_name, c.coll_name, d.data_path, "
+                                         "d.resc_id, d.data_size, d.data_checksum, d.modify_ts, d.data_is_dirty "
+                                         "from R_DATA_MAIN d inner join R_COLL_MAIN c on d.coll_id = c.coll_id "
+                                         "where {} and {} and {} "
+                                         "order by d.data_id, d.data_repl_num{}",
+                                         subtree_condition("c"), _data_id_condition, access, _limit_clause);
+
+            return read_replicas(_ctx, sql, args);
+        };
+
+        auto replicas = query("d.data_id > ?", make_limit_clause(_ctx.db_instance_name, replicas_per_batch));
+
+        if (replicas.size() < replicas_per_batch) {
+            return replicas;
+        }
+
+        // The limit may have cut the last data object's replicas in two. Leave that data
+        // object for the next batch, unless it is the only one in this batch.
+        const auto last_id = replicas.back().data_id;
+        const auto iter = std::find_if(replicas.begin(), replicas.end(), [&last_id](auto&& _r) { return _r.data_id == last_id; });
+
+        if (iter != replicas.begin()) {
+            replicas.erase(iter, replicas.end());
+            return replicas;
+        }
+
+        return query("d.data_id = ?", "");
+    } // fetch_replicas
+
+    // Returns the replicas of the data objects in "_paths". Data objects that do not exist or
+    // cannot be read by the client are reported.
+    auto fetch_replicas(checksum_context& _ctx, const std::vector<std::string>& _paths) -> std::vector<replica_info>
+    {
+        std::vector<replica_info> replicas;
+
+        for (std::size_t offset = 0; offset < _paths.size(); offset += max_rows_per_statement) {
+            const auto count = std::min(max_rows_per_statement, _paths.size() - offset);
+
+            std::vector<std::string> args;
+            args.reserve(count * 2 + 2);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const fs::path p = _paths[offset + i];
+                args.push_back(p.parent_path().string());
+                args.push_back(p.object_name().string());
+            }
+
+            const auto access = access_condition(_ctx, args);
+
+            const auto sql = fmt::format("select d.data_id, d.data_repl_num, d.data_name, c.coll_name, d.data_path, "
+                                         "d.resc_id, d.data_size, d.data_checksum, d.modify_ts, d.data_is_dirty "
+                                         "from R_DATA_MAIN d inner join R_COLL_MAIN c on d.coll_id = c.coll_id "
+                                         "where ({}) and {} "
+                                         "order by d.data_id, d.data_repl_num",
+                                         fmt::join(std::vector<std::string_view>(count, "(c.coll_name = ? and d.data_name = ?)"), " or "),
+                                         access);
+
+            auto found = read_replicas(_ctx, sql, args);
+
+            std::unordered_set<std::string_view> found_paths;
+
+            for (auto&& r : found) {
+                if (!r.skipped) {
+                    found_paths.insert(r.logical_path);
+                }
+            }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                if (found_paths.count(_paths[offset + i]) == 0) {
+                    report(_ctx, OBJ_PATH_DOES_NOT_EXIST,
+                           fmt::format("ERROR: No good replica found for data object [{}].", _paths[offset + i]));
+                    _ctx.error = OBJ_PATH_DOES_NOT_EXIST;
+                }
+            }
+
+            std::move(found.begin(), found.end(), std::back_inserter(replicas));
+        }
+
+        return replicas;
+    } // fetch_replicas
+
+    // Adds a line to the report sent to the client with the next progress message.
+    auto report(checksum_context& _ctx, int _ec, const std::string& _msg) -> void
+    {
+        addRErrorMsg(&_ctx.comm.rError, _ec, _msg.c_str());
+    } // report
+
+    // Returns the input for computing the checksum of the replica, or an empty optional if
+    // the replica must be skipped.
+    auto make_checksum_task(checksum_context& _ctx, replica_info& _replica) -> std::optional<checksum_task>
+    {
+        if (_ctx.options.verify && _replica.checksum.empty()) {
+            report(_ctx, CAT_NO_CHECKSUM_FOR_REPLICA,
+                   fmt::format("WARNING: No checksum available for replica [{}] of data object [{}].",
+                               _replica.replica_number, _replica.logical_path));
+            return std::nullopt;
+        }
+
+        if (!_ctx.options.verify && !_ctx.options.force && !_replica.checksum.empty()) {
+            return std::nullopt;
+        }
+
+        std::string resc_class;
+        if (const auto err = irods::get_resource_property<std::string>(_replica.resource_id, irods::RESOURCE_CLASS, resc_class); !err.ok()) {
+            THROW(err.code(), fmt::format("Failed to get resource class [resource_id={}]", _replica.resource_id));
+        }
+
+        if (resc_class == irods::RESOURCE_CLASS_BUNDLE) {
+            _replica.skipped = true;
+            return std::nullopt;
+        }
+
+        _replica.resource_hierarchy = resc_mgr.leaf_id_to_hier(_replica.resource_id);
+
+        if (const auto err = irods::is_hier_live(_replica.resource_hierarchy); !err.ok()) {
+            THROW(err.code(), fmt::format("Resource hierarchy is not available [resource_hierarchy={}]", _replica.resource_hierarchy));
+        }
+
+        std::string location;
+        if (const auto err = irods::get_loc_for_hier_string(_replica.resource_hierarchy, location); !err.ok()) {
+            THROW(err.code(), fmt::format("Failed to get host [resource_hierarchy={}]", _replica.resource_hierarchy));
+        }
+
+        checksum_task task{};
+        task.replica = &_replica;
+        rstrcpy(task.input.addr.hostAddr, location.c_str(), NAME_LEN);
+        rstrcpy(task.input.fileName, _replica.physical_path.c_str(), MAX_NAME_LEN);
+        rstrcpy(task.input.rescHier, _replica.resource_hierarchy.c_str(), MAX_NAME_LEN);
+        rstrcpy(task.input.objPath, _replica.logical_path.c_str(), MAX_NAME_LEN);
+
+        // Verification must use the scheme of the checksum in the catalog. New checksums
+        // use the default scheme of the server, just like rsDataObjChksum.
+        if (_ctx.options.verify) {
+            rstrcpy(task.input.orig_chksum, _replica.checksum.c_str(), NAME_LEN);
+        }
+
+        return task;
+    } // make_checksum_task
+
+    // Computes the checksum of a single replica through either the agent's connection or a
+    // connection owned by a worker. Exactly one of "_rs_comm" and "_rc_comm" is set.
+    auto compute_checksum(rsComm_t* _rs_comm, rcComm_t* _rc_comm, bool _verify, checksum_task& _task) -> void
+    {
+        char* checksum{};
+
+        _task.status = _rs_comm ? rsFileChksum(_rs_comm, &_task.input, &checksum)
+                                : rcFileChksum(_rc_comm, &_task.input, &checksum);
+
+        if (checksum) {
+            _task.checksum = checksum;
+            std::free(checksum);
+        }
+
+        if (!_verify || _task.status < 0) {
+            return;
+        }
+
+        fileStatInp_t stat_input{};
+        rstrcpy(stat_input.objPath, _task.input.objPath, MAX_NAME_LEN);
+        rstrcpy(stat_input.rescHier, _task.input.rescHier, MAX_NAME_LEN);
+        rstrcpy(stat_input.fileName, _task.input.fileName, MAX_NAME_LEN);
+        rstrcpy(stat_input.addr.hostAddr, _task.input.addr.hostAddr, NAME_LEN);
+
+        rodsStat_t* stat_output{};
+
+        _task.stat_status = _rs_comm ? rsFileStat(_rs_comm, &stat_input, &stat_output)
+                                     : rcFileStat(_rc_comm, &stat_input, &stat_output);
+
+        if (stat_output) {
+            _task.physical_size = stat_output->st_size;
+            std::free(stat_output);
+        }
+    } // compute_checksum
+
+    // Computes the checksums in parallel. The replicas of each resource are split into at
+    // most "max_concurrent_per_resource" lanes, and a lane is only ever worked on by one
+    // worker at a time. This bounds the number of replicas read from a resource at once no
+    // matter how many workers there are. Each worker owns a connection to this server
+    // because an agent's own connection cannot be shared between threads.
+    auto compute_checksums(checksum_context& _ctx, std::vector<checksum_task*>& _tasks) -> void
+    {
+        const auto verify = _ctx.options.verify;
+
+        if (_ctx.options.thread_count == 1 || _tasks.size() < min_checksums_for_worker_pool) {
+            for (auto* t : _tasks) {
+                compute_checksum(&_ctx.comm, nullptr, verify, *t);
+            }
+
+            return;
+        }
+
+        std::map<std::string_view, std::vector<checksum_task*>> tasks_by_resource;
+
+        for (auto* t : _tasks) {
+            tasks_by_resource[t->input.rescHier].push_back(t);
+        }
+
+        // Lanes are ordered so that the first lane of every resource comes before the second
+        // lane of any resource. This spreads the workers across resources.
+        std::vector<std::vector<std::vector<checksum_task*>>> lanes_by_resource;
+
+        for (auto&& [hier, tasks] : tasks_by_resource) {
+            const auto lane_count = std::min<std::size_t>(_ctx.options.max_concurrent_per_resource, tasks.size());
+            auto& lanes = lanes_by_resource.emplace_back(lane_count);
+
+            for (std::size_t i = 0; i < tasks.size(); ++i) {
+                lanes[i % lane_count].push_back(tasks[i]);
+            }
+        }
+
+        std::vector<std::vector<checksum_task*>> lanes;
+
+        for (std::size_t depth = 0; depth < static_cast<std::size_t>(_ctx.options.max_concurrent_per_resource); ++depth) {
+            for (auto&& resource_lanes : lanes_by_resource) {
+                if (depth < resource_lanes.size()) {
+                    lanes.push_back(std::move(resource_lanes[depth]));
+                }
+            }
+        }
+
+        const auto worker_count = std::min<std::size_t>(_ctx.options.thread_count, lanes.size());
+
+        // The pool only grows. Later batches may need fewer workers than earlier ones.
+        if (!_ctx.conn_pool || _ctx.conn_pool_size < worker_count) {
+            _ctx.conn_pool = irods::make_connection_pool(static_cast<int>(worker_count));
+            _ctx.conn_pool_size = worker_count;
+        }
+
+        std::mutex mtx;
+        std::size_t next_lane = 0;
+
+        irods::thread_pool pool{static_cast<int>(worker_count)};
+
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            irods::thread_pool::post(pool, [&_ctx, &lanes, &mtx, &next_lane, verify] {
+                try {
+                    auto conn = _ctx.conn_pool->get_connection();
+
+                    while (true) {
+                        std::vector<checksum_task*>* lane{};
+
+                        {
+                            std::lock_guard lk{mtx};
+
+                            if (next_lane == lanes.size()) {
+                                return;
+                            }
+
+                            lane = &lanes[next_lane++];
+                        }
+
+                        for (auto* t : *lane) {
+                            compute_checksum(nullptr, static_cast<rcComm_t*>(conn), verify, *t);
+                        }
+                    }
+                }
+                catch (const std::exception& e) {
+                    // The replicas this worker did not get to keep their initial error status
+                    // and are reported as failures.
+                    log::api::error("Checksum worker failed: {}", e.what());
+                }
+            });
+        }
+
+        pool.join();
+    } // compute_checksums
+
+    // Records the new checksums in the catalog, many replicas per statement. A replica is only
+    // updated if it is still good and has not been modified since it was read. Replicas that
+    // were not updated are reported and their tasks are marked as failed.
+    auto update_checksums(checksum_context& _ctx, const std::vector<checksum_task*>& _tasks) -> int
+    {
+        if (_tasks.empty()) {
+            return 0;
+        }
+
+        return ic::execute_transaction(_ctx.db_conn, [&](auto& _trans) -> int {
+            for (std::size_t offset = 0; offset < _tasks.size(); offset += max_rows_per_statement) {
+                const auto count = std::min(max_rows_per_statement, _tasks.size() - offset);
+                const std::string_view replica_condition = "(data_id = ? and data_repl_num = ?)";
+                const auto when_clause = fmt::format("when {} then ?", replica_condition);
+                const auto unchanged_condition = fmt::format("(data_id = ? and data_repl_num = ? and modify_ts = ? and data_is_dirty = {})",
+                                                             GOOD_REPLICA);
+
+                const auto sql = fmt::format("update R_DATA_MAIN set data_checksum = case {} end where {}",
+                                             fmt::join(std::vector<std::string_view>(count, when_clause), " "),
+                                             fmt::join(std::vector<std::string_view>(count, unchanged_condition), " or "));
+
+                nanodbc::statement stmt{_ctx.db_conn};
+
+                prepare(stmt, sql);
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto* t = _tasks[offset + i];
+                    const auto param = static_cast<short>(i * 3);
+
+                    stmt.bind(param, t->replica->data_id.c_str());
+                    stmt.bind(param + 1, t->replica->replica_number.c_str());
+                    stmt.bind(param + 2, t->checksum.c_str());
+                }
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto* t = _tasks[offset + i];
+                    const auto param = static_cast<short>(count * 3 + i * 3);
+
+                    stmt.bind(param, t->replica->data_id.c_str());
+                    stmt.bind(param + 1, t->replica->replica_number.c_str());
+                    stmt.bind(param + 2, t->replica->modify_time.c_str());
+                }
+
+                if (execute(stmt).affected_rows() == static_cast<long>(count)) {
+                    continue;
+                }
+
+                // Find the replicas that hold their new checksum. The others changed while
+                // their checksums were computed.
+                const auto select_sql = fmt::format("select data_id, data_repl_num from R_DATA_MAIN where ({}) and data_checksum = case {} end",
+                                                    fmt::join(std::vector<std::string_view>(count, replica_condition), " or "),
+                                                    fmt::join(std::vector<std::string_view>(count, when_clause), " "));
+
+                nanodbc::statement select_stmt{_ctx.db_conn};
+
+                prepare(select_stmt, select_sql);
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto* t = _tasks[offset + i];
+                    const auto param = static_cast<short>(i * 2);
+
+                    select_stmt.bind(param, t->replica->data_id.c_str());
+                    select_stmt.bind(param + 1, t->replica->replica_number.c_str());
+                }
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto* t = _tasks[offset + i];
+                    const auto param = static_cast<short>(count * 2 + i * 3);
+
+                    select_stmt.bind(param, t->replica->data_id.c_str());
+                    select_stmt.bind(param + 1, t->replica->replica_number.c_str());
+                    select_stmt.bind(param + 2, t->checksum.c_str());
+                }
+
+                std::unordered_set<std::string> updated;
+
+                for (auto row = execute(select_stmt); row.next();) {
+                    updated.insert(fmt::format("{}:{}", row.get<std::string>(0), row.get<std::string>(1)));
+                }
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto* t = _tasks[offset + i];
+                    const auto& r = *t->replica;
+
+                    if (updated.count(fmt::format("{}:{}", r.data_id, r.replica_number)) == 0) {
+                        t->status = SYS_REPLICA_INACCESSIBLE;
+                        report(_ctx, t->status, fmt::format("ERROR: Replica [{}] of data object [{}] changed while its checksum "
+                                                            "was computed. The checksum was not updated.",
+                                                            r.replica_number, r.logical_path));
+                        _ctx.error = t->status;
+                    }
+                }
+            }
+
+            _trans.commit();
+
+            return 0;
+        });
+    } // update_checksums
+
+    auto send_progress(checksum_context& _ctx, const std::string& _last_path) -> int
+    {
+        if (!_ctx.output) {
+            return 0;
+        }
+
+        if (!*_ctx.output) {
+            *_ctx.output = static_cast<collOprStat_t*>(std::calloc(1, sizeof(collOprStat_t)));
+        }
+
+        (*_ctx.output)->filesCnt = _ctx.replicas_done;
+        (*_ctx.output)->totalFileCnt = _ctx.total_replicas;
+        (*_ctx.output)->bytesWritten = _ctx.bytes_done;
+        rstrcpy((*_ctx.output)->lastObjPath, _last_path.c_str(), MAX_NAME_LEN);
+
+        // The message and the report are freed once they have been sent.
+        if (const auto ec = svrSendCollOprStat(&_ctx.comm, *_ctx.output); ec < 0) {
+            *_ctx.output = nullptr;
+            return ec;
+        }
+
+        *_ctx.output = static_cast<collOprStat_t*>(std::calloc(1, sizeof(collOprStat_t)));
+
+        return 0;
+    } // send_progress
+
+    auto checksum_batch(checksum_context& _ctx, std::vector<replica_info>& _replicas) -> int
+    {
+        if (_replicas.empty()) {
+            return 0;
+        }
+
+        std::vector<checksum_task> tasks;
+        tasks.reserve(_replicas.size());
+
+        for (auto&& r : _replicas) {
+            if (r.skipped) {
+                continue;
+            }
+
+            try {
+                if (auto task = make_checksum_task(_ctx, r); task) {
+                    tasks.push_back(*task);
+                }
+            }
+            catch (const irods::exception& e) {
+                report(_ctx, e.code(), fmt::format("ERROR: Could not checksum replica [{}] of data object [{}]: {}",
+                                                   r.replica_number, r.logical_path, e.client_display_what()));
+                _ctx.error = e.code();
+            }
+        }
+
+        std::vector<checksum_task*> task_ptrs;
+        task_ptrs.reserve(tasks.size());
+        std::transform(tasks.begin(), tasks.end(), std::back_inserter(task_ptrs), [](auto& _t) { return &_t; });
+
+        compute_checksums(_ctx, task_ptrs);
+
+        std::vector<checksum_task*> updates;
+
+        for (auto&& t : tasks) {
+            const auto& r = *t.replica;
+
+            // Like rsDataObjChksum, replicas in archive resources are silently skipped.
+            if (t.status == DIRECT_ARCHIVE_ACCESS) {
+                continue;
+            }
+
+            if (t.status < 0) {
+                const auto msg = _ctx.options.verify ? "Could not verify checksum" : "Could not compute checksum";
+                report(_ctx, t.status, fmt::format("ERROR: {} for replica [{}] of data object [{}].", msg, r.replica_number, r.logical_path));
+                _ctx.error = t.status;
+                continue;
+            }
+
+            _ctx.bytes_done += r.size;
+
+            if (!_ctx.options.verify) {
+                if (t.checksum != r.checksum) {
+                    updates.push_back(&t);
+                }
+
+                continue;
+            }
+
+            if (t.stat_status < 0) {
+                report(_ctx, t.stat_status, fmt::format("ERROR: Could not verify size for replica [{}] of data object [{}].",
+                                                        r.replica_number, r.logical_path));
+            }
+            else if (t.physical_size != r.size) {
+                report(_ctx, USER_FILE_SIZE_MISMATCH,
+                       fmt::format("ERROR: Physical size does not match size in catalog for replica [{}] of data object [{}].",
+                                   r.replica_number, r.logical_path));
+            }
+
+            if (t.checksum != r.checksum) {
+                report(_ctx, USER_CHKSUM_MISMATCH,
+                       fmt::format("ERROR: Computed checksum does not match what is in the catalog for replica [{}] of data object [{}].",
+                                   r.replica_number, r.logical_path));
+            }
+        }
+
+        if (const auto ec = update_checksums(_ctx, updates); ec < 0) {
+            return ec;
+        }
+
+        for (auto* t : updates) {
+            if (t->status >= 0) {
+                t->replica->checksum = t->checksum;
+            }
+        }
+
+        // Like rsDataObjChksum, report skipped replicas and data objects whose good replicas
+        // disagree. Replicas of a data object are adjacent because the batch is ordered by data
+        // id. Replicas without a checksum were reported above.
+        for (auto first = _replicas.begin(); first != _replicas.end();) {
+            const auto last = std::find_if(first, _replicas.end(), [first](auto&& _r) { return _r.data_id != first->data_id; });
+
+            std::unordered_set<std::string_view> checksums;
+            int skipped = 0;
+
+            std::for_each(first, last, [&checksums, &skipped](auto&& _r) {
+                if (_r.skipped) {
+                    ++skipped;
+                }
+                else if (!_r.checksum.empty()) {
+                    checksums.insert(_r.checksum);
+                }
+            });
+
+            if (skipped > 0) {
+                report(_ctx, 0, fmt::format("INFO: Number of replicas skipped for data object [{}]: {}", first->logical_path, skipped));
+            }
+
+            if (checksums.size() > 1) {
+                report(_ctx, USER_CHKSUM_MISMATCH,
+                       fmt::format("WARNING: Data object [{}] has replicas with different checksums.", first->logical_path));
+            }
+
+            first = last;
+        }
+
+        _ctx.replicas_done += static_cast<int>(_replicas.size());
+
+        return send_progress(_ctx, _replicas.back().logical_path);
+    } // checksum_batch
+
+    auto checksum_subtree(checksum_context& _ctx, const fs::path& _path) -> int
+    {
+        const auto path = _path.string();
+        const std::vector<std::string> subtree{path, escape_like_pattern(path) + "/%"};
+
+        if (count_rows(_ctx, "select count(*) from R_COLL_MAIN c where c.coll_name = ?", {path}) == 0) {
+            THROW(CAT_UNKNOWN_COLLECTION, fmt::format("Collection does not exist [logical_path={}]", path));
+        }
+
+        // The data objects of special collections are not in the catalog.
+        if (count_rows(_ctx, fmt::format("select count(*) from R_COLL_MAIN c where {} and length(c.coll_type) > 0",
+                                         subtree_condition("c")), subtree) > 0)
+        {
+            THROW(SYS_NOT_SUPPORTED, fmt::format("Collection contains special collections [logical_path={}]", path));
+        }
+
+        auto args = subtree;
+        const auto access = access_condition(_ctx, args);
+
+        _ctx.total_replicas = count_rows(_ctx,
+                                         fmt::format("select count(*) from R_DATA_MAIN d "
+                                                     "inner join R_COLL_MAIN c on d.coll_id = c.coll_id "
+                                                     "where {} and {}",
+                                                     subtree_condition("c"), access),
+                                         args);
+
+        std::string last_data_id = "0";
+
+        for (auto replicas = fetch_replicas(_ctx, _path, last_data_id); !replicas.empty(); replicas = fetch_replicas(_ctx, _path, last_data_id)) {
+            last_data_id = replicas.back().data_id;
+
+            if (const auto ec = checksum_batch(_ctx, replicas); ec < 0) {
+                return ec;
+            }
+        }
+
+        return _ctx.error;
+    } // checksum_subtree
+
+    auto checksum_data_objects(checksum_context& _ctx, const std::vector<std::string>& _paths) -> int
+    {
+        // The total is not known up front. Clients report it as unknown.
+        _ctx.total_replicas = 0;
+
+        // Every manifest entry holds at least one replica, so this many entries never
+        // produce fewer replicas than a batch over a collection.
+        for (std::size_t offset = 0; offset < _paths.size(); offset += replicas_per_batch) {
+            const auto last = std::min(_paths.size(), offset + replicas_per_batch);
+            const std::vector<std::string> paths(_paths.begin() + offset, _paths.begin() + last);
+
+            auto replicas = fetch_replicas(_ctx, paths);
+
+            if (const auto ec = checksum_batch(_ctx, replicas); ec < 0) {
+                return ec;
+            }
+        }
+
+        return _ctx.error;
+    } // checksum_data_objects
+
+    // Like svrSendZoneCollOprStat, except that the report carried by each message from the
+    // catalog service provider is passed on to the client as well.
+    auto forward_progress(rsComm_t& _comm, rcComm_t& _conn, collOprStat_t* _stat, int _ec) -> int
+    {
+        const auto take_report = [&_comm, &_conn] {
+            if (_conn.rError) {
+                replErrorStack(_conn.rError, &_comm.rError);
+                freeRError(_conn.rError);
+                _conn.rError = nullptr;
+            }
+        };
+
+        take_report();
+
+        while (_ec == SYS_SVR_TO_CLI_COLL_STAT) {
+            // The message and the report are freed once they have been sent.
+            _ec = _svrSendCollOprStat(&_comm, _stat);
+            _stat = nullptr;
+
+            if (_ec != SYS_CLI_TO_SVR_COLL_STAT_REPLY) {
+                // Tell the catalog service provider to stop.
+                int reply = htonl(_ec);
+
+                if (irods::CS_NEG_USE_SSL == _conn.negotiation_results) {
+                    sslWrite(static_cast<void*>(&reply), 4, nullptr, _conn.ssl);
+                }
+                else {
+                    myWrite(_conn.sock, static_cast<void*>(&reply), 4, nullptr);
+                }
+
+                return _ec;
+            }
+
+            _ec = _cliGetCollOprStat(&_conn, &_stat);
+            take_report();
+        }
+
+        std::free(_stat);
+
+        return _ec;
+    } // forward_progress
+
+    auto rs_bulk_checksum(rsComm_t* _comm, bytesBuf_t* _input, collOprStat_t** _output) -> int
+    {
+        if (_output) {
+            *_output = nullptr;
+        }
+
+        try {
+            const auto json_input = parse_json(_input);
+            const auto opts = parse_options(json_input);
+
+            std::vector<std::string> paths;
+
+            if (const auto iter = json_input.find(prop_data_objects.data()); iter != json_input.end()) {
+                paths = iter->get<std::vector<std::string>>();
+            }
+            else {
+                paths.push_back(json_input.at(prop_logical_path.data()).get<std::string>());
+            }
+
+            // Other zones are left to rsDataObjChksum.
+            for (auto&& p : paths) {
+                if (auto zone = fs::zone_name(p); !zone || !isLocalZone(zone->data())) {
+                    THROW(SYS_NOT_SUPPORTED, fmt::format("Path is not in the local zone [logical_path={}]", p));
+                }
+            }
+
+            if (opts.admin && !irods::is_privileged_client(*_comm)) {
+                THROW(CAT_INSUFFICIENT_PRIVILEGE_LEVEL, fmt::format("[{}] requires administrative privileges.", prop_admin));
+            }
+
+            // Checked by every server the request passes through because policy is configured
+            // per server.
+            if (bypassed_policy_is_configured(*_comm)) {
+                THROW(SYS_NOT_SUPPORTED, "Bulk checksum is disabled while checksum policy is configured.");
+            }
+
+            if (!ic::connected_to_catalog_provider(*_comm)) {
+                log::api::trace("Redirecting request to catalog service provider ...");
+
+                auto host_info = ic::redirect_to_catalog_provider(*_comm);
+                const std::string json_string(static_cast<const char*>(_input->buf), _input->len);
+
+                collOprStat_t* stat{};
+                const auto ec = _rc_bulk_checksum(host_info.conn, json_string.c_str(), &stat);
+
+                if (!_output) {
+                    const auto status = cliGetCollOprStat(host_info.conn, stat, 0, ec);
+
+                    if (host_info.conn->rError) {
+                        replErrorStack(host_info.conn->rError, &_comm->rError);
+                    }
+
+                    return status;
+                }
+
+                if (ec != SYS_SVR_TO_CLI_COLL_STAT) {
+                    *_output = stat;
+
+                    if (host_info.conn->rError) {
+                        replErrorStack(host_info.conn->rError, &_comm->rError);
+                    }
+
+                    return ec;
+                }
+
+                return forward_progress(*_comm, *host_info.conn, stat, ec);
+            }
+
+            ic::throw_if_catalog_provider_service_role_is_invalid();
+
+            std::string db_instance_name;
+            nanodbc::connection db_conn;
+
+            std::tie(db_instance_name, db_conn) = ic::new_database_connection();
+
+            checksum_context ctx{*_comm, db_conn, db_instance_name, opts, _output};
+
+            if (json_input.contains(prop_data_objects.data())) {
+                return checksum_data_objects(ctx, paths);
+            }
+
+            return checksum_subtree(ctx, paths.front());
+        }
+        catch (const fs::filesystem_error& e) {
+            log::api::error(e.what());
+            addRErrorMsg(&_comm->rError, e.code().value(), e.what());
+            return e.code().value();
+        }
+        catch (const irods::exception& e) {
+            log::api::error(e.what());
+            addRErrorMsg(&_comm->rError, e.code(), e.client_display_what());
+            return e.code();
+        }
+        catch (const std::exception& e) {
+            log::api::error(e.what());
+            addRErrorMsg(&_comm->rError, SYS_UNKNOWN_ERROR, "Cannot process request due to an unexpected error.");
+            return SYS_UNKNOWN_ERROR;
+        }
+    } // rs_bulk_checksum
+
+    const operation op = rs_bulk_checksum;
+    #define CALL_BULK_CHECKSUM call_bulk_checksum
+} // anonymous namespace
+
+#else // RODS_SERVER
+
+//
+// Client-side Implementation
+//
+
+namespace
+{
+    using operation = std::function<int(rsComm_t*, bytesBuf_t*, collOprStat_t**)>;
+    const operation op{};
+    #define CALL_BULK_CHECKSUM nullptr
+} // anonymous namespace
+
+#endif // RODS_SERVER
+
+// The plugin factory function must always be defined.
+extern "C"
+auto plugin_factory(const std::string& _instance_name,
+                    const std::string& _context) -> irods::api_entry*
+{
+#ifdef RODS_SERVER
+    irods::client_api_whitelist::instance().add(BULK_CHECKSUM_APN);
+#endif // RODS_SERVER
+
+    // clang-format off
+    irods::apidef_t def{BULK_CHECKSUM_APN,      // API number
+                        RODS_API_VERSION,       // API version
+                        NO_USER_AUTH,           // Client auth
+                        NO_USER_AUTH,           // Proxy auth
+                        "BytesBuf_PI", 0,       // In PI / bs flag
+                        "CollOprStat_PI", 0,    // Out PI / bs flag
+                        op,                     // Operation
+                        "api_bulk_checksum",    // Operation name
+                        nullptr,                // Clear function
+                        (funcPtr) CALL_BULK_CHECKSUM};
+    // clang-format on
+
+    auto* api = new irods::api_entry{def};
+
+    api->in_pack_key = "BytesBuf_PI";
+    api->in_pack_value = BytesBuf_PI;
+
+    api->out_pack_key = "CollOprStat_PI";
+    api->out_pack_value = CollOprStat_PI;
+
+    return api;
+}
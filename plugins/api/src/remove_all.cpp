@@ -0,0 +1,1215 @@
+#include "api_plugin_number.h"
+#include "rodsDef.h"
+#include "rcConnect.h"
+#include "rodsPackInstruct.h"
+#include "apiHandler.hpp"
+#include "client_api_whitelist.hpp"
+
+#include <functional>
+
+#ifdef RODS_SERVER
+
+//
+// Server-side Implementation
+//
+
+#include "remove_all.h"
+
+#include "rcMisc.h"
+#include "rodsErrorTable.h"
+#include "rodsConnect.h"
+#include "objInfo.h"
+#include "rodsPath.h"
+#include "phyBundleColl.h"
+#include "procApiRequest.h"
+#include "fileUnlink.h"
+#include "rmColl.h"
+#include "rsApiHandler.hpp"
+#include "rsFileUnlink.hpp"
+#include "rsRmColl.hpp"
+#include "rsGlobalExtern.hpp"
+#include "icatDefines.h"
+#include "catalog.hpp"
+#include "catalog_utilities.hpp"
+#include "irods_at_scope_exit.hpp"
+#include "irods_database_constants.hpp"
+#include "irods_exception.hpp"
+#include "irods_logger.hpp"
+#include "irods_re_namespaceshelper.hpp"
+#include "irods_re_plugin.hpp"
+#include "irods_re_ruleexistshelper.hpp"
+#include "irods_re_structs.hpp"
+#include "irods_resource_backport.hpp"
+#include "irods_resource_constants.hpp"
+#include "irods_server_api_call.hpp"
+#include "scoped_privileged_client.hpp"
+
+#define IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
+#include "filesystem.hpp"
+
+#include "fmt/format.h"
+#include "json.hpp"
+#include "nanodbc/nanodbc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+/*
+ The expected JSON format:
+ ~~~~~~~~~~~~~~~~~~~~~~~~~
+ {
+     // Must be an absolute path to a collection.
+     // Cannot be empty.
+     "logical_path": string,
+
+     // Optional set of options.
+     // Allowed to be empty.
+     // Not required to exist.
+     "options": {
+         // Defaults to false.
+         "no_trash": boolean,
+
+         // Defaults to false.
+         "unregister": boolean
+     }
+ }
+*/
+
+namespace
+{
+    // clang-format off
+    namespace ix = irods::experimental;
+    namespace fs = irods::experimental::filesystem;
+    namespace ic = irods::experimental::catalog;
+
+    using json      = nlohmann::json;
+    using log       = irods::experimental::log;
+    using operation = std::function<int(rsComm_t*, bytesBuf_t*, collOprStat_t**)>;
+
+    using rule_engine_context_manager_type = irods::rule_engine_context_manager<irods::unit, ruleExecInfo_t*, irods::AUDIT_RULE>;
+
+    // JSON Input Properties
+    constexpr std::string_view prop_logical_path = "logical_path";
+    constexpr std::string_view prop_options      = "options";
+    constexpr std::string_view prop_no_trash     = "no_trash";
+    constexpr std::string_view prop_unregister   = "unregister";
+    // clang-format on
+
+    // The maximum number of rows affected by a single generated SQL statement.
+    constexpr std::size_t max_rows_per_statement = 100;
+
+    // The number of replicas read from the catalog, unlinked and deleted per round. Progress
+    // is reported to the client once per round.
+    constexpr std::size_t replicas_per_batch = 1000;
+
+    // The character used to escape LIKE wildcards in logical paths.
+    constexpr char like_escape_char = '!';
+
+    // Policy the bulk path never invokes because it does not go through rsDataObjUnlink or
+    // the database plugin. Subtrees are left to rsRmColl while any of these are configured.
+    const std::array<std::string, 4> bypassed_policy{
+        "api_data_obj_unlink",
+        irods::DATABASE_OP_UNREG_REPLICA,
+        irods::DATABASE_OP_DEL_COLL,
+        irods::DATABASE_OP_DEL_COLL_BY_ADMIN
+    };
+
+    struct remove_options
+    {
+        bool no_trash = false;
+        bool unregister = false;
+    }; // struct remove_options
+
+    struct replica_info
+    {
+        std::string data_id;
+        std::string replica_number;
+        std::string logical_path;
+        std::string collection_name;
+        std::string physical_path;
+        rodsLong_t resource_id = 0;
+        rodsLong_t size = 0;
+        std::string resource_name;
+        std::string resource_hierarchy;
+    }; // struct replica_info
+
+    struct unlink_task
+    {
+        fileUnlinkInp_t input;
+        int status = SYS_INTERNAL_ERR;
+    }; // struct unlink_task
+
+    // State shared by all batches of a single request.
+    struct remove_context
+    {
+        rsComm_t& comm;
+        nanodbc::connection& db_conn;
+        std::string_view db_instance_name;
+        const fs::path& path;
+        const remove_options& options;
+        collOprStat_t** output;
+        int total_objects = 0;
+        int error = 0;
+        bool effective_access_index_enabled = false;
+
+        // Collections that must survive because something under them could not be removed.
+        std::unordered_set<std::string> kept_collections;
+    }; // struct remove_context
+
+    //
+    // Function Prototypes
+    //
+
+    auto call_remove_all(irods::api_entry* _api, rsComm_t* _comm, bytesBuf_t* _input, collOprStat_t** _output) -> int;
+
+    auto parse_json(const bytesBuf_t* _bbuf) -> json;
+
+    auto parse_options(const json& _json_input) -> remove_options;
+
+    auto make_placeholders(std::size_t _count) -> std::string;
+
+    auto make_limit_clause(std::string_view _db_instance_name, std::size_t _count) -> std::string;
+
+    auto escape_like_pattern(std::string_view _s) -> std::string;
+
+    auto subtree_condition(std::string_view _alias) -> std::string;
+
+    auto access_check_required(const remove_context& _ctx) -> bool;
+
+    auto access_condition(std::string_view _object_id, std::string_view _access_level) -> std::string;
+
+    auto count_rows(remove_context& _ctx, const std::string& _sql, const std::vector<std::string>& _bind_args) -> int;
+
+    auto remove_using_rm_coll(rsComm_t& _comm,
+                              const fs::path& _path,
+                              const remove_options& _opts,
+                              collOprStat_t** _output) -> int;
+
+    auto trash_is_enabled(rsComm_t& _comm) -> bool;
+
+    auto bypassed_policy_is_configured(rsComm_t& _comm) -> bool;
+
+    auto supports_bulk_removal(remove_context& _ctx) -> bool;
+
+    auto fetch_replicas(remove_context& _ctx, const std::string& _last_data_id) -> std::vector<replica_info>;
+
+    auto deletion_is_allowed(remove_context& _ctx, replica_info& _replica) -> bool;
+
+    auto make_unlink_task(remove_context& _ctx, const replica_info& _replica) -> std::optional<unlink_task>;
+
+    auto unlink_replicas(remove_context& _ctx, std::vector<unlink_task*>& _tasks) -> void;
+
+    auto delete_replica_rows(remove_context& _ctx, const std::vector<const replica_info*>& _replicas) -> void;
+
+    auto delete_object_rows(remove_context& _ctx, std::string_view _existence_check, const std::vector<std::string>& _ids) -> void;
+
+    auto keep_collection(remove_context& _ctx, const fs::path& _collection) -> void;
+
+    auto send_progress(remove_context& _ctx, int _objects_removed, const std::string& _last_path) -> int;
+
+    auto remove_batch(remove_context& _ctx, std::vector<replica_info>& _replicas) -> int;
+
+    auto remove_collections(remove_context& _ctx) -> int;
+
+    auto remove_subtree(remove_context& _ctx) -> int;
+
+    auto update_parent_mtime(rsComm_t& _comm, const fs::path& _path) -> int;
+
+    auto rs_remove_all(rsComm_t* _comm, bytesBuf_t* _input, collOprStat_t** _output) -> int;
+
+    //
+    // Function Implementations
+    //
+
+    auto call_remove_all(irods::api_entry* _api, rsComm_t* _comm, bytesBuf_t* _input, collOprStat_t** _output) -> int
+    {
+        return _api->call_handler<bytesBuf_t*, collOprStat_t**>(_comm, _input, _output);
+    } // call_remove_all
+
+    auto parse_json(const bytesBuf_t* _bbuf) -> json
+    {
+        if (!_bbuf || !_bbuf->buf) {
+            THROW(SYS_NULL_INPUT, "Could not parse string (null pointer) into JSON.");
+        }
+
+        try {
+            const std::string_view json_string(static_cast<const char*>(_bbuf->buf), _bbuf->len);
+            return json::parse(json_string);
+        }
+        catch (const json::exception& e) {
+            THROW(INPUT_ARG_NOT_WELL_FORMED_ERR, "Could not parse string into JSON.");
+        }
+    } // parse_json
+
+    auto parse_options(const json& _json_input) -> remove_options
+    {
+        const auto lp_iter = _json_input.find(prop_logical_path.data());
+
+        if (lp_iter == _json_input.end() || !lp_iter->is_string() || lp_iter->get<std::string>().empty()) {
+            THROW(INPUT_ARG_NOT_WELL_FORMED_ERR, fmt::format("[{}] must be a non-empty string.", prop_logical_path));
+        }
+
+        remove_options opts;
+
+        const auto opts_iter = _json_input.find(prop_options.data());
+
+        if (opts_iter == _json_input.end()) {
+            return opts;
+        }
+
+        if (!opts_iter->is_object()) {
+            THROW(INPUT_ARG_NOT_WELL_FORMED_ERR, fmt::format("[{}] must be a JSON object.", prop_options));
+        }
+
+        try {
+            opts.no_trash = opts_iter->value(prop_no_trash.data(), false);
+            opts.unregister = opts_iter->value(prop_unregister.data(), false);
+        }
+        catch (const json::exception&) {
+            THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Incorrect value type in [{}].", prop_options));
+        }
+
+        return opts;
+    } // parse_options
+
+    auto make_placeholders(std::size_t _count) -> std::string
+    {
+        return fmt::format("{}", fmt::join(std::vector<std::string_view>(_count, "?"), ", "));
+    } // make_placeholders
+
+    auto make_limit_clause(std::string_view _db_instance_name, std::size_t _count) -> std::string
+    {
+        if (_db_instance_name == "oracle") {
+            return fmt::format(" fetch first {} rows only", _count);
+        }
+
+        return fmt::format(" limit {}", _count);
+    } // make_limit_clause
+
+    auto escape_like_pattern(std::string_view _s) -> std::string
+    {
+        std::string escaped;
+        escaped.reserve(_s.size());
+
+        for (auto c : _s) {
+            if (c == like_escape_char || c == '%' || c == '_') {
+                escaped += like_escape_char;
+            }
+
+            escaped += c;
+        }
+
+        return escaped;
+    } // escape_like_pattern
+
+    // Matches the collection itself and every collection under it. Takes two bind
+    // arguments: the logical path and the LIKE pattern built from it.
+    auto subtree_condition(std::string_view _alias) -> std::string
+    {
+        return fmt::format("({0}.coll_name = ? or {0}.coll_name like ? escape '{1}')", _alias, like_escape_char);
+    } // subtree_condition
+
+    // Privileged clients may remove anything, so only other clients are checked against
+    // the permissions in the catalog.
+    auto access_check_required(const remove_context& _ctx) -> bool
+    {
+        return LOCAL_PRIV_USER_AUTH != _ctx.comm.clientUser.authInfo.authFlag;
+    } // access_check_required
+
+    // True when the client has at least the given access to the object. Takes two bind
+    // arguments: the client's user name and zone.
+    auto access_condition(std::string_view _object_id, std::string_view _access_level) -> std::string
+    {
+        return fmt::format("exists (select a.object_id from R_OBJT_ACCESS a, R_USER_GROUP ug, R_USER_MAIN u, R_TOKN_MAIN t "
+                           "where a.object_id = {} and a.user_id = ug.group_user_id and ug.user_id = u.user_id and "
+                           "u.user_name = ? and u.zone_name = ? and a.access_type_id >= t.token_id and "
+                           "t.token_namespace = 'access_type' and t.token_name = '{}')",
+                           _object_id, _access_level);
+    } // access_condition
+
+    auto count_rows(remove_context& _ctx, const std::string& _sql, const std::vector<std::string>& _bind_args) -> int
+    {
+        nanodbc::statement stmt{_ctx.db_conn};
+
+        prepare(stmt, _sql);
+
+        for (std::size_t i = 0; i < _bind_args.size(); ++i) {
+            stmt.bind(static_cast<short>(i), _bind_args[i].c_str());
+        }
+
+        if (auto row = execute(stmt); row.next()) {
+            return row.get<int>(0);
+        }
+
+        return 0;
+    } // count_rows
+
+    auto remove_using_rm_coll(rsComm_t& _comm,
+                              const fs::path& _path,
+                              const remove_options& _opts,
+                              collOprStat_t** _output) -> int
+    {
+        collInp_t input{};
+        irods::at_scope_exit free_memory{[&input] { clearKeyVal(&input.condInput); }};
+
+        std::strncpy(input.collName, _path.c_str(), MAX_NAME_LEN - 1);
+        input.oprType = _opts.unregister ? UNREG_OPR : 0;
+
+        addKeyVal(&input.condInput, RECURSIVE_OPR__KW, "");
+
+        if (_opts.no_trash) {
+            addKeyVal(&input.condInput, FORCE_FLAG_KW, "");
+        }
+
+        return rsRmColl(&_comm, &input, _output);
+    } // remove_using_rm_coll
+
+    auto trash_is_enabled(rsComm_t& _comm) -> bool
+    {
+        ruleExecInfo_t rei{};
+        initReiWithDataObjInp(&rei, &_comm, nullptr);
+
+        int status = applyRule("acTrashPolicy", nullptr, &rei, NO_SAVE_REI);
+
+        clearKeyVal(rei.condInputData);
+        free(rei.condInputData);
+
+        if (status < 0) {
+            if (rei.status < 0) {
+                status = rei.status;
+            }
+
+            THROW(status, "acTrashPolicy failed");
+        }
+
+        return NO_TRASH_CAN != rei.status;
+    } // trash_is_enabled
+
+    auto bypassed_policy_is_configured(rsComm_t& _comm) -> bool
+    {
+        ruleExecInfo_t rei{};
+        rei.rsComm = &_comm;
+        rei.uoic = &_comm.clientUser;
+        rei.uoip = &_comm.proxyUser;
+
+        rule_engine_context_manager_type re_ctx_mgr(irods::re_plugin_globals->global_re_mgr, &rei);
+
+        for (auto&& ns : NamespacesHelper::Instance()->getNamespaces()) {
+            for (auto&& op : bypassed_policy) {
+                for (std::string_view cls : {"pre", "post", "except", "finally"}) {
+                    const auto rule_name = fmt::format("{}pep_{}_{}", ns, op, cls);
+                    bool exists = false;
+
+                    if (RuleExistsHelper::Instance()->checkOperation(rule_name) &&
+                        re_ctx_mgr.rule_exists(rule_name, exists).ok() && exists)
+                    {
+                        log::api::info("Policy prevents bulk removal. Using rsRmColl [rule_name={}].", rule_name);
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    } // bypassed_policy_is_configured
+
+    // Returns true if the subtree can be removed without going through rsRmColl. Anything
+    // rsRmColl treats specially (trash, special collections, bundles, locked replicas) or
+    // would refuse part way through (missing permissions) is left to rsRmColl.
+    auto supports_bulk_removal(remove_context& _ctx) -> bool
+    {
+        auto path = _ctx.path.string();
+
+        if (isHomeColl(path.data()) || isTrashHome(path.data()) || isBundlePath(path.data())) {
+            return false;
+        }
+
+        // Never bulk remove a zone or one of its top-level collections.
+        if (std::distance(_ctx.path.begin(), _ctx.path.end()) < 4) {
+            return false;
+        }
+
+        // Unregistering requires per-replica path checks for unprivileged users.
+        if (_ctx.options.unregister && LOCAL_PRIV_USER_AUTH != _ctx.comm.clientUser.authInfo.authFlag) {
+            return false;
+        }
+
+        if (!_ctx.options.no_trash && !_ctx.options.unregister && trash_is_enabled(_ctx.comm)) {
+            return false;
+        }
+
+        if (bypassed_policy_is_configured(_ctx.comm)) {
+            return false;
+        }
+
+        const std::vector<std::string> subtree{path, escape_like_pattern(path) + "/%"};
+
+        if (count_rows(_ctx, "select count(*) from R_COLL_MAIN c where c.coll_name = ?", {path}) == 0) {
+            return false;
+        }
+
+        if (count_rows(_ctx, fmt::format("select count(*) from R_COLL_MAIN c where {} and length(c.coll_type) > 0",
+                                    subtree_condition("c")), subtree) > 0)
+        {
+            return false;
+        }
+
+        // Locked replicas and bundle files.
+        auto args = subtree;
+        args.push_back(BUNDLE_STR);
+
+        if (count_rows(_ctx, fmt::format("select count(*) from R_DATA_MAIN d inner join R_COLL_MAIN c on d.coll_id = c.coll_id "
+                                    "where {} and (d.data_is_dirty not in (0, 1) or d.data_type_name = ?)",
+                                    subtree_condition("c")), args) > 0)
+        {
+            return false;
+        }
+
+        // The user must be allowed to delete everything in the subtree and modify the parent
+        // collection. Permissions are checked again on every batch because they may change
+        // while the removal is in progress.
+        args = subtree;
+        args.push_back(_ctx.comm.clientUser.userName);
+        args.push_back(_ctx.comm.clientUser.rodsZone);
+
+        if (count_rows(_ctx, fmt::format("select count(*) from R_DATA_MAIN d inner join R_COLL_MAIN c on d.coll_id = c.coll_id "
+                                    "where {} and not {}",
+                                    subtree_condition("c"), access_condition("d.data_id", ACCESS_DELETE_OBJECT)), args) > 0)
+        {
+            return false;
+        }
+
+        if (count_rows(_ctx, fmt::format("select count(*) from R_COLL_MAIN c where {} and not {}",
+                                    subtree_condition("c"), access_condition("c.coll_id", ACCESS_DELETE_OBJECT)), args) > 0)
+        {
+            return false;
+        }
+
+        args = {_ctx.path.parent_path().string(), _ctx.comm.clientUser.userName, _ctx.comm.clientUser.rodsZone};
+
+        return count_rows(_ctx, fmt::format("select count(*) from R_COLL_MAIN c where c.coll_name = ? and {}",
+                                       access_condition("c.coll_id", ACCESS_MODIFY_OBJECT)), args) > 0;
+    } // supports_bulk_removal
+
+    // Returns the next batch of replicas ordered by data id. All replicas of a data object
+    // are always returned in the same batch.
+    auto fetch_replicas(remove_context& _ctx, const std::string& _last_data_id) -> std::vector<replica_info>
+    {
+        const auto path = _ctx.path.string();
+
+        const auto check_access = access_check_required(_ctx);
+        const auto access_clause = check_access
+            ? fmt::format(" and {}", access_condition("d.data_id", ACCESS_DELETE_OBJECT))
+            : std::string{};
+
+        const auto query = [&](std::string_view _data_id_condition, std::string_view _limit_clause) {
+            const auto sql = fmt::format("select d.data_id, d.data_repl_num, d.data_name, c.coll_name, d.data_path, d.resc_id, d.data_size "
+                                         "from R_DATA_MAIN d inner join R_COLL_MAIN c on d.coll_id = c.coll_id "
+                                         "where {} and {}{} order by d.data_id, d.data_repl_num{}",
+                                         subtree_condition("c"), _data_id_condition, access_clause, _limit_clause);
+
+            nanodbc::statement stmt{_ctx.db_conn};
+
+            prepare(stmt, sql);
+
+            const auto pattern = escape_like_pattern(path) + "/%";
+
+            stmt.bind(0, path.c_str());
+            stmt.bind(1, pattern.c_str());
+            stmt.bind(2, _last_data_id.c_str());
+
+            if (check_access) {
+                stmt.bind(3, _ctx.comm.clientUser.userName);
+                stmt.bind(4, _ctx.comm.clientUser.rodsZone);
+            }
+
+            std::vector<replica_info> replicas;
+
+            for (auto row = execute(stmt); row.next();) {
+                auto& r = replicas.emplace_back();
+
+                r.data_id = row.get<std::string>(0);
+                r.replica_number = row.get<std::string>(1);
+                r.collection_name = row.get<std::string>(3);
+                r.logical_path = (fs::path{r.collection_name} / row.get<std::string>(2)).string();
+                r.physical_path = row.get<std::string>(4);
+                r.resource_id = std::stoll(row.get<std::string>(5));
+                r.size = std::stoll(row.get<std::string>(6, "0"));
+            }
+
+            return replicas;
+        };
+
+        auto replicas = query("d.data_id > ?", make_limit_clause(_ctx.db_instance_name, replicas_per_batch));
+
+        if (replicas.size() < replicas_per_batch) {
+            return replicas;
+        }
+
+        // The limit may have cut the last data object's replicas in two. Leave that data
+        // object for the next batch, unless it is the only one in this batch.
+        const auto last_id = replicas.back().data_id;
+        const auto iter = std::find_if(replicas.begin(), replicas.end(), [&last_id](auto&& _r) { return _r.data_id == last_id; });
+
+        if (iter != replicas.begin()) {
+            replicas.erase(iter, replicas.end());
+            return replicas;
+        }
+
+        return query("d.data_id = ?", "");
+    } // fetch_replicas
+
+    // Mirrors chkPreProcDeleteRule for a single replica.
+    auto deletion_is_allowed(remove_context& _ctx, replica_info& _replica) -> bool
+    {
+        dataObjInp_t input{};
+        irods::at_scope_exit free_input{[&input] { clearKeyVal(&input.condInput); }};
+
+        std::strncpy(input.objPath, _replica.logical_path.c_str(), MAX_NAME_LEN - 1);
+        addKeyVal(&input.condInput, FORCE_FLAG_KW, "");
+
+        dataObjInfo_t info{};
+        std::strncpy(info.objPath, _replica.logical_path.c_str(), MAX_NAME_LEN - 1);
+        std::strncpy(info.filePath, _replica.physical_path.c_str(), MAX_NAME_LEN - 1);
+        std::strncpy(info.rescName, _replica.resource_name.c_str(), NAME_LEN - 1);
+        std::strncpy(info.rescHier, _replica.resource_hierarchy.c_str(), MAX_NAME_LEN - 1);
+        info.dataId = std::stoll(_replica.data_id);
+        info.replNum = std::stoi(_replica.replica_number);
+        info.rescId = _replica.resource_id;
+        info.dataSize = _replica.size;
+
+        ruleExecInfo_t rei{};
+        initReiWithDataObjInp(&rei, &_ctx.comm, &input);
+        clearKeyVal(rei.condInputData);
+        irods::get_resc_properties_as_kvp(info.rescHier, rei.condInputData);
+        rei.doi = &info;
+
+        const int status = applyRule("acDataDeletePolicy", nullptr, &rei, NO_SAVE_REI);
+
+        clearKeyVal(rei.condInputData);
+        free(rei.condInputData);
+
+        if (status < 0 && status != NO_MORE_RULES_ERR && status != SYS_DELETE_DISALLOWED) {
+            log::api::error("acDataDeletePolicy failed [logical_path={}, error_code={}]", _replica.logical_path, status);
+            _ctx.error = status;
+            return false;
+        }
+
+        if (rei.status == SYS_DELETE_DISALLOWED) {
+            log::api::info("acDataDeletePolicy disallowed removal [logical_path={}]", _replica.logical_path);
+            return false;
+        }
+
+        return true;
+    } // deletion_is_allowed
+
+    // Returns the input for unlinking the replica from storage, or an empty optional if the
+    // replica only needs to be unregistered. Mirrors the checks in dataObjUnlinkS and l3Unlink.
+    auto make_unlink_task(remove_context& _ctx, const replica_info& _replica) -> std::optional<unlink_task>
+    {
+        if (_ctx.options.unregister) {
+            return std::nullopt;
+        }
+
+        std::string resc_class;
+        if (const auto err = irods::get_resource_property<std::string>(_replica.resource_id, irods::RESOURCE_CLASS, resc_class); !err.ok()) {
+            THROW(err.code(), fmt::format("Failed to get resource class [resource={}]", _replica.resource_name));
+        }
+
+        if (resc_class == irods::RESOURCE_CLASS_BUNDLE) {
+            return std::nullopt;
+        }
+
+        bool skip_vault_path_check = false;
+        if (const auto err = irods::get_resource_property<bool>(_replica.resource_id,
+                                                                irods::RESOURCE_SKIP_VAULT_PATH_CHECK_ON_UNLINK,
+                                                                skip_vault_path_check);
+            !err.ok())
+        {
+            skip_vault_path_check = false;
+        }
+
+        if (!skip_vault_path_check) {
+            std::string vault_path;
+            if (const auto err = irods::get_vault_path_for_hier_string(_replica.resource_hierarchy, vault_path); !err.ok()) {
+                THROW(err.code(), fmt::format("Failed to get vault path [resource_hierarchy={}]", _replica.resource_hierarchy));
+            }
+
+            // Replicas outside of the vault are unregistered and left on disk as-is.
+            if (!has_prefix(_replica.physical_path.c_str(), vault_path.c_str())) {
+                log::api::info("Replica is not in a vault. Unregistering replica and leaving it on disk as-is "
+                               "[data_object={}, physical_object={}, vault_path={}].",
+                               _replica.logical_path, _replica.physical_path, vault_path);
+                return std::nullopt;
+            }
+        }
+
+        if (const auto err = irods::is_hier_live(_replica.resource_hierarchy); !err.ok()) {
+            THROW(err.code(), fmt::format("Resource hierarchy is not available [resource_hierarchy={}]", _replica.resource_hierarchy));
+        }
+
+        std::string location;
+        if (const auto err = irods::get_loc_for_hier_string(_replica.resource_hierarchy, location); !err.ok()) {
+            THROW(err.code(), fmt::format("Failed to get host [resource_hierarchy={}]", _replica.resource_hierarchy));
+        }
+
+        unlink_task task{};
+        rstrcpy(task.input.fileName, _replica.physical_path.c_str(), MAX_NAME_LEN);
+        rstrcpy(task.input.rescHier, _replica.resource_hierarchy.c_str(), MAX_NAME_LEN);
+        rstrcpy(task.input.addr.hostAddr, location.c_str(), NAME_LEN);
+        rstrcpy(task.input.objPath, _replica.logical_path.c_str(), MAX_NAME_LEN);
+
+        return task;
+    } // make_unlink_task
+
+    // Unlinks the replicas from storage. The unlinks go through the agent's own connection
+    // so that they are carried out as the client and trigger the resource unlink policy.
+    auto unlink_replicas(remove_context& _ctx, std::vector<unlink_task*>& _tasks) -> void
+    {
+        for (auto* t : _tasks) {
+            t->status = rsFileUnlink(&_ctx.comm, &t->input);
+        }
+    } // unlink_replicas
+
+    auto delete_replica_rows(remove_context& _ctx, const std::vector<const replica_info*>& _replicas) -> void
+    {
+        const auto check_access = access_check_required(_ctx);
+        const auto access_clause = check_access
+            ? fmt::format(" and {}", access_condition("R_DATA_MAIN.data_id", ACCESS_DELETE_OBJECT))
+            : std::string{};
+
+        for (std::size_t offset = 0; offset < _replicas.size(); offset += max_rows_per_statement) {
+            const auto count = std::min(max_rows_per_statement, _replicas.size() - offset);
+
+            const auto sql = fmt::format("delete from R_DATA_MAIN where ({}){}",
+                                         fmt::join(std::vector<std::string_view>(count, "(data_id = ? and data_repl_num = ?)"), " or "),
+                                         access_clause);
+
+            nanodbc::statement stmt{_ctx.db_conn};
+
+            prepare(stmt, sql);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto* r = _replicas[offset + i];
+                const auto param = static_cast<short>(i * 2);
+
+                stmt.bind(param, r->data_id.c_str());
+                stmt.bind(param + 1, r->replica_number.c_str());
+            }
+
+            if (check_access) {
+                const auto param = static_cast<short>(count * 2);
+
+                stmt.bind(param, _ctx.comm.clientUser.userName);
+                stmt.bind(param + 1, _ctx.comm.clientUser.rodsZone);
+            }
+
+            // Rows are only left behind when the client lost access after the batch was read.
+            if (const auto rows = execute(stmt).affected_rows(); rows < static_cast<long>(count)) {
+                log::api::error("Client lost permission to remove replicas during bulk removal "
+                                "[first_logical_path={}, expected_rows={}, deleted_rows={}].",
+                                _replicas[offset]->logical_path, count, rows);
+                _ctx.error = CAT_NO_ACCESS_PERMISSION;
+            }
+        }
+    } // delete_replica_rows
+
+    // Deletes the permissions and metadata links of objects that no longer exist. Objects
+    // that still exist, according to the table and column passed, are skipped.
+    auto delete_object_rows(remove_context& _ctx, std::string_view _existence_check, const std::vector<std::string>& _ids) -> void
+    {
+        std::vector<std::string_view> tables{"R_OBJT_ACCESS", "R_OBJT_METAMAP"};
+
+        if (_ctx.effective_access_index_enabled) {
+            tables.push_back("R_OBJT_ACCESS_EFFECTIVE");
+        }
+
+        for (std::size_t offset = 0; offset < _ids.size(); offset += max_rows_per_statement) {
+            const auto count = std::min(max_rows_per_statement, _ids.size() - offset);
+
+            for (auto&& table : tables) {
+                const auto sql = fmt::format("delete from {0} where object_id in ({1}) and not exists ({2} = {0}.object_id)",
+                                             table, make_placeholders(count), _existence_check);
+
+                nanodbc::statement stmt{_ctx.db_conn};
+
+                prepare(stmt, sql);
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    stmt.bind(static_cast<short>(i), _ids[offset + i].c_str());
+                }
+
+                execute(stmt);
+            }
+        }
+    } // delete_object_rows
+
+    auto keep_collection(remove_context& _ctx, const fs::path& _collection) -> void
+    {
+        for (auto p = _collection; p != _ctx.path.parent_path(); p = p.parent_path()) {
+            if (!_ctx.kept_collections.insert(p.string()).second) {
+                break;
+            }
+        }
+    } // keep_collection
+
+    auto send_progress(remove_context& _ctx, int _objects_removed, const std::string& _last_path) -> int
+    {
+        if (!_ctx.output || _objects_removed == 0) {
+            return 0;
+        }
+
+        if (!*_ctx.output) {
+            *_ctx.output = static_cast<collOprStat_t*>(std::calloc(1, sizeof(collOprStat_t)));
+        }
+
+        (*_ctx.output)->filesCnt = _objects_removed;
+        (*_ctx.output)->totalFileCnt = _ctx.total_objects;
+        rstrcpy((*_ctx.output)->lastObjPath, _last_path.c_str(), MAX_NAME_LEN);
+
+        // The message is freed once it has been sent.
+        if (const auto ec = svrSendCollOprStat(&_ctx.comm, *_ctx.output); ec < 0) {
+            *_ctx.output = nullptr;
+            return ec;
+        }
+
+        *_ctx.output = static_cast<collOprStat_t*>(std::calloc(1, sizeof(collOprStat_t)));
+
+        return 0;
+    } // send_progress
+
+    auto remove_batch(remove_context& _ctx, std::vector<replica_info>& _replicas) -> int
+    {
+        // Data objects that must not be touched at all, by data id.
+        std::unordered_set<std::string> kept_objects;
+
+        for (auto&& r : _replicas) {
+            r.resource_hierarchy = resc_mgr.leaf_id_to_hier(r.resource_id);
+            r.resource_name = resc_mgr.resc_id_to_name(r.resource_id);
+
+            if (kept_objects.count(r.data_id) == 0 && !deletion_is_allowed(_ctx, r)) {
+                kept_objects.insert(r.data_id);
+            }
+        }
+
+        std::vector<unlink_task> tasks;
+        std::vector<std::optional<std::size_t>> task_index(_replicas.size());
+        std::vector<bool> removable(_replicas.size(), false);
+
+        tasks.reserve(_replicas.size());
+
+        for (std::size_t i = 0; i < _replicas.size(); ++i) {
+            const auto& r = _replicas[i];
+
+            if (kept_objects.count(r.data_id) > 0) {
+                continue;
+            }
+
+            try {
+                if (auto task = make_unlink_task(_ctx, r); task) {
+                    task_index[i] = tasks.size();
+                    tasks.push_back(*task);
+                }
+
+                removable[i] = true;
+            }
+            catch (const irods::exception& e) {
+                log::api::error("Cannot unlink replica [logical_path={}, replica_number={}]: {}",
+                                r.logical_path, r.replica_number, e.client_display_what());
+                _ctx.error = e.code();
+            }
+        }
+
+        std::vector<unlink_task*> task_ptrs;
+        task_ptrs.reserve(tasks.size());
+        std::transform(tasks.begin(), tasks.end(), std::back_inserter(task_ptrs), [](auto& _t) { return &_t; });
+
+        unlink_replicas(_ctx, task_ptrs);
+
+        std::vector<const replica_info*> removed;
+        std::vector<std::string> touched_ids;
+
+        for (std::size_t i = 0; i < _replicas.size(); ++i) {
+            const auto& r = _replicas[i];
+
+            if (removable[i] && task_index[i]) {
+                // Like dataObjUnlinkS, a missing or inaccessible file does not stop the
+                // replica from being unregistered.
+                if (const auto ec = tasks[*task_index[i]].status; ec < 0 && getErrno(ec) != ENOENT && getErrno(ec) != EACCES) {
+                    log::api::error("Failed to unlink replica [logical_path={}, replica_number={}, physical_path={}, error_code={}]",
+                                    r.logical_path, r.replica_number, r.physical_path, ec);
+                    _ctx.error = ec;
+                    removable[i] = false;
+                }
+            }
+
+            if (!removable[i]) {
+                keep_collection(_ctx, r.collection_name);
+                continue;
+            }
+
+            removed.push_back(&r);
+
+            if (touched_ids.empty() || touched_ids.back() != r.data_id) {
+                touched_ids.push_back(r.data_id);
+            }
+        }
+
+        if (removed.empty()) {
+            return 0;
+        }
+
+        const auto ec = ic::execute_transaction(_ctx.db_conn, [&](auto& _trans) -> int {
+            delete_replica_rows(_ctx, removed);
+            delete_object_rows(_ctx, "select d.data_id from R_DATA_MAIN d where d.data_id", touched_ids);
+
+            _trans.commit();
+
+            return 0;
+        });
+
+        if (ec < 0) {
+            return ec;
+        }
+
+        // Run the post-delete policy for every data object that no longer exists.
+        std::unordered_set<std::string> partially_removed;
+
+        for (std::size_t i = 0; i < _replicas.size(); ++i) {
+            if (!removable[i]) {
+                partially_removed.insert(_replicas[i].data_id);
+            }
+        }
+
+        int objects_removed = 0;
+        const replica_info* last_removed{};
+
+        for (const auto* r : removed) {
+            if (partially_removed.count(r->data_id) > 0 || (last_removed && last_removed->data_id == r->data_id)) {
+                continue;
+            }
+
+            dataObjInp_t input{};
+            irods::at_scope_exit free_input{[&input] { clearKeyVal(&input.condInput); }};
+            std::strncpy(input.objPath, r->logical_path.c_str(), MAX_NAME_LEN - 1);
+
+            ruleExecInfo_t rei{};
+            initReiWithDataObjInp(&rei, &_ctx.comm, &input);
+            irods::get_resc_properties_as_kvp(r->resource_hierarchy, rei.condInputData);
+
+            if (const auto status = applyRule("acPostProcForDelete", nullptr, &rei, NO_SAVE_REI); status < 0) {
+                log::api::info("acPostProcForDelete failed [logical_path={}, error_code={}]", r->logical_path, status);
+            }
+
+            clearKeyVal(rei.condInputData);
+            free(rei.condInputData);
+
+            ++objects_removed;
+            last_removed = r;
+        }
+
+        return send_progress(_ctx, objects_removed, last_removed ? last_removed->logical_path : std::string{});
+    } // remove_batch
+
+    // Deletes the collections in the subtree, deepest first, skipping those that still
+    // contain something.
+    auto remove_collections(remove_context& _ctx) -> int
+    {
+        const auto path = _ctx.path.string();
+
+        std::vector<std::tuple<std::string, std::string>> collections;
+
+        {
+            nanodbc::statement stmt{_ctx.db_conn};
+
+            prepare(stmt, fmt::format("select c.coll_id, c.coll_name from R_COLL_MAIN c where {}", subtree_condition("c")));
+
+            const auto pattern = escape_like_pattern(path) + "/%";
+
+            stmt.bind(0, path.c_str());
+            stmt.bind(1, pattern.c_str());
+
+            for (auto row = execute(stmt); row.next();) {
+                auto name = row.get<std::string>(1);
+
+                if (_ctx.kept_collections.count(name) == 0) {
+                    collections.emplace_back(row.get<std::string>(0), std::move(name));
+                }
+            }
+        }
+
+        // A collection's name is always longer than the names of the collections above it.
+        std::sort(collections.begin(), collections.end(), [](auto&& _lhs, auto&& _rhs) {
+            return std::get<1>(_lhs).size() > std::get<1>(_rhs).size();
+        });
+
+        std::vector<std::string> ids;
+        ids.reserve(collections.size());
+        std::transform(collections.begin(), collections.end(), std::back_inserter(ids), [](auto&& _c) { return std::get<0>(_c); });
+
+        for (std::size_t offset = 0; offset < ids.size(); offset += max_rows_per_statement) {
+            const auto count = std::min(max_rows_per_statement, ids.size() - offset);
+            const std::vector<std::string> batch(ids.begin() + offset, ids.begin() + offset + count);
+
+            const auto ec = ic::execute_transaction(_ctx.db_conn, [&](auto& _trans) -> int {
+                // Data objects created in the meantime keep their collection alive.
+                nanodbc::statement stmt{_ctx.db_conn};
+
+                const auto check_access = access_check_required(_ctx);
+
+                prepare(stmt, fmt::format("delete from R_COLL_MAIN where coll_id in ({}) and "
+                                          "not exists (select d.coll_id from R_DATA_MAIN d where d.coll_id = R_COLL_MAIN.coll_id){}",
+                                          make_placeholders(count),
+                                          check_access
+                                              ? fmt::format(" and {}", access_condition("R_COLL_MAIN.coll_id", ACCESS_DELETE_OBJECT))
+                                              : std::string{}));
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    stmt.bind(static_cast<short>(i), batch[i].c_str());
+                }
+
+                if (check_access) {
+                    stmt.bind(static_cast<short>(count), _ctx.comm.clientUser.userName);
+                    stmt.bind(static_cast<short>(count + 1), _ctx.comm.clientUser.rodsZone);
+                }
+
+                execute(stmt);
+
+                delete_object_rows(_ctx, "select c.coll_id from R_COLL_MAIN c where c.coll_id", batch);
+
+                _trans.commit();
+
+                return 0;
+            });
+
+            if (ec < 0) {
+                return ec;
+            }
+        }
+
+        if (_ctx.kept_collections.count(path) > 0 ||
+            count_rows(_ctx, "select count(*) from R_COLL_MAIN c where c.coll_name = ?", {path}) > 0)
+        {
+            return _ctx.error < 0 ? _ctx.error : SYS_COLLECTION_NOT_EMPTY;
+        }
+
+        return 0;
+    } // remove_collections
+
+    auto remove_subtree(remove_context& _ctx) -> int
+    {
+        const auto path = _ctx.path.string();
+
+        _ctx.total_objects = count_rows(_ctx,
+                                   fmt::format("select count(distinct d.data_id) from R_DATA_MAIN d "
+                                               "inner join R_COLL_MAIN c on d.coll_id = c.coll_id where {}",
+                                               subtree_condition("c")),
+                                   {path, escape_like_pattern(path) + "/%"});
+
+        std::string last_data_id = "0";
+
+        for (auto replicas = fetch_replicas(_ctx, last_data_id); !replicas.empty(); replicas = fetch_replicas(_ctx, last_data_id)) {
+            last_data_id = replicas.back().data_id;
+
+            if (const auto ec = remove_batch(_ctx, replicas); ec < 0) {
+                return ec;
+            }
+        }
+
+        if (const auto ec = remove_collections(_ctx); ec < 0) {
+            return ec;
+        }
+
+        return _ctx.error;
+    } // remove_subtree
+
+    auto update_parent_mtime(rsComm_t& _comm, const fs::path& _path) -> int
+    {
+        const auto parent_path = _path.parent_path();
+
+        if (!fs::server::is_collection_registered(_comm, parent_path)) {
+            return 0;
+        }
+
+        using std::chrono::system_clock;
+        using std::chrono::time_point_cast;
+
+        const auto mtime = time_point_cast<fs::object_time_type::duration>(system_clock::now());
+
+        try {
+            ix::scoped_privileged_client spc{_comm};
+            fs::server::last_write_time(_comm, parent_path, mtime);
+        }
+        catch (const fs::filesystem_error& e) {
+            log::api::error(e.what());
+            return e.code().value();
+        }
+
+        return 0;
+    } // update_parent_mtime
+
+    auto rs_remove_all(rsComm_t* _comm, bytesBuf_t* _input, collOprStat_t** _output) -> int
+    {
+        if (_output) {
+            *_output = nullptr;
+        }
+
+        try {
+            const auto json_input = parse_json(_input);
+            const auto opts = parse_options(json_input);
+            const fs::path path = json_input.at(prop_logical_path.data()).get<std::string>();
+
+            // Let rsRmColl route requests for other zones.
+            if (auto zone = fs::zone_name(path); !zone || !isLocalZone(zone->data())) {
+                return remove_using_rm_coll(*_comm, path, opts, _output);
+            }
+
+            if (!ic::connected_to_catalog_provider(*_comm)) {
+                log::api::trace("Redirecting request to catalog service provider ...");
+
+                auto host_info = ic::redirect_to_catalog_provider(*_comm);
+                const std::string json_string(static_cast<const char*>(_input->buf), _input->len);
+
+                collOprStat_t* stat{};
+                const auto ec = _rc_remove_all(host_info.conn, json_string.c_str(), &stat);
+
+                if (!_output) {
+                    return cliGetCollOprStat(host_info.conn, stat, 0, ec);
+                }
+
+                if (ec != SYS_SVR_TO_CLI_COLL_STAT) {
+                    *_output = stat;
+                    return ec;
+                }
+
+                return svrSendZoneCollOprStat(_comm, host_info.conn, stat, ec);
+            }
+
+            ic::throw_if_catalog_provider_service_role_is_invalid();
+
+            std::string db_instance_name;
+            nanodbc::connection db_conn;
+
+            std::tie(db_instance_name, db_conn) = ic::new_database_connection();
+
+            remove_context ctx{*_comm, db_conn, db_instance_name, path, opts, _output};
+            ctx.effective_access_index_enabled = ic::effective_access_index_enabled();
+
+            if (!supports_bulk_removal(ctx)) {
+                log::api::debug("Subtree cannot be removed in bulk. Using rsRmColl [logical_path={}].", path.c_str());
+                return remove_using_rm_coll(*_comm, path, opts, _output);
+            }
+
+            // Only the root of the subtree goes through the collection removal policy.
+            collInp_t coll_input{};
+            irods::at_scope_exit free_coll_input{[&coll_input] { clearKeyVal(&coll_input.condInput); }};
+
+            std::strncpy(coll_input.collName, path.c_str(), MAX_NAME_LEN - 1);
+            coll_input.oprType = opts.unregister ? UNREG_OPR : 0;
+            addKeyVal(&coll_input.condInput, RECURSIVE_OPR__KW, "");
+            addKeyVal(&coll_input.condInput, FORCE_FLAG_KW, "");
+
+            collInfo_t coll_info{};
+            ruleExecInfo_t rei{};
+            initReiWithCollInp(&rei, _comm, &coll_input, &coll_info);
+
+            irods::at_scope_exit free_rei{[&rei] {
+                clearKeyVal(rei.condInputData);
+                free(rei.condInputData);
+            }};
+
+            if (const auto status = applyRule("acPreprocForRmColl", nullptr, &rei, NO_SAVE_REI); status < 0) {
+                const auto ec = rei.status < 0 ? rei.status : status;
+                log::api::error("acPreprocForRmColl failed [logical_path={}, error_code={}]", path.c_str(), ec);
+                return ec;
+            }
+
+            auto ec = remove_subtree(ctx);
+
+            rei.status = ec;
+            if (const auto status = applyRule("acPostProcForRmColl", nullptr, &rei, NO_SAVE_REI); status < 0) {
+                log::api::error("acPostProcForRmColl failed [logical_path={}, error_code={}]", path.c_str(), status);
+            }
+
+            if (ec == 0) {
+                ec = update_parent_mtime(*_comm, path);
+            }
+
+            return ec;
+        }
+        catch (const fs::filesystem_error& e) {
+            log::api::error(e.what());
+            addRErrorMsg(&_comm->rError, e.code().value(), e.what());
+            return e.code().value();
+        }
+        catch (const irods::exception& e) {
+            log::api::error(e.what());
+            addRErrorMsg(&_comm->rError, e.code(), e.client_display_what());
+            return e.code();
+        }
+        catch (const std::exception& e) {
+            log::api::error(e.what());
+            addRErrorMsg(&_comm->rError, SYS_UNKNOWN_ERROR, "Cannot process request due to an unexpected error.");
+            return SYS_UNKNOWN_ERROR;
+        }
+    } // rs_remove_all
+
+    const operation op = rs_remove_all;
+    #define CALL_REMOVE_ALL call_remove_all
+} // anonymous namespace
+
+#else // RODS_SERVER
+
+//
+// Client-side Implementation
+//
+
+namespace
+{
+    using operation = std::function<int(rsComm_t*, bytesBuf_t*, collOprStat_t**)>;
+    const operation op{};
+    #define CALL_REMOVE_ALL nullptr
+} // anonymous namespace
+
+#endif // RODS_SERVER
+
+// The plugin factory function must always be defined.
+extern "C"
+auto plugin_factory(const std::string& _instance_name,
+                    const std::string& _context) -> irods::api_entry*
+{
+#ifdef RODS_SERVER
+    irods::client_api_whitelist::instance().add(REMOVE_ALL_APN);
+#endif // RODS_SERVER
+
+    // clang-format off
+    irods::apidef_t def{REMOVE_ALL_APN,         // API number
+                        RODS_API_VERSION,       // API version
+                        NO_USER_AUTH,           // Client auth
+                        NO_USER_AUTH,           // Proxy auth
+                        "BytesBuf_PI", 0,       // In PI / bs flag
+                        "CollOprStat_PI", 0,    // Out PI / bs flag
+                        op,                     // Operation
+                        "api_remove_all",       // Operation name
+                        nullptr,                // Clear function
+                        (funcPtr) CALL_REMOVE_ALL};
+    // clang-format on
+
+    auto* api = new irods::api_entry{def};
+
+    api->in_pack_key = "BytesBuf_PI";
+    api->in_pack_value = BytesBuf_PI;
+
+    api->out_pack_key = "CollOprStat_PI";
+    api->out_pack_value = CollOprStat_PI;
+
+    return api;
+}
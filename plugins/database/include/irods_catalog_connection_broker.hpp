@@ -0,0 +1,82 @@
+#ifndef IRODS_CATALOG_CONNECTION_BROKER_HPP
+#define IRODS_CATALOG_CONNECTION_BROKER_HPP
+
+/// \file
+
+#include <cstdint>
+#include <string_view>
+
+/// Limits the number of catalog connections held by the agents of a catalog service provider.
+///
+/// An ODBC connection cannot be handed from one process to another, so agents keep opening
+/// their own connections. What the agents share instead is a table of leases in shared memory.
+/// An agent must hold a lease while its connection is open. Agents waiting for a lease are
+/// served in the order they asked, and an agent gives its lease back as soon as others are
+/// waiting and it has no open transaction or query.
+namespace irods::experimental::catalog_connection_broker
+{
+    /// Counters shared by all agents of the server.
+    struct statistics
+    {
+        std::int32_t leases_held;
+        std::int32_t agents_waiting;
+        std::uint64_t leases_granted;
+        std::uint64_t leases_granted_after_timeout;
+        std::uint64_t total_wait_milliseconds;
+        std::uint64_t max_wait_milliseconds;
+        std::uint64_t total_lease_milliseconds;
+    }; // struct statistics
+
+    /// Sets the number of leases available to all agents. Zero disables the broker.
+    ///
+    /// \param[in] _max_connections   The maximum number of catalog connections.
+    /// \param[in] _wait_timeout_secs The number of seconds an agent waits for a lease before it
+    ///                               connects anyway. This keeps agents which wait on each other
+    ///                               (e.g. through a redirect back to this server) from deadlocking.
+    /// \param[in] _shm_name          The name of the shared memory segment holding the leases.
+    ///                               Every agent of a server must use the same name.
+    ///
+    /// \since 4.3.0
+    auto configure(std::int32_t _max_connections, std::int32_t _wait_timeout_secs, std::string_view _shm_name) -> void;
+
+    /// Returns true if configure() enabled the broker.
+    ///
+    /// \since 4.3.0
+    auto enabled() noexcept -> bool;
+
+    /// Blocks until this agent holds a lease. Does nothing if it already holds one.
+    ///
+    /// \since 4.3.0
+    auto acquire() -> void;
+
+    /// Gives the lease of this agent back. Does nothing if it does not hold one.
+    ///
+    /// \since 4.3.0
+    auto release() -> void;
+
+    /// Returns true if this agent holds a lease.
+    ///
+    /// \since 4.3.0
+    auto holds_lease() noexcept -> bool;
+
+    /// Returns true if any agent is waiting for a lease.
+    ///
+    /// \since 4.3.0
+    auto agents_waiting() -> bool;
+
+    /// Returns the counters shared by all agents.
+    ///
+    /// \since 4.3.0
+    auto stats() -> statistics;
+
+    /// Removes the shared memory segment holding the leases.
+    ///
+    /// Only the process which outlives all agents (i.e. the server) should call this.
+    ///
+    /// \param[in] _shm_name The name passed to configure().
+    ///
+    /// \since 4.3.0
+    auto remove_shared_memory(std::string_view _shm_name) noexcept -> void;
+} // namespace irods::experimental::catalog_connection_broker
+
+#endif // IRODS_CATALOG_CONNECTION_BROKER_HPP
@@ -37,5 +37,8 @@ int cllCurrentValueString( const char *itemName, char *outString, int maxSize );
 int cllGetRowCount( icatSessionStruct *icss, int statementNumber );
 int cllCheckPending( const char *sql, int option, int dbType );
 int cllGetLastErrorMessage( char *msg, int maxChars );
+int cllGetPendingWriteCount();
+int cllGetSessionWriteCount();
+int cllReadsMayUseReplica( int readYourWrites );
 
 #endif	/* CLL_ODBC_HPP */
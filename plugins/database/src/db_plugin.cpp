@@ -33,6 +33,8 @@
 #include "modAccessControl.h"
 #include "checksum.hpp"
 #include "key_value_proxy.hpp"
+#include "shared_memory_object.hpp"
+#include "irods_catalog_connection_broker.hpp"
 
 // =-=-=-=-=-=-=-
 // irods includes
@@ -47,6 +49,9 @@
 #include <string_view>
 #include <iostream>
 #include <vector>
+#include <optional>
+#include <unordered_map>
+#include <cstdint>
 #include <boost/regex.hpp>
 #include <boost/lexical_cast.hpp>
 
@@ -96,6 +101,42 @@ char irods_pam_password_default_time[ NAME_LEN ] = { "1209600" };
 
 size_t log_sql_flg = 0;
 icatSessionStruct icss; // JMC :: only for testing!!!
+
+// =-=-=-=-=-=-=-
+// optional connection to a read replica of the catalog.  only read-only
+// queries (general, specific and simple queries) are ever sent to it.
+icatSessionStruct icss_read_replica;
+bool read_replica_read_your_writes = true;
+
+// =-=-=-=-=-=-=-
+// set by db_open_op, the connection is opened by open_catalog_connection
+bool catalog_connection_requested = false;
+
+// =-=-=-=-=-=-=-
+// the number of seconds an agent waits for a catalog connection lease when
+// db_connection_wait_timeout is not configured
+const int DEFAULT_CATALOG_CONNECTION_WAIT_TIMEOUT = 30;
+
+namespace ccb = irods::experimental::catalog_connection_broker;
+
+// =-=-=-=-=-=-=-
+// when set, R_OBJT_ACCESS_EFFECTIVE is kept up to date alongside R_OBJT_ACCESS
+// and R_USER_GROUP.  general queries only use it for their access checks once
+// the table is known to be complete, see sync_effective_access_index.
+bool effective_access_index_enabled = false;
+bool effective_access_index_valid = false;
+
+// =-=-=-=-=-=-=-
+// the R_GRID_CONFIGURATION row recording that R_OBJT_ACCESS_EFFECTIVE is
+// complete.  servers running without the index clear it, as they do not
+// maintain the table.
+const char* const EFFECTIVE_ACCESS_MARKER_NAMESPACE = "database";
+const char* const EFFECTIVE_ACCESS_MARKER_OPTION = "effective_access_index_valid";
+
+// =-=-=-=-=-=-=-
+// continuation indices of queries running on the read replica are offset by
+// this value so that follow-up calls are routed to the same connection.
+const int READ_REPLICA_CONTINUE_INX_OFFSET = MAX_NUM_OF_CONCURRENT_STMTS;
 extern int logSQL;
 
 int  creatingUserByGroupAdmin; // JMC - backport 4772
@@ -186,6 +227,412 @@ irods::error make_db_ptr(
 
 } // make_db_ptr
 
+// =-=-=-=-=-=-=-
+// select the connection on which a new read-only query should run
+icatSessionStruct* get_read_only_session() {
+    if ( icss_read_replica.status != 1 ) {
+        return &icss;
+    }
+
+    // =-=-=-=-=-=-=-
+    // uncommitted changes are only visible on the primary, and once this
+    // agent has modified the catalog the replica may lag behind what the
+    // client expects to see
+    if ( !cllReadsMayUseReplica( read_replica_read_your_writes ) ) {
+        return &icss;
+    }
+
+    return &icss_read_replica;
+
+} // get_read_only_session
+
+// =-=-=-=-=-=-=-
+// map a continuation index (always > 0) to the connection the query is
+// running on and strip the read replica offset from it
+icatSessionStruct* decode_continue_inx( int& _continue_inx ) {
+    if ( _continue_inx > READ_REPLICA_CONTINUE_INX_OFFSET ) {
+        _continue_inx -= READ_REPLICA_CONTINUE_INX_OFFSET;
+        return &icss_read_replica;
+    }
+
+    return &icss;
+
+} // decode_continue_inx
+
+// =-=-=-=-=-=-=-
+// tag a continuation index with the connection the query is running on
+int encode_continue_inx(
+    const icatSessionStruct* _session,
+    int                      _continue_inx ) {
+    if ( _session == &icss_read_replica && _continue_inx > 0 ) {
+        return _continue_inx + READ_REPLICA_CONTINUE_INX_OFFSET;
+    }
+
+    return _continue_inx;
+
+} // encode_continue_inx
+
+// =-=-=-=-=-=-=-
+// open the catalog connection requested by db_open_op, if it is not open yet.
+// deferring the connection until the first catalog operation means agents
+// which never touch the catalog do not hold a database connection.
+int sync_effective_access_index();
+
+irods::error open_catalog_connection() {
+    if ( !catalog_connection_requested || 1 == icss.status ) {
+        return SUCCESS();
+    }
+
+    // =-=-=-=-=-=-=-
+    // wait for a lease when the number of connections held by the agents of
+    // this server is limited
+    ccb::acquire();
+
+    // =-=-=-=-=-=-=-
+    // call open in mid level
+    int status = cmlOpen( &icss );
+    if ( 0 != status ) {
+        ccb::release();
+        return ERROR(
+                   status,
+                   "failed to open db connection" );
+    }
+
+    // =-=-=-=-=-=-=-
+    // set success flag
+    icss.status = 1;
+
+    // =-=-=-=-=-=-=-
+    // open the read replica, if configured.  failing to do so is not fatal,
+    // read-only queries simply continue to use the primary.
+    if ( icss_read_replica.odbcEntryName[0] != '\0' && icss_read_replica.status != 1 ) {
+        if ( const int replica_status = cmlOpen( &icss_read_replica ); replica_status == 0 ) {
+            icss_read_replica.status = 1;
+        }
+        else {
+            rodsLog( LOG_WARNING,
+                     "open_catalog_connection - failed to open read replica connection [%s], status = %d",
+                     icss_read_replica.odbcEntryName, replica_status );
+        }
+    }
+
+    // =-=-=-=-=-=-=-
+    // Capture ICAT properties
+#if MY_ICAT
+#elif ORA_ICAT
+#else
+    irods::catalog_properties::instance().capture_if_needed( &icss );
+#endif
+
+    // =-=-=-=-=-=-=-
+    // failing to validate the effective access index is not fatal either,
+    // general queries fall back to joining R_OBJT_ACCESS.
+    if ( const int sync_status = sync_effective_access_index(); sync_status != 0 ) {
+        rodsLog( LOG_ERROR,
+                 "open_catalog_connection - failed to synchronize the effective access index, status = %d",
+                 sync_status );
+    }
+
+    return SUCCESS();
+
+} // open_catalog_connection
+
+// =-=-=-=-=-=-=-
+// close the catalog connections and give their lease back.  the connection
+// is reopened by the next operation that needs it.
+int close_catalog_connection() {
+    int status = 0;
+    if ( 1 == icss.status ) {
+        status = cmlClose( &icss );
+        icss.status = 0;
+    }
+
+    // =-=-=-=-=-=-=-
+    // close the read replica after the primary so that pending
+    // changes are committed on the correct connection
+    if ( icss_read_replica.status == 1 ) {
+        if ( const int replica_status = cmlClose( &icss_read_replica ); replica_status != 0 ) {
+            rodsLog( LOG_WARNING,
+                     "close_catalog_connection - failed to close read replica connection, status = %d",
+                     replica_status );
+        }
+        icss_read_replica.status = 0;
+    }
+
+    ccb::release();
+
+    return status;
+
+} // close_catalog_connection
+
+// =-=-=-=-=-=-=-
+// a connection with an open transaction or an open query (e.g. a general
+// query the client has not finished reading) must stay with this agent
+bool catalog_connection_is_pinned() {
+    if ( cllGetPendingWriteCount() > 0 ) {
+        return true;
+    }
+
+    for ( const icatSessionStruct* session : { &icss, &icss_read_replica } ) {
+        if ( session->status != 1 ) {
+            continue;
+        }
+
+        const auto begin = std::begin( session->stmtPtr );
+        const auto end = std::end( session->stmtPtr );
+        if ( std::any_of( begin, end, []( const icatStmtStrct* _stmt ) { return _stmt != nullptr; } ) ) {
+            return true;
+        }
+    }
+
+    return false;
+
+} // catalog_connection_is_pinned
+
+// =-=-=-=-=-=-=-
+// the number of plugin operations in progress.  an operation may call other
+// operations (e.g. chlGeneralUpdate fetches the connection through
+// chlGetRcs), and the connection must outlive the outermost one.
+int catalog_operation_depth = 0;
+
+// =-=-=-=-=-=-=-
+// give the lease back after an operation if other agents are waiting for
+// one.  keeping the connection otherwise saves reconnecting for every call.
+void release_catalog_connection_if_contended() {
+    if ( catalog_operation_depth > 0 ) {
+        return;
+    }
+
+    if ( !ccb::holds_lease() || 1 != icss.status || catalog_connection_is_pinned() ) {
+        return;
+    }
+
+    if ( !ccb::agents_waiting() ) {
+        return;
+    }
+
+    if ( const int status = close_catalog_connection(); status != 0 ) {
+        rodsLog( LOG_WARNING,
+                 "release_catalog_connection_if_contended - failed to close db connection, status = %d",
+                 status );
+    }
+
+    if ( getRodsLogLevel() >= LOG_DEBUG ) {
+        const auto stats = ccb::stats();
+        rodsLog( LOG_DEBUG,
+                 "catalog connection leases: held = %d, waiting = %d, granted = %llu, "
+                 "granted after timeout = %llu, wait ms (total/max) = %llu/%llu, lease ms (total) = %llu",
+                 stats.leases_held, stats.agents_waiting,
+                 static_cast<unsigned long long>( stats.leases_granted ),
+                 static_cast<unsigned long long>( stats.leases_granted_after_timeout ),
+                 static_cast<unsigned long long>( stats.total_wait_milliseconds ),
+                 static_cast<unsigned long long>( stats.max_wait_milliseconds ),
+                 static_cast<unsigned long long>( stats.total_lease_milliseconds ) );
+    }
+
+} // release_catalog_connection_if_contended
+
+// =-=-=-=-=-=-=-
+// wrap a plugin operation so that the catalog connection is opened
+// before the operation runs, and released afterwards if other agents
+// are waiting for a connection
+template <typename... Args>
+auto with_catalog_connection(
+    irods::error ( *_op )( irods::plugin_context&, Args... ) ) {
+    return [_op]( irods::plugin_context& _ctx, Args... _args ) -> irods::error {
+        irods::error ret = open_catalog_connection();
+        if ( !ret.ok() ) {
+            return PASS( ret );
+        }
+
+        ++catalog_operation_depth;
+        ret = _op( _ctx, _args... );
+        --catalog_operation_depth;
+
+        release_catalog_connection_if_contended();
+        return ret;
+    };
+
+} // with_catalog_connection
+
+// =-=-=-=-=-=-=-
+// wrap a plugin operation which hands the catalog connection to its caller.
+// the caller uses the connection after the operation returns, so the lease
+// is kept until the next operation finishes or the connection is closed.
+template <typename... Args>
+auto with_held_catalog_connection(
+    irods::error ( *_op )( irods::plugin_context&, Args... ) ) {
+    return [_op]( irods::plugin_context& _ctx, Args... _args ) -> irods::error {
+        irods::error ret = open_catalog_connection();
+        if ( !ret.ok() ) {
+            return PASS( ret );
+        }
+
+        return _op( _ctx, _args... );
+    };
+
+} // with_held_catalog_connection
+
+// =-=-=-=-=-=-=-
+// specific queries resolved by this agent, keyed by the sql string or alias
+// provided by the client.  every agent on the catalog provider shares a
+// generation number which is bumped whenever a specific query is added or
+// removed, and a cache built for an older generation is discarded.  the
+// number of cache hits across all agents is kept in shared memory as well.
+const std::size_t SPECIFIC_QUERY_CACHE_MAX_ENTRIES = 1000;
+std::unordered_map<std::string, std::string> specific_query_cache;
+std::uint64_t specific_query_cache_generation = 0;
+
+auto specific_query_generation() -> irods::experimental::interprocess::shared_memory_object<std::uint64_t>& {
+    static irods::experimental::interprocess::shared_memory_object<std::uint64_t> generation{"irods_specific_query_generation"};
+    return generation;
+} // specific_query_generation
+
+auto specific_query_cache_hits() -> irods::experimental::interprocess::shared_memory_object<std::uint64_t>& {
+    static irods::experimental::interprocess::shared_memory_object<std::uint64_t> hits{"irods_specific_query_cache_hits"};
+    return hits;
+} // specific_query_cache_hits
+
+// =-=-=-=-=-=-=-
+// returns the current generation, or nothing if the shared generation
+// number is unavailable, in which case caching is disabled
+auto get_specific_query_generation() -> std::optional<std::uint64_t> {
+    try {
+        return specific_query_generation().atomic_exec( []( auto& _generation ) { return _generation; } );
+    }
+    catch ( const std::exception& e ) {
+        rodsLog( LOG_DEBUG, "get_specific_query_generation - specific query cache disabled: %s", e.what() );
+        return std::nullopt;
+    }
+} // get_specific_query_generation
+
+auto lookup_specific_query(
+    const std::optional<std::uint64_t>& _generation,
+    const std::string&                  _sql_or_alias ) -> const std::string* {
+    if ( !_generation ) {
+        return nullptr;
+    }
+
+    if ( *_generation != specific_query_cache_generation ) {
+        specific_query_cache.clear();
+        specific_query_cache_generation = *_generation;
+        return nullptr;
+    }
+
+    const auto iter = specific_query_cache.find( _sql_or_alias );
+    if ( iter == specific_query_cache.end() ) {
+        return nullptr;
+    }
+
+    try {
+        specific_query_cache_hits().atomic_exec( []( auto& _hits ) { ++_hits; } );
+    }
+    catch ( const std::exception& e ) {
+        rodsLog( LOG_DEBUG, "lookup_specific_query - %s", e.what() );
+    }
+
+    return &iter->second;
+} // lookup_specific_query
+
+// =-=-=-=-=-=-=-
+// the resolved sql is only cached if no specific query was added or removed
+// since the lookup, as it may have been read before that change committed.
+// a read replica may not have applied the change yet even then, so only
+// lookups on the primary connection are cached.
+auto cache_specific_query(
+    const icatSessionStruct*            _session,
+    const std::optional<std::uint64_t>& _generation,
+    const std::string&                  _sql_or_alias,
+    const std::string&                  _sql ) -> void {
+    if ( _session != &icss ) {
+        return;
+    }
+
+    if ( !_generation || *_generation != specific_query_cache_generation ) {
+        return;
+    }
+
+    if ( get_specific_query_generation() != _generation ) {
+        return;
+    }
+
+    if ( specific_query_cache.size() >= SPECIFIC_QUERY_CACHE_MAX_ENTRIES ) {
+        specific_query_cache.clear();
+    }
+
+    specific_query_cache.insert_or_assign( _sql_or_alias, _sql );
+} // cache_specific_query
+
+auto invalidate_specific_query_caches() -> void {
+    specific_query_cache.clear();
+
+    try {
+        specific_query_generation().atomic_exec( []( auto& _generation ) { ++_generation; } );
+    }
+    catch ( const std::exception& e ) {
+        rodsLog( LOG_DEBUG, "invalidate_specific_query_caches - %s", e.what() );
+    }
+} // invalidate_specific_query_caches
+
+// =-=-=-=-=-=-=-
+// recompute the rows of R_OBJT_ACCESS_EFFECTIVE for the objects selected by
+// _object_filter and, if given, the users selected by _user_filter.  both are
+// sql expressions yielding ids which consume the matching bind variables.
+// R_OBJT_ACCESS_EFFECTIVE holds one row per (user, object) with the highest
+// access the user has to the object, either directly or through a group.
+int refresh_effective_access(
+    const std::string&              _object_filter,
+    const std::vector<std::string>& _object_bind_vars,
+    const std::string&              _user_filter = {},
+    const std::vector<std::string>& _user_bind_vars = {} ) {
+    if ( !effective_access_index_enabled ) {
+        return 0;
+    }
+
+    const auto bind = [&] {
+        for ( const auto& v : _object_bind_vars ) {
+            cllBindVars[cllBindVarCount++] = v.c_str();
+        }
+        for ( const auto& v : _user_bind_vars ) {
+            cllBindVars[cllBindVarCount++] = v.c_str();
+        }
+    };
+
+    std::string delete_sql = "delete from R_OBJT_ACCESS_EFFECTIVE where object_id in (" + _object_filter + ")";
+    std::string insert_sql = "insert into R_OBJT_ACCESS_EFFECTIVE (user_id, object_id, access_type_id) "
+                             "select UG.user_id, OA.object_id, max(OA.access_type_id) from R_OBJT_ACCESS OA, R_USER_GROUP UG, R_USER_MAIN UM "
+                             "where UG.group_user_id = OA.user_id and UM.user_id = UG.user_id and UM.user_type_name != 'rodsgroup' "
+                             "and OA.object_id in (" + _object_filter + ")";
+    if ( !_user_filter.empty() ) {
+        delete_sql += " and user_id in (" + _user_filter + ")";
+        insert_sql += " and UG.user_id in (" + _user_filter + ")";
+    }
+    insert_sql += " group by UG.user_id, OA.object_id";
+
+    if ( logSQL != 0 ) {
+        rodsLog( LOG_SQL, "refresh_effective_access SQL 1" );
+    }
+    bind();
+    int status = cmlExecuteNoAnswerSql( delete_sql.c_str(), &icss );
+    if ( status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO ) {
+        rodsLog( LOG_NOTICE, "refresh_effective_access delete failure %d", status );
+        return status;
+    }
+
+    if ( logSQL != 0 ) {
+        rodsLog( LOG_SQL, "refresh_effective_access SQL 2" );
+    }
+    bind();
+    status = cmlExecuteNoAnswerSql( insert_sql.c_str(), &icss );
+    if ( status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO ) {
+        rodsLog( LOG_NOTICE, "refresh_effective_access insert failure %d", status );
+        return status;
+    }
+
+    return 0;
+
+} // refresh_effective_access
+
 // =-=-=-=-=-=-=-
 //  Called internally to rollback current transaction after an error.
 int _rollback( const char *functionName ) {
@@ -207,6 +654,103 @@ int _rollback( const char *functionName ) {
 
 } // _rollback
 
+// =-=-=-=-=-=-=-
+// decide whether general queries may use R_OBJT_ACCESS_EFFECTIVE.  the table
+// is only trusted while the marker row exists.  when the index is disabled the
+// marker is removed, since this server will not maintain the table.  when it
+// is enabled and the marker is missing, the table is repopulated from
+// R_OBJT_ACCESS and the marker is set in the same transaction.
+int sync_effective_access_index() {
+    effective_access_index_valid = false;
+
+    char marker[MAX_NAME_LEN]{};
+    int status;
+    {
+        std::vector<std::string> bindVars;
+        bindVars.push_back( EFFECTIVE_ACCESS_MARKER_NAMESPACE );
+        bindVars.push_back( EFFECTIVE_ACCESS_MARKER_OPTION );
+        status = cmlGetStringValueFromSql(
+                     "select option_value from R_GRID_CONFIGURATION where namespace=? and option_name=?",
+                     marker, MAX_NAME_LEN, bindVars, &icss );
+    }
+    if ( status != 0 && status != CAT_NO_ROWS_FOUND ) {
+        return status;
+    }
+    const bool marker_found = ( status == 0 );
+
+    if ( !effective_access_index_enabled ) {
+        if ( !marker_found ) {
+            return 0;
+        }
+
+        if ( logSQL != 0 ) {
+            rodsLog( LOG_SQL, "sync_effective_access_index SQL 1" );
+        }
+        cllBindVars[cllBindVarCount++] = EFFECTIVE_ACCESS_MARKER_NAMESPACE;
+        cllBindVars[cllBindVarCount++] = EFFECTIVE_ACCESS_MARKER_OPTION;
+        status = cmlExecuteNoAnswerSql( "delete from R_GRID_CONFIGURATION where namespace=? and option_name=?", &icss );
+        if ( status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO ) {
+            _rollback( "sync_effective_access_index" );
+            return status;
+        }
+        return cmlExecuteNoAnswerSql( "commit", &icss );
+    }
+
+    if ( marker_found ) {
+        effective_access_index_valid = true;
+        return 0;
+    }
+
+    // =-=-=-=-=-=-=-
+    // the unique index on R_GRID_CONFIGURATION serializes agents racing to
+    // repopulate the table.  the losers keep using R_OBJT_ACCESS until their
+    // next connection.
+    rodsLog( LOG_NOTICE, "sync_effective_access_index - repopulating R_OBJT_ACCESS_EFFECTIVE" );
+
+    if ( logSQL != 0 ) {
+        rodsLog( LOG_SQL, "sync_effective_access_index SQL 2" );
+    }
+    cllBindVars[cllBindVarCount++] = EFFECTIVE_ACCESS_MARKER_NAMESPACE;
+    cllBindVars[cllBindVarCount++] = EFFECTIVE_ACCESS_MARKER_OPTION;
+    status = cmlExecuteNoAnswerSql( "insert into R_GRID_CONFIGURATION (namespace, option_name, option_value) values (?, ?, 'true')", &icss );
+    if ( status != 0 ) {
+        _rollback( "sync_effective_access_index" );
+        return 0;
+    }
+
+    if ( logSQL != 0 ) {
+        rodsLog( LOG_SQL, "sync_effective_access_index SQL 3" );
+    }
+    status = cmlExecuteNoAnswerSql( "delete from R_OBJT_ACCESS_EFFECTIVE", &icss );
+    if ( status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO ) {
+        _rollback( "sync_effective_access_index" );
+        return status;
+    }
+
+    if ( logSQL != 0 ) {
+        rodsLog( LOG_SQL, "sync_effective_access_index SQL 4" );
+    }
+    status = cmlExecuteNoAnswerSql(
+                 "insert into R_OBJT_ACCESS_EFFECTIVE (user_id, object_id, access_type_id) "
+                 "select UG.user_id, OA.object_id, max(OA.access_type_id) from R_OBJT_ACCESS OA, R_USER_GROUP UG, R_USER_MAIN UM "
+                 "where UG.group_user_id = OA.user_id and UM.user_id = UG.user_id and UM.user_type_name != 'rodsgroup' "
+                 "group by UG.user_id, OA.object_id",
+                 &icss );
+    if ( status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO ) {
+        _rollback( "sync_effective_access_index" );
+        return status;
+    }
+
+    status = cmlExecuteNoAnswerSql( "commit", &icss );
+    if ( status != 0 ) {
+        return status;
+    }
+
+    effective_access_index_valid = true;
+    return 0;
+
+} // sync_effective_access_index
+
 // =-=-=-=-=-=-=-
 //  Internal function to return the local zone (which is the default
 //  zone).  The first time it's called, it gets the zone from the DB and
@@ -899,6 +1443,9 @@ static int _delColl( rsComm_t *rsComm, collInfo_t *collInfo ) {
                  status );
         _rollback( "_delColl" );
     }
+    else if ( ( status = refresh_effective_access( "?", { collIdNum } ) ) != 0 ) {
+        _rollback( "_delColl" );
+    }
 
     /* Remove associated AVUs, if any */
     removeMetaMapAndAVU( collIdNum );
@@ -1882,6 +2429,44 @@ irods::error db_open_op(
         snprintf(icss.databaseUsername, DB_USERNAME_LEN, "%s", boost::any_cast<const std::string&>(boost::any_cast<const std::unordered_map<std::string, boost::any>>(db_plugin).at(irods::CFG_DB_USERNAME_KW)).c_str());
         snprintf(icss.databasePassword, DB_PASSWORD_LEN, "%s", boost::any_cast<const std::string&>(boost::any_cast<const std::unordered_map<std::string, boost::any>>(db_plugin).at(irods::CFG_DB_PASSWORD_KW)).c_str());
         snprintf(icss.database_plugin_type, DB_TYPENAME_LEN, "%s", db_type.c_str());
+
+        const auto& db_plugin_cfg = boost::any_cast<const std::unordered_map<std::string, boost::any>&>(db_plugin);
+        if ( const auto iter = db_plugin_cfg.find( irods::CFG_DB_EFFECTIVE_ACCESS_INDEX_KW ); iter != db_plugin_cfg.end() ) {
+            effective_access_index_enabled = boost::any_cast<const bool&>( iter->second );
+        }
+
+        // =-=-=-=-=-=-=-
+        // the read replica uses the primary's credentials unless overridden
+        if ( const auto iter = db_plugin_cfg.find( irods::CFG_DB_READ_REPLICA_KW ); iter != db_plugin_cfg.end() ) {
+            const auto& replica_cfg = boost::any_cast<const std::unordered_map<std::string, boost::any>&>(iter->second);
+            const auto get_or_default = [&replica_cfg]( const std::string& _key, const char* _default ) -> std::string {
+                const auto it = replica_cfg.find( _key );
+                return it == replica_cfg.end() ? _default : boost::any_cast<const std::string&>( it->second );
+            };
+
+            snprintf(icss_read_replica.odbcEntryName, DB_TYPENAME_LEN, "%s", boost::any_cast<const std::string&>(replica_cfg.at(irods::CFG_DB_ODBC_DSN_KW)).c_str());
+            snprintf(icss_read_replica.databaseUsername, DB_USERNAME_LEN, "%s", get_or_default(irods::CFG_DB_USERNAME_KW, icss.databaseUsername).c_str());
+            snprintf(icss_read_replica.databasePassword, DB_PASSWORD_LEN, "%s", get_or_default(irods::CFG_DB_PASSWORD_KW, icss.databasePassword).c_str());
+            snprintf(icss_read_replica.database_plugin_type, DB_TYPENAME_LEN, "%s", db_type.c_str());
+
+            if ( const auto it = replica_cfg.find( irods::CFG_DB_READ_YOUR_WRITES_KW ); it != replica_cfg.end() ) {
+                read_replica_read_your_writes = boost::any_cast<const bool&>( it->second );
+            }
+        }
+
+        // =-=-=-=-=-=-=-
+        // limit the number of connections held by the agents of this server
+        int max_connections = 0;
+        int wait_timeout = DEFAULT_CATALOG_CONNECTION_WAIT_TIMEOUT;
+        if ( const auto iter = db_plugin_cfg.find( irods::CFG_DB_MAX_CONNECTIONS_KW ); iter != db_plugin_cfg.end() ) {
+            max_connections = boost::any_cast<const int&>( iter->second );
+        }
+        if ( const auto iter = db_plugin_cfg.find( irods::CFG_DB_CONNECTION_WAIT_TIMEOUT_KW ); iter != db_plugin_cfg.end() ) {
+            wait_timeout = boost::any_cast<const int&>( iter->second );
+        }
+        ccb::configure( max_connections, wait_timeout, irods::CATALOG_CONNECTION_LEASES_SHM_NAME );
+    } catch ( const std::out_of_range& e ) {
+        return ERROR(KEY_NOT_FOUND, "Missing db_odbc_dsn in the read replica database configuration");
     } catch ( const irods::exception& e ) {
         return irods::error(e);
     } catch ( const boost::exception& e ) {
@@ -1889,25 +2474,9 @@ irods::error db_open_op(
     }
 
     // =-=-=-=-=-=-=-
-    // call open in mid level
-    int status = cmlOpen( &icss );
-    if ( 0 != status ) {
-        return ERROR(
-                   status,
-                   "failed to open db connection" );
-    }
-
-    // =-=-=-=-=-=-=-
-    // set success flag
-    icss.status = 1;
-
-    // =-=-=-=-=-=-=-
-    // Capture ICAT properties
-#if MY_ICAT
-#elif ORA_ICAT
-#else
-    irods::catalog_properties::instance().capture_if_needed( &icss );
-#endif
+    // the connection itself is opened on first use by open_catalog_connection
+    catalog_connection_requested = true;
+    int status = 0;
 
     // =-=-=-=-=-=-=-
     // set pam properties
@@ -1956,19 +2525,24 @@ irods::error db_close_op(
 //        icatSessionStruct icss;
 //        _ctx.prop_map().get< icatSessionStruct >( ICSS_PROP, icss );
 
+    catalog_connection_requested = false;
+
     // =-=-=-=-=-=-=-
-    // call open in mid level
-    int status = cmlClose( &icss );
+    // nothing to do if the connection was never used
+    if ( 1 != icss.status ) {
+        ccb::release();
+        return SUCCESS();
+    }
+
+    // =-=-=-=-=-=-=-
+    // call close in mid level
+    int status = close_catalog_connection();
     if ( 0 != status ) {
         return ERROR(
                    status,
                    "failed to close db connection" );
     }
 
-    // =-=-=-=-=-=-=-
-    // set success flag
-    icss.status = 0;
-
     return CODE( status );
 
 } // db_close_op
@@ -2785,6 +3359,12 @@ irods::error db_reg_data_obj_op(
         }
     }
 
+    status = refresh_effective_access( "?", { dataIdNum } );
+    if ( status != 0 ) {
+        _rollback( "chlRegDataObj" );
+        return ERROR( status, "failed to update effective access" );
+    }
+
     if ( !( _data_obj_info->flags & NO_COMMIT_FLAG ) ) {
         status =  cmlExecuteNoAnswerSql( "commit", &icss );
         if ( status != 0 ) {
@@ -3275,6 +3855,12 @@ irods::error db_unreg_replica_op(
         if ( status == 0 ) {
             removeMetaMapAndAVU( dataObjNumber ); /* remove AVU metadata, if any */
         }
+
+        status = refresh_effective_access( "?", { dataObjNumber } );
+        if ( status != 0 ) {
+            _rollback( "chlUnregDataObj" );
+            return ERROR( status, "failed to update effective access" );
+        }
     }
 
     status =  cmlExecuteNoAnswerSql( "commit", &icss );
@@ -4443,6 +5029,20 @@ irods::error db_del_user_re_op(
         return ERROR( status, "Error removing user_group entry" );
     }
 
+    /* Members of a removed group lose the access granted through it */
+    status = refresh_effective_access( "select object_id from R_OBJT_ACCESS where user_id=?", { iValStr } );
+    if ( status == 0 && effective_access_index_enabled ) {
+        cllBindVars[cllBindVarCount++] = iValStr;
+        status = cmlExecuteNoAnswerSql( "delete from R_OBJT_ACCESS_EFFECTIVE where user_id=?", &icss );
+        if ( status == CAT_SUCCESS_BUT_WITH_NO_INFO ) {
+            status = 0;
+        }
+    }
+    if ( status != 0 ) {
+        _rollback( "chlDelUserRE" );
+        return ERROR( status, "failed to update effective access" );
+    }
+
     /* Remove any R_USER_AUTH rows for this user */
     cllBindVars[cllBindVarCount++] = iValStr;
     if ( logSQL != 0 ) {
@@ -4663,6 +5263,12 @@ irods::error db_reg_coll_by_admin_op(
         return ERROR( status, "cmlExecuteNoAnswerSql(insert access) failure" );
     }
 
+    status = refresh_effective_access( "select coll_id from R_COLL_MAIN where coll_name=?", { _coll_info->collName } );
+    if ( status != 0 ) {
+        _rollback( "chlRegCollByAdmin" );
+        return ERROR( status, "failed to update effective access" );
+    }
+
     return SUCCESS();
 
 } // db_reg_coll_by_admin_op
@@ -4876,6 +5482,12 @@ irods::error db_reg_coll_op(
         return ERROR( status, "cmlExecuteNoAnswerSql(insert access) failure" );
     }
 
+    status = refresh_effective_access( "select coll_id from R_COLL_MAIN where coll_name=?", { _coll_info->collName } );
+    if ( status != 0 ) {
+        _rollback( "chlRegColl" );
+        return ERROR( status, "failed to update effective access" );
+    }
+
     status =  cmlExecuteNoAnswerSql( "commit", &icss );
     if ( status != 0 ) {
         rodsLog( LOG_NOTICE,
@@ -5399,6 +6011,14 @@ irods::error db_rename_coll_op(
 
 } // db_rename_coll_op
 
+irods::error db_mod_access_control_op(
+    irods::plugin_context& _ctx,
+    const int              _recursive_flag,
+    const char*            _access_level,
+    const char*            _user_name,
+    const char*            _zone,
+    const char*            _path_name );
+
 // =-=-=-=-=-=-=-
 // modify the zone
 irods::error db_mod_zone_coll_acl_op(
@@ -5445,16 +6065,19 @@ irods::error db_mod_zone_coll_acl_op(
     if ( strstr( cp, PATH_SEPARATOR ) != NULL ) {
         return ERROR( CAT_INVALID_ARGUMENT, "invalid path name" );
     }
-    status =  chlModAccessControl( _ctx.comm(), 0,
-                                   _access_level,
-                                   _user_name,
-                                   _ctx.comm()->clientUser.rodsZone,
-                                   _path_name );
-    if ( !status ) {
-        return ERROR( status, "chlModAccessControl failed" );
+    // =-=-=-=-=-=-=-
+    // call the operation directly so the effective access index is
+    // maintained in the same way as for any other access control change
+    ret = db_mod_access_control_op( _ctx, 0,
+                                    _access_level,
+                                    _user_name,
+                                    _ctx.comm()->clientUser.rodsZone,
+                                    _path_name );
+    if ( !ret.ok() ) {
+        return PASSMSG( "db_mod_access_control_op failed", ret );
     }
 
-    return CODE( status );
+    return CODE( ret.code() );
 
 } // db_mod_zone_coll_acl_op
 
@@ -5755,8 +6378,9 @@ irods::error db_del_zone_op(
 
 // =-=-=-=-=-=-=-
 // modify the zone
-irods::error db_simple_query_op_vector(
+irods::error simple_query_impl(
     irods::plugin_context& _ctx,
+    icatSessionStruct*     _icss,
     const char*                  _sql,
     std::vector<std::string> _bindVars,
     int                    _format,
@@ -5935,14 +6559,14 @@ irods::error db_simple_query_op_vector(
     rows = 0;
     if ( *_control == 0 ) {
         status = cmlGetFirstRowFromSqlBV( _sql, _bindVars,
-                                          &stmtNum, &icss );
+                                          &stmtNum, _icss );
         if ( status < 0 ) {
             if ( status != CAT_NO_ROWS_FOUND ) {
                 rodsLog( LOG_NOTICE,
                          "chlSimpleQuery cmlGetFirstRowFromSqlBV failure %d",
                          status );
             }
-            cmlFreeStatement(stmtNum, &icss);
+            cmlFreeStatement(stmtNum, _icss);
             return ERROR( status, "cmlGetFirstRowFromSqlBV failure" );
         }
         didGet = 1;
@@ -5955,7 +6579,7 @@ irods::error db_simple_query_op_vector(
 
     for ( ;; ) {
         if ( needToGet ) {
-            status = cmlGetNextRowFromStatement( stmtNum, &icss );
+            status = cmlGetNextRowFromStatement( stmtNum, _icss );
             if ( status == CAT_NO_ROWS_FOUND ) {
                 *_control = 0;
                 if ( didGet ) {
@@ -5965,7 +6589,7 @@ irods::error db_simple_query_op_vector(
                     }
                     return CODE( 0 );
                 }
-                cmlFreeStatement(stmtNum, &icss);
+                cmlFreeStatement(stmtNum, _icss);
                 return ERROR( status, "cmlGetNextRowFromStatement failed" );
             }
             if ( status < 0 ) {
@@ -5978,10 +6602,10 @@ irods::error db_simple_query_op_vector(
             didGet = 1;
         }
         needToGet = 1;
-        nCols = icss.stmtPtr[stmtNum]->numOfCols;
+        nCols = _icss->stmtPtr[stmtNum]->numOfCols;
         if ( rows == 0 && _format == 3 ) {
             for ( i = 0; i < nCols ; i++ ) {
-                rstrcat( _out_buf, icss.stmtPtr[stmtNum]->resultColName[i], _max_out_buf );
+                rstrcat( _out_buf, _icss->stmtPtr[stmtNum]->resultColName[i], _max_out_buf );
                 if ( i != nCols - 1 ) {
                     rstrcat( _out_buf, " ", _max_out_buf );
                 }
@@ -5990,11 +6614,11 @@ irods::error db_simple_query_op_vector(
         rows++;
         for ( i = 0; i < nCols ; i++ ) {
             if ( _format == 1 || _format == 3 ) {
-                if ( strlen( icss.stmtPtr[stmtNum]->resultValue[i] ) == 0 ) {
+                if ( strlen( _icss->stmtPtr[stmtNum]->resultValue[i] ) == 0 ) {
                     rstrcat( _out_buf, "- ", _max_out_buf );
                 }
                 else {
-                    rstrcat( _out_buf, icss.stmtPtr[stmtNum]->resultValue[i],
+                    rstrcat( _out_buf, _icss->stmtPtr[stmtNum]->resultValue[i],
                              _max_out_buf );
                     if ( i != nCols - 1 ) {
                         /* add a space except for the last column */
@@ -6003,9 +6627,9 @@ irods::error db_simple_query_op_vector(
                 }
             }
             if ( _format == 2 ) {
-                rstrcat( _out_buf, icss.stmtPtr[stmtNum]->resultColName[i], _max_out_buf );
+                rstrcat( _out_buf, _icss->stmtPtr[stmtNum]->resultColName[i], _max_out_buf );
                 rstrcat( _out_buf, ": ", _max_out_buf );
-                rstrcat( _out_buf, icss.stmtPtr[stmtNum]->resultValue[i], _max_out_buf );
+                rstrcat( _out_buf, _icss->stmtPtr[stmtNum]->resultValue[i], _max_out_buf );
                 rstrcat( _out_buf, "\n", _max_out_buf );
             }
         }
@@ -6018,10 +6642,37 @@ irods::error db_simple_query_op_vector(
         }
     }
 
-    cmlFreeStatement(stmtNum, &icss);
+    cmlFreeStatement(stmtNum, _icss);
     return SUCCESS();
 
-} // db_simple_query_op
+} // simple_query_impl
+
+irods::error db_simple_query_op_vector(
+    irods::plugin_context& _ctx,
+    const char*            _sql,
+    std::vector<std::string> _bindVars,
+    int                    _format,
+    int*                   _control,
+    char*                  _out_buf,
+    int                    _max_out_buf ) {
+    // =-=-=-=-=-=-=-
+    // check incoming pointers
+    if ( !_control ) {
+        return ERROR( CAT_INVALID_ARGUMENT, "null control parameter" );
+    }
+
+    int control = *_control;
+    icatSessionStruct* session = ( 0 == control ) ?
+                                 get_read_only_session() :
+                                 decode_continue_inx( control );
+
+    irods::error ret = simple_query_impl( _ctx, session, _sql, _bindVars, _format,
+                                          &control, _out_buf, _max_out_buf );
+    *_control = encode_continue_inx( session, control );
+
+    return ret;
+
+} // db_simple_query_op_vector
 
 irods::error db_simple_query_op(
     irods::plugin_context& _ctx,
@@ -6180,6 +6831,12 @@ irods::error db_del_coll_by_admin_op(
     snprintf( collIdNum, MAX_NAME_LEN, "%lld", iVal );
     removeMetaMapAndAVU( collIdNum );
 
+    status = refresh_effective_access( "?", { collIdNum } );
+    if ( status != 0 ) {
+        _rollback( "chlDelCollByAdmin" );
+        return ERROR( status, "failed to update effective access" );
+    }
+
     /* delete the row if it exists */
     cllBindVars[cllBindVarCount++] = _coll_info->collName;
     if ( logSQL != 0 ) {
@@ -7832,6 +8489,12 @@ irods::error db_mod_group_op(
         return ERROR( CAT_INVALID_ARGUMENT, "invalid option" );
     }
 
+    status = refresh_effective_access( "select object_id from R_OBJT_ACCESS where user_id=?", { groupId }, "?", { userId } );
+    if ( status != 0 ) {
+        _rollback( "chlModGroup" );
+        return ERROR( status, "failed to update effective access" );
+    }
+
     status =  cmlExecuteNoAnswerSql( "commit", &icss );
     if ( status != 0 ) {
         rodsLog( LOG_NOTICE,
@@ -10385,6 +11048,12 @@ irods::error db_mod_access_control_op(
                 }
             }
 
+            status = refresh_effective_access( "?", { objIdStr }, "select user_id from R_USER_GROUP where group_user_id=?", { userIdStr } );
+            if ( status != 0 ) {
+                _rollback( "chlModAccessControl" );
+                return ERROR( status, "failed to update effective access" );
+            }
+
             status =  cmlExecuteNoAnswerSql( "commit", &icss );
             return ERROR( status, "commit failiure" );
         }
@@ -10403,6 +11072,12 @@ irods::error db_mod_access_control_op(
             return ERROR( status, "delete failure" );
         }
         if ( rmFlag ) { /* just removing */
+            status = refresh_effective_access( "?", { collIdStr }, "select user_id from R_USER_GROUP where group_user_id=?", { userIdStr } );
+            if ( status != 0 ) {
+                _rollback( "chlModAccessControl" );
+                return ERROR( status, "failed to update effective access" );
+            }
+
             status =  cmlExecuteNoAnswerSql( "commit", &icss );
             return ERROR( status, "commit failure" );
         }
@@ -10425,6 +11100,13 @@ irods::error db_mod_access_control_op(
             _rollback( "chlModAccessControl" );
             return ERROR( status, "insert failure" );
         }
+
+        status = refresh_effective_access( "?", { collIdStr }, "select user_id from R_USER_GROUP where group_user_id=?", { userIdStr } );
+        if ( status != 0 ) {
+            _rollback( "chlModAccessControl" );
+            return ERROR( status, "failed to update effective access" );
+        }
+
         status =  cmlExecuteNoAnswerSql( "commit", &icss );
         return ERROR( status, "commit failure" );
     }
@@ -10445,6 +11127,23 @@ irods::error db_mod_access_control_op(
     std::string pathStart = makeEscapedPath( _path_name ) + "/%";
     int status;
 
+    /* Recompute the effective access of the receiving user (or the
+       members of the receiving group) on everything under the collection */
+    const auto refresh_effective_access_recursively = [&]() -> int {
+#if defined ORA_ICAT
+        const std::string coll_filter = "select coll_id from R_COLL_MAIN where coll_name = ? or coll_name like ? ESCAPE '\\'";
+#else
+        const std::string coll_filter = "select coll_id from R_COLL_MAIN where coll_name = ? or coll_name like ?";
+#endif
+        const std::string members_filter = "select user_id from R_USER_GROUP where group_user_id=?";
+        int status = refresh_effective_access( "select data_id from R_DATA_MAIN where coll_id in (" + coll_filter + ")",
+                                               { _path_name, pathStart }, members_filter, { userIdStr } );
+        if ( status == 0 ) {
+            status = refresh_effective_access( coll_filter, { _path_name, pathStart }, members_filter, { userIdStr } );
+        }
+        return status;
+    };
+
 #if (defined ORA_ICAT || defined MY_ICAT)
 #else
     /* The temporary table created and used below has been found to
@@ -10565,6 +11264,12 @@ irods::error db_mod_access_control_op(
         return ERROR( status, "delete failure" );
     }
     if ( rmFlag ) { /* just removing */
+        status = refresh_effective_access_recursively();
+        if ( status != 0 ) {
+            _rollback( "chlModAccessControl" );
+            return ERROR( status, "failed to update effective access" );
+        }
+
         status =  cmlExecuteNoAnswerSql( "commit", &icss );
         return ERROR( status, "commit failure" );
     }
@@ -10633,6 +11338,12 @@ irods::error db_mod_access_control_op(
         return ERROR( status, "insert failure" );
     }
 
+    status = refresh_effective_access_recursively();
+    if ( status != 0 ) {
+        _rollback( "chlModAccessControl" );
+        return ERROR( status, "failed to update effective access" );
+    }
+
     status =  cmlExecuteNoAnswerSql( "commit", &icss );
     if ( status < 0 ) {
         return ERROR( status, "commit failed" );
@@ -13110,9 +13821,10 @@ irods::error db_add_specific_query_op(
     if ( status < 0 ) {
         return ERROR( status, "commit failed" );
     }
-    else {
-        return SUCCESS();
-    }
+
+    invalidate_specific_query_caches();
+
+    return SUCCESS();
 
 } // db_add_specific_query_op
 
@@ -13185,15 +13897,17 @@ irods::error db_del_specific_query_op(
     if ( status < 0 ) {
         return ERROR( status, "commit failed" );
     }
-    else {
-        return SUCCESS();
-    }
+
+    invalidate_specific_query_caches();
+
+    return SUCCESS();
 
 } // db_del_specific_query_op
 
 #define MINIMUM_COL_SIZE 50
-irods::error db_specific_query_op(
+irods::error specific_query_impl(
     irods::plugin_context& _ctx,
+    icatSessionStruct*     _icss,
     specificQueryInp_t*    _spec_query_inp,
     genQueryOut_t*         _result ) {
     // =-=-=-=-=-=-=-
@@ -13252,43 +13966,53 @@ irods::error db_specific_query_op(
         if ( _spec_query_inp->sql == NULL ) {
             return ERROR( CAT_INVALID_ARGUMENT, "null sql string" );
         }
-        /*
-          First check that this SQL is one of the allowed forms.
-        */
-        if ( logSQL != 0 ) {
-            rodsLog( LOG_SQL, "chlSpecificQuery SQL 1" );
-        }
-        {
-            std::vector<std::string> bindVars;
-            bindVars.push_back( _spec_query_inp->sql );
-            status = cmlGetStringValueFromSql(
-                         "select create_ts from R_SPECIFIC_QUERY where sqlStr=?",
-                         tsCreateTime, 50, bindVars, &icss );
+
+        const auto cache_generation = get_specific_query_generation();
+        const auto* cached_sql = lookup_specific_query( cache_generation, _spec_query_inp->sql );
+        if ( cached_sql ) {
+            snprintf( combinedSQL, sizeof( combinedSQL ), "%s", cached_sql->c_str() );
         }
-        if ( status == CAT_NO_ROWS_FOUND ) {
-            int status2;
+        else {
+            /*
+              First check that this SQL is one of the allowed forms.
+            */
             if ( logSQL != 0 ) {
-                rodsLog( LOG_SQL, "chlSpecificQuery SQL 2" );
+                rodsLog( LOG_SQL, "chlSpecificQuery SQL 1" );
             }
             {
                 std::vector<std::string> bindVars;
                 bindVars.push_back( _spec_query_inp->sql );
-                status2 = cmlGetStringValueFromSql(
-                              "select sqlStr from R_SPECIFIC_QUERY where alias=?",
-                              combinedSQL, sizeof( combinedSQL ), bindVars, &icss );
-            }
-            if ( status2 == CAT_NO_ROWS_FOUND ) {
-                return ERROR( CAT_UNKNOWN_SPECIFIC_QUERY, "unknown query" );
+                status = cmlGetStringValueFromSql(
+                             "select create_ts from R_SPECIFIC_QUERY where sqlStr=?",
+                             tsCreateTime, 50, bindVars, _icss );
             }
-            if ( status2 != 0 ) {
-                return ERROR( status2, "failed to get first query" );
+            if ( status == CAT_NO_ROWS_FOUND ) {
+                int status2;
+                if ( logSQL != 0 ) {
+                    rodsLog( LOG_SQL, "chlSpecificQuery SQL 2" );
+                }
+                {
+                    std::vector<std::string> bindVars;
+                    bindVars.push_back( _spec_query_inp->sql );
+                    status2 = cmlGetStringValueFromSql(
+                                  "select sqlStr from R_SPECIFIC_QUERY where alias=?",
+                                  combinedSQL, sizeof( combinedSQL ), bindVars, _icss );
+                }
+                if ( status2 == CAT_NO_ROWS_FOUND ) {
+                    return ERROR( CAT_UNKNOWN_SPECIFIC_QUERY, "unknown query" );
+                }
+                if ( status2 != 0 ) {
+                    return ERROR( status2, "failed to get first query" );
+                }
             }
-        }
-        else {
-            if ( status != 0 ) {
-                return ERROR( status, "failed to get query strings" );
+            else {
+                if ( status != 0 ) {
+                    return ERROR( status, "failed to get query strings" );
+                }
+                snprintf( combinedSQL, sizeof( combinedSQL ), "%s", _spec_query_inp->sql );
             }
-            snprintf( combinedSQL, sizeof( combinedSQL ), "%s", _spec_query_inp->sql );
+
+            cache_specific_query( _icss, cache_generation, _spec_query_inp->sql, combinedSQL );
         }
 
         i = 0;
@@ -13300,14 +14024,14 @@ irods::error db_specific_query_op(
             rodsLog( LOG_SQL, "chlSpecificQuery SQL 3" );
         }
         status = cmlGetFirstRowFromSql( combinedSQL, &statementNum,
-                                        _spec_query_inp->rowOffset, &icss );
+                                        _spec_query_inp->rowOffset, _icss );
         if ( status < 0 ) {
             if ( status != CAT_NO_ROWS_FOUND ) {
                 rodsLog( LOG_NOTICE,
                          "chlSpecificQuery cmlGetFirstRowFromSql failure %d",
                          status );
             }
-            cmlFreeStatement(statementNum, &icss);
+            cmlFreeStatement(statementNum, _icss);
             return ERROR( status, "cmlGetFirstRowFromSql failure" );
         }
 
@@ -13318,7 +14042,7 @@ irods::error db_specific_query_op(
         statementNum = _spec_query_inp->continueInx - 1;
         needToGetNextRow = 1;
         if ( _spec_query_inp->maxRows <= 0 ) { /* caller is closing out the query */
-            status = cmlFreeStatement( statementNum, &icss );
+            status = cmlFreeStatement( statementNum, _icss );
             if ( status < 0 ) {
                 return ERROR( status, "failed in free statement" );
             }
@@ -13329,9 +14053,9 @@ irods::error db_specific_query_op(
     }
     for ( i = 0; i < _spec_query_inp->maxRows; i++ ) {
         if ( needToGetNextRow ) {
-            status = cmlGetNextRowFromStatement( statementNum, &icss );
+            status = cmlGetNextRowFromStatement( statementNum, _icss );
             if ( status == CAT_NO_ROWS_FOUND ) {
-                cmlFreeStatement( statementNum, &icss );
+                cmlFreeStatement( statementNum, _icss );
                 _result->continueInx = 0;
                 if ( _result->rowCnt == 0 ) {
                     return ERROR( status, "no rows found" );
@@ -13340,21 +14064,21 @@ irods::error db_specific_query_op(
                 return SUCCESS();
             }
             if ( status < 0 ) {
-                cmlFreeStatement(statementNum, &icss);
+                cmlFreeStatement(statementNum, _icss);
                 return ERROR( status, "failed to get next row" );
             }
         }
         needToGetNextRow = 1;
 
         _result->rowCnt++;
-        numOfCols = icss.stmtPtr[statementNum]->numOfCols;
+        numOfCols = _icss->stmtPtr[statementNum]->numOfCols;
         _result->attriCnt = numOfCols;
         _result->continueInx = statementNum + 1;
 
         maxColSize = 0;
 
         for ( k = 0; k < numOfCols; k++ ) {
-            j = strlen( icss.stmtPtr[statementNum]->resultValue[k] );
+            j = strlen( _icss->stmtPtr[statementNum]->resultValue[k] );
             if ( maxColSize <= j ) {
                 maxColSize = j;
             }
@@ -13370,7 +14094,7 @@ irods::error db_specific_query_op(
             for ( j = 0; j < numOfCols; j++ ) {
                 tResult = ( char * ) malloc( totalLen );
                 if ( tResult == NULL ) {
-                    cmlFreeStatement(statementNum, &icss);
+                    cmlFreeStatement(statementNum, _icss);
                     return ERROR( SYS_MALLOC_ERR, "malloc error" );
                 }
                 memset( tResult, 0, totalLen );
@@ -13398,7 +14122,7 @@ irods::error db_specific_query_op(
                 int k;
                 tResult = ( char * ) malloc( totalLen );
                 if ( tResult == NULL ) {
-                    cmlFreeStatement(statementNum, &icss);
+                    cmlFreeStatement(statementNum, _icss);
                     return ERROR( SYS_MALLOC_ERR, "failed to allocate result" );
                 }
                 memset( tResult, 0, totalLen );
@@ -13422,7 +14146,7 @@ irods::error db_specific_query_op(
             tResult2 = _result->sqlResult[j].value; /* ptr to value str */
             tResult2 += currentMaxColSize * ( _result->rowCnt - 1 );  /* skip forward
                                                                   for this row */
-            strncpy( tResult2, icss.stmtPtr[statementNum]->resultValue[j],
+            strncpy( tResult2, _icss->stmtPtr[statementNum]->resultValue[j],
                      currentMaxColSize ); /* copy in the value text */
         }
 
@@ -13432,6 +14156,28 @@ irods::error db_specific_query_op(
                                             always >0 */
     return SUCCESS();
 
+} // specific_query_impl
+
+irods::error db_specific_query_op(
+    irods::plugin_context& _ctx,
+    specificQueryInp_t*    _spec_query_inp,
+    genQueryOut_t*         _result ) {
+    // =-=-=-=-=-=-=-
+    // check the params
+    if ( !_spec_query_inp || !_result ) {
+        return ERROR( CAT_INVALID_ARGUMENT, "null parameter" );
+    }
+
+    specificQueryInp_t spec_query_inp = *_spec_query_inp;
+    icatSessionStruct* session = ( 0 == spec_query_inp.continueInx ) ?
+                                 get_read_only_session() :
+                                 decode_continue_inx( spec_query_inp.continueInx );
+
+    irods::error ret = specific_query_impl( _ctx, session, &spec_query_inp, _result );
+    _result->continueInx = encode_continue_inx( session, _result->continueInx );
+
+    return ret;
+
 } // db_specific_query_op
 
 irods::error db_get_distinct_data_obj_count_on_resource_op(
@@ -14453,7 +15199,7 @@ irods::error db_get_icss_op(
 
 // =-=-=-=-=-=-=-
 // from general_query.cpp ::
-int chl_gen_query_impl( genQueryInp_t, genQueryOut_t* );
+int chl_gen_query_impl( genQueryInp_t, genQueryOut_t*, icatSessionStruct* );
 
 irods::error db_gen_query_op(
     irods::plugin_context& _ctx,
@@ -14487,9 +15233,16 @@ irods::error db_gen_query_op(
     // extract the icss property
 //        icatSessionStruct icss;
 //        _ctx.prop_map().get< icatSessionStruct >( ICSS_PROP, icss );
+    genQueryInp_t gen_query_inp = *_gen_query_inp;
+    icatSessionStruct* session = ( 0 == gen_query_inp.continueInx ) ?
+                                 get_read_only_session() :
+                                 decode_continue_inx( gen_query_inp.continueInx );
+
     int status = chl_gen_query_impl(
-                     *_gen_query_inp,
-                     _result );
+                     gen_query_inp,
+                     _result,
+                     session );
+    _result->continueInx = encode_continue_inx( session, _result->continueInx );
 //         if( status < 0 ) {
 //             return ERROR( status, "chl_gen_query_impl failed" );
 //         } else {
@@ -14718,299 +15471,299 @@ irods::database* plugin_factory(
     pg->add_operation<std::string*>(
         DATABASE_OP_GET_LOCAL_ZONE,
         function<error(plugin_context&,std::string*)>(
-            db_get_local_zone_op ) );
+            with_catalog_connection( db_get_local_zone_op ) ) );
     pg->add_operation<const std::string*, int>(
         DATABASE_OP_UPDATE_RESC_OBJ_COUNT,
         function<error(plugin_context&,const std::string*, int)>(
-            db_update_resc_obj_count_op ) );
+            with_catalog_connection( db_update_resc_obj_count_op ) ) );
     pg->add_operation<dataObjInfo_t*,keyValPair_t*>(
         DATABASE_OP_MOD_DATA_OBJ_META,
         function<error(plugin_context&,dataObjInfo_t*,keyValPair_t*)>(
-            db_mod_data_obj_meta_op ) );
+            with_catalog_connection( db_mod_data_obj_meta_op ) ) );
     pg->add_operation<dataObjInfo_t*>(
         DATABASE_OP_REG_DATA_OBJ,
         function<error(plugin_context&,dataObjInfo_t*)>(
-            db_reg_data_obj_op ) );
+            with_catalog_connection( db_reg_data_obj_op ) ) );
     pg->add_operation<dataObjInfo_t*,dataObjInfo_t*,keyValPair_t*>(
         DATABASE_OP_REG_REPLICA,
         function<error(plugin_context&,dataObjInfo_t*,dataObjInfo_t*,keyValPair_t*)>(
-            db_reg_replica_op ) );
+            with_catalog_connection( db_reg_replica_op ) ) );
     pg->add_operation<dataObjInfo_t*,keyValPair_t*>(
         DATABASE_OP_UNREG_REPLICA,
         function<error(plugin_context&,dataObjInfo_t*,keyValPair_t*)>(
-            db_unreg_replica_op ) );
+            with_catalog_connection( db_unreg_replica_op ) ) );
     pg->add_operation<ruleExecSubmitInp_t*>(
         DATABASE_OP_REG_RULE_EXEC,
         function<error(plugin_context&,ruleExecSubmitInp_t*)>(
-            db_reg_rule_exec_op ) );
+            with_catalog_connection( db_reg_rule_exec_op ) ) );
     pg->add_operation<const char*,keyValPair_t*>(
         DATABASE_OP_MOD_RULE_EXEC,
         function<error(plugin_context&,const char*,keyValPair_t*)>(
-            db_mod_rule_exec_op ) );
+            with_catalog_connection( db_mod_rule_exec_op ) ) );
     pg->add_operation<const char*>(
         DATABASE_OP_DEL_RULE_EXEC,
         function<error(plugin_context&,const char*)>(
-            db_del_rule_exec_op ) );
+            with_catalog_connection( db_del_rule_exec_op ) ) );
     pg->add_operation<map<string, string>*>(
         DATABASE_OP_ADD_CHILD_RESC,
         function<error(plugin_context&,map<string,string>*)>(
-            db_add_child_resc_op ) );
+            with_catalog_connection( db_add_child_resc_op ) ) );
     pg->add_operation<map<string, string>*>(
         DATABASE_OP_REG_RESC,
         function<error(plugin_context&,map<string, string>*)>(
-            db_reg_resc_op ) );
+            with_catalog_connection( db_reg_resc_op ) ) );
     pg->add_operation<map<string,string>*>(
         DATABASE_OP_DEL_CHILD_RESC,
         function<error(plugin_context&,map<string,string>*)>(
-            db_del_child_resc_op ) );
+            with_catalog_connection( db_del_child_resc_op ) ) );
     pg->add_operation<const char*,int>(
         DATABASE_OP_DEL_RESC,
         function<error(plugin_context&,const char*,int)>(
-            db_del_resc_op ) );
+            with_catalog_connection( db_del_resc_op ) ) );
     pg->add_operation(
         DATABASE_OP_ROLLBACK,
         function<error(plugin_context&)>(
-            db_rollback_op ) );
+            with_catalog_connection( db_rollback_op ) ) );
     pg->add_operation(
         DATABASE_OP_COMMIT,
         function<error(plugin_context&)>(
-            db_commit_op ) );
+            with_catalog_connection( db_commit_op ) ) );
     pg->add_operation<userInfo_t*>(
         DATABASE_OP_DEL_USER_RE,
         function<error(plugin_context&,userInfo_t*)>(
-            db_del_user_re_op ) );
+            with_catalog_connection( db_del_user_re_op ) ) );
     pg->add_operation<collInfo_t*>(
         DATABASE_OP_REG_COLL_BY_ADMIN,
         function<error(plugin_context&,collInfo_t*)>(
-            db_reg_coll_by_admin_op ) );
+            with_catalog_connection( db_reg_coll_by_admin_op ) ) );
     pg->add_operation<collInfo_t*>(
         DATABASE_OP_REG_COLL,
         function<error(plugin_context&,collInfo_t*)>(
-            db_reg_coll_op ) );
+            with_catalog_connection( db_reg_coll_op ) ) );
     pg->add_operation<collInfo_t*>(
         DATABASE_OP_MOD_COLL,
         function<error(plugin_context&,collInfo_t*)>(
-            db_mod_coll_op ) );
+            with_catalog_connection( db_mod_coll_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*>(
         DATABASE_OP_REG_ZONE,
         function<error(plugin_context&,const char*,const char*,const char*,const char*)>(
-            db_reg_zone_op ) );
+            with_catalog_connection( db_reg_zone_op ) ) );
     pg->add_operation<const char*,const char*,const char*>(
         DATABASE_OP_MOD_ZONE,
         function<error(plugin_context&,const char*,const char*,const char*)>(
-            db_mod_zone_op ) );
+            with_catalog_connection( db_mod_zone_op ) ) );
     pg->add_operation<const char*,const char*>(
         DATABASE_OP_RENAME_COLL,
         function<error(plugin_context&,const char*,const char*)>(
-            db_rename_coll_op ) );
+            with_catalog_connection( db_rename_coll_op ) ) );
     pg->add_operation<const char*,const char*,const char*>(
         DATABASE_OP_MOD_ZONE_COLL_ACL,
         function<error(plugin_context&,const char*,const char*,const char*)>(
-            db_mod_zone_coll_acl_op ) );
+            with_catalog_connection( db_mod_zone_coll_acl_op ) ) );
     pg->add_operation<const char*,const char*>(
         DATABASE_OP_RENAME_LOCAL_ZONE,
         function<error(plugin_context&,const char*,const char*)>(
-            db_rename_local_zone_op ) );
+            with_catalog_connection( db_rename_local_zone_op ) ) );
     pg->add_operation<const char*>(
         DATABASE_OP_DEL_ZONE,
         function<error(plugin_context&,const char*)>(
-            db_del_zone_op ) );
+            with_catalog_connection( db_del_zone_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*,const char*,int,int*,char*,int>(
         DATABASE_OP_SIMPLE_QUERY,
         function<error(plugin_context&,const char*,const char*,const char*,const char*,const char*,int,int*,char*,int)>(
-            db_simple_query_op ) );
+            with_catalog_connection( db_simple_query_op ) ) );
     pg->add_operation<collInfo_t*>(
         DATABASE_OP_DEL_COLL_BY_ADMIN,
         function<error(plugin_context&,collInfo_t*)>(
-            db_del_coll_by_admin_op ) );
+            with_catalog_connection( db_del_coll_by_admin_op ) ) );
     pg->add_operation<collInfo_t*>(
         DATABASE_OP_DEL_COLL,
         function<error(plugin_context&,collInfo_t*)>(
-            db_del_coll_op ) );
+            with_catalog_connection( db_del_coll_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*,int*,int*>(
         DATABASE_OP_CHECK_AUTH,
         function<error(plugin_context&,const char*,const char*,const char*,const char*,int*,int*)>(
-            db_check_auth_op ) );
+            with_catalog_connection( db_check_auth_op ) ) );
     pg->add_operation<char*,const char*>(
         DATABASE_OP_MAKE_TEMP_PW,
         function<error(plugin_context&,char*, const char*)>(
-            db_make_temp_pw_op ) );
+            with_catalog_connection( db_make_temp_pw_op ) ) );
     pg->add_operation<const char*,int,const char*,char**>(
         DATABASE_OP_UPDATE_PAM_PASSWORD,
         function<error(plugin_context&,const char*,int,const char*,char**)>(
-            db_update_pam_password_op ) );
+            with_catalog_connection( db_update_pam_password_op ) ) );
     pg->add_operation<const char*,const char*,const char*>(
         DATABASE_OP_MOD_USER,
         function<error(plugin_context&,const char*,const char*,const char*)>(
-            db_mod_user_op ) );
+            with_catalog_connection( db_mod_user_op ) ) );
     pg->add_operation<int,char*>(
         DATABASE_OP_MAKE_LIMITED_PW,
         function<error(plugin_context&,int,char*)>(
-            db_make_limited_pw_op ) );
+            with_catalog_connection( db_make_limited_pw_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*>(
         DATABASE_OP_MOD_GROUP,
         function<error(plugin_context&,const char*,const char*,const char*,const char*)>(
-            db_mod_group_op ) );
+            with_catalog_connection( db_mod_group_op ) ) );
     pg->add_operation<const char*,const char*,const char*>(
         DATABASE_OP_MOD_RESC,
         function<error(plugin_context&,const char*,const char*,const char*)>(
-            db_mod_resc_op ) );
+            with_catalog_connection( db_mod_resc_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*>(
         DATABASE_OP_MOD_RESC_DATA_PATHS,
         function<error(plugin_context&,const char*,const char*,const char*,const char*)>(
-            db_mod_resc_data_paths_op ) );
+            with_catalog_connection( db_mod_resc_data_paths_op ) ) );
     pg->add_operation<const char*,int>(
         DATABASE_OP_MOD_RESC_FREESPACE,
         function<error(plugin_context&,const char*,int)>(
-            db_mod_resc_freespace_op ) );
+            with_catalog_connection( db_mod_resc_freespace_op ) ) );
     pg->add_operation<userInfo_t*>(
         DATABASE_OP_REG_USER_RE,
         function<error(plugin_context&,userInfo_t*)>(
-            db_reg_user_re_op ) );
+            with_catalog_connection( db_reg_user_re_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*,const char*>(
         DATABASE_OP_SET_AVU_METADATA,
         function<error(plugin_context&,const char*,const char*,const char*,const char*,const char*)>(
-            db_set_avu_metadata_op ) );
+            with_catalog_connection( db_set_avu_metadata_op ) ) );
     pg->add_operation<int,const char*,const char*,const char*,const char*,const char*>(
         DATABASE_OP_ADD_AVU_METADATA_WILD,
         function<error(plugin_context&,int,const char*,const char*,const char*,const char*,const char*)>(
-            db_add_avu_metadata_wild_op ) );
+            with_catalog_connection( db_add_avu_metadata_wild_op ) ) );
     pg->add_operation<int,const char*,const char*,const char*,const char*,const char*>(
         DATABASE_OP_ADD_AVU_METADATA,
         function<error(plugin_context&,int,const char*,const char*,const char*,const char*,const char*)>(
-            db_add_avu_metadata_op ) );
+            with_catalog_connection( db_add_avu_metadata_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*>(
         DATABASE_OP_MOD_AVU_METADATA,
         function<error(plugin_context&,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*)>(
-            db_mod_avu_metadata_op ) );
+            with_catalog_connection( db_mod_avu_metadata_op ) ) );
     pg->add_operation<int,const char*,const char*,const char*,const char*,const char*,int>(
         DATABASE_OP_DEL_AVU_METADATA,
         function<error(plugin_context&,int,const char*,const char*,const char*,const char*,const char*,int)>(
-            db_del_avu_metadata_op ) );
+            with_catalog_connection( db_del_avu_metadata_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*>(
         DATABASE_OP_COPY_AVU_METADATA,
         function<error(plugin_context&,const char*,const char*,const char*,const char*)>(
-            db_copy_avu_metadata_op ) );
+            with_catalog_connection( db_copy_avu_metadata_op ) ) );
     pg->add_operation<int,const char*,const char*,const char*,const char*>(
         DATABASE_OP_MOD_ACCESS_CONTROL_RESC,
         function<error(plugin_context&,int,const char*,const char*,const char*,const char*)>(
-            db_mod_access_control_resc_op ) );
+            with_catalog_connection( db_mod_access_control_resc_op ) ) );
     pg->add_operation<int,const char*,const char*,const char*,const char*>(
         DATABASE_OP_MOD_ACCESS_CONTROL,
         function<error(plugin_context&,int,const char*,const char*,const char*,const char*)>(
-            db_mod_access_control_op ) );
+            with_catalog_connection( db_mod_access_control_op ) ) );
     pg->add_operation<rodsLong_t,const char*>(
         DATABASE_OP_RENAME_OBJECT,
         function<error(plugin_context&,rodsLong_t,const char*)>(
-            db_rename_object_op ) );
+            with_catalog_connection( db_rename_object_op ) ) );
     pg->add_operation<rodsLong_t,rodsLong_t>(
         DATABASE_OP_MOVE_OBJECT,
         function<error(plugin_context&,rodsLong_t,rodsLong_t)>(
-            db_move_object_op ) );
+            with_catalog_connection( db_move_object_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*,const char*,const char*>(
         DATABASE_OP_REG_TOKEN,
         function<error(plugin_context&,const char*,const char*,const char*,const char*,const char*,const char*)>(
-            db_reg_token_op ) );
+            with_catalog_connection( db_reg_token_op ) ) );
     pg->add_operation<const char*,const char*>(
         DATABASE_OP_DEL_TOKEN,
         function<error(plugin_context&,const char*,const char*)>(
-            db_del_token_op ) );
+            with_catalog_connection( db_del_token_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*>(
         DATABASE_OP_REG_SERVER_LOAD,
         function<error(plugin_context&,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*)>(
-            db_reg_server_load_op ) );
+            with_catalog_connection( db_reg_server_load_op ) ) );
     pg->add_operation<const char*>(
         DATABASE_OP_PURGE_SERVER_LOAD,
         function<error(plugin_context&,const char*)>(
-            db_purge_server_load_op ) );
+            with_catalog_connection( db_purge_server_load_op ) ) );
     pg->add_operation<const char*,const char*>(
         DATABASE_OP_REG_SERVER_LOAD_DIGEST,
         function<error(plugin_context&,const char*,const char*)>(
-            db_reg_server_load_digest_op ) );
+            with_catalog_connection( db_reg_server_load_digest_op ) ) );
     pg->add_operation<const char*>(
         DATABASE_OP_PURGE_SERVER_LOAD_DIGEST,
         function<error(plugin_context&,const char*)>(
-            db_purge_server_load_digest_op ) );
+            with_catalog_connection( db_purge_server_load_digest_op ) ) );
     pg->add_operation(
         DATABASE_OP_CALC_USAGE_AND_QUOTA,
         function<error(plugin_context&)>(
-            db_calc_usage_and_quota_op ) );
+            with_catalog_connection( db_calc_usage_and_quota_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*>(
         DATABASE_OP_SET_QUOTA,
         function<error(plugin_context&,const char*,const char*,const char*,const char*)>(
-            db_set_quota_op ) );
+            with_catalog_connection( db_set_quota_op ) ) );
     pg->add_operation<const char*,const char*,rodsLong_t*,int*>(
         DATABASE_OP_CHECK_QUOTA,
         function<error(plugin_context&,const char*,const char*,rodsLong_t*,int*)>(
-            db_check_quota_op ) );
+            with_catalog_connection( db_check_quota_op ) ) );
     pg->add_operation(
         DATABASE_OP_DEL_UNUSED_AVUS,
         function<error(plugin_context&)>(
-            db_del_unused_avus_op ) );
+            with_catalog_connection( db_del_unused_avus_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*>(
         DATABASE_OP_INS_RULE_TABLE,
         function<error(plugin_context&,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*)>(
-            db_ins_rule_table_op ) );
+            with_catalog_connection( db_ins_rule_table_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*,const char*>(
         DATABASE_OP_INS_DVM_TABLE,
         function<error(plugin_context&,const char*,const char*,const char*,const char*,const char*)>(
-            db_ins_dvm_table_op ) );
+            with_catalog_connection( db_ins_dvm_table_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*>(
         DATABASE_OP_INS_FNM_TABLE,
         function<error(plugin_context&,const char*,const char*,const char*,const char*)>(
-            db_ins_fnm_table_op ) );
+            with_catalog_connection( db_ins_fnm_table_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*>(
         DATABASE_OP_INS_MSRVC_TABLE,
         function<error(plugin_context&,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*,const char*)>(
-            db_ins_msrvc_table_op ) );
+            with_catalog_connection( db_ins_msrvc_table_op ) ) );
     pg->add_operation<const char*,const char*>(
         DATABASE_OP_VERSION_RULE_BASE,
         function<error(plugin_context&,const char*,const char*)>(
-            db_version_rule_base_op ) );
+            with_catalog_connection( db_version_rule_base_op ) ) );
     pg->add_operation<const char*,const char*>(
         DATABASE_OP_VERSION_DVM_BASE,
         function<error(plugin_context&,const char*,const char*)>(
-            db_version_dvm_base_op ) );
+            with_catalog_connection( db_version_dvm_base_op ) ) );
     pg->add_operation<const char*,const char*>(
         DATABASE_OP_VERSION_FNM_BASE,
         function<error(plugin_context&,const char*,const char*)>(
-            db_version_fnm_base_op ) );
+            with_catalog_connection( db_version_fnm_base_op ) ) );
     pg->add_operation<const char*,const char*>(
         DATABASE_OP_ADD_SPECIFIC_QUERY,
         function<error(plugin_context&,const char*,const char*)>(
-            db_add_specific_query_op ) );
+            with_catalog_connection( db_add_specific_query_op ) ) );
     pg->add_operation<const char*>(
         DATABASE_OP_DEL_SPECIFIC_QUERY,
         function<error(plugin_context&,const char*)>(
-            db_del_specific_query_op ) );
+            with_catalog_connection( db_del_specific_query_op ) ) );
     pg->add_operation<specificQueryInp_t*,genQueryOut_t*>(
         DATABASE_OP_SPECIFIC_QUERY,
         function<error(plugin_context&,specificQueryInp_t*,genQueryOut_t*)>(
-            db_specific_query_op ) );
+            with_catalog_connection( db_specific_query_op ) ) );
     pg->add_operation<const string*, const string*,std::string*>(
         DATABASE_OP_GET_HIERARCHY_FOR_RESC,
         function<error(plugin_context&,const string*, const string*,std::string*)>(
-            db_get_hierarchy_for_resc_op ) );
+            with_catalog_connection( db_get_hierarchy_for_resc_op ) ) );
     pg->add_operation<const char*,const char*,const char*,const char*,const char*>(
         DATABASE_OP_MOD_TICKET,
         function<error(plugin_context&,const char*,const char*,const char*,const char*,const char*)>(
-            db_mod_ticket_op ) );
+            with_catalog_connection( db_mod_ticket_op ) ) );
     pg->add_operation<const char*,const char*,const char*>(
         DATABASE_OP_CHECK_AND_GET_OBJ_ID,
         function<error(plugin_context&,const char*,const char*,const char*)>(
-            db_check_and_get_object_id_op ) );
+            with_catalog_connection( db_check_and_get_object_id_op ) ) );
     pg->add_operation<icatSessionStruct**>(
         DATABASE_OP_GET_RCS,
         function<error(plugin_context&,icatSessionStruct**)>(
-            db_get_icss_op ) );
+            with_held_catalog_connection( db_get_icss_op ) ) );
     pg->add_operation<genQueryInp_t*,genQueryOut_t*>(
         DATABASE_OP_GEN_QUERY,
         function<error(plugin_context&,genQueryInp_t*,genQueryOut_t*)>(
-            db_gen_query_op ) );
+            with_catalog_connection( db_gen_query_op ) ) );
     pg->add_operation<generalUpdateInp_t*>(
         DATABASE_OP_GENERAL_UPDATE,
         function<error(plugin_context&,generalUpdateInp_t*)>(
-            db_general_update_op ) );
+            with_catalog_connection( db_general_update_op ) ) );
     pg->add_operation<const char*,const char*,const char*,int,int>(
         DATABASE_OP_GEN_QUERY_ACCESS_CONTROL_SETUP,
         function<error(plugin_context&,const char*,const char*,const char*,int,int)>(
@@ -15022,15 +15775,15 @@ irods::database* plugin_factory(
     pg->add_operation<const char*,long long*>(
         DATABASE_OP_GET_DISTINCT_DATA_OBJ_COUNT_ON_RESOURCE,
         function<error(plugin_context&,const char*,long long*)>(
-            db_get_distinct_data_obj_count_on_resource_op ) );
+            with_catalog_connection( db_get_distinct_data_obj_count_on_resource_op ) ) );
     pg->add_operation<const string*, const string*, int, dist_child_result_t*>(
         DATABASE_OP_GET_DISTINCT_DATA_OBJS_MISSING_FROM_CHILD_GIVEN_PARENT,
         function<error(plugin_context&,const string*, const string*, int, dist_child_result_t*)>(
-            db_get_distinct_data_objs_missing_from_child_given_parent_op ) );
+            with_catalog_connection( db_get_distinct_data_objs_missing_from_child_given_parent_op ) ) );
     pg->add_operation<rodsLong_t,size_t,const std::vector<leaf_bundle_t>*,const std::string*,dist_child_result_t*>(
         DATABASE_OP_GET_REPL_LIST_FOR_LEAF_BUNDLES,
         function<error(plugin_context&,rodsLong_t,size_t,const std::vector<leaf_bundle_t>*,const std::string*,dist_child_result_t*)>(
-            db_get_repl_list_for_leaf_bundles_op));
+            with_catalog_connection( db_get_repl_list_for_leaf_bundles_op )));
     return pg;
 
 } // plugin_factory
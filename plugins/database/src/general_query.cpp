@@ -35,6 +35,7 @@
 #include <algorithm>
 
 extern int logSQLGenQuery;
+extern bool effective_access_index_valid;
 
 void icatGeneralQuerySetup();
 int insertWhere( char *condition, int option );
@@ -1604,6 +1605,8 @@ insertWhere( char *condition, int option ) {
  Only used if requested by msiAclPolicy (acAclPolicy rule) (which
  normally isn't) or if the user is anonymous.  This restricts
  R_DATA_MAIN anc R_COLL_MAIN info to only users with access.
+ If the effective access index is enabled and populated, the check is a
+ lookup in R_OBJT_ACCESS_EFFECTIVE instead of a join across the user's groups.
  If client user is the local admin, do not restrict.
  */
 int
@@ -1657,7 +1660,10 @@ genqAppendAccessCheck() {
 
             cllBindVars[cllBindVarCount++] = accessControlUserName;
             cllBindVars[cllBindVarCount++] = accessControlZone;
-            if ( !rstrcat( whereSQL, "R_DATA_MAIN.data_id in (select object_id from R_OBJT_ACCESS OA, R_USER_GROUP UG, R_USER_MAIN UM, R_TOKN_MAIN TM where UM.user_name=? and UM.zone_name=? and UM.user_type_name!='rodsgroup' and UM.user_id = UG.user_id and UG.group_user_id = OA.user_id and OA.object_id = R_DATA_MAIN.data_id and OA.access_type_id >= TM.token_id and TM.token_namespace ='access_type' and TM.token_name = 'read object')", MAX_SQL_SIZE_GQ ) ) { return USER_STRLEN_TOOLONG; }
+            if ( effective_access_index_valid ) {
+                if ( !rstrcat( whereSQL, "R_DATA_MAIN.data_id in (select EA.object_id from R_OBJT_ACCESS_EFFECTIVE EA, R_USER_MAIN UM where UM.user_name=? and UM.zone_name=? and EA.user_id = UM.user_id and EA.object_id = R_DATA_MAIN.data_id and EA.access_type_id >= (select token_id from R_TOKN_MAIN where token_namespace ='access_type' and token_name = 'read object'))", MAX_SQL_SIZE_GQ ) ) { return USER_STRLEN_TOOLONG; }
+            }
+            else if ( !rstrcat( whereSQL, "R_DATA_MAIN.data_id in (select object_id from R_OBJT_ACCESS OA, R_USER_GROUP UG, R_USER_MAIN UM, R_TOKN_MAIN TM where UM.user_name=? and UM.zone_name=? and UM.user_type_name!='rodsgroup' and UM.user_id = UG.user_id and UG.group_user_id = OA.user_id and OA.object_id = R_DATA_MAIN.data_id and OA.access_type_id >= TM.token_id and TM.token_namespace ='access_type' and TM.token_name = 'read object')", MAX_SQL_SIZE_GQ ) ) { return USER_STRLEN_TOOLONG; }
         }
 
         if ( strstr( selectSQL, "R_COLL_MAIN" ) != NULL ||
@@ -1668,7 +1674,10 @@ genqAppendAccessCheck() {
 
             cllBindVars[cllBindVarCount++] = accessControlUserName;
             cllBindVars[cllBindVarCount++] = accessControlZone;
-            if ( !rstrcat( whereSQL, "R_COLL_MAIN.coll_id in (select object_id from R_OBJT_ACCESS OA, R_USER_GROUP UG, R_USER_MAIN UM, R_TOKN_MAIN TM where UM.user_name=? and UM.zone_name=? and UM.user_type_name!='rodsgroup' and UM.user_id = UG.user_id and UG.group_user_id = OA.user_id and OA.object_id = R_COLL_MAIN.coll_id and OA.access_type_id >= TM.token_id and TM.token_namespace ='access_type' and TM.token_name = 'read object')", MAX_SQL_SIZE_GQ ) ) { return USER_STRLEN_TOOLONG; }
+            if ( effective_access_index_valid ) {
+                if ( !rstrcat( whereSQL, "R_COLL_MAIN.coll_id in (select EA.object_id from R_OBJT_ACCESS_EFFECTIVE EA, R_USER_MAIN UM where UM.user_name=? and UM.zone_name=? and EA.user_id = UM.user_id and EA.object_id = R_COLL_MAIN.coll_id and EA.access_type_id >= (select token_id from R_TOKN_MAIN where token_namespace ='access_type' and token_name = 'read object'))", MAX_SQL_SIZE_GQ ) ) { return USER_STRLEN_TOOLONG; }
+            }
+            else if ( !rstrcat( whereSQL, "R_COLL_MAIN.coll_id in (select object_id from R_OBJT_ACCESS OA, R_USER_GROUP UG, R_USER_MAIN UM, R_TOKN_MAIN TM where UM.user_name=? and UM.zone_name=? and UM.user_type_name!='rodsgroup' and UM.user_id = UG.user_id and UG.group_user_id = OA.user_id and OA.object_id = R_COLL_MAIN.coll_id and OA.access_type_id >= TM.token_id and TM.token_namespace ='access_type' and TM.token_name = 'read object')", MAX_SQL_SIZE_GQ ) ) { return USER_STRLEN_TOOLONG; }
         }
     }
     else {
@@ -2274,7 +2283,8 @@ int chl_gen_query_access_control_setup_impl(
 /* General Query */
  int chl_gen_query_impl(
     genQueryInp_t  genQueryInp,
-    genQueryOut_t* result ) {
+    genQueryOut_t* result,
+    icatSessionStruct* icss ) {
     int i, j, k;
     int needToGetNextRow;
 
@@ -2294,16 +2304,13 @@ int chl_gen_query_access_control_setup_impl(
         rodsLog( LOG_SQL, "chlGenQuery" );
     }
 
-    icatSessionStruct *icss = 0;
-
     result->attriCnt = 0;
     result->rowCnt = 0;
     result->totalRowCount = 0;
 
     currentMaxColSize = 0;
 
-    status = chlGetRcs( &icss );
-    if ( status < 0 || icss == NULL ) {
+    if ( icss == NULL || icss->status != 1 ) {
         return CAT_NOT_OPEN;
     }
     if ( debug ) {
@@ -13,6 +13,7 @@ drop table R_USER_PASSWORD;
 drop table R_RESC_GROUP;
 drop table R_OBJT_METAMAP;
 drop table R_OBJT_ACCESS;
+drop table R_OBJT_ACCESS_EFFECTIVE;
 drop table R_OBJT_DENY_ACCESS;
 drop table R_OBJT_AUDIT;
 drop table R_SERVER_LOAD;
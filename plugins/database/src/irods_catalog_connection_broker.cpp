@@ -0,0 +1,240 @@
+#include "irods_catalog_connection_broker.hpp"
+
+#include "shared_memory_object.hpp"
+#include "rodsLog.h"
+
+#include <sys/types.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace irods::experimental::catalog_connection_broker
+{
+    namespace
+    {
+        using clock_type = std::chrono::steady_clock;
+
+        // The maximum number of agents tracked as holders or waiters. Agents beyond this
+        // are let through without a lease rather than being turned away.
+        constexpr std::int32_t max_tracked_agents = 4096;
+
+        // How long a waiting agent sleeps before checking the table again.
+        constexpr std::chrono::milliseconds poll_interval{5};
+
+        struct lease_table
+        {
+            std::int32_t holder_count;
+            pid_t holders[max_tracked_agents];
+
+            // Ordered by the time the agents started waiting.
+            std::int32_t waiter_count;
+            pid_t waiters[max_tracked_agents];
+
+            statistics stats;
+        }; // struct lease_table
+
+        std::int32_t g_max_connections = 0;
+        std::chrono::seconds g_wait_timeout{0};
+        std::string g_shm_name;
+
+        // The process holding the lease. A child forked from that process does not hold it.
+        pid_t g_lease_holder = 0;
+        clock_type::time_point g_lease_start;
+
+        std::unique_ptr<interprocess::shared_memory_object<lease_table>> g_leases;
+
+        auto leases() -> interprocess::shared_memory_object<lease_table>&
+        {
+            if (!g_leases) {
+                g_leases = std::make_unique<interprocess::shared_memory_object<lease_table>>(g_shm_name);
+            }
+
+            return *g_leases;
+        } // leases
+
+        auto is_alive(pid_t _pid) noexcept -> bool
+        {
+            return kill(_pid, 0) == 0 || errno != ESRCH;
+        } // is_alive
+
+        auto erase(pid_t* _pids, std::int32_t& _count, pid_t _pid) noexcept -> bool
+        {
+            const auto end = _pids + _count;
+            const auto iter = std::find(_pids, end, _pid);
+
+            if (iter == end) {
+                return false;
+            }
+
+            std::copy(iter + 1, end, iter);
+            --_count;
+
+            return true;
+        } // erase
+
+        // Agents that exited without giving their lease back (e.g. after a crash) would
+        // otherwise hold it forever.
+        auto erase_dead_holders(lease_table& _t) noexcept -> void
+        {
+            const auto end = std::remove_if(_t.holders, _t.holders + _t.holder_count, [](pid_t _p) { return !is_alive(_p); });
+            _t.holder_count = static_cast<std::int32_t>(end - _t.holders);
+        } // erase_dead_holders
+
+        auto erase_dead_waiters_at_front(lease_table& _t, pid_t _self) noexcept -> void
+        {
+            while (_t.waiter_count > 0 && _t.waiters[0] != _self && !is_alive(_t.waiters[0])) {
+                erase(_t.waiters, _t.waiter_count, _t.waiters[0]);
+            }
+        } // erase_dead_waiters_at_front
+
+        auto grant(lease_table& _t, pid_t _self, clock_type::duration _waited, bool _timed_out) noexcept -> void
+        {
+            erase(_t.waiters, _t.waiter_count, _self);
+
+            if (_t.holder_count < max_tracked_agents) {
+                _t.holders[_t.holder_count++] = _self;
+            }
+
+            const auto waited_ms = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(_waited).count());
+
+            _t.stats.leases_held = _t.holder_count;
+            _t.stats.agents_waiting = _t.waiter_count;
+            ++_t.stats.leases_granted;
+            _t.stats.total_wait_milliseconds += waited_ms;
+            _t.stats.max_wait_milliseconds = std::max(_t.stats.max_wait_milliseconds, waited_ms);
+
+            if (_timed_out) {
+                ++_t.stats.leases_granted_after_timeout;
+            }
+        } // grant
+    } // anonymous namespace
+
+    auto configure(std::int32_t _max_connections, std::int32_t _wait_timeout_secs, const std::string_view _shm_name) -> void
+    {
+        // A lease held in the previous segment cannot be given back through the new one.
+        if (holds_lease() && _shm_name != g_shm_name) {
+            release();
+        }
+
+        g_max_connections = std::max(0, _max_connections);
+        g_wait_timeout = std::chrono::seconds{std::max(0, _wait_timeout_secs)};
+
+        if (_shm_name != g_shm_name) {
+            g_leases.reset();
+            g_shm_name = _shm_name;
+        }
+    } // configure
+
+    auto enabled() noexcept -> bool
+    {
+        return g_max_connections > 0;
+    } // enabled
+
+    auto acquire() -> void
+    {
+        if (!enabled() || holds_lease()) {
+            return;
+        }
+
+        const auto self = getpid();
+        const auto start = clock_type::now();
+
+        const bool queued = leases().atomic_exec([self](lease_table& _t) {
+            if (_t.waiter_count == max_tracked_agents) {
+                return false;
+            }
+
+            _t.waiters[_t.waiter_count++] = self;
+            _t.stats.agents_waiting = _t.waiter_count;
+
+            return true;
+        });
+
+        while (true) {
+            const auto waited = clock_type::now() - start;
+            const auto timed_out = waited >= g_wait_timeout;
+
+            const bool granted = leases().atomic_exec([&](lease_table& _t) {
+                erase_dead_waiters_at_front(_t, self);
+
+                const bool next_in_line = !queued || _t.waiter_count == 0 || _t.waiters[0] == self;
+
+                if (next_in_line && _t.holder_count >= g_max_connections) {
+                    erase_dead_holders(_t);
+                }
+
+                if ((next_in_line && _t.holder_count < g_max_connections) || timed_out) {
+                    grant(_t, self, waited, timed_out);
+                    return true;
+                }
+
+                return false;
+            });
+
+            if (granted) {
+                if (timed_out) {
+                    rodsLog(LOG_NOTICE,
+                            "catalog_connection_broker - no lease became available within %lld seconds, connecting anyway",
+                            static_cast<long long>(g_wait_timeout.count()));
+                }
+
+                break;
+            }
+
+            std::this_thread::sleep_for(poll_interval);
+        }
+
+        g_lease_holder = self;
+        g_lease_start = clock_type::now();
+    } // acquire
+
+    auto release() -> void
+    {
+        if (!holds_lease()) {
+            return;
+        }
+
+        const auto held = std::chrono::duration_cast<std::chrono::milliseconds>(clock_type::now() - g_lease_start);
+
+        leases().atomic_exec([held](lease_table& _t) {
+            erase(_t.holders, _t.holder_count, getpid());
+            _t.stats.leases_held = _t.holder_count;
+            _t.stats.total_lease_milliseconds += static_cast<std::uint64_t>(held.count());
+        });
+
+        g_lease_holder = 0;
+    } // release
+
+    auto holds_lease() noexcept -> bool
+    {
+        return g_lease_holder != 0 && g_lease_holder == getpid();
+    } // holds_lease
+
+    auto agents_waiting() -> bool
+    {
+        return leases().atomic_exec([](const lease_table& _t) { return _t.waiter_count > 0; });
+    } // agents_waiting
+
+    auto stats() -> statistics
+    {
+        return leases().atomic_exec([](const lease_table& _t) { return _t.stats; });
+    } // stats
+
+    auto remove_shared_memory(const std::string_view _shm_name) noexcept -> void
+    {
+        try {
+            if (_shm_name == g_shm_name) {
+                g_leases.reset();
+            }
+
+            boost::interprocess::shared_memory_object::remove(std::string{_shm_name}.data());
+        }
+        catch (...) {}
+    } // remove_shared_memory
+} // namespace irods::experimental::catalog_connection_broker
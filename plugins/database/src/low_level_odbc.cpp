@@ -34,6 +34,7 @@
 #include "irods_error.hpp"
 #include "irods_stacktrace.hpp"
 #include "irods_server_properties.hpp"
+#include "catalog.hpp"
 
 #include <cctype>
 #include <string>
@@ -77,6 +78,8 @@ SQLINTEGER columnLength[MAX_TOKEN];  /* change me ! */
 #ifndef ORA_ICAT
 static int didBegin = 0;
 #endif
+static int writesPending = 0;   /* DB-modifying SQL since the last commit/rollback */
+static int writesInSession = 0; /* DB-modifying SQL since the agent connected */
 static int noResultRowCount = 0;
 
 // =-=-=-=-=-=-=-
@@ -176,10 +179,14 @@ cllConnect( icatSessionStruct *icss ) {
     }
 
     // =-=-=-=-=-=-=-
-    // ODBC Entry is defined as "iRODS Catalog" or an env variable
+    // ODBC Entry is defined by the session, an env variable, or "iRODS Catalog"
     char odbcEntryName[ DB_TYPENAME_LEN ];
     char* odbc_env = getenv( "irodsOdbcDSN" );
-    if ( odbc_env ) {
+    if ( icss->odbcEntryName[0] != '\0' ) {
+        rodsLog( LOG_DEBUG, "Setting ODBC entry to session entry [%s]", icss->odbcEntryName );
+        snprintf( odbcEntryName, sizeof( odbcEntryName ), "%s", icss->odbcEntryName );
+    }
+    else if ( odbc_env ) {
         rodsLog( LOG_DEBUG, "Setting ODBC entry to ENV [%s]", odbc_env );
         snprintf( odbcEntryName, sizeof( odbcEntryName ), "%s", odbc_env );
     }
@@ -223,11 +230,16 @@ cllConnect( icatSessionStruct *icss ) {
            PIPES_AS_CONCAT mode) to be able to understand Postgres
            SQL. STRICT_TRANS_TABLES must be st too, otherwise inserting NULL
            into NOT NULL column does not produce error. */
+        const int savedWritesPending = writesPending;
+        const int savedWritesInSession = writesInSession;
         cllExecSqlNoResult( icss, "SET SESSION autocommit=0" ) ;
         cllExecSqlNoResult( icss, "SET SESSION sql_mode='ANSI,STRICT_TRANS_TABLES'" ) ;
         cllExecSqlNoResult( icss, "SET character_set_client = utf8" ) ;
         cllExecSqlNoResult( icss, "SET character_set_results = utf8" ) ;
         cllExecSqlNoResult( icss, "SET character_set_connection = utf8" ) ;
+        /* Session settings do not modify the catalog. */
+        writesPending = savedWritesPending;
+        writesInSession = savedWritesInSession;
     }
 
     return 0;
@@ -353,6 +365,15 @@ cllDisconnect( icatSessionStruct *icss ) {
 int
 cllExecSqlNoResult( icatSessionStruct *icss, const char *sql ) {
 
+    if ( strncmp( sql, "commit", 6 ) == 0 ||
+            strncmp( sql, "rollback", 8 ) == 0 ) {
+        writesPending = 0;
+    }
+    else {
+        writesPending++;
+        writesInSession++;
+    }
+
 #ifndef ORA_ICAT
     if ( strncmp( sql, "commit", 6 ) == 0 ||
             strncmp( sql, "rollback", 8 ) == 0 ) {
@@ -371,6 +392,43 @@ cllExecSqlNoResult( icatSessionStruct *icss, const char *sql ) {
     return _cllExecSqlNoResult( icss, sql, 0 );
 }
 
+/*
+  Returns the number of DB-modifying SQL statements executed since the last
+  commit or rollback.  Read-only queries must not be sent to another
+  connection (e.g. a read replica) while this is non-zero.
+*/
+int
+cllGetPendingWriteCount() {
+    return writesPending;
+}
+
+/*
+  Returns the number of DB-modifying SQL statements executed by this process.
+*/
+int
+cllGetSessionWriteCount() {
+    return writesInSession;
+}
+
+/*
+  Returns non-zero if read-only queries may be sent to a read replica.
+  Uncommitted writes are only visible on the primary.  If readYourWrites is
+  set, any write made by this process (through this module or through
+  irods::experimental::catalog::execute_transaction) also keeps the reads on
+  the primary, because the replica may not have caught up with it yet.
+*/
+int
+cllReadsMayUseReplica( int readYourWrites ) {
+    if ( writesPending > 0 ) {
+        return 0;
+    }
+    if ( readYourWrites &&
+         ( writesInSession > 0 || irods::experimental::catalog::catalog_modified() ) ) {
+        return 0;
+    }
+    return 1;
+}
+
 /*
   Log the bind variables from the global array (after an error)
 */
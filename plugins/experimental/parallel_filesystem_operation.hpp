@@ -107,7 +107,8 @@ namespace irods::experimental::api {
                                    }
                                };
 
-                    auto itr = fscl::recursive_collection_iterator(conn, lp);
+                    // Listing the subtree in bulk avoids opening every collection individually.
+                    auto itr = fscl::recursive_collection_iterator(conn, lp, fscl::collection_options::bulk_listing);
                     auto dp = dispatch_type(ef, itr, job);
                     auto f = dp.execute(tp);
 
@@ -11,6 +11,8 @@
 #include "rsFileStageToCache.hpp"
 #include "rsFileSyncToArch.hpp"
 #include "dataObjOpr.hpp"
+#include "fileStageToCache.h"
+#include "rsGlobalExtern.hpp"
 
 // =-=-=-=-=-=-=-
 #include "irods_resource_plugin.hpp"
@@ -26,14 +28,29 @@
 #include "irods_lexical_cast.hpp"
 #include "irods_random.hpp"
 #include "irods_at_scope_exit.hpp"
+#include "irods_resource_backport.hpp"
+#include "client_connection.hpp"
 
 // =-=-=-=-=-=-=-
+// system includes
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 // stl includes
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 #include <vector>
 #include <string>
 #include <string_view>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 // =-=-=-=-=-=-=-
 // boost includes
@@ -62,6 +79,12 @@ const std::string AUTO_REPL_POLICY( "auto_repl" );
 /// @brief constant indicating the replication policy is enabled
 const std::string AUTO_REPL_POLICY_ENABLED( "on" );
 
+/// @brief constant indicating how objects are staged from the archive to the cache
+const std::string STAGE_MODE( "stage_mode" );
+
+/// @brief constant indicating stages run in the background while the staged bytes are read
+const std::string STAGE_MODE_BACKGROUND( "background" );
+
 namespace
 {
     auto get_archive_replica_number(
@@ -516,6 +539,257 @@ namespace {
         clearKeyVal( &data_obj_close_inp.condInput );
         return close_status;
     }
+
+    // A stage to cache which runs in the background. The source and destination replicas stay
+    // open until the stage completes so that the destination is only finalized, and marked
+    // good, once all of its bytes have arrived in the cache.
+    struct background_stage
+    {
+        std::mutex              mutex;
+        std::condition_variable cv;
+        bool                    done{};
+        int                     status{};
+        rodsLong_t              staged_bytes{};
+        int                     source_l1descInx{};
+        int                     destination_l1descInx{};
+    };
+
+    // Stages in flight in this agent, indexed by the physical path of the cache replica
+    std::map<std::string, std::shared_ptr<background_stage>> background_stages;
+    std::mutex background_stages_mutex;
+
+    bool stage_in_background(
+        irods::plugin_context& _ctx)
+    {
+        std::string mode;
+        irods::error ret = _ctx.prop_map().get<std::string>(STAGE_MODE, mode);
+        return ret.ok() && STAGE_MODE_BACKGROUND == mode;
+    } // stage_in_background
+
+    std::shared_ptr<background_stage> find_background_stage(
+        const std::string& _cache_path)
+    {
+        std::lock_guard<std::mutex> lock{background_stages_mutex};
+        const auto itr = background_stages.find(_cache_path);
+        return background_stages.end() == itr ? nullptr : itr->second;
+    } // find_background_stage
+
+    // How often a running stage looks at the cache file for newly arrived bytes
+    constexpr std::chrono::milliseconds stage_progress_interval{20};
+
+    // Returns the number of leading bytes of the cache file which have arrived. The archive writes
+    // the file in another agent, so they are read off the file: everything before its first hole
+    // has been written, except perhaps the block the archive is writing at this moment. That block
+    // is left out.
+    rodsLong_t staged_frontier(
+        const std::string& _cache_path)
+    {
+        const int fd = open(_cache_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return 0;
+        }
+        const irods::at_scope_exit close_fd{[fd] { close(fd); }};
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            return 0;
+        }
+
+        // filesystems without hole support report the end of the file
+        off_t first_hole = lseek(fd, 0, SEEK_HOLE);
+        if (first_hole < 0) {
+            first_hole = st.st_size;
+        }
+
+        return std::max<rodsLong_t>(0, std::min<rodsLong_t>(first_hole, st.st_size) - st.st_blksize);
+    } // staged_frontier
+
+    // Publishes the staged bytes of a running stage and wakes the reads waiting for them
+    void monitor_background_stage(
+        background_stage&  _stage,
+        const std::string& _cache_path)
+    {
+        std::unique_lock<std::mutex> lock{_stage.mutex};
+        while (!_stage.done) {
+            lock.unlock();
+            const rodsLong_t frontier = staged_frontier(_cache_path);
+            lock.lock();
+
+            if (!_stage.done && frontier > _stage.staged_bytes) {
+                _stage.staged_bytes = frontier;
+                _stage.cv.notify_all();
+            }
+
+            _stage.cv.wait_for(lock, stage_progress_interval, [&_stage] { return _stage.done; });
+        }
+    } // monitor_background_stage
+
+    // Blocks until the bytes up to _end have been staged or the stage has completed. The
+    // staged bytes grow while the stage runs, see monitor_background_stage.
+    int wait_for_staged_range(
+        background_stage& _stage,
+        const rodsLong_t  _end)
+    {
+        std::unique_lock<std::mutex> lock{_stage.mutex};
+        _stage.cv.wait(lock, [&_stage, _end] { return _stage.done || _stage.staged_bytes >= _end; });
+        return _stage.status;
+    } // wait_for_staged_range
+
+    // Blocks until the stage has completed
+    int wait_for_stage(
+        background_stage& _stage)
+    {
+        std::unique_lock<std::mutex> lock{_stage.mutex};
+        _stage.cv.wait(lock, [&_stage] { return _stage.done; });
+        return _stage.status;
+    } // wait_for_stage
+
+    irods::error start_background_stage(
+        irods::plugin_context&    _ctx,
+        const fileStageSyncInp_t& _stage_inp,
+        const int                 _source_l1descInx,
+        const int                 _destination_l1descInx)
+    {
+        // =-=-=-=-=-=-=-
+        // reads are only served by the agent running the stage, so the cache must be local
+        int remote_flag = 0;
+        rodsServerHost_t* host = nullptr;
+        irods::error ret = irods::get_host_for_hier_string(_stage_inp.rescHier, remote_flag, host);
+        if (!ret.ok()) {
+            return PASS(ret);
+        }
+        if (LOCAL_HOST != remote_flag) {
+            return ERROR(SYS_NOT_SUPPORTED, "cache resource is not local to this server");
+        }
+
+        const int status = mkDirForFilePath(
+                               _ctx.comm(),
+                               0,
+                               _stage_inp.cacheFilename,
+                               _stage_inp.rescHier,
+                               getDefDirMode());
+        if (status < 0) {
+            return ERROR(status, "mkDirForFilePath failed");
+        }
+
+        // =-=-=-=-=-=-=-
+        // the agent's connection belongs to the agent thread, so the stage is carried out by
+        // another agent over a connection of the service account.  the worker owns a copy of
+        // everything it uses and is detached; completion is only observed through the stage.
+        auto stage_inp = std::make_shared<fileStageSyncInp_t>(_stage_inp);
+        stage_inp->condInput = keyValPair_t{};
+        copyKeyVal(const_cast<keyValPair_t*>(&_stage_inp.condInput), &stage_inp->condInput);
+
+        // a stale cache file would pass for staged bytes until the archive truncates it
+        if (truncate(_stage_inp.cacheFilename, 0) != 0 && ENOENT != errno) {
+            return ERROR(UNIX_FILE_TRUNCATE_ERR - errno, "failed to truncate the cache file");
+        }
+
+        auto stage = std::make_shared<background_stage>();
+        stage->source_l1descInx = _source_l1descInx;
+        stage->destination_l1descInx = _destination_l1descInx;
+
+        const std::string cache_path = _stage_inp.cacheFilename;
+        {
+            std::lock_guard<std::mutex> lock{background_stages_mutex};
+            background_stages[cache_path] = stage;
+        }
+
+        try {
+            std::thread{[stage, stage_inp, cache_path] {
+                int status = 0;
+
+                // without a monitor, reads past the first byte wait for the whole stage
+                std::thread monitor;
+                try {
+                    monitor = std::thread{[stage, cache_path] { monitor_background_stage(*stage, cache_path); }};
+                }
+                catch (const std::system_error& e) {
+                    irods::log(LOG_NOTICE, fmt::format(
+                        "background stage to [{}] reports no progress: {}", cache_path, e.what()));
+                }
+
+                try {
+                    irods::experimental::client_connection conn;
+                    status = rcFileStageToCache(static_cast<rcComm_t*>(conn), stage_inp.get());
+                }
+                catch (const irods::exception& e) {
+                    status = e.code();
+                }
+
+                clearKeyVal(&stage_inp->condInput);
+
+                if (status < 0) {
+                    irods::log(LOG_ERROR, fmt::format(
+                        "background stage to [{}] failed with [{}]", cache_path, status));
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock{stage->mutex};
+                    stage->status = status < 0 ? status : 0;
+                    stage->staged_bytes = status < 0 ? 0 : stage_inp->dataSize;
+                    stage->done = true;
+                    stage->cv.notify_all();
+                }
+
+                if (monitor.joinable()) {
+                    monitor.join();
+                }
+            }}.detach();
+        }
+        catch (const std::system_error& e) {
+            clearKeyVal(&stage_inp->condInput);
+            std::lock_guard<std::mutex> lock{background_stages_mutex};
+            background_stages.erase(cache_path);
+            return ERROR(SYS_INTERNAL_ERR, fmt::format("failed to start background stage: {}", e.what()));
+        }
+
+        return SUCCESS();
+    } // start_background_stage
+
+    // Returns the L1 descriptor whose physical file is open on _fd, or 0 if there is none
+    int l1desc_for_file_descriptor(
+        const int _fd)
+    {
+        for (int i = 3; i < NUM_L1_DESC; ++i) {
+            const int l3descInx = L1desc[i].l3descInx;
+            if (FD_INUSE == L1desc[i].inuseFlag &&
+                l3descInx >= 3 &&
+                FD_INUSE == FileDesc[l3descInx].inuseFlag &&
+                _fd == FileDesc[l3descInx].fd) {
+                return i;
+            }
+        }
+        return 0;
+    } // l1desc_for_file_descriptor
+
+    // Waits for a background stage and finalizes its replicas. When the destination replica
+    // itself is being closed only the stage status is recorded so that a failed stage leaves
+    // the replica stale.
+    int complete_background_stage(
+        irods::plugin_context& _ctx,
+        const std::string&     _cache_path,
+        background_stage&      _stage,
+        const bool             _close_replicas)
+    {
+        wait_for_stage(_stage);
+
+        if (!_close_replicas) {
+            if (_stage.status < 0) {
+                L1desc[_stage.destination_l1descInx].oprStatus = _stage.status;
+            }
+
+            std::lock_guard<std::mutex> lock{background_stages_mutex};
+            background_stages.erase(_cache_path);
+            return _stage.status;
+        }
+
+        // closing the destination re-enters compound_file_close which records the status
+        close_replica(_ctx, _stage.destination_l1descInx);
+        close_replica(_ctx, _stage.source_l1descInx);
+
+        return _stage.status;
+    } // complete_background_stage
 }
 
 /// =-=-=-=-=-=-=-
@@ -523,7 +797,8 @@ namespace {
 irods::error repl_object(
     irods::plugin_context& _ctx,
     const irods::hierarchy_parser& _hier_from_root_to_compound,
-    const std::string_view _stage_sync_kw)
+    const std::string_view _stage_sync_kw,
+    const bool _in_background = false)
 {
     // =-=-=-=-=-=-=-
     // error check incoming params
@@ -683,6 +958,22 @@ irods::error repl_object(
         file_stage.dataSize = srcDataObjInfo->dataSize;
         file_stage.mode = getFileMode(L1desc[destination_l1descInx].dataObjInp);
 
+        // =-=-=-=-=-=-=-
+        // hand both replicas to a background stage, reads wait only for their own range
+        if (_in_background) {
+            ret = start_background_stage(_ctx, file_stage, source_l1descInx, destination_l1descInx);
+            if (ret.ok()) {
+                source_l1descInx = 0;
+                destination_l1descInx = 0;
+                return SUCCESS();
+            }
+
+            irods::log(LOG_NOTICE, fmt::format(
+                "[{}] - staging [{}] in the foreground: {}",
+                __FUNCTION__, obj->logical_path(), ret.result()));
+            ret = SUCCESS();
+        }
+
         int status = rsFileStageToCache(_ctx.comm(), &file_stage);
         if (status < 0) {
             ret = ERROR(status, "rsFileStageToCache failed");
@@ -861,6 +1152,21 @@ irods::error compound_file_read(
         return PASSMSG( "Unable to get cache resource.", ret );
     }
 
+    // =-=-=-=-=-=-=-
+    // if the object is still being staged, wait for the requested range to arrive
+    irods::file_object_ptr fco = boost::dynamic_pointer_cast< irods::file_object >( _ctx.fco() );
+    if ( auto stage = find_background_stage( fco->physical_path() ) ) {
+        ret = resc->call< const long long, const int >( _ctx.comm(), irods::RESOURCE_OP_LSEEK, _ctx.fco(), 0, SEEK_CUR );
+        if ( !ret.ok() ) {
+            return PASS( ret );
+        }
+
+        const int status = wait_for_staged_range( *stage, ret.code() + _len );
+        if ( status < 0 ) {
+            return ERROR( status, "background stage to cache failed" );
+        }
+    }
+
     // =-=-=-=-=-=-=-
     // forward the call
     return resc->call< void*, const int >( _ctx.comm(), irods::RESOURCE_OP_READ, _ctx.fco(), _buf, _len );
@@ -921,6 +1227,21 @@ irods::error compound_file_close(
 
     }
 
+    // =-=-=-=-=-=-=-
+    // a background stage completes no later than the close of its object.  descriptors
+    // of parallel transfer threads belong to no object and leave the stage running.
+    irods::file_object_ptr fco = boost::dynamic_pointer_cast< irods::file_object >( _ctx.fco() );
+    if ( auto stage = find_background_stage( fco->physical_path() ) ) {
+        const int l1descInx = l1desc_for_file_descriptor( fco->file_descriptor() );
+        if ( l1descInx > 0 ) {
+            complete_background_stage(
+                _ctx,
+                fco->physical_path(),
+                *stage,
+                l1descInx != stage->destination_l1descInx );
+        }
+    }
+
     return SUCCESS();
 
 } // compound_file_close
@@ -1611,7 +1932,7 @@ irods::error open_for_prefer_archive_policy(
     // =-=-=-=-=-=-=-
     // if the vote is 0 then we do a wholesale stage, not an update
     // otherwise it is an update operation for the stage to cache
-    ret = repl_object( _ctx, _out_parser, STAGE_OBJ_KW );
+    ret = repl_object( _ctx, _out_parser, STAGE_OBJ_KW, stage_in_background( _ctx ) );
     if ( !ret.ok() ) {
         return PASS( ret );
     }
@@ -1818,7 +2139,7 @@ irods::error open_for_prefer_cache_policy(
 
         // =-=-=-=-=-=-=-
         // if the archive has it, then replicate
-        ret = repl_object( _ctx, arch_check_parser, STAGE_OBJ_KW );
+        ret = repl_object( _ctx, arch_check_parser, STAGE_OBJ_KW, stage_in_background( _ctx ) );
         if ( !ret.ok() ) {
             return PASS( ret );
         }
@@ -16,6 +16,7 @@
 #include "irods_resource_redirect.hpp"
 #include "irods_stacktrace.hpp"
 #include "irods_kvp_string_parser.hpp"
+#include "server_load_digest_cache.hpp"
 
 // =-=-=-=-=-=-=-
 // stl includes
@@ -32,6 +33,13 @@
 
 #define MAX_ELAPSE_TIME 1800
 
+/// =-=-=-=-=-=-=-
+/// @brief number of seconds the shared load digest is reused before
+///        the catalog is queried again
+#define LOAD_DIGEST_REFRESH_INTERVAL 60
+
+namespace sldc = irods::experimental::server_load_digest_cache;
+
 /// =-=-=-=-=-=-=-
 /// @brief Key to deferral policy requested
 const std::string DEFER_POLICY_KEY( "defer_policy" );
@@ -624,16 +632,10 @@ irods::error load_balanced_file_notify(
 } // load_balanced_file_notify
 
 /// =-=-=-=-=-=-=-
-/// @brief get the loads, times and names from the resource monitoring table
-irods::error get_load_lists(
-    irods::plugin_context& _ctx,
-    std::vector< std::string >&     _resc_names,
-    std::vector< int >&             _resc_loads,
-    std::vector< int >&             _resc_times ) {
-    // =-=-=-=-=-=-=-
-    //
-    int i = 0, j = 0, nresc = 0, status = 0;
-    char* tResult = 0;
+/// @brief query the resource monitoring table for the latest load of each resource
+irods::error query_load_digest(
+    rsComm_t*                        _comm,
+    std::vector< sldc::load_entry >& _entries ) {
     genQueryInp_t  genQueryInp;
     genQueryOut_t* genQueryOut = NULL;
 
@@ -648,45 +650,78 @@ irods::error get_load_lists(
     // =-=-=-=-=-=-=-
     // a tmp fix to increase no. of resource to 256
     genQueryInp.maxRows = MAX_SQL_ROWS * 10;
-    status =  rsGenQuery( _ctx.comm(), &genQueryInp, &genQueryOut );
-    if ( status == 0 ) {
-        nresc = genQueryOut->rowCnt;
-        // =-=-=-=-=-=-=-
-        // vectors should be sized to number of resources
-        // these vectors will be indexed directly, not built
-        _resc_names.resize( nresc );
-        _resc_loads.resize( nresc );
-        _resc_times.resize( nresc );
-
-        for ( i = 0; i < genQueryOut->attriCnt; i++ ) {
-            for ( j = 0; j < nresc; j++ ) {
-                tResult = genQueryOut->sqlResult[i].value;
-                tResult += j * genQueryOut->sqlResult[i].len;
-                switch ( i ) {
-                case 0:
-                    _resc_names[j] = tResult;
-
-                case 1:
-                    _resc_loads[j] = atoi( tResult );
-                    break;
-                case 2:
-                    _resc_times[j] = atoi( tResult );
-                    break;
-                }
-            }
-        }
-    }
-    else {
+    int status = rsGenQuery( _comm, &genQueryInp, &genQueryOut );
+    if ( status != 0 ) {
         clearGenQueryInp( &genQueryInp );
         freeGenQueryOut( &genQueryOut );
         return ERROR( status, "genquery failed" );
     }
 
+    // =-=-=-=-=-=-=-
+    // parse the load factors and times once so that every vote
+    // reading the cache can use them directly
+    _entries.clear();
+    _entries.reserve( genQueryOut->rowCnt );
+    for ( int j = 0; j < genQueryOut->rowCnt; j++ ) {
+        const auto* name = genQueryOut->sqlResult[0].value + j * genQueryOut->sqlResult[0].len;
+        const auto* load = genQueryOut->sqlResult[1].value + j * genQueryOut->sqlResult[1].len;
+        const auto* time = genQueryOut->sqlResult[2].value + j * genQueryOut->sqlResult[2].len;
+        _entries.push_back( { name, atoi( load ), atoi( time ) } );
+    }
+
     clearGenQueryInp( &genQueryInp );
     freeGenQueryOut( &genQueryOut );
 
     return SUCCESS();
 
+} // query_load_digest
+
+/// =-=-=-=-=-=-=-
+/// @brief get the loads, times and names from the resource monitoring table
+///        by way of the shared load digest cache.  only the agent granted
+///        the refresh touches the catalog, all others read the cache.
+irods::error get_load_lists(
+    irods::plugin_context& _ctx,
+    std::vector< std::string >&     _resc_names,
+    std::vector< int >&             _resc_loads,
+    std::vector< int >&             _resc_times ) {
+    std::vector< sldc::load_entry > entries;
+
+    if ( sldc::claim_refresh( LOAD_DIGEST_REFRESH_INTERVAL ) ) {
+        irods::error ret = query_load_digest( _ctx.comm(), entries );
+        if ( !ret.ok() ) {
+            return PASS( ret );
+        }
+
+        sldc::update( entries );
+    }
+    else if ( auto cached = sldc::entries(); cached ) {
+        entries = std::move( *cached );
+    }
+    else {
+        // =-=-=-=-=-=-=-
+        // another agent is populating the cache for the first time
+        irods::error ret = query_load_digest( _ctx.comm(), entries );
+        if ( !ret.ok() ) {
+            return PASS( ret );
+        }
+    }
+
+    // =-=-=-=-=-=-=-
+    // vectors should be sized to number of resources
+    // these vectors will be indexed directly, not built
+    _resc_names.resize( entries.size() );
+    _resc_loads.resize( entries.size() );
+    _resc_times.resize( entries.size() );
+
+    for ( std::size_t i = 0; i < entries.size(); i++ ) {
+        _resc_names[i] = entries[i].resource_name;
+        _resc_loads[i] = entries[i].load_factor;
+        _resc_times[i] = entries[i].create_time;
+    }
+
+    return SUCCESS();
+
 } // get_load_lists
 
 
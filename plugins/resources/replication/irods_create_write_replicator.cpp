@@ -1,8 +1,14 @@
 #include "irods_create_write_replicator.hpp"
 
 #include "dataObjRepl.h"
+#include "irods_at_scope_exit.hpp"
 #include "irods_repl_retry.hpp"
 #include "irods_stacktrace.hpp"
+#include "rsDataObjRepl.hpp"
+
+#include <vector>
+
+#include "fmt/format.h"
 
 namespace irods {
 
@@ -36,58 +42,109 @@ namespace irods {
             child_parser.str( sub_hier, current_resource_ );
 
             file_object object = _object_oper.object();
+
+            auto fan_out_threads = DEFAULT_FAN_OUT_THREADS;
+            auto minimum_good_replicas = DEFAULT_MINIMUM_GOOD_REPLICAS;
+            _ctx.prop_map().get< decltype( fan_out_threads ) >( FAN_OUT_THREADS_KW, fan_out_threads );
+            _ctx.prop_map().get< decltype( minimum_good_replicas ) >( MINIMUM_GOOD_REPLICAS_KW, minimum_good_replicas );
+
+            std::vector< std::string > hierarchies;
             child_list_t::const_iterator it;
             for ( it = _siblings.begin(); it != _siblings.end(); ++it ) {
                 hierarchy_parser sibling = *it;
                 std::string hierarchy_string;
                 error ret = sibling.str( hierarchy_string );
                 if ( ( result = ASSERT_PASS( ret, "Failed to get the hierarchy string from the sibling hierarchy parser." ) ).ok() ) {
-                    dataObjInp_t dataObjInp;
-                    bzero( &dataObjInp, sizeof( dataObjInp ) );
-                    rstrcpy( dataObjInp.objPath, object.logical_path().c_str(), MAX_NAME_LEN );
-                    dataObjInp.createMode = object.mode();
-
-                    copyKeyVal( ( keyValPair_t* )&object.cond_input(), &dataObjInp.condInput );
-                    addKeyVal( &dataObjInp.condInput, RESC_HIER_STR_KW, child_.c_str() );
-                    addKeyVal( &dataObjInp.condInput, DEST_RESC_HIER_STR_KW, hierarchy_string.c_str() );
-                    addKeyVal( &dataObjInp.condInput, RESC_NAME_KW, root_resource_.c_str() );
-                    addKeyVal( &dataObjInp.condInput, DEST_RESC_NAME_KW, root_resource_.c_str() );
-                    addKeyVal( &dataObjInp.condInput, IN_PDMO_KW, sub_hier.c_str() );
+                    hierarchies.push_back( hierarchy_string );
+                }
+            } // for it
+
+            dataObjInp_t dataObjInp;
+            bzero( &dataObjInp, sizeof( dataObjInp ) );
+            rstrcpy( dataObjInp.objPath, object.logical_path().c_str(), MAX_NAME_LEN );
+            dataObjInp.createMode = object.mode();
+
+            copyKeyVal( ( keyValPair_t* )&object.cond_input(), &dataObjInp.condInput );
+            addKeyVal( &dataObjInp.condInput, RESC_HIER_STR_KW, child_.c_str() );
+            addKeyVal( &dataObjInp.condInput, RESC_NAME_KW, root_resource_.c_str() );
+            addKeyVal( &dataObjInp.condInput, DEST_RESC_NAME_KW, root_resource_.c_str() );
+            addKeyVal( &dataObjInp.condInput, IN_PDMO_KW, sub_hier.c_str() );
+            rmKeyVal( &dataObjInp.condInput, ALL_KW );
+
+            // Move the data to all of the siblings at once. Any sibling which fails is retried
+            // serially below with the configured retry policy.
+            std::vector< int > statuses( hierarchies.size(), -1 );
+            if ( fan_out_threads > 1 && hierarchies.size() > 1 ) {
+                try {
+                    statuses = dataObjReplToHierarchies( _ctx.comm(), dataObjInp, hierarchies, fan_out_threads );
+                }
+                catch ( const irods::exception& e ) {
+                    irods::log( irods::error( e ) );
+                }
+            }
+
+            // The replica which was just written counts toward the minimum.
+            uint32_t good_replicas = 1;
+            for ( std::size_t i = 0; i < hierarchies.size(); ++i ) {
+                const auto& hierarchy_string = hierarchies[ i ];
+                int status = statuses[ i ];
+
+                // Replications which failed simply because they were not allowed need not be reported.
+                // Such failures should be fixed with a rebalance or some tree surgery.
+                if ( SYS_NOT_ALLOWED == status ) {
+                    continue;
+                }
+
+                if ( status < 0 ) {
+                    dataObjInp_t sibling_inp = dataObjInp;
+                    replKeyVal( &dataObjInp.condInput, &sibling_inp.condInput );
+                    const irods::at_scope_exit free_cond_input{ [&sibling_inp] { clearKeyVal( &sibling_inp.condInput ); } };
+                    addKeyVal( &sibling_inp.condInput, DEST_RESC_HIER_STR_KW, hierarchy_string.c_str() );
 
                     try {
-                        const auto status = data_obj_repl_with_retry( _ctx, dataObjInp );
-                        if (status < 0) {
-                            // Replications which failed simply because they were not allowed need not be reported.
-                            // Such failures should be fixed with a rebalance or some tree surgery.
-                            if (SYS_NOT_ALLOWED == status) {
-                                continue;
-                            }
-
-                            char* sys_error = NULL;
-                            auto rods_error = rodsErrorName( status, &sys_error );
-                            result = ERROR(status, fmt::format(
-                                "Failed to replicate the data object: \"{}\" from resource: \"{}\" to sibling: \"{}\" - {} {}.",
-                                object.logical_path(), child_, hierarchy_string, rods_error, sys_error));
-                            free( sys_error );
-
-                            // cache last error to return, log it and add it to the
-                            // client side error stack
-                            last_error = result;
-                            irods::log( result );
-                            addRErrorMsg(
-                                &_ctx.comm()->rError,
-                                result.code(),
-                                result.result().c_str() );
-                            result = SUCCESS();
-                        }
+                        status = data_obj_repl_with_retry( _ctx, sibling_inp );
                     }
                     catch ( const irods::exception& e ) {
                         irods::log( irods::error( e ) );
+                        continue;
                     }
 
-                } // if hier str
-
-            } // for it
+                    if ( SYS_NOT_ALLOWED == status ) {
+                        continue;
+                    }
+                }
+
+                if ( status >= 0 ) {
+                    ++good_replicas;
+                    continue;
+                }
+
+                char* sys_error = NULL;
+                auto rods_error = rodsErrorName( status, &sys_error );
+                result = ERROR(status, fmt::format(
+                    "Failed to replicate the data object: \"{}\" from resource: \"{}\" to sibling: \"{}\" - {} {}.",
+                    object.logical_path(), child_, hierarchy_string, rods_error, sys_error));
+                free( sys_error );
+
+                // cache last error to return, log it and add it to the
+                // client side error stack
+                last_error = result;
+                irods::log( result );
+                addRErrorMsg(
+                    &_ctx.comm()->rError,
+                    result.code(),
+                    result.result().c_str() );
+                result = SUCCESS();
+            } // for i
+
+            clearKeyVal( &dataObjInp.condInput );
+
+            if ( !last_error.ok() && minimum_good_replicas > 0 && good_replicas >= minimum_good_replicas ) {
+                irods::log( LOG_NOTICE, fmt::format(
+                    "[{}:{}] - [{}] has [{}] good replicas, which meets the minimum of [{}] for [{}]",
+                    __FUNCTION__, __LINE__, object.logical_path(), good_replicas, minimum_good_replicas, current_resource_ ) );
+                last_error = SUCCESS();
+            }
 
         } // if ok
 
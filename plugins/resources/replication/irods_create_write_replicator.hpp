@@ -4,8 +4,21 @@
 #include "irods_error.hpp"
 #include "irods_oper_replicator.hpp"
 
+#include <string>
+
 namespace irods {
 
+    // Number of siblings which are replicated to at the same time; 1 replicates serially.
+    // Only copies between unixfilesystem vaults on the local server run concurrently.
+    // Siblings on other servers, or of other resource types, are still copied one at a time.
+    const std::string FAN_OUT_THREADS_KW{ "fan_out_threads" };
+    // Number of good replicas, including the one just written, which makes a create/write
+    // successful even if replication to some siblings fails; 0 requires every sibling.
+    const std::string MINIMUM_GOOD_REPLICAS_KW{ "minimum_good_replicas" };
+
+    const uint32_t DEFAULT_FAN_OUT_THREADS{ 1 };
+    const uint32_t DEFAULT_MINIMUM_GOOD_REPLICAS{ 0 };
+
     /**
      * @brief Replicator for create/write operations
      */
@@ -8,15 +8,22 @@
 #include "icatHighLevelRoutines.hpp"
 #include "dataObjRepl.h"
 #include "genQuery.h"
+#include "rsDataObjRepl.hpp"
 #include "rsGenQuery.hpp"
+#include "rsModAVUMetadata.hpp"
+#include "irods_at_scope_exit.hpp"
 #include "boost/format.hpp"
 #include "boost/lexical_cast.hpp"
 #include "rodsError.h"
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+
 
 namespace {
-    irods::error repl_for_rebalance(
-        irods::plugin_context& _ctx,
+    void init_rebalance_input(
+        dataObjInp_t&      _data_obj_inp,
         const std::string& _obj_path,
         const std::string& _current_resc,
         const std::string& _src_hier,
@@ -31,15 +38,29 @@ namespace {
         std::string sub_hier;
         parser.str( sub_hier, _current_resc );
 
+        _data_obj_inp = dataObjInp_t{};
+        rstrcpy( _data_obj_inp.objPath, _obj_path.c_str(), MAX_NAME_LEN );
+        _data_obj_inp.createMode = _mode;
+        addKeyVal( &_data_obj_inp.condInput, RESC_HIER_STR_KW,      _src_hier.c_str() );
+        addKeyVal( &_data_obj_inp.condInput, DEST_RESC_HIER_STR_KW, _dst_hier.c_str() );
+        addKeyVal( &_data_obj_inp.condInput, RESC_NAME_KW,          _src_resc.c_str() );
+        addKeyVal( &_data_obj_inp.condInput, DEST_RESC_NAME_KW,     _dst_resc.c_str() );
+        addKeyVal( &_data_obj_inp.condInput, IN_PDMO_KW,             sub_hier.c_str() );
+        addKeyVal( &_data_obj_inp.condInput, ADMIN_KW,              "" );
+    }
+
+    irods::error repl_for_rebalance(
+        irods::plugin_context& _ctx,
+        const std::string& _obj_path,
+        const std::string& _current_resc,
+        const std::string& _src_hier,
+        const std::string& _dst_hier,
+        const std::string& _src_resc,
+        const std::string& _dst_resc,
+        const int          _mode ) {
         dataObjInp_t data_obj_inp{};
-        rstrcpy( data_obj_inp.objPath, _obj_path.c_str(), MAX_NAME_LEN );
-        data_obj_inp.createMode = _mode;
-        addKeyVal( &data_obj_inp.condInput, RESC_HIER_STR_KW,      _src_hier.c_str() );
-        addKeyVal( &data_obj_inp.condInput, DEST_RESC_HIER_STR_KW, _dst_hier.c_str() );
-        addKeyVal( &data_obj_inp.condInput, RESC_NAME_KW,          _src_resc.c_str() );
-        addKeyVal( &data_obj_inp.condInput, DEST_RESC_NAME_KW,     _dst_resc.c_str() );
-        addKeyVal( &data_obj_inp.condInput, IN_PDMO_KW,             sub_hier.c_str() );
-        addKeyVal( &data_obj_inp.condInput, ADMIN_KW,              "" );
+        init_rebalance_input( data_obj_inp, _obj_path, _current_resc, _src_hier, _dst_hier, _src_resc, _dst_resc, _mode );
+        const irods::at_scope_exit free_cond_input{ [&data_obj_inp] { clearKeyVal( &data_obj_inp.condInput ); } };
 
         try {
             // =-=-=-=-=-=-=-
@@ -59,6 +80,111 @@ namespace {
         return SUCCESS();
     }
 
+    struct rebalance_replication {
+        rodsLong_t  data_id;
+        std::string object_path;
+        std::string source_hierarchy;
+        std::string destination_hierarchy;
+        std::string root_resource;
+        int         data_mode;
+        rodsLong_t  data_size;
+    };
+
+    // Replicates every entry of _replications and returns the result of each, in order. With more
+    // than one thread, the data for up to _thread_count replications is moved at a time; anything
+    // which fails that way is retried serially so that the configured retry policy still applies.
+    // The number of replications open at once is bounded to keep the agent within its l1
+    // descriptor table.
+    std::vector<irods::error> replicate_for_rebalance(
+        irods::plugin_context&                     _ctx,
+        const std::string&                         _current_resc,
+        const std::vector<rebalance_replication>& _replications,
+        const uint32_t                             _thread_count) {
+        std::vector<int> statuses(_replications.size(), -1);
+
+        if (_thread_count > 1) {
+            const std::size_t window_size = 4 * _thread_count;
+            for (std::size_t offset = 0; offset < _replications.size(); offset += window_size) {
+                const std::size_t end = std::min(offset + window_size, _replications.size());
+
+                std::vector<dataObjInp_t> inputs(end - offset);
+                const irods::at_scope_exit free_cond_input{[&inputs] {
+                    for (auto& inp : inputs) {
+                        clearKeyVal(&inp.condInput);
+                    }
+                }};
+
+                for (std::size_t i = offset; i < end; ++i) {
+                    const auto& r = _replications[i];
+                    init_rebalance_input(inputs[i - offset], r.object_path, _current_resc, r.source_hierarchy,
+                                         r.destination_hierarchy, r.root_resource, r.root_resource, r.data_mode);
+                }
+
+                try {
+                    const auto window_statuses = dataObjReplBatch(_ctx.comm(), inputs, _thread_count);
+                    std::copy(window_statuses.begin(), window_statuses.end(), statuses.begin() + offset);
+                }
+                catch (const irods::exception& e) {
+                    irods::log(e);
+                }
+            }
+        }
+
+        std::vector<irods::error> ret;
+        ret.reserve(_replications.size());
+        for (std::size_t i = 0; i < _replications.size(); ++i) {
+            if (statuses[i] >= 0) {
+                ret.push_back(SUCCESS());
+                continue;
+            }
+
+            const auto& r = _replications[i];
+            ret.push_back(repl_for_rebalance(
+                _ctx,
+                r.object_path,
+                _current_resc,
+                r.source_hierarchy,
+                r.destination_hierarchy,
+                r.root_resource,
+                r.root_resource,
+                r.data_mode));
+        }
+        return ret;
+    }
+
+    // Reports the throughput of one phase of a rebalance in the server log.
+    class rebalance_progress {
+        public:
+            rebalance_progress(
+                const std::string& _phase,
+                const std::string& _resource_name)
+                : phase_{_phase}
+                , resource_name_{_resource_name}
+                , start_{std::chrono::steady_clock::now()}
+            {
+            }
+
+            void add(const rodsLong_t _objects, const rodsLong_t _bytes) {
+                objects_ += _objects;
+                bytes_ += _bytes;
+            }
+
+            void log() const {
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+                const double seconds = std::max(elapsed.count(), 0.001);
+                rodsLog(LOG_NOTICE, "rebalance: [%s] on [%s] replicated [%lld] objects and [%lld] bytes in [%.1f] seconds ([%.1f] objects/s, [%.1f] bytes/s)",
+                        phase_.c_str(), resource_name_.c_str(), objects_, bytes_, seconds,
+                        objects_ / seconds, bytes_ / seconds);
+            }
+
+        private:
+            const std::string phase_;
+            const std::string resource_name_;
+            const std::chrono::steady_clock::time_point start_;
+            rodsLong_t objects_{};
+            rodsLong_t bytes_{};
+    };
+
     // throws irods::exception
     sqlResult_t* extract_sql_result(const genQueryInp_t& genquery_inp, genQueryOut_t* genquery_out_ptr, const int column_number) {
         if (sqlResult_t *sql_result = getSqlResultByInx(genquery_out_ptr, column_number)) {
@@ -76,92 +202,130 @@ namespace {
         std::string object_path;
         std::string resource_hierarchy;
         int data_mode;
+        rodsLong_t data_size;
     };
 
+    // Returns the path, mode, size, and a good replica's hierarchy within _leaf_bundles for each of
+    // _data_ids, looked up with one query per chunk of ids rather than one per id. Data ids which
+    // have no good replica in the bundles are not in the result.
     // throws irods::exception
-    ReplicationSourceInfo get_source_data_object_attributes(
+    std::map<rodsLong_t, ReplicationSourceInfo> get_source_data_object_attributes(
         rsComm_t* _comm,
-        const rodsLong_t _data_id,
+        const std::vector<rodsLong_t>& _data_ids,
         const std::vector<leaf_bundle_t>& _leaf_bundles) {
 
         if (!_comm) {
             THROW(SYS_INTERNAL_NULL_INPUT_ERR, "null comm ptr");
         }
 
-        irods::GenQueryInpWrapper genquery_inp_wrapped;
-        genquery_inp_wrapped.get().maxRows = MAX_SQL_ROWS;
-        addInxVal(&genquery_inp_wrapped.get().sqlCondInp, COL_D_DATA_ID, (boost::format("= '%lld'") % _data_id).str().c_str());
-
         std::stringstream cond_ss;
         for (auto& bun : _leaf_bundles) {
             for (auto id : bun) {
                 cond_ss << "= '" << id << "' || ";
             }
         }
-        std::string cond_str = cond_ss.str().substr(0, cond_ss.str().size()-4);
-        addInxVal(&genquery_inp_wrapped.get().sqlCondInp, COL_D_RESC_ID, cond_str.c_str());
+        const std::string cond_str = cond_ss.str().substr(0, cond_ss.str().size()-4);
 
-        addInxVal(&genquery_inp_wrapped.get().sqlCondInp, COL_D_REPL_STATUS, (boost::format("= '%d'") % GOOD_REPLICA).str().c_str());
+        // keeps the generated sql well under the general query limit
+        constexpr std::size_t data_ids_per_query = 200;
 
-        addInxIval(&genquery_inp_wrapped.get().selectInp, COL_DATA_NAME, 1);
-        addInxIval(&genquery_inp_wrapped.get().selectInp, COL_COLL_NAME, 1);
-        addInxIval(&genquery_inp_wrapped.get().selectInp, COL_DATA_MODE, 1);
-        addInxIval(&genquery_inp_wrapped.get().selectInp, COL_D_RESC_ID, 1);
+        std::map<rodsLong_t, ReplicationSourceInfo> ret;
+        for (std::size_t offset = 0; offset < _data_ids.size(); offset += data_ids_per_query) {
+            irods::GenQueryInpWrapper genquery_inp_wrapped;
+            genquery_inp_wrapped.get().maxRows = MAX_SQL_ROWS;
 
-        irods::GenQueryOutPtrWrapper genquery_out_ptr_wrapped;
-        const int status_rsGenQuery = rsGenQuery(_comm, &genquery_inp_wrapped.get(), &genquery_out_ptr_wrapped.get());
-        if (status_rsGenQuery < 0) {
-            THROW(
-                status_rsGenQuery,
-                boost::format("rsGenQuery failed. genquery_inp contents:\n%s\n\n possible iquest [%s]") %
-                genquery_inp_to_diagnostic_string(&genquery_inp_wrapped.get()) %
-                genquery_inp_to_iquest_string(&genquery_inp_wrapped.get()));
-        }
-
-        if (!genquery_out_ptr_wrapped.get()) {
-            THROW(
-                SYS_INTERNAL_NULL_INPUT_ERR,
-                boost::format("rsGenQuery failed. genquery_inp contents:\n%s\n\n possible iquest [%s]") %
-                genquery_inp_to_diagnostic_string(&genquery_inp_wrapped.get()) %
-                genquery_inp_to_iquest_string(&genquery_inp_wrapped.get()));
-        }
+            std::stringstream data_id_ss;
+            data_id_ss << "in (";
+            const std::size_t end = std::min(offset + data_ids_per_query, _data_ids.size());
+            for (std::size_t i = offset; i < end; ++i) {
+                data_id_ss << (i == offset ? "'" : ", '") << _data_ids[i] << "'";
+            }
+            data_id_ss << ")";
+            addInxVal(&genquery_inp_wrapped.get().sqlCondInp, COL_D_DATA_ID, data_id_ss.str().c_str());
+            addInxVal(&genquery_inp_wrapped.get().sqlCondInp, COL_D_RESC_ID, cond_str.c_str());
+            addInxVal(&genquery_inp_wrapped.get().sqlCondInp, COL_D_REPL_STATUS, (boost::format("= '%d'") % GOOD_REPLICA).str().c_str());
+
+            addInxIval(&genquery_inp_wrapped.get().selectInp, COL_D_DATA_ID, 1);
+            addInxIval(&genquery_inp_wrapped.get().selectInp, COL_DATA_NAME, 1);
+            addInxIval(&genquery_inp_wrapped.get().selectInp, COL_COLL_NAME, 1);
+            addInxIval(&genquery_inp_wrapped.get().selectInp, COL_DATA_MODE, 1);
+            addInxIval(&genquery_inp_wrapped.get().selectInp, COL_D_RESC_ID, 1);
+            addInxIval(&genquery_inp_wrapped.get().selectInp, COL_DATA_SIZE, 1);
+
+            auto cast_genquery_result = [&genquery_inp_wrapped](char *s) -> rodsLong_t {
+                try {
+                    return boost::lexical_cast<rodsLong_t>(s);
+                } catch (const boost::bad_lexical_cast&) {
+                    THROW(
+                        INVALID_LEXICAL_CAST,
+                        boost::format("boost::lexical_cast failed. tried to cast [%s]. genquery_inp contents:\n%s\n\n possible iquest [%s]") %
+                        s %
+                        genquery_inp_to_diagnostic_string(&genquery_inp_wrapped.get()) %
+                        genquery_inp_to_iquest_string(&genquery_inp_wrapped.get()));
+                }
+            };
 
+            while (true) {
+                irods::GenQueryOutPtrWrapper genquery_out_ptr_wrapped;
+                const int status_rsGenQuery = rsGenQuery(_comm, &genquery_inp_wrapped.get(), &genquery_out_ptr_wrapped.get());
+                if (CAT_NO_ROWS_FOUND == status_rsGenQuery) {
+                    break;
+                }
+                else if (status_rsGenQuery < 0) {
+                    THROW(
+                        status_rsGenQuery,
+                        boost::format("rsGenQuery failed. genquery_inp contents:\n%s\n\n possible iquest [%s]") %
+                        genquery_inp_to_diagnostic_string(&genquery_inp_wrapped.get()) %
+                        genquery_inp_to_iquest_string(&genquery_inp_wrapped.get()));
+                }
+                else if (!genquery_out_ptr_wrapped.get()) {
+                    THROW(
+                        SYS_INTERNAL_NULL_INPUT_ERR,
+                        boost::format("rsGenQuery failed. genquery_inp contents:\n%s\n\n possible iquest [%s]") %
+                        genquery_inp_to_diagnostic_string(&genquery_inp_wrapped.get()) %
+                        genquery_inp_to_iquest_string(&genquery_inp_wrapped.get()));
+                }
 
-        sqlResult_t *data_name_result = extract_sql_result(genquery_inp_wrapped.get(), genquery_out_ptr_wrapped.get(), COL_DATA_NAME);
-        char *data_name = &data_name_result->value[0];
+                genQueryOut_t* genquery_out = genquery_out_ptr_wrapped.get();
+                sqlResult_t *data_id_results   = extract_sql_result(genquery_inp_wrapped.get(), genquery_out, COL_D_DATA_ID);
+                sqlResult_t *data_name_results = extract_sql_result(genquery_inp_wrapped.get(), genquery_out, COL_DATA_NAME);
+                sqlResult_t *coll_name_results = extract_sql_result(genquery_inp_wrapped.get(), genquery_out, COL_COLL_NAME);
+                sqlResult_t *data_mode_results = extract_sql_result(genquery_inp_wrapped.get(), genquery_out, COL_DATA_MODE);
+                sqlResult_t *resc_id_results   = extract_sql_result(genquery_inp_wrapped.get(), genquery_out, COL_D_RESC_ID);
+                sqlResult_t *data_size_results = extract_sql_result(genquery_inp_wrapped.get(), genquery_out, COL_DATA_SIZE);
+
+                for (int i = 0; i < genquery_out->rowCnt; ++i) {
+                    // any good replica will do as the source
+                    const rodsLong_t data_id = cast_genquery_result(&data_id_results->value[data_id_results->len * i]);
+                    if (ret.count(data_id)) {
+                        continue;
+                    }
 
-        sqlResult_t *coll_name_result = extract_sql_result(genquery_inp_wrapped.get(), genquery_out_ptr_wrapped.get(), COL_COLL_NAME);
-        char *coll_name = &coll_name_result->value[0];
+                    const char* data_name = &data_name_results->value[data_name_results->len * i];
+                    const char* coll_name = &coll_name_results->value[coll_name_results->len * i];
+                    const rodsLong_t resc_id = cast_genquery_result(&resc_id_results->value[resc_id_results->len * i]);
+
+                    ReplicationSourceInfo info;
+                    info.object_path = (boost::format("%s%s%s") % coll_name % irods::get_virtual_path_separator() % data_name).str();
+                    irods::error err = resc_mgr.leaf_id_to_hier(resc_id, info.resource_hierarchy);
+                    if (!err.ok()) {
+                        THROW(err.code(),
+                              boost::format("leaf_id_to_hier failed. resc id [%lld] genquery inp:\n%s") %
+                              resc_id %
+                              genquery_inp_to_diagnostic_string(&genquery_inp_wrapped.get()));
+                    }
+                    info.data_mode = cast_genquery_result(&data_mode_results->value[data_mode_results->len * i]);
+                    info.data_size = cast_genquery_result(&data_size_results->value[data_size_results->len * i]);
+                    ret.emplace(data_id, std::move(info));
+                }
 
-        auto cast_genquery_result = [&genquery_inp_wrapped](char *s) -> rodsLong_t {
-            try {
-                return boost::lexical_cast<rodsLong_t>(s);
-            } catch (const boost::bad_lexical_cast&) {
-                THROW(
-                    INVALID_LEXICAL_CAST,
-                    boost::format("boost::lexical_cast failed. tried to cast [%s]. genquery_inp contents:\n%s\n\n possible iquest [%s]") %
-                    s %
-                    genquery_inp_to_diagnostic_string(&genquery_inp_wrapped.get()) %
-                    genquery_inp_to_iquest_string(&genquery_inp_wrapped.get()));
+                if (genquery_out->continueInx <= 0) {
+                    break;
+                }
+                genquery_inp_wrapped.get().continueInx = genquery_out->continueInx;
             }
-        };
-
-        sqlResult_t *resc_id_result = extract_sql_result(genquery_inp_wrapped.get(), genquery_out_ptr_wrapped.get(), COL_D_RESC_ID);
-        const rodsLong_t resc_id = cast_genquery_result(&resc_id_result->value[0]);
-
-        sqlResult_t *data_mode_result = extract_sql_result(genquery_inp_wrapped.get(), genquery_out_ptr_wrapped.get(), COL_DATA_MODE);
-        const int data_mode = cast_genquery_result(&data_mode_result->value[0]);
-
-        ReplicationSourceInfo ret;
-        ret.object_path = (boost::format("%s%s%s") % coll_name % irods::get_virtual_path_separator() % data_name).str();
-        irods::error err = resc_mgr.leaf_id_to_hier(resc_id, ret.resource_hierarchy);
-        if (!err.ok()) {
-            THROW(err.code(),
-                  boost::format("leaf_id_to_hier failed. resc id [%lld] genquery inp:\n%s") %
-                  resc_id %
-                  genquery_inp_to_diagnostic_string(&genquery_inp_wrapped.get()));
         }
-        ret.data_mode = data_mode;
+
         return ret;
     }
 
@@ -300,7 +464,9 @@ namespace {
         const std::string&               _child_resc_name,
         const size_t                     _bun_idx,
         const std::vector<leaf_bundle_t> _bundles,
-        const dist_child_result_t&       _data_ids_to_replicate) {
+        const dist_child_result_t&       _data_ids_to_replicate,
+        const uint32_t                   _thread_count,
+        rebalance_progress&              _progress) {
         if (!_ctx.comm()) {
             THROW(SYS_INVALID_INPUT_PARAM,
                   boost::format("null comm pointer. resource [%s]. child resource [%s]. bundle index [%d]. bundles [%s]") %
@@ -319,11 +485,38 @@ namespace {
                   leaf_bundles_to_string(_bundles));
         }
 
-        //irods::file_object_ptr file_obj{boost::dynamic_pointer_cast<irods::file_object>(_ctx.fco())};
+        // resolve the target child resource plugin
+        irods::resource_ptr dst_resc;
+        const irods::error err_resolve = resc_mgr.resolve(_child_resc_name, dst_resc);
+        if (!err_resolve.ok()) {
+            THROW(err_resolve.code(), boost::format("failed to resolve resource plugin. child resc [%s] parent resc [%s] bundle index [%d] bundles [%s]. resolve message [%s]") %
+                  _child_resc_name %
+                  _parent_resc_name %
+                  _bun_idx %
+                  leaf_bundles_to_string(_bundles) %
+                  err_resolve.result());
+        }
+
+        const std::vector<rodsLong_t> data_ids(_data_ids_to_replicate.begin(), _data_ids_to_replicate.end());
+        const auto source_infos = get_source_data_object_attributes(_ctx.comm(), data_ids, _bundles);
+
+        std::vector<rebalance_replication> replications;
+        replications.reserve(data_ids.size());
 
         irods::error first_rebalance_error = SUCCESS();
-        for (auto data_id_to_replicate : _data_ids_to_replicate) {
-            const ReplicationSourceInfo source_info = get_source_data_object_attributes(_ctx.comm(), data_id_to_replicate, _bundles);
+        for (auto data_id_to_replicate : data_ids) {
+            const auto source_info_it = source_infos.find(data_id_to_replicate);
+            if (source_infos.end() == source_info_it) {
+                const irods::error err = ERROR(CAT_NO_ROWS_FOUND, boost::format("no good replica to replicate from for data id [%lld] in bundles [%s]") %
+                                               data_id_to_replicate %
+                                               leaf_bundles_to_string(_bundles));
+                if (first_rebalance_error.ok()) {
+                    first_rebalance_error = err;
+                }
+                irods::log(err);
+                continue;
+            }
+            const ReplicationSourceInfo& source_info = source_info_it->second;
 
             // create a file object so we can resolve a valid hierarchy to which to replicate
             irods::file_object_ptr f_ptr(new irods::file_object(_ctx.comm(), source_info.object_path, "", "", 0, source_info.data_mode, 0));
@@ -340,19 +533,6 @@ namespace {
             std::string src_frag = irods::hierarchy_parser{source_info.resource_hierarchy}.str(_parent_resc_name);
             irods::hierarchy_parser parser{src_frag};
 
-            // resolve the target child resource plugin
-            irods::resource_ptr dst_resc;
-            const irods::error err_resolve = resc_mgr.resolve(_child_resc_name, dst_resc);
-            if (!err_resolve.ok()) {
-                THROW(err_resolve.code(), boost::format("failed to resolve resource plugin. child resc [%s] parent resc [%s] bundle index [%d] bundles [%s] data id [%lld]. resolve message [%s]") %
-                      _child_resc_name %
-                      _parent_resc_name %
-                      _bun_idx %
-                      leaf_bundles_to_string(_bundles) %
-                      data_id_to_replicate %
-                      err_resolve.result());
-            }
-
             // then we need to query the target resource and ask it to determine a dest resc hier for the repl
             std::string host_name{};
             float vote = 0.0;
@@ -378,27 +558,36 @@ namespace {
             const std::string dst_hier = parser.str();
             rodsLog(LOG_NOTICE, "%s: creating new replica for data id [%lld] from [%s] on [%s]", __FUNCTION__, data_id_to_replicate, source_info.resource_hierarchy.c_str(), dst_hier.c_str());
 
-            const irods::error err_rebalance = repl_for_rebalance(
-                _ctx,
+            replications.push_back({
+                data_id_to_replicate,
                 source_info.object_path,
-                _parent_resc_name,
                 source_info.resource_hierarchy,
                 dst_hier,
                 root_resc,
-                root_resc,
-                source_info.data_mode);
-            if (!err_rebalance.ok()) {
-                if (first_rebalance_error.ok()) {
-                    first_rebalance_error = err_rebalance;
-                }
-                rodsLog(LOG_ERROR, "%s: repl_for_rebalance failed. object path [%s] parent resc [%s] source hier [%s] dest hier [%s] root resc [%s] data mode [%d]",
-                        __FUNCTION__, source_info.object_path.c_str(), _parent_resc_name.c_str(), source_info.resource_hierarchy.c_str(), dst_hier.c_str(), root_resc.c_str(), source_info.data_mode);
-                irods::log(PASS(err_rebalance));
-                if (_ctx.comm()->rError.len < MAX_ERROR_MESSAGES) {
-                    addRErrorMsg(&_ctx.comm()->rError, err_rebalance.code(), err_rebalance.result().c_str());
-                }
+                source_info.data_mode,
+                source_info.data_size});
+        }
+
+        const auto results = replicate_for_rebalance(_ctx, _parent_resc_name, replications, _thread_count);
+        for (std::size_t i = 0; i < replications.size(); ++i) {
+            const auto& r = replications[i];
+            const irods::error& err_rebalance = results[i];
+            if (err_rebalance.ok()) {
+                _progress.add(1, r.data_size);
+                continue;
+            }
+
+            if (first_rebalance_error.ok()) {
+                first_rebalance_error = err_rebalance;
+            }
+            rodsLog(LOG_ERROR, "%s: repl_for_rebalance failed. object path [%s] parent resc [%s] source hier [%s] dest hier [%s] root resc [%s] data mode [%d]",
+                    __FUNCTION__, r.object_path.c_str(), _parent_resc_name.c_str(), r.source_hierarchy.c_str(), r.destination_hierarchy.c_str(), r.root_resource.c_str(), r.data_mode);
+            irods::log(PASS(err_rebalance));
+            if (_ctx.comm()->rError.len < MAX_ERROR_MESSAGES) {
+                addRErrorMsg(&_ctx.comm()->rError, err_rebalance.code(), err_rebalance.result().c_str());
             }
         }
+        _progress.log();
 
         if (!first_rebalance_error.ok()) {
             THROW(first_rebalance_error.code(),
@@ -409,23 +598,126 @@ namespace {
                   first_rebalance_error.result());
         }
     }
+
+    const std::string REBALANCE_CHECKPOINT_ATTR{"rebalance_checkpoint"};
+
+    int modify_rebalance_checkpoint_avu(
+        rsComm_t*          _comm,
+        const std::string& _operation,
+        const std::string& _resource_name,
+        const std::string& _value,
+        const std::string& _units) {
+        modAVUMetadataInp_t mod_avu_inp{};
+        mod_avu_inp.arg0 = const_cast<char*>(_operation.c_str());
+        mod_avu_inp.arg1 = const_cast<char*>("-R");
+        mod_avu_inp.arg2 = const_cast<char*>(_resource_name.c_str());
+        mod_avu_inp.arg3 = const_cast<char*>(REBALANCE_CHECKPOINT_ATTR.c_str());
+        mod_avu_inp.arg4 = const_cast<char*>(_value.c_str());
+        mod_avu_inp.arg5 = const_cast<char*>(_units.c_str());
+        return rsModAVUMetadata(_comm, &mod_avu_inp);
+    }
 }
 
 namespace irods {
+    // throws irods::exception
+    std::optional<rebalance_checkpoint> get_rebalance_checkpoint(
+        rsComm_t* _comm,
+        const std::string& _resource_name) {
+        irods::GenQueryInpWrapper genquery_inp_wrapped;
+        genquery_inp_wrapped.get().maxRows = 1;
+        addInxVal(&genquery_inp_wrapped.get().sqlCondInp, COL_R_RESC_NAME, (boost::format("= '%s'") % _resource_name).str().c_str());
+        addInxVal(&genquery_inp_wrapped.get().sqlCondInp, COL_META_RESC_ATTR_NAME, (boost::format("= '%s'") % REBALANCE_CHECKPOINT_ATTR).str().c_str());
+        addInxIval(&genquery_inp_wrapped.get().selectInp, COL_META_RESC_ATTR_VALUE, 1);
+        addInxIval(&genquery_inp_wrapped.get().selectInp, COL_META_RESC_ATTR_UNITS, 1);
+
+        irods::GenQueryOutPtrWrapper genquery_out_ptr_wrapped;
+        const int status_rsGenQuery = rsGenQuery(_comm, &genquery_inp_wrapped.get(), &genquery_out_ptr_wrapped.get());
+        if (CAT_NO_ROWS_FOUND == status_rsGenQuery) {
+            return std::nullopt;
+        }
+        else if (status_rsGenQuery < 0 || !genquery_out_ptr_wrapped.get()) {
+            THROW(
+                status_rsGenQuery < 0 ? status_rsGenQuery : SYS_INTERNAL_NULL_INPUT_ERR,
+                boost::format("rsGenQuery failed. genquery_inp contents:\n%s\npossible iquest [%s]") %
+                genquery_inp_to_diagnostic_string(&genquery_inp_wrapped.get()) %
+                genquery_inp_to_iquest_string(&genquery_inp_wrapped.get()));
+        }
+
+        // the value is "<phase>:<bundle index>" and the units are the invocation timestamp
+        const std::string value = &extract_sql_result(genquery_inp_wrapped.get(), genquery_out_ptr_wrapped.get(), COL_META_RESC_ATTR_VALUE)->value[0];
+        const std::string units = &extract_sql_result(genquery_inp_wrapped.get(), genquery_out_ptr_wrapped.get(), COL_META_RESC_ATTR_UNITS)->value[0];
+
+        const auto colon = value.rfind(':');
+        if (std::string::npos == colon || units.empty()) {
+            rodsLog(LOG_ERROR, "%s: ignoring malformed rebalance checkpoint [%s] [%s] on resource [%s]",
+                    __FUNCTION__, value.c_str(), units.c_str(), _resource_name.c_str());
+            return std::nullopt;
+        }
+
+        try {
+            return rebalance_checkpoint{units, value.substr(0, colon), boost::lexical_cast<std::size_t>(value.substr(colon + 1))};
+        }
+        catch (const boost::bad_lexical_cast&) {
+            rodsLog(LOG_ERROR, "%s: ignoring malformed rebalance checkpoint [%s] [%s] on resource [%s]",
+                    __FUNCTION__, value.c_str(), units.c_str(), _resource_name.c_str());
+            return std::nullopt;
+        }
+    }
+
+    // throws irods::exception
+    void set_rebalance_checkpoint(
+        rsComm_t* _comm,
+        const std::string& _resource_name,
+        const rebalance_checkpoint& _checkpoint) {
+        const std::string value = _checkpoint.phase + ":" + std::to_string(_checkpoint.bundle_index);
+        const int status = modify_rebalance_checkpoint_avu(_comm, "set", _resource_name, value, _checkpoint.invocation_timestamp);
+        if (status < 0) {
+            THROW(status, boost::format("failed to set rebalance checkpoint [%s] on resource [%s]") % value % _resource_name);
+        }
+    }
+
+    // throws irods::exception
+    void remove_rebalance_checkpoint(
+        rsComm_t* _comm,
+        const std::string& _resource_name) {
+        const int status = modify_rebalance_checkpoint_avu(_comm, "rmw", _resource_name, "%", "%");
+        if (status < 0 && CAT_SUCCESS_BUT_WITH_NO_INFO != status) {
+            THROW(status, boost::format("failed to remove rebalance checkpoint from resource [%s]") % _resource_name);
+        }
+    }
+
     // throws irods::exception
     void update_out_of_date_replicas(
         irods::plugin_context& _ctx,
         const std::vector<leaf_bundle_t>& _leaf_bundles,
         const int _batch_size,
+        const uint32_t _thread_count,
+        const size_t _first_bundle_index,
         const std::string& _invocation_timestamp,
         const std::string& _resource_name) {
 
+        // keep the bundles finished by an earlier, interrupted rebalance in the checkpoint
+        set_rebalance_checkpoint(_ctx.comm(), _resource_name, {_invocation_timestamp, REBALANCE_PHASE_UPDATE, _first_bundle_index});
+        rebalance_progress progress{REBALANCE_PHASE_UPDATE, _resource_name};
+
         while (true) {
             const std::vector<ReplicaAndRescId> replicas_to_update = get_out_of_date_replicas_batch(_ctx.comm(), _leaf_bundles, _invocation_timestamp, _batch_size);
             if (replicas_to_update.empty()) {
                 break;
             }
 
+            std::vector<rodsLong_t> data_ids;
+            data_ids.reserve(replicas_to_update.size());
+            for (const auto& replica_to_update : replicas_to_update) {
+                data_ids.push_back(replica_to_update.data_id);
+            }
+            const auto source_infos = get_source_data_object_attributes(_ctx.comm(), data_ids, _leaf_bundles);
+
+            std::vector<rebalance_replication> replications;
+            replications.reserve(replicas_to_update.size());
+            std::vector<rodsLong_t> replica_numbers;
+            replica_numbers.reserve(replicas_to_update.size());
+
             error first_error = SUCCESS();
             for (const auto& replica_to_update : replicas_to_update) {
                 std::string destination_hierarchy;
@@ -438,7 +730,19 @@ namespace irods {
                           replica_to_update.resource_id);
                 }
 
-                ReplicationSourceInfo source_info = get_source_data_object_attributes(_ctx.comm(), replica_to_update.data_id, _leaf_bundles);
+                const auto source_info_it = source_infos.find(replica_to_update.data_id);
+                if (source_infos.end() == source_info_it) {
+                    const error err = ERROR(CAT_NO_ROWS_FOUND, boost::format("no good replica to update from for data id [%lld] in bundles [%s]") %
+                                            replica_to_update.data_id %
+                                            leaf_bundles_to_string(_leaf_bundles));
+                    if (first_error.ok()) {
+                        first_error = err;
+                    }
+                    irods::log(err);
+                    continue;
+                }
+                const ReplicationSourceInfo& source_info = source_info_it->second;
+
                 hierarchy_parser hierarchy_parser;
                 const error err_parser = hierarchy_parser.set_string(source_info.resource_hierarchy);
                 if (!err_parser.ok()) {
@@ -462,30 +766,41 @@ namespace irods {
                         static_cast<intmax_t>(replica_to_update.data_id),
                         source_info.resource_hierarchy.c_str(),
                         destination_hierarchy.c_str());
-                const error err_repl = repl_for_rebalance(
-                    _ctx,
+
+                replications.push_back({
+                    replica_to_update.data_id,
                     source_info.object_path,
-                    _resource_name,
                     source_info.resource_hierarchy,
                     destination_hierarchy,
                     root_resc,
-                    root_resc,
-                    source_info.data_mode);
+                    source_info.data_mode,
+                    source_info.data_size});
+                replica_numbers.push_back(replica_to_update.replica_number);
+            }
 
-                if (!err_repl.ok()) {
-                    if (first_error.ok()) {
-                        first_error = err_repl;
-                    }
-                    const error error_to_log = PASS(err_repl);
-                    if (_ctx.comm()->rError.len < MAX_ERROR_MESSAGES) {
-                        addRErrorMsg(&_ctx.comm()->rError, error_to_log.code(), error_to_log.result().c_str());
-                    }
-                    rodsLog(LOG_ERROR,
-                            "update_out_of_date_replicas: repl_for_rebalance failed with code [%ji] and message [%s]. object [%s] source hierarchy [%s] data id [%ji] destination repl num [%ji] destination hierarchy [%s]",
-                            static_cast<intmax_t>(err_repl.code()), err_repl.result().c_str(), source_info.object_path.c_str(), source_info.resource_hierarchy.c_str(),
-                            static_cast<intmax_t>(replica_to_update.data_id), static_cast<intmax_t>(replica_to_update.replica_number), destination_hierarchy.c_str());
+            const auto results = replicate_for_rebalance(_ctx, _resource_name, replications, _thread_count);
+            for (std::size_t i = 0; i < replications.size(); ++i) {
+                const auto& r = replications[i];
+                const error& err_repl = results[i];
+                if (err_repl.ok()) {
+                    progress.add(1, r.data_size);
+                    continue;
+                }
+
+                if (first_error.ok()) {
+                    first_error = err_repl;
                 }
+                const error error_to_log = PASS(err_repl);
+                if (_ctx.comm()->rError.len < MAX_ERROR_MESSAGES) {
+                    addRErrorMsg(&_ctx.comm()->rError, error_to_log.code(), error_to_log.result().c_str());
+                }
+                rodsLog(LOG_ERROR,
+                        "update_out_of_date_replicas: repl_for_rebalance failed with code [%ji] and message [%s]. object [%s] source hierarchy [%s] data id [%ji] destination repl num [%ji] destination hierarchy [%s]",
+                        static_cast<intmax_t>(err_repl.code()), err_repl.result().c_str(), r.object_path.c_str(), r.source_hierarchy.c_str(),
+                        static_cast<intmax_t>(r.data_id), static_cast<intmax_t>(replica_numbers[i]), r.destination_hierarchy.c_str());
             }
+            progress.log();
+
             if (!first_error.ok()) {
                 THROW(first_error.code(), first_error.result());
             }
@@ -497,9 +812,19 @@ namespace irods {
         irods::plugin_context& _ctx,
         const std::vector<leaf_bundle_t>& _leaf_bundles,
         const int _batch_size,
+        const uint32_t _thread_count,
+        const size_t _first_bundle_index,
         const std::string& _invocation_timestamp,
         const std::string& _resource_name) {
-        for (size_t i=0; i<_leaf_bundles.size(); ++i) {
+        rebalance_progress progress{REBALANCE_PHASE_CREATE, _resource_name};
+
+        // start with the bundle an interrupted rebalance was working on, then wrap around to
+        // re-check the bundles it had finished. those only return objects which changed since.
+        const size_t first_bundle_index = _leaf_bundles.empty() ? 0 : _first_bundle_index % _leaf_bundles.size();
+        for (size_t n=0; n<_leaf_bundles.size(); ++n) {
+            const size_t i = (first_bundle_index + n) % _leaf_bundles.size();
+            set_rebalance_checkpoint(_ctx.comm(), _resource_name, {_invocation_timestamp, REBALANCE_PHASE_CREATE, i});
+
             const std::string child_name = get_child_name_that_is_ancestor_of_bundle(_resource_name, _leaf_bundles[i]);
             while (true) {
                 dist_child_result_t data_ids_needing_new_replicas;
@@ -515,7 +840,7 @@ namespace irods {
                     break;
                 }
 
-                proc_results_for_rebalance(_ctx, _resource_name, child_name, i, _leaf_bundles, data_ids_needing_new_replicas);
+                proc_results_for_rebalance(_ctx, _resource_name, child_name, i, _leaf_bundles, data_ids_needing_new_replicas, _thread_count, progress);
             }
         }
     }
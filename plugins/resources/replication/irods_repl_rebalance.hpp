@@ -5,6 +5,8 @@
 #include "irods_resource_manager.hpp"
 #include "icatHighLevelRoutines.hpp"
 
+#include <cstdint>
+#include <optional>
 #include <vector>
 #include <string>
 #include <utility>
@@ -12,11 +14,51 @@
 namespace irods {
     using leaf_bundle_t = resource_manager::leaf_bundle_t;
 
+    // Number of replications whose data is moved at the same time during a rebalance.
+    // Up to four times as many replications are open at once, two l1 descriptors each,
+    // so the setting is clamped to keep those well within the agent's descriptor table.
+    const std::string REBALANCE_THREADS_KW{ "rebalance_threads" };
+    const uint32_t DEFAULT_REBALANCE_THREADS{ 1 };
+    const uint32_t MAX_REBALANCE_THREADS{ 32 };
+
+    const std::string REBALANCE_PHASE_UPDATE{ "update_out_of_date_replicas" };
+    const std::string REBALANCE_PHASE_CREATE{ "create_missing_replicas" };
+
+    // Progress of a rebalance, kept on the replication resource until the rebalance completes
+    // so that an interrupted rebalance resumes with the leaf bundle it was working on.
+    // The bundle index is the bundle the create phase was working on, in either phase.
+    // A resumed rebalance still re-checks the bundles before it afterwards, because objects
+    // in them may have been created or trimmed since the interruption.
+    // The invocation timestamp is informational; a resumed rebalance queries with its own.
+    struct rebalance_checkpoint {
+        std::string invocation_timestamp;
+        std::string phase;
+        size_t bundle_index;
+    };
+
+    // throws irods::exception
+    std::optional<rebalance_checkpoint> get_rebalance_checkpoint(
+        rsComm_t* _comm,
+        const std::string& _resource_name);
+
+    // throws irods::exception
+    void set_rebalance_checkpoint(
+        rsComm_t* _comm,
+        const std::string& _resource_name,
+        const rebalance_checkpoint& _checkpoint);
+
+    // throws irods::exception
+    void remove_rebalance_checkpoint(
+        rsComm_t* _comm,
+        const std::string& _resource_name);
+
     // throws irods::exception
     void update_out_of_date_replicas(
         irods::plugin_context& _ctx,
         const std::vector<leaf_bundle_t>& _leaf_bundles,
         const int _batch_size,
+        const uint32_t _thread_count,
+        const size_t _first_bundle_index,
         const std::string& _invocation_timestamp,
         const std::string& resource_name);
 
@@ -25,6 +67,8 @@ namespace irods {
         irods::plugin_context& _ctx,
         const std::vector<leaf_bundle_t>& _leaf_bundles,
         const int _batch_size,
+        const uint32_t _thread_count,
+        const size_t _first_bundle_index,
         const std::string& _invocation_timestamp,
         const std::string& resource_name);
 }
@@ -40,6 +40,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <limits>
 #include <boost/lexical_cast.hpp>
 
 // =-=-=-=-=-=-=-
@@ -1533,11 +1534,29 @@ irods::error repl_file_rebalance(
         return PASS(result);
     }
 
+    auto thread_count = irods::DEFAULT_REBALANCE_THREADS;
+    _ctx.prop_map().get<decltype(thread_count)>(irods::REBALANCE_THREADS_KW, thread_count);
+
     try {
         const int batch_size = get_rebalance_batch_size(_ctx);
         const std::vector<leaf_bundle_t> leaf_bundles = resc_mgr.gather_leaf_bundles_for_resc(resource_name);
-        irods::update_out_of_date_replicas(_ctx, leaf_bundles, batch_size, invocation_timestamp, resource_name);
-        irods::create_missing_replicas(_ctx, leaf_bundles, batch_size, invocation_timestamp, resource_name);
+
+        // resume an interrupted rebalance with the leaf bundle it was working on. the
+        // queries still use this invocation's timestamp, and the bundles before it are
+        // re-checked at the end, so that replicas which went stale, or objects which
+        // were created, since the interruption are included. out-of-date replicas are
+        // always updated, as that phase has no bundle order.
+        size_t first_bundle_index = 0;
+        if (const auto checkpoint = irods::get_rebalance_checkpoint(_ctx.comm(), resource_name); checkpoint) {
+            rodsLog(LOG_NOTICE, "%s: resuming rebalance of [%s] from [%s] bundle index [%zu] invoked at [%s]",
+                    __FUNCTION__, resource_name.c_str(), checkpoint->phase.c_str(), checkpoint->bundle_index,
+                    checkpoint->invocation_timestamp.c_str());
+            first_bundle_index = checkpoint->bundle_index;
+        }
+
+        irods::update_out_of_date_replicas(_ctx, leaf_bundles, batch_size, thread_count, first_bundle_index, invocation_timestamp, resource_name);
+        irods::create_missing_replicas(_ctx, leaf_bundles, batch_size, thread_count, first_bundle_index, invocation_timestamp, resource_name);
+        irods::remove_rebalance_checkpoint(_ctx.comm(), resource_name);
     } catch (const irods::exception& e) {
         return irods::error(e);
     }
@@ -1601,6 +1620,9 @@ class repl_resource : public irods::resource {
                     properties_.set< decltype( irods::DEFAULT_RETRY_ATTEMPTS ) >( irods::RETRY_ATTEMPTS_KW, irods::DEFAULT_RETRY_ATTEMPTS );
                     properties_.set< decltype( irods::DEFAULT_RETRY_FIRST_DELAY_IN_SECONDS ) >( irods::RETRY_FIRST_DELAY_IN_SECONDS_KW, irods::DEFAULT_RETRY_FIRST_DELAY_IN_SECONDS );
                     properties_.set< decltype( irods::DEFAULT_RETRY_BACKOFF_MULTIPLIER ) >( irods::RETRY_BACKOFF_MULTIPLIER_KW, irods::DEFAULT_RETRY_BACKOFF_MULTIPLIER );
+                    properties_.set< decltype( irods::DEFAULT_FAN_OUT_THREADS ) >( irods::FAN_OUT_THREADS_KW, irods::DEFAULT_FAN_OUT_THREADS );
+                    properties_.set< decltype( irods::DEFAULT_MINIMUM_GOOD_REPLICAS ) >( irods::MINIMUM_GOOD_REPLICAS_KW, irods::DEFAULT_MINIMUM_GOOD_REPLICAS );
+                    properties_.set< decltype( irods::DEFAULT_REBALANCE_THREADS ) >( irods::REBALANCE_THREADS_KW, irods::DEFAULT_REBALANCE_THREADS );
                     return;
                 }
 
@@ -1700,6 +1722,56 @@ class repl_resource : public irods::resource {
                 }
                 properties_.set< decltype( backoff_multiplier ) >( irods::RETRY_BACKOFF_MULTIPLIER_KW, backoff_multiplier );
 
+                // thread counts must be at least 1; minimum_good_replicas may be 0.
+                // values above _maximum are clamped to it.
+                const auto set_count_property = [&]( const std::string& _key, const uint32_t _default, const int _minimum,
+                                                     const int _maximum = std::numeric_limits< int >::max() ) {
+                    auto value = _default;
+                    if ( kvp_map.find( _key ) != kvp_map.end() ) {
+                        try {
+                            const int int_value = boost::lexical_cast< int >( kvp_map[ _key ] );
+                            if ( int_value < _minimum ) {
+                                irods::log( ERROR( SYS_INVALID_INPUT_PARAM,
+                                               boost::format(
+                                               "[%s] - [%s] for resource [%s] is < %d; using default value [%d]" ) %
+                                               __FUNCTION__ %
+                                               _key %
+                                               _inst_name %
+                                               _minimum %
+                                               _default ) );
+                            }
+                            else if ( int_value > _maximum ) {
+                                irods::log( ERROR( SYS_INVALID_INPUT_PARAM,
+                                               boost::format(
+                                               "[%s] - [%s] for resource [%s] is > %d; using [%d]" ) %
+                                               __FUNCTION__ %
+                                               _key %
+                                               _inst_name %
+                                               _maximum %
+                                               _maximum ) );
+                                value = static_cast< decltype( value ) >( _maximum );
+                            }
+                            else {
+                                value = static_cast< decltype( value ) >( int_value );
+                            }
+                        }
+                        catch ( const boost::bad_lexical_cast& ) {
+                            irods::log( ERROR( SYS_INVALID_INPUT_PARAM,
+                                            boost::format(
+                                            "[%s] - failed to cast [%s] for resource [%s] to value [%s]; using default value [%d]") %
+                                            __FUNCTION__ %
+                                            _key %
+                                            _inst_name %
+                                            kvp_map[ _key ] %
+                                            _default ) );
+                        }
+                    }
+                    properties_.set< decltype( value ) >( _key, value );
+                };
+                set_count_property( irods::FAN_OUT_THREADS_KW, irods::DEFAULT_FAN_OUT_THREADS, 1 );
+                set_count_property( irods::MINIMUM_GOOD_REPLICAS_KW, irods::DEFAULT_MINIMUM_GOOD_REPLICAS, 0 );
+                set_count_property( irods::REBALANCE_THREADS_KW, irods::DEFAULT_REBALANCE_THREADS, 1, irods::MAX_REBALANCE_THREADS );
+
                 if ( kvp_map.find( READ_KW ) != kvp_map.end() ) {
                     properties_.set< std::string >( READ_KW, kvp_map[ READ_KW ] );
                 }
@@ -7,6 +7,7 @@
 #include "irods_resource_manager.hpp"
 #include "irods_hierarchy_parser.hpp"
 #include "irods_resource_backport.hpp"
+#include "irods_kvp_string_parser.hpp"
 #include "apiHeaderAll.h"
 #include "rsFileOpen.hpp"
 #include "rsFileStat.hpp"
@@ -33,6 +34,14 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <map>
+#include <list>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 // =-=-=-=-=-=-=-
 // boost includes
@@ -62,6 +71,12 @@ typedef struct tarSubFileDesc {
     int fd;                         /* the fd of the opened cached subFile */
     char cacheFilePath[MAX_NAME_LEN];   /* the phy path name of the cached
                                          * subFile */
+    int indexed;                    /* read directly from the archive, fd is
+                                     * the fd of the archive or -1 if the
+                                     * member is buffered */
+    rodsLong_t dataOffset;          /* offset of the member in the archive */
+    rodsLong_t dataSize;            /* size of the member */
+    rodsLong_t position;            /* read position within the member */
 } tarSubFileDesc_t;
 
 #define NUM_TAR_SUB_FILE_DESC 20
@@ -88,6 +103,53 @@ const int NUM_STRUCT_FILE_DESC = 16;
 structFileDesc_t PluginStructFileDesc[ NUM_STRUCT_FILE_DESC  ];
 tarSubFileDesc_t PluginTarSubFileDesc[ NUM_TAR_SUB_FILE_DESC ];
 
+// =-=-=-=-=-=-=-
+// members of tar files which have not been staged to a cache directory are
+// read straight out of the archive using an index of the members, which is
+// built on first use.  uncompressed tar files are read by byte range, members
+// of compressed archives are decompressed into a small lru cache.
+struct tar_member_t {
+    rodsLong_t offset; // offset of the data in the archive, -1 if compressed
+    rodsLong_t size;
+    rodsLong_t mtime;
+    int        mode;
+    bool       is_dir;
+};
+
+struct tar_index_t {
+    rodsLong_t                          archive_size;
+    rodsLong_t                          archive_mtime;
+    bool                                compressed;
+    std::map<std::string, tar_member_t> members;
+};
+
+const int         TAR_BLOCK_SIZE             = 512;
+const std::string TAR_INDEX_FILE_SUFFIX( ".irods_index" );
+const std::string TAR_INDEX_FILE_MAGIC( "irods_tar_index_1" );
+const std::size_t TAR_MEMBER_CACHE_MAX_BYTES = 64 * 1024 * 1024;
+
+std::map<std::string, std::shared_ptr<const tar_index_t>> PluginTarIndexCache;
+std::list<std::pair<std::string, std::shared_ptr<const std::string>>> PluginTarMemberCache; // most recently used first
+std::shared_ptr<const std::string> PluginTarSubFileBuffer[ NUM_TAR_SUB_FILE_DESC ];
+
+void close_tar_archive_reader();
+
+// =-=-=-=-=-=-=-
+// context string settings of the resource holding the archive, used when
+// writing the cache dir back to it.  with more than one reader thread,
+// member files are read into memory ahead of the single thread which
+// writes the archive in order
+const std::string BUNDLE_READER_THREADS_KW( "bundle_reader_threads" );
+const std::string BUNDLE_COMPRESSION_LEVEL_KW( "bundle_compression_level" );
+
+const std::size_t BUNDLE_MEMBER_MAX_STAGED_BYTES = 4 * 1024 * 1024;
+const std::size_t BUNDLE_MAX_STAGED_BYTES        = 64 * 1024 * 1024;
+
+struct bundle_options_t {
+    int reader_threads;
+    int compression_level; // -1 for the libarchive default
+};
+
 // =-=-=-=-=-=-=-=-
 // manager of resource plugins which are resolved and cached
 extern irods::resource_manager resc_mgr;
@@ -106,6 +168,12 @@ irods::error tarfilesystem_resource_start( irods::plugin_property_map& ) {
 // stop operation used to free the FileDesc tables
 // must be C linkage for delay_load
 irods::error tarfilesystem_resource_stop( irods::plugin_property_map& ) {
+    for ( auto& buffer : PluginTarSubFileBuffer ) {
+        buffer.reset();
+    }
+    close_tar_archive_reader();
+    PluginTarMemberCache.clear();
+    PluginTarIndexCache.clear();
     memset( PluginStructFileDesc, 0, sizeof( structFileDesc_t ) * NUM_STRUCT_FILE_DESC );
     memset( PluginTarSubFileDesc, 0, sizeof( tarSubFileDesc_t ) * NUM_TAR_SUB_FILE_DESC );
     return SUCCESS();
@@ -571,6 +639,732 @@ irods::error stage_tar_struct_file( int _index, std::string _host ) {
 
 } // stage_tar_struct_file
 
+// =-=-=-=-=-=-=-
+// strip leading "./" and "/" and trailing "/" from a member name
+std::string normalize_member_path( std::string _path ) {
+    while ( _path.compare( 0, 2, "./" ) == 0 || _path.compare( 0, 1, "/" ) == 0 ) {
+        _path.erase( 0, _path[ 0 ] == '.' ? 2 : 1 );
+    }
+
+    while ( !_path.empty() && _path.back() == '/' ) {
+        _path.pop_back();
+    }
+
+    return _path == "." ? std::string{} : _path;
+
+} // normalize_member_path
+
+// =-=-=-=-=-=-=-
+// path of a sub file relative to the root of the tar file
+std::string compose_member_path(
+    specColl_t*        _spec_coll,
+    const std::string& _sub_file_path ) {
+    const std::size_t len = strlen( _spec_coll->collection );
+    if ( _sub_file_path.compare( 0, len, _spec_coll->collection ) != 0 ) {
+        return {};
+    }
+
+    return normalize_member_path( _sub_file_path.substr( len ) );
+
+} // compose_member_path
+
+// =-=-=-=-=-=-=-
+// decode a numeric tar header field, either octal or gnu base-256
+rodsLong_t parse_tar_number( const char* _field, std::size_t _len ) {
+    rodsLong_t value = 0;
+    if ( static_cast< unsigned char >( _field[ 0 ] ) & 0x80 ) {
+        for ( std::size_t i = 1; i < _len; ++i ) {
+            value = ( value << 8 ) | static_cast< unsigned char >( _field[ i ] );
+        }
+        return value;
+    }
+
+    for ( std::size_t i = 0; i < _len && _field[ i ] != '\0'; ++i ) {
+        if ( _field[ i ] >= '0' && _field[ i ] <= '7' ) {
+            value = ( value << 3 ) | ( _field[ i ] - '0' );
+        }
+    }
+
+    return value;
+
+} // parse_tar_number
+
+// =-=-=-=-=-=-=-
+// read _len bytes at _offset of an open archive
+int read_archive_at(
+    rsComm_t*  _comm,
+    int        _fd,
+    rodsLong_t _offset,
+    void*      _buf,
+    int        _len ) {
+    fileLseekInp_t lseek_inp{};
+    lseek_inp.fileInx = _fd;
+    lseek_inp.offset  = _offset;
+    lseek_inp.whence  = SEEK_SET;
+
+    fileLseekOut_t* lseek_out = NULL;
+    int status = rsFileLseek( _comm, &lseek_inp, &lseek_out );
+    free( lseek_out );
+    if ( status < 0 ) {
+        return status;
+    }
+
+    fileReadInp_t read_inp{};
+    read_inp.fileInx = _fd;
+    read_inp.len     = _len;
+
+    bytesBuf_t read_buf{};
+    read_buf.buf = _buf;
+
+    return rsFileRead( _comm, &read_inp, &read_buf );
+
+} // read_archive_at
+
+// =-=-=-=-=-=-=-
+// build a file open structure for the archive of a struct file
+irods::error compose_archive_open_inp(
+    int            _index,
+    fileOpenInp_t& _open_inp ) {
+    specColl_t* spec_coll = PluginStructFileDesc[ _index ].specColl;
+
+    std::string location;
+    irods::error ret = irods::get_loc_for_hier_string( spec_coll->rescHier, location );
+    if ( !ret.ok() ) {
+        return PASSMSG( "compose_archive_open_inp - failed in get_loc_for_hier_string", ret );
+    }
+
+    memset( &_open_inp, 0, sizeof( _open_inp ) );
+    rstrcpy( _open_inp.resc_name_,     spec_coll->resource, MAX_NAME_LEN );
+    rstrcpy( _open_inp.resc_hier_,     spec_coll->rescHier, MAX_NAME_LEN );
+    rstrcpy( _open_inp.objPath,        spec_coll->objPath,  MAX_NAME_LEN );
+    rstrcpy( _open_inp.addr.hostAddr,  location.c_str(),    NAME_LEN );
+    rstrcpy( _open_inp.fileName,       spec_coll->phyPath,  MAX_NAME_LEN );
+    _open_inp.mode  = getDefFileMode();
+    _open_inp.flags = O_RDONLY;
+
+    return SUCCESS();
+
+} // compose_archive_open_inp
+
+// =-=-=-=-=-=-=-
+// record a member and any directories it implies
+void add_tar_member(
+    tar_index_t&        _index,
+    const std::string&  _path,
+    const tar_member_t& _member ) {
+    _index.members[ _path ] = _member;
+
+    std::string parent = _path;
+    while ( !parent.empty() ) {
+        const auto pos = parent.rfind( '/' );
+        parent = ( pos == std::string::npos ) ? std::string{} : parent.substr( 0, pos );
+        if ( _index.members.count( parent ) > 0 ) {
+            break;
+        }
+        _index.members[ parent ] = tar_member_t{ -1, 0, _member.mtime, S_IFDIR | 0755, true };
+    }
+
+} // add_tar_member
+
+// =-=-=-=-=-=-=-
+// walk the headers of an uncompressed tar file, seeking over member data
+irods::error build_plain_tar_index(
+    rsComm_t*    _comm,
+    int          _fd,
+    tar_index_t& _index ) {
+    char        block[ TAR_BLOCK_SIZE ];
+    rodsLong_t  offset = 0;
+    std::string long_name;
+    rodsLong_t  pax_size = -1;
+
+    while ( true ) {
+        int status = read_archive_at( _comm, _fd, offset, block, TAR_BLOCK_SIZE );
+        if ( status < 0 ) {
+            return ERROR( status, "build_plain_tar_index - failed to read header" );
+        }
+
+        if ( status < TAR_BLOCK_SIZE ||
+                std::all_of( block, block + TAR_BLOCK_SIZE, []( char _c ) { return _c == '\0'; } ) ) {
+            break;
+        }
+
+        const rodsLong_t size        = ( pax_size >= 0 ) ? pax_size : parse_tar_number( block + 124, 12 );
+        const rodsLong_t data_offset = offset + TAR_BLOCK_SIZE;
+        const rodsLong_t padded_size = ( parse_tar_number( block + 124, 12 ) + TAR_BLOCK_SIZE - 1 ) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+        const char       type        = block[ 156 ];
+
+        if ( type == 'L' || type == 'x' ) {
+            // =-=-=-=-=-=-=-
+            // gnu long name or pax extended header for the next member
+            std::string data( parse_tar_number( block + 124, 12 ), '\0' );
+            status = read_archive_at( _comm, _fd, data_offset, &data[ 0 ], data.size() );
+            if ( status < static_cast< int >( data.size() ) ) {
+                return ERROR( status < 0 ? status : SYS_STRUCT_FILE_INMOUNTED_COLL, "build_plain_tar_index - failed to read extended header" );
+            }
+
+            if ( type == 'L' ) {
+                long_name = data.c_str();
+            }
+            else {
+                std::size_t pos = 0;
+                while ( pos < data.size() ) {
+                    const std::size_t space = data.find( ' ', pos );
+                    const std::size_t len   = std::strtoul( data.c_str() + pos, NULL, 10 );
+                    if ( space == std::string::npos || len == 0 || pos + len > data.size() ) {
+                        break;
+                    }
+                    const std::string record = data.substr( space + 1, pos + len - space - 2 );
+                    if ( record.compare( 0, 5, "path=" ) == 0 ) {
+                        long_name = record.substr( 5 );
+                    }
+                    else if ( record.compare( 0, 5, "size=" ) == 0 ) {
+                        pax_size = std::strtoll( record.c_str() + 5, NULL, 10 );
+                    }
+                    pos += len;
+                }
+            }
+
+            offset = data_offset + padded_size;
+            continue;
+        }
+
+        if ( type == '0' || type == '\0' || type == '5' ) {
+            std::string name = long_name;
+            if ( name.empty() ) {
+                name.assign( block, strnlen( block, 100 ) );
+                // =-=-=-=-=-=-=-
+                // posix ustar headers split long names into a prefix, gnu
+                // headers use the same bytes for other fields
+                if ( memcmp( block + 257, "ustar\0", 6 ) == 0 && block[ 345 ] != '\0' ) {
+                    name = std::string( block + 345, strnlen( block + 345, 155 ) ) + "/" + name;
+                }
+            }
+
+            tar_member_t member{};
+            member.offset = data_offset;
+            member.size   = ( type == '5' ) ? 0 : size;
+            member.mtime  = parse_tar_number( block + 136, 12 );
+            member.is_dir = ( type == '5' );
+            member.mode   = ( parse_tar_number( block + 100, 8 ) & 07777 ) | ( member.is_dir ? S_IFDIR : S_IFREG );
+            add_tar_member( _index, normalize_member_path( name ), member );
+        }
+
+        // =-=-=-=-=-=-=-
+        // pax sizes override the header, which may be truncated
+        const rodsLong_t skip = ( pax_size >= 0 )
+                                ? ( pax_size + TAR_BLOCK_SIZE - 1 ) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE
+                                : padded_size;
+        offset = data_offset + ( ( type == '5' ) ? 0 : skip );
+        long_name.clear();
+        pax_size = -1;
+    }
+
+    return SUCCESS();
+
+} // build_plain_tar_index
+
+// =-=-=-=-=-=-=-
+// open the archive of a struct file for reading with libarchive.  the
+// callbacks use _cb_ctx, which must outlive _arch
+irods::error open_archive_for_read(
+    specColl_t*      _spec_coll,
+    cb_ctx_t&        _cb_ctx,
+    struct archive*& _arch ) {
+    std::string location;
+    irods::error ret = irods::get_loc_for_hier_string( _spec_coll->rescHier, location );
+    if ( !ret.ok() ) {
+        return PASSMSG( "open_archive_for_read - failed in get_loc_for_hier_string", ret );
+    }
+
+    _arch = archive_read_new();
+    archive_read_support_filter_all( _arch );
+    archive_read_support_format_all( _arch );
+
+    snprintf( _cb_ctx.loc_, sizeof( _cb_ctx.loc_ ), "%s", location.c_str() );
+
+    if ( archive_read_open(
+                _arch,
+                &_cb_ctx,
+                irods_file_open_for_read,
+                irods_file_read,
+                irods_file_close ) != ARCHIVE_OK ) {
+        archive_read_free( _arch );
+        _arch = NULL;
+        free( _cb_ctx.read_buf.buf );
+        _cb_ctx.read_buf.buf = NULL;
+        std::stringstream msg;
+        msg << "open_archive_for_read - failed to open archive [";
+        msg << _spec_coll->phyPath;
+        msg << "]";
+        return ERROR( SYS_STRUCT_FILE_INMOUNTED_COLL, msg.str() );
+    }
+
+    return SUCCESS();
+
+} // open_archive_for_read
+
+// =-=-=-=-=-=-=-
+// iterate over the headers of any archive libarchive understands, calling
+// _func for each entry until it returns false
+irods::error for_each_archive_entry(
+    int                                                         _index,
+    const std::function< bool( struct archive*, struct archive_entry* ) >& _func ) {
+    cb_ctx_t cb_ctx{};
+    cb_ctx.desc_ = &PluginStructFileDesc[ _index ];
+
+    struct archive* arch = NULL;
+    irods::error ret = open_archive_for_read( PluginStructFileDesc[ _index ].specColl, cb_ctx, arch );
+    if ( !ret.ok() ) {
+        return PASS( ret );
+    }
+
+    struct archive_entry* entry;
+    while ( ARCHIVE_OK == archive_read_next_header( arch, &entry ) ) {
+        if ( !_func( arch, entry ) ) {
+            break;
+        }
+    }
+
+    archive_read_free( arch );
+    free( cb_ctx.read_buf.buf );
+
+    return SUCCESS();
+
+} // for_each_archive_entry
+
+// =-=-=-=-=-=-=-
+// a reader left open on the last compressed archive whose members were read
+// in place.  a compressed archive cannot be seeked, so a member which is not
+// in the lru cache is found by continuing the walk from the last member read.
+// the archive is only decompressed again from its start when a member before
+// that point is requested.  the reader keeps its own copy of the struct file
+// descriptor, the callbacks only need its rsComm once the archive is open
+struct tar_archive_reader_t {
+    std::string      key; // resc hier, physical path and mtime of the archive
+    structFileDesc_t desc;
+    cb_ctx_t         cb_ctx;
+    struct archive*  arch;
+};
+
+std::unique_ptr<tar_archive_reader_t> PluginTarArchiveReader;
+
+void close_tar_archive_reader() {
+    if ( !PluginTarArchiveReader ) {
+        return;
+    }
+
+    archive_read_free( PluginTarArchiveReader->arch );
+    free( PluginTarArchiveReader->cb_ctx.read_buf.buf );
+    PluginTarArchiveReader.reset();
+
+} // close_tar_archive_reader
+
+irods::error open_tar_archive_reader(
+    int                _index,
+    const std::string& _key ) {
+    close_tar_archive_reader();
+
+    auto reader = std::make_unique<tar_archive_reader_t>();
+    reader->key          = _key;
+    reader->desc         = PluginStructFileDesc[ _index ];
+    reader->cb_ctx       = cb_ctx_t{};
+    reader->cb_ctx.desc_ = &reader->desc;
+    reader->arch         = NULL;
+
+    irods::error ret = open_archive_for_read( PluginStructFileDesc[ _index ].specColl, reader->cb_ctx, reader->arch );
+    if ( !ret.ok() ) {
+        return PASS( ret );
+    }
+
+    // =-=-=-=-=-=-=-
+    // the spec coll belongs to the struct file descriptor, which may be
+    // freed while the reader is open
+    reader->desc.specColl = NULL;
+    PluginTarArchiveReader = std::move( reader );
+
+    return SUCCESS();
+
+} // open_tar_archive_reader
+
+// =-=-=-=-=-=-=-
+// walk the open reader forward to _member_path and read its data.  returns
+// false if the member is not found before the end of the archive
+bool read_member_from_tar_archive_reader(
+    const std::string&             _member_path,
+    std::shared_ptr<std::string>& _contents ) {
+    struct archive*       arch = PluginTarArchiveReader->arch;
+    struct archive_entry* entry;
+    while ( ARCHIVE_OK == archive_read_next_header( arch, &entry ) ) {
+        if ( normalize_member_path( archive_entry_pathname( entry ) ) != _member_path ) {
+            archive_read_data_skip( arch );
+            continue;
+        }
+
+        std::string data( archive_entry_size( entry ), '\0' );
+        std::size_t total = 0;
+        while ( total < data.size() ) {
+            const la_ssize_t n = archive_read_data( arch, &data[ total ], data.size() - total );
+            if ( n <= 0 ) {
+                break;
+            }
+            total += n;
+        }
+
+        if ( total == data.size() ) {
+            _contents = std::make_shared<std::string>( std::move( data ) );
+        }
+
+        return true;
+    }
+
+    return false;
+
+} // read_member_from_tar_archive_reader
+
+// =-=-=-=-=-=-=-
+// the member index of a bundle is also written to a file next to the archive
+// on the resource holding it, so that agents other than the one which wrote
+// the bundle need not scan it.  the file records the size and mtime of the
+// archive it describes and is ignored once the archive changes.  each member
+// is a line of offset, size, mtime, mode, directory flag, path length and path
+std::string serialize_tar_index( const tar_index_t& _tar_index ) {
+    std::stringstream out;
+    out << TAR_INDEX_FILE_MAGIC << ' '
+        << _tar_index.archive_size << ' '
+        << _tar_index.archive_mtime << ' '
+        << _tar_index.compressed << '\n';
+
+    for ( const auto& entry : _tar_index.members ) {
+        const tar_member_t& member = entry.second;
+        out << member.offset << ' '
+            << member.size << ' '
+            << member.mtime << ' '
+            << member.mode << ' '
+            << member.is_dir << ' '
+            << entry.first.size() << ' '
+            << entry.first << '\n';
+    }
+
+    return out.str();
+
+} // serialize_tar_index
+
+bool parse_tar_index(
+    const std::string& _data,
+    tar_index_t&       _tar_index ) {
+    std::istringstream in( _data );
+
+    std::string magic;
+    if ( !( in >> magic >> _tar_index.archive_size >> _tar_index.archive_mtime >> _tar_index.compressed ) ||
+            magic != TAR_INDEX_FILE_MAGIC ) {
+        return false;
+    }
+
+    tar_member_t member{};
+    std::size_t  path_len = 0;
+    while ( in >> member.offset >> member.size >> member.mtime >> member.mode >> member.is_dir >> path_len ) {
+        std::string path( path_len, '\0' );
+        if ( in.get() != ' ' || !in.read( &path[ 0 ], path_len ) ) {
+            return false;
+        }
+        _tar_index.members[ path ] = member;
+    }
+
+    return in.eof();
+
+} // parse_tar_index
+
+// =-=-=-=-=-=-=-
+// build a file open structure for the index file of a struct file
+irods::error compose_tar_index_file_open_inp(
+    int            _index,
+    int            _flags,
+    fileOpenInp_t& _open_inp ) {
+    irods::error ret = compose_archive_open_inp( _index, _open_inp );
+    if ( !ret.ok() ) {
+        return PASS( ret );
+    }
+
+    const std::string path = std::string( _open_inp.fileName ) + TAR_INDEX_FILE_SUFFIX;
+    if ( path.size() >= MAX_NAME_LEN ) {
+        return ERROR( USER_STRLEN_TOOLONG, "compose_tar_index_file_open_inp - path too long" );
+    }
+
+    rstrcpy( _open_inp.fileName, path.c_str(), MAX_NAME_LEN );
+    _open_inp.flags = _flags;
+
+    return SUCCESS();
+
+} // compose_tar_index_file_open_inp
+
+irods::error write_tar_index_file(
+    int                _index,
+    const tar_index_t& _tar_index ) {
+    rsComm_t* comm = PluginStructFileDesc[ _index ].rsComm;
+
+    fileOpenInp_t open_inp;
+    irods::error ret = compose_tar_index_file_open_inp( _index, O_WRONLY | O_CREAT | O_TRUNC, open_inp );
+    if ( !ret.ok() ) {
+        return PASS( ret );
+    }
+
+    const int fd = rsFileOpen( comm, &open_inp );
+    if ( fd < 0 ) {
+        return ERROR( fd, "write_tar_index_file - rsFileOpen failed." );
+    }
+
+    const std::string data = serialize_tar_index( _tar_index );
+
+    fileWriteInp_t write_inp{};
+    write_inp.fileInx = fd;
+    write_inp.len     = data.size();
+
+    bytesBuf_t write_buf{};
+    write_buf.buf = const_cast< char* >( data.data() );
+    write_buf.len = data.size();
+
+    const int status = rsFileWrite( comm, &write_inp, &write_buf );
+
+    fileCloseInp_t close_inp{};
+    close_inp.fileInx = fd;
+    rsFileClose( comm, &close_inp );
+
+    if ( status != static_cast< int >( data.size() ) ) {
+        return ERROR( status < 0 ? status : SYS_COPY_LEN_ERR, "write_tar_index_file - rsFileWrite failed." );
+    }
+
+    return SUCCESS();
+
+} // write_tar_index_file
+
+// =-=-=-=-=-=-=-
+// read the index file of a struct file.  fails if there is none, or if it
+// does not describe the archive as it is now
+irods::error read_tar_index_file(
+    int          _index,
+    rodsLong_t   _archive_size,
+    rodsLong_t   _archive_mtime,
+    tar_index_t& _tar_index ) {
+    rsComm_t* comm = PluginStructFileDesc[ _index ].rsComm;
+
+    fileOpenInp_t open_inp;
+    irods::error ret = compose_tar_index_file_open_inp( _index, O_RDONLY, open_inp );
+    if ( !ret.ok() ) {
+        return PASS( ret );
+    }
+
+    const int fd = rsFileOpen( comm, &open_inp );
+    if ( fd < 0 ) {
+        return ERROR( fd, "read_tar_index_file - rsFileOpen failed." );
+    }
+
+    std::string data;
+    std::vector< char > block( 1024 * 1024 );
+    int status = 0;
+    do {
+        fileReadInp_t read_inp{};
+        read_inp.fileInx = fd;
+        read_inp.len     = block.size();
+
+        bytesBuf_t read_buf{};
+        read_buf.buf = block.data();
+
+        status = rsFileRead( comm, &read_inp, &read_buf );
+        if ( status > 0 ) {
+            data.append( block.data(), status );
+        }
+    }
+    while ( status > 0 );
+
+    fileCloseInp_t close_inp{};
+    close_inp.fileInx = fd;
+    rsFileClose( comm, &close_inp );
+
+    if ( status < 0 ) {
+        return ERROR( status, "read_tar_index_file - rsFileRead failed." );
+    }
+
+    if ( !parse_tar_index( data, _tar_index ) ||
+            _tar_index.archive_size  != _archive_size ||
+            _tar_index.archive_mtime != _archive_mtime ) {
+        return ERROR( SYS_STRUCT_FILE_INMOUNTED_COLL, "read_tar_index_file - index file does not match the archive" );
+    }
+
+    return SUCCESS();
+
+} // read_tar_index_file
+
+// =-=-=-=-=-=-=-
+// fetch the member index of a struct file, building it on first use.  the
+// index is rebuilt if the archive has been rewritten since it was built
+irods::error get_tar_index(
+    int                                  _index,
+    std::shared_ptr<const tar_index_t>& _tar_index ) {
+    specColl_t* spec_coll = PluginStructFileDesc[ _index ].specColl;
+    rsComm_t*   comm      = PluginStructFileDesc[ _index ].rsComm;
+
+    fileOpenInp_t open_inp;
+    irods::error ret = compose_archive_open_inp( _index, open_inp );
+    if ( !ret.ok() ) {
+        return PASS( ret );
+    }
+
+    fileStatInp_t stat_inp;
+    memset( &stat_inp, 0, sizeof( stat_inp ) );
+    rstrcpy( stat_inp.fileName,      open_inp.fileName,      MAX_NAME_LEN );
+    rstrcpy( stat_inp.rescHier,      open_inp.resc_hier_,    MAX_NAME_LEN );
+    rstrcpy( stat_inp.objPath,       open_inp.objPath,       MAX_NAME_LEN );
+    rstrcpy( stat_inp.addr.hostAddr, open_inp.addr.hostAddr, NAME_LEN );
+
+    rodsStat_t* rods_stat = NULL;
+    int status = rsFileStat( comm, &stat_inp, &rods_stat );
+    if ( status < 0 ) {
+        return ERROR( status, "get_tar_index - rsFileStat failed." );
+    }
+    const rodsLong_t archive_size  = rods_stat->st_size;
+    const rodsLong_t archive_mtime = rods_stat->st_mtim;
+    free( rods_stat );
+
+    const std::string key = std::string( spec_coll->rescHier ) + ":" + spec_coll->phyPath;
+    if ( const auto iter = PluginTarIndexCache.find( key );
+            iter != PluginTarIndexCache.end()                   &&
+            iter->second->archive_size  == archive_size         &&
+            iter->second->archive_mtime == archive_mtime ) {
+        _tar_index = iter->second;
+        return SUCCESS();
+    }
+
+    // =-=-=-=-=-=-=-
+    // use the index written next to the archive when it was bundled
+    auto tar_index = std::make_shared<tar_index_t>();
+    if ( read_tar_index_file( _index, archive_size, archive_mtime, *tar_index ).ok() ) {
+        PluginTarIndexCache[ key ] = tar_index;
+        _tar_index = tar_index;
+        return SUCCESS();
+    }
+
+    tar_index = std::make_shared<tar_index_t>();
+    tar_index->archive_size  = archive_size;
+    tar_index->archive_mtime = archive_mtime;
+    tar_index->compressed    = false;
+    tar_index->members[ "" ] = tar_member_t{ -1, 0, archive_mtime, S_IFDIR | 0755, true };
+
+    // =-=-=-=-=-=-=-
+    // plain tar files carry the ustar magic in the first header
+    const int fd = rsFileOpen( comm, &open_inp );
+    if ( fd < 0 ) {
+        return ERROR( fd, "get_tar_index - rsFileOpen failed." );
+    }
+
+    char block[ TAR_BLOCK_SIZE ];
+    status = read_archive_at( comm, fd, 0, block, TAR_BLOCK_SIZE );
+    if ( status == TAR_BLOCK_SIZE && strncmp( block + 257, "ustar", 5 ) == 0 ) {
+        ret = build_plain_tar_index( comm, fd, *tar_index );
+    }
+    else {
+        tar_index->compressed = true;
+    }
+
+    fileCloseInp_t close_inp;
+    memset( &close_inp, 0, sizeof( close_inp ) );
+    close_inp.fileInx = fd;
+    rsFileClose( comm, &close_inp );
+
+    if ( tar_index->compressed ) {
+        ret = for_each_archive_entry( _index, [&tar_index]( struct archive* _arch, struct archive_entry* _entry ) {
+            const mode_t type = archive_entry_filetype( _entry );
+            if ( type == AE_IFREG || type == AE_IFDIR ) {
+                tar_member_t member{};
+                member.offset = -1;
+                member.size   = ( type == AE_IFDIR ) ? 0 : archive_entry_size( _entry );
+                member.mtime  = archive_entry_mtime( _entry );
+                member.mode   = archive_entry_mode( _entry );
+                member.is_dir = ( type == AE_IFDIR );
+                add_tar_member( *tar_index, normalize_member_path( archive_entry_pathname( _entry ) ), member );
+            }
+            archive_read_data_skip( _arch );
+            return true;
+        } );
+    }
+
+    if ( !ret.ok() ) {
+        return PASS( ret );
+    }
+
+    PluginTarIndexCache[ key ] = tar_index;
+    _tar_index = tar_index;
+
+    return SUCCESS();
+
+} // get_tar_index
+
+// =-=-=-=-=-=-=-
+// decompress a member of a compressed archive, using the lru cache
+irods::error read_compressed_member(
+    int                                  _index,
+    const tar_index_t&                   _tar_index,
+    const std::string&                   _member_path,
+    std::shared_ptr<const std::string>& _contents ) {
+    specColl_t* spec_coll = PluginStructFileDesc[ _index ].specColl;
+    const std::string archive_key = std::string( spec_coll->rescHier ) + ":" + spec_coll->phyPath + ":" +
+                                    std::to_string( _tar_index.archive_mtime );
+    const std::string key = archive_key + ":" + _member_path;
+
+    for ( auto iter = PluginTarMemberCache.begin(); iter != PluginTarMemberCache.end(); ++iter ) {
+        if ( iter->first == key ) {
+            _contents = iter->second;
+            PluginTarMemberCache.splice( PluginTarMemberCache.begin(), PluginTarMemberCache, iter );
+            return SUCCESS();
+        }
+    }
+
+    // =-=-=-=-=-=-=-
+    // continue from the last member read, and start over from the beginning
+    // of the archive only if the member was not found after it
+    bool reopened = false;
+    if ( !PluginTarArchiveReader || PluginTarArchiveReader->key != archive_key ) {
+        irods::error ret = open_tar_archive_reader( _index, archive_key );
+        if ( !ret.ok() ) {
+            return PASS( ret );
+        }
+        reopened = true;
+    }
+
+    std::shared_ptr<std::string> contents;
+    bool found = read_member_from_tar_archive_reader( _member_path, contents );
+    if ( !found && !reopened ) {
+        irods::error ret = open_tar_archive_reader( _index, archive_key );
+        if ( !ret.ok() ) {
+            return PASS( ret );
+        }
+        found = read_member_from_tar_archive_reader( _member_path, contents );
+    }
+
+    if ( !contents ) {
+        // =-=-=-=-=-=-=-
+        // the reader is at an unknown position after a failed read
+        close_tar_archive_reader();
+        return ERROR( SYS_STRUCT_FILE_INMOUNTED_COLL, "read_compressed_member - failed to read member" );
+    }
+
+    // =-=-=-=-=-=-=-
+    // evict the least recently used members to make room
+    std::size_t cached_bytes = contents->size();
+    for ( const auto& entry : PluginTarMemberCache ) {
+        cached_bytes += entry.second->size();
+    }
+    while ( cached_bytes > TAR_MEMBER_CACHE_MAX_BYTES && !PluginTarMemberCache.empty() ) {
+        cached_bytes -= PluginTarMemberCache.back().second->size();
+        PluginTarMemberCache.pop_back();
+    }
+
+    PluginTarMemberCache.emplace_front( key, contents );
+    _contents = contents;
+
+    return SUCCESS();
+
+} // read_compressed_member
+
 // =-=-=-=-=-=-=-
 // find the next free PluginStructFileDesc slot, mark it in use and return the index
 int alloc_struct_file_desc() {
@@ -616,13 +1410,60 @@ int match_struct_file_desc( specColl_t* _spec_coll ) {
 } // match_struct_file_desc
 
 // =-=-=-=-=-=-=-
-// local function to manage the open of a tar file
+// resolve the host of the last resource in a hierarchy
+irods::error resolve_resc_host(
+    const std::string& _resc_hier,
+    std::string&       _resc_host ) {
+    // =-=-=-=-=-=-=-
+    // resolve the child resource by name
+    irods::resource_ptr resc;
+    std::string last_resc;
+    irods::hierarchy_parser parser;
+    parser.set_string( _resc_hier );
+    parser.last_resc( last_resc );
+    irods::error resc_err = resc_mgr.resolve( last_resc, resc );
+    if ( !resc_err.ok() ) {
+        std::stringstream msg;
+        msg << "resolve_resc_host - error returned from resolveResc for resource [";
+        msg << last_resc;
+        msg << "], status: ";
+        msg << resc_err.code();
+        return PASSMSG( msg.str(), resc_err );
+    }
+
+    // =-=-=-=-=-=-=-
+    // extract the name of the host of the resource from the resource plugin
+    rodsServerHost_t* rods_host = 0;
+    irods::error get_err = resc->get_property< rodsServerHost_t* >( irods::RESOURCE_HOST, rods_host );
+    if ( !get_err.ok() ) {
+        return PASSMSG( "failed to call get_property", get_err );
+    }
+
+    if ( !rods_host ) {
+        return ERROR( -1, "null rods server host" );
+    }
+
+    if ( !rods_host->hostName ) {
+        return ERROR( -1, "null rods server hostname" );
+    }
+
+    _resc_host = rods_host->hostName->name;
+
+    return SUCCESS();
+
+} // resolve_resc_host
+
+// =-=-=-=-=-=-=-
+// local function to manage the open of a tar file.  if _stage is false the
+// tar file is not extracted to a cache dir, so that its members may be read
+// in place
 irods::error tar_struct_file_open(
     rsComm_t*          _comm,
     specColl_t*        _spec_coll,
     int&               _struct_desc_index,
     const std::string& _resc_hier,
-    std::string&       _resc_host ) {
+    std::string&       _resc_host,
+    bool               _stage = true ) {
     int status                  = 0;
     specCollCache_t* spec_cache = 0;
 
@@ -639,9 +1480,24 @@ irods::error tar_struct_file_open(
     }
 
     // =-=-=-=-=-=-=-
-    // look for opened PluginStructFileDesc
+    // look for opened PluginStructFileDesc, staging it if it was opened
+    // without a cache dir
     _struct_desc_index = match_struct_file_desc( _spec_coll );
     if ( _struct_desc_index > 0 ) {
+        if ( !_stage || strlen( PluginStructFileDesc[ _struct_desc_index ].specColl->cacheDir ) > 0 ) {
+            return SUCCESS();
+        }
+
+        irods::error host_err = resolve_resc_host( _resc_hier, _resc_host );
+        if ( !host_err.ok() ) {
+            return PASS( host_err );
+        }
+
+        irods::error stage_err = stage_tar_struct_file( _struct_desc_index, _resc_host );
+        if ( !stage_err.ok() ) {
+            return PASSMSG( "stage_tar_struct_file failed.", stage_err );
+        }
+
         return SUCCESS();
     }
 
@@ -667,66 +1523,38 @@ irods::error tar_struct_file_open(
         // does not give phyPath nor resource
         if ( strlen( _spec_coll->phyPath ) > 0 ) { // JMC - backport 4517
             rstrcpy( spec_cache->specColl.phyPath,  _spec_coll->phyPath, MAX_NAME_LEN );
-        }
-        if ( strlen( spec_cache->specColl.resource ) == 0 ) {
-            rstrcpy( spec_cache->specColl.resource,  _spec_coll->resource, NAME_LEN );
-        }
-    }
-    else {
-        // =-=-=-=-=-=-=-
-        // special collection is local to this server ??
-        PluginStructFileDesc[ _struct_desc_index ].specColl =  _spec_coll;
-    }
-
-    // =-=-=-=-=-=-=-
-    // cache pointer to comm struct
-    PluginStructFileDesc[ _struct_desc_index ].rsComm = _comm;
-
-    // =-=-=-=-=-=-=-
-    // resolve the child resource by name
-    irods::resource_ptr resc;
-    std::string last_resc;
-    irods::hierarchy_parser parser;
-    parser.set_string( _resc_hier );
-    parser.last_resc( last_resc );
-    irods::error resc_err = resc_mgr.resolve( last_resc, resc );
-    if ( !resc_err.ok() ) {
-        std::stringstream msg;
-        msg << "tar_struct_file_open - error returned from resolveResc for resource [";
-        msg << _spec_coll->resource;
-        msg << "], status: ";
-        msg << resc_err.code();
-        free_struct_file_desc( _struct_desc_index );
-        return PASSMSG( msg.str(), resc_err );
+        }
+        if ( strlen( spec_cache->specColl.resource ) == 0 ) {
+            rstrcpy( spec_cache->specColl.resource,  _spec_coll->resource, NAME_LEN );
+        }
     }
-
-    // =-=-=-=-=-=-=-
-    // extract the name of the host of the resource from the resource plugin
-    rodsServerHost_t* rods_host = 0;
-    irods::error get_err = resc->get_property< rodsServerHost_t* >( irods::RESOURCE_HOST, rods_host );
-    if ( !get_err.ok() ) {
-        return PASSMSG( "failed to call get_property", get_err );
+    else {
+        // =-=-=-=-=-=-=-
+        // special collection is local to this server ??
+        PluginStructFileDesc[ _struct_desc_index ].specColl =  _spec_coll;
     }
 
-    if ( !rods_host ) {
-        return ERROR( -1, "null rods server host" );
-    }
+    // =-=-=-=-=-=-=-
+    // cache pointer to comm struct
+    PluginStructFileDesc[ _struct_desc_index ].rsComm = _comm;
 
-    if ( !rods_host->hostName ) {
-        return ERROR( -1, "null rods server hostname" );
+    irods::error host_err = resolve_resc_host( _resc_hier, _resc_host );
+    if ( !host_err.ok() ) {
+        free_struct_file_desc( _struct_desc_index );
+        return PASS( host_err );
     }
 
-    _resc_host = rods_host->hostName->name;
-
     // =-=-=-=-=-=-=-
     // TODO :: need to deal with remote open here
 
     // =-=-=-=-=-=-=-
     // stage the tar file so we can get at its tasty innards
-    irods::error stage_err = stage_tar_struct_file( _struct_desc_index, _resc_host );
-    if ( !stage_err.ok() ) {
-        free_struct_file_desc( _struct_desc_index );
-        return PASSMSG( "stage_tar_struct_file failed.", stage_err );
+    if ( _stage ) {
+        irods::error stage_err = stage_tar_struct_file( _struct_desc_index, _resc_host );
+        if ( !stage_err.ok() ) {
+            free_struct_file_desc( _struct_desc_index );
+            return PASSMSG( "stage_tar_struct_file failed.", stage_err );
+        }
     }
 
     // =-=-=-=-=-=-=-
@@ -791,11 +1619,111 @@ int free_tar_sub_file_desc( int _idx ) {
         return SYS_FILE_DESC_OUT_OF_RANGE;
     }
 
+    PluginTarSubFileBuffer[ _idx ].reset();
     memset( &PluginTarSubFileDesc[ _idx ], 0, sizeof( tarSubFileDesc_t ) );
 
     return 0;
 }
 
+// =-=-=-=-=-=-=-
+// open a member of an unstaged tar file for reading in place.  fails if the
+// member is not a regular file in the index, in which case the caller should
+// fall back to staging the tar file
+irods::error open_tar_member(
+    int                _sub_index,
+    const std::string& _sub_file_path ) {
+    tarSubFileDesc_t& sub_desc  = PluginTarSubFileDesc[ _sub_index ];
+    const int         index     = sub_desc.structFileInx;
+    specColl_t*       spec_coll = PluginStructFileDesc[ index ].specColl;
+    rsComm_t*         comm      = PluginStructFileDesc[ index ].rsComm;
+
+    std::shared_ptr<const tar_index_t> tar_index;
+    irods::error ret = get_tar_index( index, tar_index );
+    if ( !ret.ok() ) {
+        return PASS( ret );
+    }
+
+    const std::string member_path = compose_member_path( spec_coll, _sub_file_path );
+    const auto iter = tar_index->members.find( member_path );
+    if ( iter == tar_index->members.end() || iter->second.is_dir ) {
+        std::stringstream msg;
+        msg << "open_tar_member - [";
+        msg << _sub_file_path;
+        msg << "] is not a file in the index";
+        return ERROR( SYS_STRUCT_FILE_PATH_ERR, msg.str() );
+    }
+
+    const tar_member_t& member = iter->second;
+    if ( tar_index->compressed ) {
+        if ( member.size > static_cast< rodsLong_t >( TAR_MEMBER_CACHE_MAX_BYTES ) ) {
+            return ERROR( SYS_STRUCT_FILE_PATH_ERR, "open_tar_member - member too large to buffer" );
+        }
+
+        ret = read_compressed_member( index, *tar_index, member_path, PluginTarSubFileBuffer[ _sub_index ] );
+        if ( !ret.ok() ) {
+            return PASS( ret );
+        }
+
+        sub_desc.fd = -1;
+    }
+    else {
+        fileOpenInp_t open_inp;
+        ret = compose_archive_open_inp( index, open_inp );
+        if ( !ret.ok() ) {
+            return PASS( ret );
+        }
+
+        const int fd = rsFileOpen( comm, &open_inp );
+        if ( fd < 0 ) {
+            return ERROR( fd, "open_tar_member - rsFileOpen failed." );
+        }
+
+        sub_desc.fd = fd;
+    }
+
+    sub_desc.indexed    = 1;
+    sub_desc.dataOffset = member.offset;
+    sub_desc.dataSize   = member.size;
+    sub_desc.position   = 0;
+
+    return SUCCESS();
+
+} // open_tar_member
+
+// =-=-=-=-=-=-=-
+// stat a member of an unstaged tar file using the index
+irods::error stat_tar_member(
+    int                _index,
+    const std::string& _sub_file_path,
+    struct stat*       _statbuf ) {
+    std::shared_ptr<const tar_index_t> tar_index;
+    irods::error ret = get_tar_index( _index, tar_index );
+    if ( !ret.ok() ) {
+        return PASS( ret );
+    }
+
+    const std::string member_path = compose_member_path( PluginStructFileDesc[ _index ].specColl, _sub_file_path );
+    const auto iter = tar_index->members.find( member_path );
+    if ( iter == tar_index->members.end() ) {
+        std::stringstream msg;
+        msg << "stat_tar_member - [";
+        msg << _sub_file_path;
+        msg << "] is not in the index";
+        return ERROR( SYS_STRUCT_FILE_PATH_ERR, msg.str() );
+    }
+
+    memset( _statbuf, 0, sizeof( struct stat ) );
+    _statbuf->st_size  = iter->second.size;
+    _statbuf->st_mode  = iter->second.mode;
+    _statbuf->st_nlink = 1;
+    _statbuf->st_atime = iter->second.mtime;
+    _statbuf->st_mtime = iter->second.mtime;
+    _statbuf->st_ctime = iter->second.mtime;
+
+    return SUCCESS();
+
+} // stat_tar_member
+
 // =-=-=-=-=-=-=-
 // interface for POSIX create
 irods::error tar_file_create(
@@ -927,11 +1855,14 @@ irods::error tar_file_open(
     }
 
     // =-=-=-=-=-=-=-
-    // open and stage the tar file, get its index
+    // open the tar file, get its index.  read only opens do not stage the
+    // tar file so that the member may be read in place
+    const bool read_only = ( fco->flags() & O_ACCMODE ) == O_RDONLY &&
+                           !( fco->flags() & ( O_CREAT | O_TRUNC ) );
     int struct_file_index = 0;
     std::string resc_host;
     irods::error open_err =  tar_struct_file_open( comm, spec_coll, struct_file_index,
-                             fco->resc_hier(), resc_host );
+                             fco->resc_hier(), resc_host, !read_only );
     if ( !open_err.ok() ) {
         std::stringstream msg;
         msg << "tar_struct_file_open error for [";
@@ -954,6 +1885,31 @@ irods::error tar_file_open(
     // cache struct file index into sub file index
     PluginTarSubFileDesc[ sub_index ].structFileInx = struct_file_index;
 
+    // =-=-=-=-=-=-=-
+    // read the member in place if the tar file has not been staged,
+    // otherwise stage it and open the member in the cache dir
+    if ( strlen( spec_coll->cacheDir ) == 0 ) {
+        irods::error idx_err = open_tar_member( sub_index, fco->sub_file_path() );
+        if ( idx_err.ok() ) {
+            PluginStructFileDesc[ struct_file_index ].openCnt++;
+            fco->file_descriptor( sub_index );
+            return CODE( sub_index );
+        }
+
+        rodsLog( LOG_DEBUG, "tar_file_open_plugin - staging [%s] : %s",
+                 spec_coll->objPath, idx_err.result().c_str() );
+
+        open_err = tar_struct_file_open( comm, spec_coll, struct_file_index,
+                                         fco->resc_hier(), resc_host );
+        if ( !open_err.ok() ) {
+            free_tar_sub_file_desc( sub_index );
+            std::stringstream msg;
+            msg << "tar_struct_file_open error for [";
+            msg << spec_coll->objPath;
+            return PASSMSG( msg.str(), open_err );
+        }
+    }
+
     // =-=-=-=-=-=-=-
     // build a file open structure to pass off to the server api call
     fileOpenInp_t fileOpenInp;
@@ -1023,6 +1979,32 @@ irods::error tar_file_read(
         return ERROR( SYS_STRUCT_FILE_DESC_ERR, msg.str() );
     }
 
+    // =-=-=-=-=-=-=-
+    // members read in place are served from their range of the tar file
+    // or from the buffered member
+    tarSubFileDesc_t& sub_desc = PluginTarSubFileDesc[ fco->file_descriptor() ];
+    if ( sub_desc.indexed ) {
+        const rodsLong_t remaining = std::max< rodsLong_t >( sub_desc.dataSize - sub_desc.position, 0 );
+        const int len = static_cast< int >( std::min< rodsLong_t >( _len, remaining ) );
+        if ( len <= 0 ) {
+            return CODE( 0 );
+        }
+
+        int status = len;
+        if ( sub_desc.fd < 0 ) {
+            memcpy( _buf, PluginTarSubFileBuffer[ fco->file_descriptor() ]->data() + sub_desc.position, len );
+        }
+        else {
+            status = read_archive_at( fco->comm(), sub_desc.fd, sub_desc.dataOffset + sub_desc.position, _buf, len );
+            if ( status < 0 ) {
+                return ERROR( status, "rsFileRead failed" );
+            }
+        }
+
+        sub_desc.position += status;
+        return CODE( status );
+    }
+
     // =-=-=-=-=-=-=-
     // build a read structure and make the rs call
     fileReadInp_t fileReadInp;
@@ -1074,6 +2056,12 @@ irods::error tar_file_write(
         return ERROR( SYS_STRUCT_FILE_DESC_ERR, msg.str() );
     }
 
+    // =-=-=-=-=-=-=-
+    // members read in place were opened read only
+    if ( PluginTarSubFileDesc[ fco->file_descriptor() ].indexed ) {
+        return ERROR( UNIX_FILE_WRITE_ERR - EBADF, "tar_file_write_plugin - sub file is open read only" );
+    }
+
     // =-=-=-=-=-=-=-
     // build a write structure and make the rs call
     const fileWriteInp_t fileWriteInp{
@@ -1136,11 +2124,16 @@ irods::error tar_file_close(
     }
 
     // =-=-=-=-=-=-=-
-    // build a close structure and make the rs call
-    fileCloseInp_t fileCloseInp;
-    memset( &fileCloseInp, 0, sizeof( fileCloseInp ) );
-    fileCloseInp.fileInx = PluginTarSubFileDesc[ fco->file_descriptor() ].fd;
-    int status = rsFileClose( fco->comm(), &fileCloseInp );
+    // build a close structure and make the rs call.  buffered members
+    // have no open file
+    int status = 0;
+    if ( !PluginTarSubFileDesc[ fco->file_descriptor() ].indexed ||
+            PluginTarSubFileDesc[ fco->file_descriptor() ].fd >= 0 ) {
+        fileCloseInp_t fileCloseInp;
+        memset( &fileCloseInp, 0, sizeof( fileCloseInp ) );
+        fileCloseInp.fileInx = PluginTarSubFileDesc[ fco->file_descriptor() ].fd;
+        status = rsFileClose( fco->comm(), &fileCloseInp );
+    }
     if ( status < 0 ) {
         std::stringstream msg;
         msg << "tar_file_close_plugin - failed in rsFileClose for fd [ ";
@@ -1277,11 +2270,11 @@ irods::error tar_file_stat(
     }
 
     // =-=-=-=-=-=-=-
-    // open and stage the tar file, get its index
+    // open the tar file, get its index
     int struct_file_index = 0;
     std::string resc_host;
     irods::error open_err =  tar_struct_file_open( comm, spec_coll, struct_file_index,
-                             fco->resc_hier(), resc_host );
+                             fco->resc_hier(), resc_host, false );
     if ( !open_err.ok() ) {
         std::stringstream msg;
         msg << "tar_file_stat_plugin - tar_struct_file_open error for [";
@@ -1293,6 +2286,25 @@ irods::error tar_file_stat(
     // use the cached specColl. specColl may have changed
     spec_coll = PluginStructFileDesc[ struct_file_index ].specColl;
 
+    // =-=-=-=-=-=-=-
+    // stat the member from the index if the tar file has not been staged,
+    // staging it if the member is not found
+    if ( strlen( spec_coll->cacheDir ) == 0 ) {
+        irods::error idx_err = stat_tar_member( struct_file_index, fco->sub_file_path(), _statbuf );
+        if ( idx_err.ok() ) {
+            return CODE( 0 );
+        }
+
+        open_err = tar_struct_file_open( comm, spec_coll, struct_file_index,
+                                         fco->resc_hier(), resc_host );
+        if ( !open_err.ok() ) {
+            std::stringstream msg;
+            msg << "tar_file_stat_plugin - tar_struct_file_open error for [";
+            msg << spec_coll->objPath;
+            return PASSMSG( msg.str(), open_err );
+        }
+    }
+
 
     // =-=-=-=-=-=-=-
     // build a file stat structure to pass off to the server api call
@@ -1364,6 +2376,29 @@ irods::error tar_file_lseek(
         return ERROR( -1, "tar_file_lseek_plugin - null comm pointer in structure_object" );
     }
 
+    // =-=-=-=-=-=-=-
+    // members read in place only track their position
+    tarSubFileDesc_t& sub_desc = PluginTarSubFileDesc[ fco->file_descriptor() ];
+    if ( sub_desc.indexed ) {
+        rodsLong_t position = _offset;
+        if ( SEEK_CUR == _whence ) {
+            position += sub_desc.position;
+        }
+        else if ( SEEK_END == _whence ) {
+            position += sub_desc.dataSize;
+        }
+        else if ( SEEK_SET != _whence ) {
+            return ERROR( UNIX_FILE_LSEEK_ERR - EINVAL, "tar_file_lseek_plugin - invalid whence" );
+        }
+
+        if ( position < 0 ) {
+            return ERROR( UNIX_FILE_LSEEK_ERR - EINVAL, "tar_file_lseek_plugin - negative offset" );
+        }
+
+        sub_desc.position = position;
+        return CODE( position );
+    }
+
     // =-=-=-=-=-=-=-
     // build a lseek structure and make the rs call
     fileLseekInp_t fileLseekInp;
@@ -2047,7 +3082,9 @@ irods::error tar_file_extract(
 // helper function to write an archive entry
 irods::error write_file_to_archive( const boost::filesystem::path _path,
                                     const std::string&            _cache_dir,
-                                    struct archive*               _archive ) {
+                                    struct archive*               _archive,
+                                    const std::string*            _contents = NULL,
+                                    tar_member_t*                 _member = NULL ) {
     namespace fs = boost::filesystem;
     struct archive_entry* entry = archive_entry_new();
 
@@ -2058,8 +3095,9 @@ irods::error write_file_to_archive( const boost::filesystem::path _path,
     archive_entry_set_pathname( entry, strip_file.c_str() );
 
     // =-=-=-=-=-=-=-
-    // ask for the file size
-    archive_entry_set_size( entry, fs::file_size( _path ) );
+    // ask for the file size, unless the contents have already been read
+    const rodsLong_t file_size = _contents ? _contents->size() : fs::file_size( _path );
+    archive_entry_set_size( entry, file_size );
     archive_entry_set_filetype( entry, AE_IFREG );
 
     // =-=-=-=-=-=-=-
@@ -2082,9 +3120,36 @@ irods::error write_file_to_archive( const boost::filesystem::path _path,
         msg << "] with error string [";
         msg << archive_error_string( _archive );
         msg << "]";
+        archive_entry_free( entry );
         return ERROR( -1, msg.str() );
     }
 
+    if ( _member ) {
+        _member->size   = file_size;
+        _member->mtime  = tt;
+        _member->mode   = S_IFREG | 0600;
+        _member->is_dir = false;
+    }
+
+    // =-=-=-=-=-=-=-
+    // write out contents which were read ahead
+    if ( _contents ) {
+        if ( !_contents->empty() &&
+                archive_write_data( _archive, _contents->data(), _contents->size() ) < 0 ) {
+            std::stringstream msg;
+            msg << "write_file_to_archive - failed to write data for [";
+            msg << path_name;
+            msg << "] with error string [";
+            msg << archive_error_string( _archive );
+            msg << "]";
+            archive_entry_free( entry );
+            return ERROR( -1, msg.str() );
+        }
+
+        archive_entry_free( entry );
+        return SUCCESS();
+    }
+
     // =-=-=-=-=-=-=-
     // JMC :: i didnt use ifstream as readsome() garbled the file
     //     :: some reason.  revisit this for windows
@@ -2098,6 +3163,7 @@ irods::error write_file_to_archive( const boost::filesystem::path _path,
         msg << "] with error [";
         msg << strerror( errno );
         msg << "]";
+        archive_entry_free( entry );
         return ERROR( -1, msg.str() );
     }
 
@@ -2119,6 +3185,254 @@ irods::error write_file_to_archive( const boost::filesystem::path _path,
 
 } // write_file_to_archive
 
+// =-=-=-=-=-=-=-
+// helper function to read a member of the cache dir into memory
+irods::error read_file_for_archive( const boost::filesystem::path& _path,
+                                    std::string&                   _contents ) {
+    int fd = open( _path.string().c_str(), O_RDONLY );
+    if ( -1 == fd ) {
+        std::stringstream msg;
+        msg << "read_file_for_archive - failed to open file for read [";
+        msg << _path.string();
+        msg << "] with error [";
+        msg << strerror( errno );
+        msg << "]";
+        return ERROR( -1, msg.str() );
+    }
+
+    char buff[ 16384 ];
+    ssize_t len = read( fd, buff, sizeof( buff ) );
+    while ( len > 0 ) {
+        _contents.append( buff, len );
+        len = read( fd, buff, sizeof( buff ) );
+    }
+
+    close( fd );
+
+    if ( len < 0 ) {
+        std::stringstream msg;
+        msg << "read_file_for_archive - failed to read file [";
+        msg << _path.string();
+        msg << "]";
+        return ERROR( -1, msg.str() );
+    }
+
+    return SUCCESS();
+
+} // read_file_for_archive
+
+// =-=-=-=-=-=-=-
+// helper function to write the files of a listing to the archive in order,
+// recording each member in the index.  member offsets are only known for
+// uncompressed ustar archives, where each member is a 512 byte header
+// followed by its data padded out to the block size.  with more than one
+// reader thread, the files are read into memory ahead of the writer
+irods::error write_listing_to_archive( const std::vector< boost::filesystem::path >& _listing,
+                                       const std::string&                            _cache_dir,
+                                       struct archive*                               _archive,
+                                       int                                           _reader_threads,
+                                       tar_index_t&                                  _tar_index ) {
+    namespace fs = boost::filesystem;
+
+    // =-=-=-=-=-=-=-
+    // a member read ahead by a reader thread
+    struct staged_member_t {
+        bool         ready;
+        bool         staged;
+        std::string  contents;
+    };
+
+    std::vector< staged_member_t > staged( _listing.size(), staged_member_t{ false, false, {} } );
+    std::mutex                     mutex;
+    std::condition_variable        cond;
+    std::size_t                    next_to_stage = 0;
+    std::size_t                    next_to_write = 0;
+    std::size_t                    staged_bytes  = 0;
+    bool                           done          = false;
+    const std::size_t              window        = std::max( _reader_threads, 1 ) * 4;
+
+    auto reader = [&]() {
+        while ( true ) {
+            std::size_t i = 0;
+            {
+                std::unique_lock< std::mutex > lock( mutex );
+                cond.wait( lock, [&]() {
+                    return done                                   ||
+                           next_to_stage >= _listing.size()       ||
+                           ( next_to_stage < next_to_write + window &&
+                             staged_bytes < BUNDLE_MAX_STAGED_BYTES );
+                } );
+                if ( done || next_to_stage >= _listing.size() ) {
+                    return;
+                }
+                i = next_to_stage++;
+            }
+
+            // =-=-=-=-=-=-=-
+            // large files and files which fail to read are left for the
+            // writer to stream, which will also report any error
+            std::string contents;
+            bool        is_staged = false;
+            boost::system::error_code ec;
+            const auto  size = fs::file_size( _listing[ i ], ec );
+            if ( !ec && size <= BUNDLE_MEMBER_MAX_STAGED_BYTES ) {
+                is_staged = read_file_for_archive( _listing[ i ], contents ).ok();
+            }
+
+            {
+                std::lock_guard< std::mutex > lock( mutex );
+                staged[ i ].staged   = is_staged;
+                staged[ i ].contents = std::move( contents );
+                staged[ i ].ready    = true;
+                staged_bytes += staged[ i ].contents.size();
+            }
+            cond.notify_all();
+        }
+    };
+
+    std::vector< std::thread > readers;
+    if ( _reader_threads > 1 ) {
+        for ( int i = 0; i < _reader_threads; ++i ) {
+            readers.emplace_back( reader );
+        }
+    }
+
+    irods::error arch_err = SUCCESS();
+    rodsLong_t   offset   = 0;
+    for ( size_t i = 0; i < _listing.size(); ++i ) {
+        staged_member_t member{ false, false, {} };
+        if ( !readers.empty() ) {
+            std::unique_lock< std::mutex > lock( mutex );
+            cond.wait( lock, [&]() { return staged[ i ].ready; } );
+            member = std::move( staged[ i ] );
+            staged_bytes -= member.contents.size();
+            next_to_write = i + 1;
+            lock.unlock();
+            cond.notify_all();
+        }
+
+        // =-=-=-=-=-=-=-
+        // strip off archive path from the filename
+        tar_member_t entry{};
+        irods::error ret = write_file_to_archive(
+                               _listing[ i ].string(),
+                               _cache_dir,
+                               _archive,
+                               member.staged ? &member.contents : NULL,
+                               &entry );
+        // =-=-=-=-=-=-=-
+        // write_file_to_archive fills in the member once its header is
+        // written.  libarchive pads a member whose data could not be written
+        // out to the size in its header, so it still takes up that space
+        const bool header_written = entry.mode != 0;
+        const rodsLong_t data_offset = offset + TAR_BLOCK_SIZE;
+        if ( header_written ) {
+            offset += TAR_BLOCK_SIZE + ( entry.size + TAR_BLOCK_SIZE - 1 ) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+        }
+
+        if ( !ret.ok() ) {
+            std::stringstream msg;
+            msg << "bundle_cache_dir - failed to archive file [";
+            msg << _listing[ i ].string();
+            msg << "]";
+            arch_err = PASSMSG( msg.str(), arch_err );
+            irods::log( PASSMSG( msg.str(), ret ) );
+            continue;
+        }
+
+        entry.offset = _tar_index.compressed ? -1 : data_offset;
+        add_tar_member( _tar_index, normalize_member_path( _listing[ i ].string().substr( _cache_dir.size() + 1 ) ), entry );
+
+    } // for i
+
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        done = true;
+    }
+    cond.notify_all();
+    for ( auto& thread : readers ) {
+        thread.join();
+    }
+
+    return arch_err;
+
+} // write_listing_to_archive
+
+// =-=-=-=-=-=-=-
+// helper function to set the compression level of a filter, if one is given
+irods::error set_compression_level( struct archive* _archive,
+                                    const char*     _filter,
+                                    int             _level ) {
+    if ( _level < 0 ) {
+        return SUCCESS();
+    }
+
+    const std::string level = std::to_string( _level );
+    if ( archive_write_set_filter_option( _archive, _filter, "compression-level", level.c_str() ) != ARCHIVE_OK ) {
+        std::stringstream msg;
+        msg << "set_compression_level - failed to set level [";
+        msg << _level;
+        msg << "] for [";
+        msg << _filter;
+        msg << "] with error string [";
+        msg << archive_error_string( _archive );
+        msg << "]";
+        return ERROR( SYS_INVALID_INPUT_PARAM, msg.str() );
+    }
+
+    return SUCCESS();
+
+} // set_compression_level
+
+// =-=-=-=-=-=-=-
+// read the bundle settings from the context string of the last resource
+// in the hierarchy, which holds the archive
+bundle_options_t get_bundle_options( const std::string& _resc_hier ) {
+    bundle_options_t options{ 1, -1 };
+
+    std::string last_resc;
+    irods::hierarchy_parser parser;
+    parser.set_string( _resc_hier );
+    parser.last_resc( last_resc );
+
+    irods::resource_ptr resc;
+    std::string context;
+    if ( !resc_mgr.resolve( last_resc, resc ).ok() ||
+         !resc->get_property< std::string >( irods::RESOURCE_CONTEXT, context ).ok() ) {
+        return options;
+    }
+
+    // =-=-=-=-=-=-=-
+    // contexts are free form, so take whatever keys could be parsed
+    irods::kvp_map_t kvp;
+    irods::parse_kvp_string( context, kvp );
+
+    auto itr = kvp.find( BUNDLE_READER_THREADS_KW );
+    if ( kvp.end() != itr ) {
+        try {
+            options.reader_threads = std::max( std::stoi( itr->second ), 1 );
+        }
+        catch ( const std::exception& ) {
+            rodsLog( LOG_ERROR, "get_bundle_options - invalid %s [%s] for resource [%s]",
+                     BUNDLE_READER_THREADS_KW.c_str(), itr->second.c_str(), last_resc.c_str() );
+        }
+    }
+
+    itr = kvp.find( BUNDLE_COMPRESSION_LEVEL_KW );
+    if ( kvp.end() != itr ) {
+        try {
+            options.compression_level = std::stoi( itr->second );
+        }
+        catch ( const std::exception& ) {
+            rodsLog( LOG_ERROR, "get_bundle_options - invalid %s [%s] for resource [%s]",
+                     BUNDLE_COMPRESSION_LEVEL_KW.c_str(), itr->second.c_str(), last_resc.c_str() );
+        }
+    }
+
+    return options;
+
+} // get_bundle_options
+
 // =-=-=-=-=-=-=-
 // helper function for recursive directory scanning
 irods::error build_directory_listing( const boost::filesystem::path&          _path,
@@ -2183,8 +3497,10 @@ irods::error build_directory_listing( const boost::filesystem::path&          _p
 
 // =-=-=-=-=-=-=-
 // create an archive from the cache directory
-irods::error bundle_cache_dir( int         _index,
-                               std::string _data_type ) {
+irods::error bundle_cache_dir( int                     _index,
+                               std::string             _data_type,
+                               const bundle_options_t& _options,
+                               tar_index_t&            _tar_index ) {
     // =-=-=-=-=-=-=-
     // namespace alias for brevity
     namespace fs = boost::filesystem;
@@ -2244,6 +3560,10 @@ irods::error bundle_cache_dir( int         _index,
     std::vector< fs::path > listing;
     build_directory_listing( full_path, listing );
 
+    // =-=-=-=-=-=-=-
+    // sort the listing so that the archive does not depend on directory order
+    std::sort( listing.begin(), listing.end() );
+
     // =-=-=-=-=-=-=-
     // create the archive
     struct archive* arch = archive_write_new();
@@ -2285,6 +3605,11 @@ irods::error bundle_cache_dir( int         _index,
 
         }
 
+        irods::error level_err = set_compression_level( arch, "gzip", _options.compression_level );
+        if ( !level_err.ok() ) {
+            return PASSMSG( "bundle_cache_dir - failed to set compression level", level_err );
+        }
+
         // =-=-=-=-=-=-=-
         // set the format of the tar archive
         archive_write_set_format_ustar( arch );
@@ -2302,6 +3627,11 @@ irods::error bundle_cache_dir( int         _index,
 
         }
 
+        irods::error level_err = set_compression_level( arch, "bzip2", _options.compression_level );
+        if ( !level_err.ok() ) {
+            return PASSMSG( "bundle_cache_dir - failed to set compression level", level_err );
+        }
+
         // =-=-=-=-=-=-=-
         // set the format of the tar archive
         archive_write_set_format_ustar( arch );
@@ -2360,22 +3690,15 @@ irods::error bundle_cache_dir( int         _index,
     // =-=-=-=-=-=-=-
     // iterate over the dir listing and archive the files
     std::string cache_dir( spec_coll->cacheDir );
-    irods::error arch_err = SUCCESS();
-    for ( size_t i = 0; i < listing.size(); ++i ) {
-        // =-=-=-=-=-=-=-
-        // strip off archive path from the filename
-        irods::error ret = write_file_to_archive( listing[ i ].string(), cache_dir, arch );
-
-        if ( !ret.ok() ) {
-            std::stringstream msg;
-            msg << "bundle_cache_dir - failed to archive file [";
-            msg << listing[ i ].string();
-            msg << "]";
-            arch_err = PASSMSG( msg.str(), arch_err );
-            irods::log( PASSMSG( msg.str(), ret ) );
-        }
-
-    } // for i
+    _tar_index.compressed = ( _data_type == ZIP_DT_STR       ||
+                              _data_type == GZIP_TAR_DT_STR  ||
+                              _data_type == BZIP2_TAR_DT_STR );
+    irods::error arch_err = write_listing_to_archive(
+                                listing,
+                                cache_dir,
+                                arch,
+                                _options.reader_threads,
+                                _tar_index );
 
     // =-=-=-=-=-=-=-
     // close the archive and clean up
@@ -2404,15 +3727,17 @@ irods::error bundle_cache_dir( int         _index,
 // =-=-=-=-=-=-=-
 // interface for tar / zip up of cache dir which also updates
 // the icat with the new file size
-irods::error sync_cache_dir_to_tar_file( int         _index,
-        int         _opr_type,
-        std::string _host ) {
+irods::error sync_cache_dir_to_tar_file( int                     _index,
+        int                     _opr_type,
+        std::string             _host,
+        const bundle_options_t& _options ) {
     specColl_t* spec_coll = PluginStructFileDesc[ _index ].specColl;
     rsComm_t*   comm      = PluginStructFileDesc[ _index ].rsComm;
 
     // =-=-=-=-=-=-=-
     // call bundle helper functions
-    irods::error bundle_err = bundle_cache_dir( _index, PluginStructFileDesc[ _index ].dataType );
+    auto tar_index = std::make_shared<tar_index_t>();
+    irods::error bundle_err = bundle_cache_dir( _index, PluginStructFileDesc[ _index ].dataType, _options, *tar_index );
     if ( !bundle_err.ok() ) {
         return PASSMSG( "sync_cache_dir_to_tar_file - failed in bundle.", bundle_err );
     }
@@ -2440,6 +3765,19 @@ irods::error sync_cache_dir_to_tar_file( int         _index,
 
     }
 
+    // =-=-=-=-=-=-=-
+    // keep the member index built while bundling so that later reads of
+    // the archive need not scan it
+    tar_index->archive_size  = file_stat_out->st_size;
+    tar_index->archive_mtime = file_stat_out->st_mtim;
+    tar_index->members[ "" ] = tar_member_t{ -1, 0, tar_index->archive_mtime, S_IFDIR | 0755, true };
+    PluginTarIndexCache[ std::string( spec_coll->rescHier ) + ":" + spec_coll->phyPath ] = tar_index;
+
+    irods::error index_err = write_tar_index_file( _index, *tar_index );
+    if ( !index_err.ok() ) {
+        irods::log( PASSMSG( "sync_cache_dir_to_tar_file - failed to write the index file, it will be rebuilt on read", index_err ) );
+    }
+
     // =-=-=-=-=-=-=-
     // update icat with the new size of the file
     if ( ( _opr_type & NO_REG_COLL_INFO ) == 0 ) {
@@ -2484,11 +3822,12 @@ irods::error tar_file_sync(
     }
 
     // =-=-=-=-=-=-=-
-    // open and stage the tar file, get its index
+    // open the tar file, get its index.  there is nothing to sync if it
+    // was never staged, so do not stage it here
     int struct_file_index = 0;
     std::string resc_host;
     irods::error open_err = tar_struct_file_open( comm, spec_coll, struct_file_index,
-                            fco->resc_hier(), resc_host );
+                            fco->resc_hier(), resc_host, false );
     if ( !open_err.ok() ) {
         std::stringstream msg;
         msg << "tar_file_sync_plugin - tar_struct_file_open error for [";
@@ -2527,7 +3866,8 @@ irods::error tar_file_sync(
             // write the tar file and register no dirty
             irods::error sync_err = sync_cache_dir_to_tar_file( struct_file_index,
                                     fco->opr_type(),
-                                    resc_host );
+                                    resc_host,
+                                    get_bundle_options( spec_coll->rescHier ) );
             if ( !sync_err.ok() ) {
                 std::stringstream msg;
                 msg << "tar_file_sync_plugin - failed in sync_cache_dir_to_tar_file for [";
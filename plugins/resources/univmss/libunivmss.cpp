@@ -17,14 +17,24 @@
 #include "irods_resource_redirect.hpp"
 #include "irods_stacktrace.hpp"
 #include "irods_re_structs.hpp"
+#include "irods_kvp_string_parser.hpp"
+#include "execCmd.h"
 #include "voting.hpp"
 
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 // =-=-=-=-=-=-=-
 // stl includes
+#include <algorithm>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <vector>
 #include <string>
+#include <map>
+#include <memory>
 
 // =-=-=-=-=-=-=-
 // boost includes
@@ -58,6 +68,356 @@ inline irods::error univ_mss_check_param(
 /// @brief token to index the script property
 const std::string SCRIPT_PROP( "script" );
 
+// =-=-=-=-=-=-=-
+/// @brief token to index the coprocess property.  when set to "on" the
+///        script is started once per agent and kept running, see
+///        univ_mss_coprocess below.
+const std::string COPROCESS_KW( "coprocess" );
+
+// =-=-=-=-=-=-=-
+// a long running instance of the univmss script.  the script is started
+// as "<script> coprocess" and reads requests from stdin, answering each
+// one on stdout, in order:
+//
+//     request:  "<id> <argc>\n" followed by argc lines, one per argument
+//     response: "<id> <status> <line count>\n" followed by the output lines
+//
+// requests may be pipelined, i.e. several can be submitted before the
+// first response is waited for.  the first request sent to a new
+// coprocess is always "ping" without arguments, which may be answered
+// with any status.  a script which exits instead of answering it does not
+// support the coprocess protocol.
+class univ_mss_coprocess {
+    public:
+        struct response {
+            int         status;
+            std::string output;
+        };
+
+        explicit univ_mss_coprocess( const std::string& _script ) :
+            pid_( -1 ),
+            to_child_( -1 ),
+            from_child_( -1 ),
+            next_id_( 0 ) {
+            int in_fd[2];
+            int out_fd[2];
+            if ( pipe( in_fd ) < 0 ) {
+                return;
+            }
+            if ( pipe( out_fd ) < 0 ) {
+                close( in_fd[0] );
+                close( in_fd[1] );
+                return;
+            }
+
+            const std::string path = std::string( CMD_DIR ) + "/" + _script;
+            // the open file limit is read before forking since only
+            // async-signal-safe calls are allowed in the child
+            const long max_fd = sysconf( _SC_OPEN_MAX );
+            pid_ = fork();
+            if ( 0 == pid_ ) {
+                dup2( in_fd[0], 0 );
+                dup2( out_fd[1], 1 );
+
+                // =-=-=-=-=-=-=-
+                // the script must not inherit the agent's sockets, database
+                // connection or open replicas
+                for ( long fd = max_fd > 0 ? max_fd - 1 : 1023; fd > 2; --fd ) {
+                    close( static_cast< int >( fd ) );
+                }
+
+                execl( path.c_str(), path.c_str(), "coprocess", static_cast< char* >( nullptr ) );
+                _exit( 127 );
+            }
+
+            close( in_fd[0] );
+            close( out_fd[1] );
+            if ( pid_ < 0 ) {
+                close( in_fd[1] );
+                close( out_fd[0] );
+                return;
+            }
+
+            to_child_   = in_fd[1];
+            from_child_ = out_fd[0];
+            rodsLog( LOG_DEBUG, "univ_mss_coprocess - started [%s] as pid [%d]", path.c_str(), pid_ );
+        }
+
+        ~univ_mss_coprocess() {
+            shutdown();
+        }
+
+        univ_mss_coprocess( const univ_mss_coprocess& ) = delete;
+        univ_mss_coprocess& operator=( const univ_mss_coprocess& ) = delete;
+
+        bool alive() const {
+            return pid_ > 0;
+        }
+
+        // =-=-=-=-=-=-=-
+        // send the "ping" request, returning true if the script answered it
+        bool ping() {
+            response resp;
+            const int id = submit( { "ping" } );
+            return id >= 0 && wait( id, resp );
+        }
+
+        // =-=-=-=-=-=-=-
+        // queue a request, returning its id or a negative value on failure
+        int submit( const std::vector< std::string >& _args ) {
+            if ( !alive() ) {
+                return -1;
+            }
+
+            const int id = next_id_++;
+            std::string frame = std::to_string( id ) + " " + std::to_string( _args.size() ) + "\n";
+            for ( auto&& arg : _args ) {
+                if ( arg.find( '\n' ) != std::string::npos ) {
+                    return -1;
+                }
+                frame += arg + "\n";
+            }
+
+            for ( std::size_t off = 0; off < frame.size(); ) {
+                const ssize_t n = write( to_child_, frame.data() + off, frame.size() - off );
+                if ( n < 0 ) {
+                    if ( EINTR == errno ) {
+                        continue;
+                    }
+                    shutdown();
+                    return -1;
+                }
+                off += n;
+            }
+
+            return id;
+        }
+
+        // =-=-=-=-=-=-=-
+        // block until the response to a submitted request arrives
+        bool wait( int _id, response& _resp ) {
+            while ( completed_.find( _id ) == completed_.end() ) {
+                std::string header;
+                if ( !read_line( header ) ) {
+                    shutdown();
+                    return false;
+                }
+
+                int id = 0, status = 0, count = 0;
+                if ( sscanf( header.c_str(), "%d %d %d", &id, &status, &count ) != 3 || count < 0 ) {
+                    rodsLog( LOG_ERROR, "univ_mss_coprocess - malformed response [%s]", header.c_str() );
+                    shutdown();
+                    return false;
+                }
+
+                response resp{ status, "" };
+                for ( int i = 0; i < count; ++i ) {
+                    std::string line;
+                    if ( !read_line( line ) ) {
+                        shutdown();
+                        return false;
+                    }
+                    resp.output += line + "\n";
+                }
+                completed_[ id ] = resp;
+            }
+
+            auto it = completed_.find( _id );
+            _resp = it->second;
+            completed_.erase( it );
+            return true;
+        }
+
+    private:
+        bool read_line( std::string& _line ) {
+            std::string::size_type pos;
+            while ( ( pos = buffer_.find( '\n' ) ) == std::string::npos ) {
+                char chunk[4096];
+                const ssize_t n = read( from_child_, chunk, sizeof( chunk ) );
+                if ( n < 0 && EINTR == errno ) {
+                    continue;
+                }
+                if ( n <= 0 ) {
+                    return false;
+                }
+                buffer_.append( chunk, n );
+            }
+
+            _line = buffer_.substr( 0, pos );
+            buffer_.erase( 0, pos + 1 );
+            return true;
+        }
+
+        void shutdown() {
+            if ( to_child_ >= 0 ) {
+                close( to_child_ );
+                to_child_ = -1;
+            }
+            if ( from_child_ >= 0 ) {
+                close( from_child_ );
+                from_child_ = -1;
+            }
+            if ( pid_ > 0 ) {
+                waitpid( pid_, nullptr, 0 );
+                pid_ = -1;
+            }
+            completed_.clear();
+            buffer_.clear();
+        }
+
+        pid_t                         pid_;
+        int                           to_child_;
+        int                           from_child_;
+        int                           next_id_;
+        std::string                   buffer_;
+        std::map< int, response >     completed_;
+
+}; // class univ_mss_coprocess
+
+/// =-=-=-=-=-=-=-
+/// @brief one coprocess per script for the lifetime of the agent
+std::map< std::string, std::unique_ptr< univ_mss_coprocess > > univ_mss_coprocesses;
+
+/// =-=-=-=-=-=-=-
+/// @brief scripts whose coprocess did not answer the "ping" request.  these
+///        do not support the coprocess protocol and are run with exec for
+///        the lifetime of the agent instead of being restarted per call.
+std::set< std::string > univ_mss_coprocess_unsupported;
+
+/// =-=-=-=-=-=-=-
+/// @brief run a batch of script requests.  resources configured with
+///        coprocess=on send all of them to the script's coprocess before
+///        waiting for the first response; otherwise, or if the coprocess
+///        is unusable, each request forks the script via _rsExecCmd.
+///        requests are of the form { operation, arguments... }.  the
+///        status of each request is placed in _status, with the stdout of
+///        the script in _output and the errno of a failed _rsExecCmd in
+///        _errno.  a request which was sent to the coprocess is never run
+///        again: if the coprocess dies before answering it, its outcome is
+///        unknown and it fails with EXEC_CMD_ERROR.  only the requests which
+///        were never sent fall back to _rsExecCmd.
+void univ_mss_exec_batch(
+    irods::plugin_context&                         _ctx,
+    const std::vector< std::vector< std::string > >& _requests,
+    std::vector< int >&                              _status,
+    std::vector< std::string >&                      _output,
+    std::vector< int >&                              _errno ) {
+    _status.assign( _requests.size(), SYS_INVALID_INPUT_PARAM );
+    _output.assign( _requests.size(), "" );
+    _errno.assign( _requests.size(), 0 );
+
+    std::string script;
+    irods::error err = _ctx.prop_map().get< std::string >( SCRIPT_PROP, script );
+    if ( !err.ok() ) {
+        irods::log( PASS( err ) );
+        return;
+    }
+
+    std::vector< bool > done( _requests.size(), false );
+
+    std::string coprocess;
+    const bool use_coprocess = _ctx.prop_map().get< std::string >( COPROCESS_KW, coprocess ).ok() &&
+                               "on" == coprocess &&
+                               univ_mss_coprocess_unsupported.count( script ) == 0;
+    if ( use_coprocess ) {
+        auto& started = univ_mss_coprocesses[ script ];
+        if ( !started || !started->alive() ) {
+            started = std::make_unique< univ_mss_coprocess >( script );
+            if ( !started->ping() ) {
+                rodsLog( LOG_NOTICE, "univ_mss_exec_batch - [%s] does not support coprocess mode, using exec",
+                         script.c_str() );
+                univ_mss_coprocess_unsupported.insert( script );
+                univ_mss_coprocesses.erase( script );
+            }
+        }
+
+        auto it = univ_mss_coprocesses.find( script );
+        if ( it != univ_mss_coprocesses.end() ) {
+            auto& cp = it->second;
+
+            // =-=-=-=-=-=-=-
+            // a request which could not be written in full was never seen
+            // by the script, and neither was any request after it
+            std::vector< int > ids;
+            for ( auto&& req : _requests ) {
+                ids.push_back( cp->submit( req ) );
+            }
+
+            bool lost = false;
+            for ( std::size_t i = 0; i < _requests.size(); ++i ) {
+                if ( ids[ i ] < 0 ) {
+                    continue;
+                }
+
+                univ_mss_coprocess::response resp;
+                if ( cp->wait( ids[ i ], resp ) ) {
+                    _status[ i ] = ( 0 == resp.status ) ? 0 : EXEC_CMD_ERROR;
+                    _output[ i ] = resp.output;
+                }
+                else {
+                    rodsLog( LOG_ERROR, "univ_mss_exec_batch - coprocess for [%s] failed before answering [%s], its outcome is unknown",
+                             script.c_str(), _requests[ i ].empty() ? "" : _requests[ i ][ 0 ].c_str() );
+                    _status[ i ] = EXEC_CMD_ERROR;
+                    lost = true;
+                }
+                done[ i ] = true;
+            }
+
+            if ( lost || std::find( done.begin(), done.end(), false ) != done.end() ) {
+                rodsLog( LOG_NOTICE, "univ_mss_exec_batch - coprocess for [%s] failed, requests which were not sent use exec",
+                         script.c_str() );
+            }
+        }
+    }
+
+    for ( std::size_t i = 0; i < _requests.size(); ++i ) {
+        if ( done[ i ] ) {
+            continue;
+        }
+
+        std::string cmd_argv = _requests[ i ].empty() ? "" : _requests[ i ][ 0 ];
+        for ( std::size_t a = 1; a < _requests[ i ].size(); ++a ) {
+            cmd_argv += " '" + _requests[ i ][ a ] + "'";
+        }
+
+        execCmd_t execCmdInp;
+        memset( &execCmdInp, 0, sizeof( execCmdInp ) );
+        snprintf( execCmdInp.cmd, sizeof( execCmdInp.cmd ), "%s", script.c_str() );
+        snprintf( execCmdInp.cmdArgv, sizeof( execCmdInp.cmdArgv ), "%s", cmd_argv.c_str() );
+        snprintf( execCmdInp.execAddr, sizeof( execCmdInp.execAddr ), "%s", "localhost" );
+
+        execCmdOut_t* execCmdOut = NULL;
+        _status[ i ] = _rsExecCmd( &execCmdInp, &execCmdOut );
+        if ( _status[ i ] < 0 ) {
+            _errno[ i ] = errno;
+        }
+        if ( NULL != execCmdOut && NULL != execCmdOut->stdoutBuf.buf ) {
+            _output[ i ].assign( static_cast< char* >( execCmdOut->stdoutBuf.buf ), execCmdOut->stdoutBuf.len );
+        }
+        freeCmdExecOut( execCmdOut );
+    }
+
+} // univ_mss_exec_batch
+
+/// =-=-=-=-=-=-=-
+/// @brief run a single script request, see univ_mss_exec_batch.  on
+///        failure errno is set to the errno of the failed _rsExecCmd.
+int univ_mss_exec(
+    irods::plugin_context&            _ctx,
+    const std::vector< std::string >& _request,
+    std::string*                      _output = nullptr ) {
+    std::vector< int >         status;
+    std::vector< std::string > output;
+    std::vector< int >         errnos;
+    univ_mss_exec_batch( _ctx, { _request }, status, output, errnos );
+    if ( _output ) {
+        *_output = output[ 0 ];
+    }
+    errno = errnos[ 0 ];
+    return status[ 0 ];
+
+} // univ_mss_exec
+
 /// =-=-=-=-=-=-=-
 /// @brief interface for POSIX create
 irods::error univ_mss_file_create(
@@ -117,28 +477,12 @@ irods::error univ_mss_file_unlink(
 
     }
 
-    // =-=-=-=-=-=-=-
-    // get the script property
-    std::string script;
-    err = _ctx.prop_map().get< std::string >( SCRIPT_PROP, script );
-    if ( !err.ok() ) {
-        return PASSMSG( __FUNCTION__, err );
-    }
-
     // =-=-=-=-=-=-=-
     // snag a ref to the fco
     irods::data_object_ptr fco = boost::dynamic_pointer_cast< irods::data_object >( _ctx.fco() );
     std::string filename = fco->physical_path();
 
-    execCmd_t execCmdInp;
-    memset( &execCmdInp, 0, sizeof( execCmdInp ) );
-    snprintf( execCmdInp.cmd, sizeof( execCmdInp.cmd ), "%s", script.c_str() );
-    snprintf( execCmdInp.cmdArgv, sizeof( execCmdInp.cmdArgv ), "rm '%s'", filename.c_str() );
-    snprintf( execCmdInp.execAddr, sizeof( execCmdInp.execAddr ), "localhost" );
-
-    execCmdOut_t *execCmdOut = NULL;
-    int status = _rsExecCmd( &execCmdInp, &execCmdOut );
-    freeCmdExecOut( execCmdOut );
+    int status = univ_mss_exec( _ctx, { "rm", filename } );
 
     if ( status < 0 ) {
         status = UNIV_MSS_UNLINK_ERR - errno;
@@ -169,14 +513,6 @@ irods::error univ_mss_file_stat(
 
     }
 
-    // =-=-=-=-=-=-=-
-    // get the script property
-    std::string script;
-    err = _ctx.prop_map().get< std::string >( SCRIPT_PROP, script );
-    if ( !err.ok() ) {
-        return PASSMSG( __FUNCTION__, err );
-    }
-
     // =-=-=-=-=-=-=-
     // snag a ref to the fco
     irods::data_object_ptr fco = boost::dynamic_pointer_cast< irods::data_object >( _ctx.fco() );
@@ -184,25 +520,17 @@ irods::error univ_mss_file_stat(
 
 
     int i, status;
-    execCmd_t execCmdInp;
-    char cmdArgv[HUGE_NAME_LEN] = "";
     const char *delim1 = ":\n";
     const char *delim2 = "-";
     const char *delim3 = ".";
-    execCmdOut_t *execCmdOut = NULL;
     struct tm mytm;
     time_t myTime;
 
-    bzero( &execCmdInp, sizeof( execCmdInp ) );
-    rstrcpy( execCmdInp.cmd, script.c_str(), LONG_NAME_LEN );
-    snprintf( cmdArgv, sizeof( cmdArgv ), "stat '%s' ", filename.c_str() );
-    rstrcpy( execCmdInp.cmdArgv, cmdArgv, HUGE_NAME_LEN );
-    rstrcpy( execCmdInp.execAddr, "localhost", LONG_NAME_LEN );
-    status = _rsExecCmd( &execCmdInp, &execCmdOut );
+    std::string outputStr;
+    status = univ_mss_exec( _ctx, { "stat", filename }, &outputStr );
 
-    if ( status == 0 && NULL != execCmdOut ) { // JMC cppcheck - nullptr
-        if ( execCmdOut->stdoutBuf.buf != NULL ) {
-            const std::string outputStr(static_cast<char*>(execCmdOut->stdoutBuf.buf), execCmdOut->stdoutBuf.len);
+    if ( status == 0 ) {
+        if ( !outputStr.empty() ) {
             std::vector<std::string> output_tokens;
             boost::algorithm::split( output_tokens, outputStr, boost::is_any_of( delim1 ) );
             _statbuf->st_dev = atoi( output_tokens[0].c_str() );
@@ -247,12 +575,10 @@ irods::error univ_mss_file_stat(
         msg << "univ_mss_file_stat - failed for [";
         msg << filename;
         msg << "]";
-        freeCmdExecOut( execCmdOut );
         return ERROR( status, msg.str() );
 
     }
 
-    freeCmdExecOut( execCmdOut );
     return CODE( status );
 
 } // univ_mss_file_stat
@@ -282,14 +608,6 @@ irods::error univ_mss_file_chmod(
 
     }
 
-    // =-=-=-=-=-=-=-
-    // get the script property
-    std::string script;
-    err = _ctx.prop_map().get< std::string >( SCRIPT_PROP, script );
-    if ( !err.ok() ) {
-        return PASSMSG( __FUNCTION__, err );
-    }
-
     // =-=-=-=-=-=-=-
     // snag a ref to the fco
     irods::data_object_ptr fco = boost::dynamic_pointer_cast< irods::data_object >( _ctx.fco() );
@@ -297,19 +615,14 @@ irods::error univ_mss_file_chmod(
 
     int mode = fco->mode();
     int status = 0;
-    execCmd_t execCmdInp;
 
     if ( mode != getDefDirMode() ) {
         mode = getDefFileMode();
     }
 
-    bzero( &execCmdInp, sizeof( execCmdInp ) );
-    snprintf( execCmdInp.cmd, sizeof( execCmdInp.cmd ), "%s", script.c_str() );
-    snprintf( execCmdInp.cmdArgv, sizeof( execCmdInp.cmdArgv ), "chmod '%s' %o", filename.c_str(), mode );
-    snprintf( execCmdInp.execAddr, sizeof( execCmdInp.execAddr ), "%s", "localhost" );
-    execCmdOut_t *execCmdOut = NULL;
-    status = _rsExecCmd( &execCmdInp, &execCmdOut );
-    freeCmdExecOut( execCmdOut );
+    char mode_str[NAME_LEN];
+    snprintf( mode_str, sizeof( mode_str ), "%o", mode );
+    status = univ_mss_exec( _ctx, { "chmod", filename, mode_str } );
 
     if ( status < 0 ) {
         status = UNIV_MSS_CHMOD_ERR - errno;
@@ -340,43 +653,46 @@ irods::error univ_mss_file_mkdir(
 
     }
 
-    // =-=-=-=-=-=-=-
-    // get the script property
-    std::string script;
-    err = _ctx.prop_map().get< std::string >( SCRIPT_PROP, script );
-    if ( !err.ok() ) {
-        return PASSMSG( __FUNCTION__, err );
-    }
-
     // =-=-=-=-=-=-=-
     // snag a ref to the fco
     irods::collection_object_ptr fco = boost::dynamic_pointer_cast< irods::collection_object >( _ctx.fco() );
     std::string dirname = fco->physical_path();
 
-    int status = 0;
-    execCmd_t execCmdInp;
-
-    bzero( &execCmdInp, sizeof( execCmdInp ) );
-    snprintf( execCmdInp.cmd, sizeof( execCmdInp.cmd ), "%s", script.c_str() );
-    snprintf( execCmdInp.cmdArgv, sizeof( execCmdInp.cmdArgv ), "mkdir '%s'", dirname.c_str() );
-    snprintf( execCmdInp.execAddr, sizeof( execCmdInp.execAddr ), "%s", "localhost" );
-    execCmdOut_t *execCmdOut = NULL;
-    status = _rsExecCmd( &execCmdInp, &execCmdOut );
-    freeCmdExecOut( execCmdOut );
-    if ( status < 0 ) {
-        status = UNIV_MSS_MKDIR_ERR - errno;
+    int mode = getDefDirMode();
+    fco->mode( mode );
+
+    char mode_str[NAME_LEN];
+    snprintf( mode_str, sizeof( mode_str ), "%o", mode );
+
+    // =-=-=-=-=-=-=-
+    // the chmod is pipelined behind the mkdir.  the script handles
+    // requests in order so the directory exists by the time it runs.
+    std::vector< int >         status;
+    std::vector< std::string > output;
+    std::vector< int >         errnos;
+    univ_mss_exec_batch(
+        _ctx,
+        { { "mkdir", dirname }, { "chmod", dirname, mode_str } },
+        status,
+        output,
+        errnos );
+    if ( status[ 0 ] < 0 ) {
         std::stringstream msg;
         msg << "univ_mss_file_mkdir - mkdir failed for [";
         msg << dirname;
         msg << "]";
-        return ERROR( status, msg.str() );
+        return ERROR( UNIV_MSS_MKDIR_ERR - errnos[ 0 ], msg.str() );
     }
 
-    int mode = getDefDirMode();
-    fco->mode( mode );
-    err = univ_mss_file_chmod( _ctx );
+    if ( status[ 1 ] < 0 ) {
+        std::stringstream msg;
+        msg << "univ_mss_file_chmod - failed for [";
+        msg << dirname;
+        msg << "]";
+        return ERROR( UNIV_MSS_CHMOD_ERR - errnos[ 1 ], msg.str() );
+    }
 
-    return err;
+    return CODE( status[ 1 ] );
 
 } // univ_mss_file_mkdir
 
@@ -429,14 +745,6 @@ irods::error univ_mss_file_rename(
 
     }
 
-    // =-=-=-=-=-=-=-
-    // get the script property
-    std::string script;
-    err = _ctx.prop_map().get< std::string >( SCRIPT_PROP, script );
-    if ( !err.ok() ) {
-        return PASSMSG( __FUNCTION__, err );
-    }
-
     // =-=-=-=-=-=-=-
     // snag a ref to the fco
     irods::file_object_ptr fco = boost::dynamic_pointer_cast< irods::file_object >( _ctx.fco() );
@@ -465,15 +773,7 @@ irods::error univ_mss_file_rename(
     int status = 0;
     err = univ_mss_file_mkdir( context );
 
-    execCmd_t execCmdInp;
-
-    bzero( &execCmdInp, sizeof( execCmdInp ) );
-    snprintf( execCmdInp.cmd, sizeof( execCmdInp.cmd ), "%s", script.c_str() );
-    snprintf( execCmdInp.cmdArgv, sizeof( execCmdInp.cmdArgv ), "mv '%s' '%s'", filename.c_str(), _new_file_name );
-    snprintf( execCmdInp.execAddr, sizeof( execCmdInp.execAddr ), "%s", "localhost" );
-    execCmdOut_t *execCmdOut = NULL;
-    status = _rsExecCmd( &execCmdInp, &execCmdOut );
-    freeCmdExecOut( execCmdOut );
+    status = univ_mss_exec( _ctx, { "mv", filename, _new_file_name } );
 
     if ( status < 0 ) {
         status = UNIV_MSS_RENAME_ERR - errno;
@@ -531,28 +831,7 @@ irods::error univ_mss_file_stage_to_cache(
     irods::file_object_ptr fco = boost::dynamic_pointer_cast< irods::file_object >( _ctx.fco() );
     std::string filename = fco->physical_path();
 
-    // =-=-=-=-=-=-=-
-    // get the script property
-    std::string script;
-    err = _ctx.prop_map().get< std::string >( SCRIPT_PROP, script );
-    if ( !err.ok() ) {
-        return PASSMSG( __FUNCTION__, err );
-    }
-
-    int status = 0;
-
-    std::stringstream cmdArgv;
-    cmdArgv << "stageToCache '" << filename << "' '" << _cache_file_name << "'";
-
-    execCmd_t execCmdInp;
-    bzero( &execCmdInp, sizeof( execCmdInp ) );
-    snprintf( execCmdInp.cmd, sizeof( execCmdInp.cmd ), "%s",  script.c_str() );
-    snprintf( execCmdInp.cmdArgv, sizeof( execCmdInp.cmdArgv ), "%s", cmdArgv.str().c_str() );
-    snprintf( execCmdInp.execAddr, sizeof( execCmdInp.execAddr ), "%s", "localhost" );
-
-    execCmdOut_t *execCmdOut = NULL;
-    status = _rsExecCmd( &execCmdInp, &execCmdOut );
-    freeCmdExecOut( execCmdOut );
+    int status = univ_mss_exec( _ctx, { "stageToCache", filename, _cache_file_name } );
 
     if ( status < 0 ) {
         status = UNIV_MSS_STAGETOCACHE_ERR - errno;
@@ -615,22 +894,8 @@ irods::error univ_mss_file_sync_to_arch(
     int status = 0;
     err = univ_mss_file_mkdir( context );
 
-    execCmdOut_t* execCmdOut = NULL;
-
-    // =-=-=-=-=-=-=-
-    // get the script property
-    std::string script;
-    err = _ctx.prop_map().get< std::string >( SCRIPT_PROP, script );
-    if ( !err.ok() ) {
-        return PASSMSG( __FUNCTION__, err );
-    }
-
-    execCmd_t execCmdInp;
-    bzero( &execCmdInp, sizeof( execCmdInp ) );
-    rstrcpy( execCmdInp.cmd, script.c_str(), LONG_NAME_LEN );
-    snprintf( execCmdInp.cmdArgv, sizeof( execCmdInp.cmdArgv ), "syncToArch %s %s", _cache_file_name, filename.c_str() );
-    rstrcpy( execCmdInp.execAddr, "localhost", LONG_NAME_LEN );
-    status = _rsExecCmd( &execCmdInp, &execCmdOut );
+    std::string output;
+    status = univ_mss_exec( _ctx, { "syncToArch", _cache_file_name, filename }, &output );
     if ( status == 0 ) {
         err = univ_mss_file_chmod( _ctx );
         if ( !err.ok() ) {
@@ -646,12 +911,8 @@ irods::error univ_mss_file_sync_to_arch(
         msg << filename;
         msg << "] failed.";
         msg << "   stdout buff [";
-        msg << execCmdOut->stdoutBuf.buf;
-        msg << "]   stderr buff [";
-        msg << execCmdOut->stderrBuf.buf;
-        msg << "]  status [";
-        msg << execCmdOut->status << "]";
-        freeCmdExecOut( execCmdOut );
+        msg << output;
+        msg << "]";
         return ERROR( status, msg.str() );
     }
 
@@ -757,19 +1018,37 @@ class univ_mss_resource : public irods::resource {
                            const std::string& _context ) :
             irods::resource( _inst_name, _context ) {
 
+            // =-=-=-=-=-=-=-
+            // the context string is the script name, optionally followed
+            // by options, e.g. "univMSSInterface.sh;coprocess=on"
+            std::string script = context_;
+            const std::string::size_type pos = context_.find( ';' );
+            if ( std::string::npos != pos ) {
+                script = context_.substr( 0, pos );
+
+                irods::kvp_map_t kvp;
+                irods::error ret = irods::parse_kvp_string( context_.substr( pos + 1 ), kvp );
+                if ( !ret.ok() ) {
+                    rodsLog( LOG_ERROR, "univmss resource :: invalid context [%s]", context_.c_str() );
+                }
+                else if ( kvp.find( COPROCESS_KW ) != kvp.end() ) {
+                    properties_.set< std::string >( COPROCESS_KW, kvp[ COPROCESS_KW ] );
+                }
+            }
+
             // =-=-=-=-=-=-=-
             // check the context string for inappropriate path behavior
-            if ( context_.find( "/" ) != std::string::npos ) {
+            if ( script.find( "/" ) != std::string::npos ) {
                 std::stringstream msg;
                 msg << "univmss resource :: the path [";
-                msg << context_;
+                msg << script;
                 msg << "] should be a single file name which should reside in msiExecCmd_bin";
                 rodsLog( LOG_ERROR, "[%s]", msg.str().c_str() );
             }
 
             // =-=-=-=-=-=-=-
             // assign context string as the univ mss script to call
-            properties_.set< std::string >( SCRIPT_PROP, context_ );
+            properties_.set< std::string >( SCRIPT_PROP, script );
         }
 
         // =-=-=-=-=-=-
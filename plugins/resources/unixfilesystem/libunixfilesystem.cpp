@@ -19,13 +19,23 @@
 #include "irods_kvp_string_parser.hpp"
 #include "irods_logger.hpp"
 #include "voting.hpp"
+#include "server_utilities.hpp"
+#include "resource_free_space_tracker.hpp"
+#include "irods_at_scope_exit.hpp"
+#include "client_connection.hpp"
 
 // =-=-=-=-=-=-=-
 // stl includes
 #include <iostream>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 #include <string>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <future>
+#include <limits>
 
 // =-=-=-=-=-=-=-
 // boost includes
@@ -83,6 +93,210 @@
 const std::string DEFAULT_VAULT_DIR_MODE( "default_vault_directory_mode_kw" );
 const std::string HIGH_WATER_MARK( "high_water_mark" ); // no longer used
 const std::string REQUIRED_FREE_INODES_FOR_CREATE("required_free_inodes_for_create"); // no longer used
+const std::string ASYNC_IO_KW( "async_io" );
+const std::string ASYNC_IO_WINDOW_SIZE_KW( "async_io_window_size" );
+const std::string ASYNC_IO_QUEUE_DEPTH_KW( "async_io_queue_depth" );
+
+const off_t ASYNC_IO_DEFAULT_WINDOW_SIZE = 4 * 1024 * 1024;
+const int   ASYNC_IO_DEFAULT_QUEUE_DEPTH = 4;
+
+// =-=-=-=-=-=-=-
+// resources configured with a free_space_refresh_interval (in seconds)
+// check creates against free space tracked in shared memory rather than
+// calling statfs each time.  free_space_publish=on also pushes each new
+// measurement to the catalog's free space column.
+const std::string FREE_SPACE_REFRESH_INTERVAL_KW( "free_space_refresh_interval" );
+const std::string FREE_SPACE_PUBLISH_KW( "free_space_publish" );
+
+namespace fst = irods::experimental::resource_free_space_tracker;
+
+// =-=-=-=-=-=-=-
+// per descriptor read-ahead / write-behind bookkeeping for resources
+// configured with async_io=on.  reads hint the kernel about the next
+// queue_depth windows of a sequential stream; writes start writeback
+// of each completed window and only wait once more than queue_depth
+// windows are in flight.  all outstanding data is flushed at close.
+//
+// the state is keyed by the native descriptor and remembers the physical
+// path it was opened for, so a descriptor number reused for another file
+// never picks up the windows of a stream whose close was not seen here.
+struct async_io_stream_t {
+    std::string physical_path;
+    off_t       window_size;
+    int         queue_depth;
+    off_t       read_ahead_end;
+    off_t       write_behind_start;
+    off_t       write_behind_end;
+    bool        dirty;
+};
+
+std::map< int, async_io_stream_t > async_io_streams;
+std::mutex                         async_io_streams_mutex;
+
+void async_io_unregister_stream(
+    int _fd ) {
+    std::lock_guard< std::mutex > lock( async_io_streams_mutex );
+    async_io_streams.erase( _fd );
+
+} // async_io_unregister_stream
+
+// =-=-=-=-=-=-=-
+// find the state of a stream, dropping it if the descriptor now belongs
+// to another file.  the caller must hold async_io_streams_mutex
+async_io_stream_t* async_io_find_stream(
+    int                _fd,
+    const std::string& _physical_path ) {
+    auto itr = async_io_streams.find( _fd );
+    if ( async_io_streams.end() == itr ) {
+        return nullptr;
+    }
+
+    if ( itr->second.physical_path != _physical_path ) {
+        async_io_streams.erase( itr );
+        return nullptr;
+    }
+
+    return &itr->second;
+
+} // async_io_find_stream
+
+void async_io_register_stream(
+    irods::plugin_context& _ctx,
+    int                    _fd,
+    const std::string&     _physical_path ) {
+    // =-=-=-=-=-=-=-
+    // the descriptor may be a reused one, never carry over another stream's state
+    async_io_unregister_stream( _fd );
+
+    std::string mode;
+    if ( !_ctx.prop_map().get< std::string >( ASYNC_IO_KW, mode ).ok() ||
+         ( mode != "on" && mode != "yes" && mode != "true" ) ) {
+        return;
+    }
+
+    async_io_stream_t stream{ _physical_path, ASYNC_IO_DEFAULT_WINDOW_SIZE, ASYNC_IO_DEFAULT_QUEUE_DEPTH, 0, 0, 0, false };
+
+    std::string value;
+    try {
+        if ( _ctx.prop_map().get< std::string >( ASYNC_IO_WINDOW_SIZE_KW, value ).ok() ) {
+            stream.window_size = std::max< off_t >( std::stoll( value ), 64 * 1024 );
+        }
+        if ( _ctx.prop_map().get< std::string >( ASYNC_IO_QUEUE_DEPTH_KW, value ).ok() ) {
+            stream.queue_depth = std::max( std::stoi( value ), 1 );
+        }
+    }
+    catch ( const std::exception& ) {
+        rodsLog( LOG_ERROR, "%s: invalid async_io setting [%s], using defaults", __FUNCTION__, value.c_str() );
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise( _fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+#endif
+
+    std::lock_guard< std::mutex > lock( async_io_streams_mutex );
+    async_io_streams[ _fd ] = stream;
+
+} // async_io_register_stream
+
+void async_io_after_read(
+    int                _fd,
+    const std::string& _physical_path ) {
+    std::lock_guard< std::mutex > lock( async_io_streams_mutex );
+    async_io_stream_t* found = async_io_find_stream( _fd, _physical_path );
+    if ( !found ) {
+        return;
+    }
+
+    async_io_stream_t& stream = *found;
+    const off_t pos = lseek( _fd, 0, SEEK_CUR );
+    if ( pos < 0 ) {
+        return;
+    }
+
+    // =-=-=-=-=-=-=-
+    // a seek outside the current read-ahead restarts it at the new position
+    const off_t ahead = stream.window_size * stream.queue_depth;
+    if ( pos > stream.read_ahead_end || pos + ahead < stream.read_ahead_end ) {
+        stream.read_ahead_end = pos;
+    }
+
+    // =-=-=-=-=-=-=-
+    // top the read-ahead back up once a full window has been consumed
+    if ( stream.read_ahead_end - pos <= ahead - stream.window_size ) {
+#ifdef POSIX_FADV_WILLNEED
+        posix_fadvise( _fd, stream.read_ahead_end, pos + ahead - stream.read_ahead_end, POSIX_FADV_WILLNEED );
+#endif
+        stream.read_ahead_end = pos + ahead;
+    }
+
+} // async_io_after_read
+
+void async_io_after_write(
+    int                _fd,
+    const std::string& _physical_path ) {
+    std::lock_guard< std::mutex > lock( async_io_streams_mutex );
+    async_io_stream_t* found = async_io_find_stream( _fd, _physical_path );
+    if ( !found ) {
+        return;
+    }
+
+    async_io_stream_t& stream = *found;
+    stream.dirty = true;
+
+    const off_t pos = lseek( _fd, 0, SEEK_CUR );
+    if ( pos < 0 ) {
+        return;
+    }
+
+    // =-=-=-=-=-=-=-
+    // non-sequential writes are left to the page cache and flushed at close
+    if ( pos < stream.write_behind_end ) {
+        stream.write_behind_start = pos;
+        stream.write_behind_end   = pos;
+        return;
+    }
+
+#ifdef SYNC_FILE_RANGE_WRITE
+    if ( pos - stream.write_behind_end >= stream.window_size ) {
+        sync_file_range( _fd, stream.write_behind_end, pos - stream.write_behind_end, SYNC_FILE_RANGE_WRITE );
+        stream.write_behind_end = pos;
+    }
+
+    // =-=-=-=-=-=-=-
+    // apply back-pressure once more than queue_depth windows are in flight.
+    // only the windows beyond the queue depth are waited on, so a writer
+    // that keeps up with the disk never blocks here
+    const off_t in_flight = stream.window_size * stream.queue_depth;
+    if ( stream.write_behind_end - stream.write_behind_start > in_flight ) {
+        const off_t wait_end = stream.write_behind_end - in_flight;
+        sync_file_range( _fd, stream.write_behind_start, wait_end - stream.write_behind_start,
+                         SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER );
+        stream.write_behind_start = wait_end;
+    }
+#endif
+
+} // async_io_after_write
+
+int async_io_before_close(
+    int                _fd,
+    const std::string& _physical_path ) {
+    bool dirty = false;
+    {
+        std::lock_guard< std::mutex > lock( async_io_streams_mutex );
+        const async_io_stream_t* found = async_io_find_stream( _fd, _physical_path );
+        if ( !found ) {
+            return 0;
+        }
+        dirty = found->dirty;
+        async_io_streams.erase( _fd );
+    }
+
+    // =-=-=-=-=-=-=-
+    // writeback was started out of order, so make everything durable
+    // before the close is reported
+    return dirty ? fsync( _fd ) : 0;
+
+} // async_io_before_close
 
 // =-=-=-=-=-=-=-
 // NOTE: All storage resources must do this on the physical path stored in the file object and then update
@@ -134,17 +348,41 @@ static irods::error unix_file_copy(
             destFileName, err_status));
     }
 
+    // Share the extents of the source if both vaults are on a filesystem which
+    // supports reflinks, otherwise let the kernel copy the data. Large files are
+    // split into chunks which are copied concurrently.
+    if ( irods::reflink_file( inFd, outFd ) ) {
+        return SUCCESS();
+    }
+
     size_t trans_buff_size;
+    int copy_threads;
     try {
         trans_buff_size = irods::get_advanced_setting<const int>(irods::CFG_TRANS_BUFFER_SIZE_FOR_PARA_TRANS) * 1024 * 1024;
+        const rodsLong_t chunk_size = irods::get_advanced_setting<const int>(irods::CFG_TRANS_CHUNK_SIZE_PARA_TRANS) * 1024 * 1024;
+        copy_threads = std::clamp<rodsLong_t>(
+            statbuf.st_size / std::max<rodsLong_t>( chunk_size, 1 ),
+            1,
+            irods::get_advanced_setting<const int>(irods::CFG_DEF_NUMBER_TRANSFER_THREADS) );
     }
     catch ( const irods::exception& e ) {
         return irods::error(e);
     }
 
+    rodsLong_t bytesCopied = irods::copy_file_range_in_kernel( inFd, outFd, 0, statbuf.st_size, copy_threads );
+    if ( bytesCopied == statbuf.st_size ) {
+        return SUCCESS();
+    }
+
+    // Fall back to copying the rest through a buffer.
+    if ( lseek( inFd, bytesCopied, SEEK_SET ) < 0 || lseek( outFd, bytesCopied, SEEK_SET ) < 0 ) {
+        return ERROR(UNIX_FILE_LSEEK_ERR - errno, fmt::format(
+            "lseek failed for \"{}\" or \"{}\" at offset {}",
+            srcFileName, destFileName, bytesCopied));
+    }
+
     std::vector<char> myBuf( trans_buff_size );
     int bytesRead{};
-    rodsLong_t bytesCopied = 0;
     while ( ( bytesRead = read( inFd, ( void * ) myBuf.data(), trans_buff_size ) ) > 0 ) {
         int bytesWritten = write( outFd, ( void * ) myBuf.data(), bytesRead );
         err_status = UNIX_FILE_WRITE_ERR - errno;
@@ -423,6 +661,127 @@ defined(linux_platform)
 
 } // unix_file_getfs_freespace
 
+// =-=-=-=-=-=-=-
+// returns the free space refresh interval of the resource, or 0 when
+// free space is not tracked
+std::time_t free_space_refresh_interval(
+    irods::plugin_context& _ctx ) {
+    std::string value;
+    if ( !_ctx.prop_map().get< std::string >( FREE_SPACE_REFRESH_INTERVAL_KW, value ).ok() ) {
+        return 0;
+    }
+
+    try {
+        return std::max< std::time_t >( 0, std::stol( value ) );
+    }
+    catch ( const std::exception& ) {
+        rodsLog( LOG_ERROR, "%s: invalid value [%s] for [%s]",
+                 __FUNCTION__, value.c_str(), FREE_SPACE_REFRESH_INTERVAL_KW.c_str() );
+    }
+
+    return 0;
+
+} // free_space_refresh_interval
+
+// =-=-=-=-=-=-=-
+// the publication in flight, if any.  an agent publishes at most one
+// measurement at a time, the destructor waits for it at exit.
+static std::future< void > free_space_publisher;
+
+// =-=-=-=-=-=-=-
+// push a free space measurement to the catalog.  the update is sent from
+// a background thread over a connection of the service account so the
+// create which measured does not wait on the catalog.  failures are logged
+// and otherwise ignored, the measurement stays in the tracker.
+void publish_free_space(
+    irods::plugin_context& _ctx,
+    const std::string&     _resc_name,
+    rodsLong_t             _free_space ) {
+    std::string publish;
+    if ( !_ctx.prop_map().get< std::string >( FREE_SPACE_PUBLISH_KW, publish ).ok() || "on" != publish ) {
+        return;
+    }
+
+    // =-=-=-=-=-=-=-
+    // the previous publication is still running, the next refresh
+    // will publish a newer measurement anyway
+    if ( free_space_publisher.valid() &&
+         free_space_publisher.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready ) {
+        return;
+    }
+
+    free_space_publisher = std::async( std::launch::async, [resc_name = _resc_name, _free_space] {
+        const std::string free_space = std::to_string( _free_space );
+
+        generalAdminInp_t admin_inp{};
+        admin_inp.arg0 = "modify";
+        admin_inp.arg1 = "resource";
+        admin_inp.arg2 = resc_name.c_str();
+        admin_inp.arg3 = "freespace";
+        admin_inp.arg4 = free_space.c_str();
+
+        int status = 0;
+
+        try {
+            irods::experimental::client_connection conn;
+            status = rcGeneralAdmin( static_cast< rcComm_t* >( conn ), &admin_inp );
+        }
+        catch ( const irods::exception& e ) {
+            status = e.code();
+        }
+
+        if ( status < 0 ) {
+            rodsLog( LOG_NOTICE, "publish_free_space: failed to publish free space for [%s], status = %d",
+                     resc_name.c_str(), status );
+        }
+    } );
+
+} // publish_free_space
+
+// =-=-=-=-=-=-=-
+// determine the free space available for a create, using the shared
+// free space tracker when the resource is configured for it.  only one
+// agent at a time measures and publishes a resource, the others use the
+// last measurement while the refresh is in progress.
+irods::error unix_file_tracked_freespace(
+    irods::plugin_context& _ctx ) {
+    const std::time_t interval = free_space_refresh_interval( _ctx );
+    if ( interval <= 0 ) {
+        return unix_file_getfs_freespace( _ctx );
+    }
+
+    const std::string resc_name = irods::get_resource_name( _ctx );
+    if ( const auto free_space = fst::lookup( resc_name, interval ); free_space ) {
+        return CODE( *free_space );
+    }
+
+    // =-=-=-=-=-=-=-
+    // without an earlier measurement to fall back on, every agent
+    // measures for itself but only the refreshing agent records it
+    const bool refresher = fst::try_claim_refresh( resc_name, interval );
+    if ( !refresher ) {
+        if ( const auto free_space = fst::lookup( resc_name, std::numeric_limits< std::time_t >::max() ); free_space ) {
+            return CODE( *free_space );
+        }
+    }
+
+    irods::error ret = unix_file_getfs_freespace( _ctx );
+    if ( !refresher ) {
+        return ret;
+    }
+
+    if ( !ret.ok() ) {
+        fst::release_refresh( resc_name );
+        return ret;
+    }
+
+    fst::update( resc_name, ret.code() );
+    publish_free_space( _ctx, resc_name, ret.code() );
+
+    return ret;
+
+} // unix_file_tracked_freespace
+
 irods::error stat_vault_path(
     const std::string& _path,
     struct statfs&     _sb ) {
@@ -520,7 +879,7 @@ irods::error unix_file_create(
             }
         }
 
-        ret = unix_file_getfs_freespace( _ctx );
+        ret = unix_file_tracked_freespace( _ctx );
         if ( ( result = ASSERT_PASS( ret, "Error determining freespace on system." ) ).ok() ) {
             rodsLong_t file_size = fco->size();
             if ( ( result = ASSERT_ERROR( file_size < 0 || ret.code() >= file_size, USER_FILE_TOO_LARGE, "File size: %ld is greater than space left on device: %ld",
@@ -574,6 +933,8 @@ irods::error unix_file_create(
                     irods::log(result);
                 }
                 else {
+                    async_io_register_stream( _ctx, fd, fco->physical_path() );
+
                     // =-=-=-=-=-=-=-
                     // cache file descriptor in out-variable
                     fco->file_descriptor( fd );
@@ -671,6 +1032,8 @@ irods::error unix_file_open(
             result = ERROR( status, msg.str() );
         }
         else {
+            async_io_register_stream( _ctx, fd, fco->physical_path() );
+
             // =-=-=-=-=-=-=-
             // cache status in the file object
             fco->file_descriptor( fd );
@@ -713,6 +1076,7 @@ irods::error unix_file_read(
             result.code( err_status );
         }
         else {
+            async_io_after_read( fco->file_descriptor(), fco->physical_path() );
             result.code( status );
         }
     }
@@ -752,6 +1116,15 @@ irods::error unix_file_write(
             result.code( err_status );
         }
         else {
+            async_io_after_write( fco->file_descriptor(), fco->physical_path() );
+
+            // =-=-=-=-=-=-=-
+            // optimistically account for the bytes written until the
+            // next measurement of the free space
+            if ( free_space_refresh_interval( _ctx ) > 0 ) {
+                fst::consume( irods::get_resource_name( _ctx ), status );
+            }
+
             result.code( status );
         }
     }
@@ -777,6 +1150,18 @@ irods::error unix_file_close(
         // get ref to fco
         irods::file_object_ptr fco = boost::dynamic_pointer_cast< irods::file_object >( _ctx.fco() );
 
+        // =-=-=-=-=-=-=-
+        // flush any write-behind before the close is reported.  this also
+        // forgets the stream, on success and on error alike
+        int sync_status = async_io_before_close( fco->file_descriptor(), fco->physical_path() );
+        int sync_err = UNIX_FILE_FSYNC_ERR - errno;
+        if ( !( result = ASSERT_ERROR( sync_status >= 0, sync_err, "Fsync error for file: \"%s\", errno = \"%s\", status = %d.",
+                                       fco->physical_path().c_str(), strerror( errno ), sync_err ) ).ok() ) {
+            close( fco->file_descriptor() );
+            result.code( sync_err );
+            return result;
+        }
+
         // =-=-=-=-=-=-=-
         // make the call to close
         int status = close( fco->file_descriptor() );
@@ -792,6 +1177,11 @@ irods::error unix_file_close(
             result.code( status );
         }
     }
+    else if ( irods::file_object_ptr fco = boost::dynamic_pointer_cast< irods::file_object >( _ctx.fco() ) ) {
+        // =-=-=-=-=-=-=-
+        // the descriptor stays open, but the caller is done with the stream
+        async_io_unregister_stream( fco->file_descriptor() );
+    }
 
     return result;
 
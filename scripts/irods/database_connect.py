@@ -295,6 +295,20 @@ def get_schema_version_in_database(cursor):
 
     return schema_version
 
+def populate_effective_access(cursor):
+    # R_OBJT_ACCESS_EFFECTIVE holds the highest access each user has to each
+    # object, either directly or through one of its groups.
+    execute_sql_statement(cursor, "delete from R_OBJT_ACCESS_EFFECTIVE;")
+    execute_sql_statement(cursor,
+            "insert into R_OBJT_ACCESS_EFFECTIVE (user_id, object_id, access_type_id) "
+            "select UG.user_id, OA.object_id, max(OA.access_type_id) from R_OBJT_ACCESS OA, R_USER_GROUP UG, R_USER_MAIN UM "
+            "where UG.group_user_id = OA.user_id and UM.user_id = UG.user_id and UM.user_type_name != 'rodsgroup' "
+            "group by UG.user_id, OA.object_id;")
+    # The database plugin only uses the table for access checks while this row
+    # exists. Servers running without "db_effective_access_index" remove it.
+    execute_sql_statement(cursor, "delete from R_GRID_CONFIGURATION where namespace = 'database' and option_name = 'effective_access_index_valid';")
+    execute_sql_statement(cursor, "insert into R_GRID_CONFIGURATION values ( 'database', 'effective_access_index_valid', 'true' );")
+
 def sync_odbc_ini(irods_config):
     odbc_dict = get_odbc_entry(irods_config.database_config, irods_config.catalog_database_type)
 
@@ -479,6 +493,8 @@ def setup_database_values(irods_config, cursor=None, default_resource_directory=
                 timestamp,
                 timestamp)
 
+    populate_effective_access(cursor)
+
     #bundle resource
     bundle_resc_id = get_next_object_id()
     execute_sql_statement(cursor,
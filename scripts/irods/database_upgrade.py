@@ -101,6 +101,15 @@ def run_update(irods_config, cursor):
             # TEXT has no upper limit on the number of bytes it can hold.
             database_connect.execute_sql_statement(cursor, "alter table R_RULE_EXEC add column exe_context text;")
 
+    elif new_schema_version == 9:
+        # Add the table of effective permissions used by the database plugin when
+        # "db_effective_access_index" is enabled.
+        int64_type = 'integer' if irods_config.catalog_database_type == 'oracle' else 'bigint'
+        database_connect.execute_sql_statement(cursor, "create table R_OBJT_ACCESS_EFFECTIVE ( user_id {0} not null, object_id {0} not null, access_type_id {0} not null);".format(int64_type))
+        database_connect.execute_sql_statement(cursor, "create unique index idx_objt_access_effective1 on R_OBJT_ACCESS_EFFECTIVE (user_id,object_id);")
+        database_connect.execute_sql_statement(cursor, "create index idx_objt_access_effective2 on R_OBJT_ACCESS_EFFECTIVE (object_id);")
+        database_connect.populate_effective_access(cursor)
+
     else:
         raise IrodsError('Upgrade to schema version %d is unsupported.' % (new_schema_version))
 
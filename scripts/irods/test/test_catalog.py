@@ -15,6 +15,7 @@ from .. import lib
 from .. import paths
 from ..test.command import assert_command
 from ..configuration import IrodsConfig
+from ..controller import IrodsController
 
 
 class Test_Catalog(ResourceBase, unittest.TestCase):
@@ -307,3 +308,95 @@ class Test_CatalogPermissions(ResourceBase, unittest.TestCase):
         self.user0.assert_icommand('isysmeta ls testfile.txt', 'STDOUT_SINGLELINE',
                                    'data_expiry_ts (expire time): 00000000000: None')  # initialized with zeros
         self.user0.assert_icommand('isysmeta mod testfile.txt 1', 'STDERR_SINGLELINE', 'CAT_NO_ACCESS_PERMISSION')  # cannot set expiry
+
+class Test_EffectiveAccessIndex(ResourceBase, unittest.TestCase):
+
+    def setUp(self):
+        super(Test_EffectiveAccessIndex, self).setUp()
+        self.group = 'effective_access_group'
+        self.data_object = 'effective_access_object'
+        self.admin.assert_icommand(['iadmin', 'mkgroup', self.group])
+        self.user0.assert_icommand(['iput', self.testfile, self.data_object])
+
+    def tearDown(self):
+        self.user0.run_icommand(['irm', '-f', self.data_object])
+        self.admin.run_icommand(['iadmin', 'rmgroup', self.group])
+        super(Test_EffectiveAccessIndex, self).tearDown()
+
+    def set_effective_access_index(self, enabled):
+        config = IrodsConfig()
+        database_config = config.server_config['plugin_configuration']['database']
+        for db_type in database_config:
+            database_config[db_type]['db_effective_access_index'] = enabled
+        lib.update_json_file_from_dict(paths.server_config_path(), config.server_config)
+        IrodsController().restart()
+
+    def assert_user1_can_see_data_object(self, visible):
+        query = "select DATA_NAME where COLL_NAME = '{0}' and DATA_NAME = '{1}'".format(self.user0.session_collection, self.data_object)
+        if visible:
+            self.user1.assert_icommand(['iquest', '%s', query], 'STDOUT_SINGLELINE', self.data_object)
+        else:
+            self.user1.assert_icommand(['iquest', '%s', query], 'STDOUT_SINGLELINE', 'CAT_NO_ROWS_FOUND')
+
+    def test_general_queries_honor_grants_made_while_the_index_was_disabled(self):
+        core_re_path = os.path.join(IrodsConfig().core_re_directory, 'core.re')
+        with lib.file_backed_up(paths.server_config_path()):
+            with lib.file_backed_up(core_re_path):
+                lib.prepend_string_to_file('acAclPolicy {msiAclPolicy("STRICT"); }\n', core_re_path)
+
+                try:
+                    # Grant and revoke while nothing maintains the table.
+                    self.set_effective_access_index(False)
+                    self.user0.assert_icommand(['ichmod', 'read', self.group, self.data_object])
+                    self.admin.assert_icommand(['iadmin', 'atg', self.group, self.user1.username])
+                    self.assert_user1_can_see_data_object(True)
+
+                    # Enabling the index must not expose stale rows, nor hide the new grant.
+                    self.set_effective_access_index(True)
+                    self.assert_user1_can_see_data_object(True)
+
+                    # Changes made while enabled go through the table.
+                    self.admin.assert_icommand(['iadmin', 'rfg', self.group, self.user1.username])
+                    self.assert_user1_can_see_data_object(False)
+                    self.user0.assert_icommand(['ichmod', 'read', self.user1.username, self.data_object])
+                    self.assert_user1_can_see_data_object(True)
+
+                    # A revocation made while disabled must not survive re-enabling the index.
+                    self.set_effective_access_index(False)
+                    self.user0.assert_icommand(['ichmod', 'null', self.user1.username, self.data_object])
+                    self.assert_user1_can_see_data_object(False)
+                    self.set_effective_access_index(True)
+                    self.assert_user1_can_see_data_object(False)
+
+                finally:
+                    self.admin.run_icommand(['iadmin', 'rfg', self.group, self.user1.username])
+
+        IrodsController().restart()
+
+    def test_recursive_and_group_grants_are_reflected_in_general_queries(self):
+        core_re_path = os.path.join(IrodsConfig().core_re_directory, 'core.re')
+        collection = 'effective_access_collection'
+        with lib.file_backed_up(paths.server_config_path()):
+            with lib.file_backed_up(core_re_path):
+                lib.prepend_string_to_file('acAclPolicy {msiAclPolicy("STRICT"); }\n', core_re_path)
+
+                try:
+                    self.set_effective_access_index(True)
+
+                    self.user0.assert_icommand(['imkdir', collection])
+                    self.user0.assert_icommand(['iput', self.testfile, collection + '/' + self.data_object])
+                    query = "select DATA_NAME where COLL_NAME = '{0}/{1}'".format(self.user0.session_collection, collection)
+                    self.user1.assert_icommand(['iquest', '%s', query], 'STDOUT_SINGLELINE', 'CAT_NO_ROWS_FOUND')
+
+                    self.admin.assert_icommand(['iadmin', 'atg', self.group, self.user1.username])
+                    self.user0.assert_icommand(['ichmod', '-r', 'read', self.group, collection])
+                    self.user1.assert_icommand(['iquest', '%s', query], 'STDOUT_SINGLELINE', self.data_object)
+
+                    self.user0.assert_icommand(['ichmod', '-r', 'null', self.group, collection])
+                    self.user1.assert_icommand(['iquest', '%s', query], 'STDOUT_SINGLELINE', 'CAT_NO_ROWS_FOUND')
+
+                finally:
+                    self.user0.run_icommand(['irm', '-rf', collection])
+                    self.admin.run_icommand(['iadmin', 'rfg', self.group, self.user1.username])
+
+        IrodsController().restart()
@@ -8,6 +8,7 @@ import os
 import stat
 import datetime
 import filecmp
+import glob
 import time
 import shutil
 import random
@@ -443,6 +444,44 @@ class ChunkyDevTest(ResourceBase):
             if os.path.exists(mysdir):
                 shutil.rmtree(mysdir)
 
+    def test_mcoll_tar_member_read_in_place(self):
+        local_dir = os.path.join(self.admin.local_session_dir, 'tar_members')
+        lib.make_large_local_tmp_dir(local_dir, 5, 3000)
+        member_name = sorted(os.listdir(local_dir))[2]
+        downloaded = os.path.join(self.admin.local_session_dir, 'downloaded_member')
+        collection = self.admin.session_collection + '/tar_members'
+        self.admin.assert_icommand(['iput', '-r', local_dir, collection])
+
+        for bundle_name, data_type in [('members.tar', 'tar'), ('members.tar.gz', 'gzip')]:
+            bundle = self.admin.session_collection + '/' + bundle_name
+            mount_point = self.admin.session_collection + '/mnt_' + data_type
+            self.admin.assert_icommand(['ibun', '-c', '-D' + data_type, bundle, collection])
+            self.admin.assert_icommand(['imkdir', mount_point])
+            self.admin.assert_icommand(['imcoll', '-m', 'tar', bundle, mount_point])
+            try:
+                # fetch a single member without listing the mounted collection first
+                self.admin.assert_icommand(['iget', '-f', mount_point + '/tar_members/' + member_name, downloaded])
+                assert filecmp.cmp(os.path.join(local_dir, member_name), downloaded, shallow=False)
+                self.admin.assert_icommand(['ils', '-l', mount_point + '/tar_members/' + member_name],
+                                           'STDOUT_SINGLELINE', [member_name, '3000'])
+
+                # reading the member must not have staged the bundle into a cache dir
+                out, _, _ = self.admin.run_icommand(
+                    ['iquest', '%s', "select COLL_INFO2 where COLL_NAME = '{0}'".format(mount_point)])
+                self.assertEqual('', out.strip())
+
+                out, _, _ = self.admin.run_icommand(
+                    ['iquest', '%s', "select DATA_PATH where COLL_NAME = '{0}' and DATA_NAME = '{1}'".format(
+                        self.admin.session_collection, bundle_name)])
+                for data_path in out.split():
+                    self.assertEqual([], glob.glob(data_path + '.cacheDir*'))
+            finally:
+                self.admin.assert_icommand(['imcoll', '-U', mount_point])
+                if os.path.exists(downloaded):
+                    os.unlink(downloaded)
+
+        shutil.rmtree(local_dir)
+
     def test_large_dir_and_mcoll_from_devtest(self):
         # build expected variables with similar devtest names
         test_file = os.path.join(self.admin.local_session_dir, 'test_file')
@@ -5,11 +5,14 @@ if sys.version_info < (2, 7):
 else:
     import unittest
 
+import filecmp
 import os
+import random
 import shutil
 import tempfile
 
 from . import resource_suite
+from . import session
 from .. import lib
 
 @unittest.skip('Generation of large file causes I/O thrashing... skip for now')
@@ -100,3 +103,85 @@ class Test_Ibun(resource_suite.ResourceBase, unittest.TestCase):
             if os.path.exists(tar_file_name):
                 os.unlink(tar_file_name)
 
+
+
+class Test_Ibun_Bundle_Settings(session.make_sessions_mixin([('otherrods', 'rods')], []), unittest.TestCase):
+
+    def setUp(self):
+        super(Test_Ibun_Bundle_Settings, self).setUp()
+        self.admin = self.admin_sessions[0]
+
+        # The bundle settings are read from the context string of the resource holding the bundle.
+        self.resource = 'bundle_settings_resc'
+        self.vault = tempfile.mkdtemp()
+        self.admin.assert_icommand(['iadmin', 'mkresc', self.resource, 'unixfilesystem', lib.get_hostname() + ':' + self.vault],
+                                   'STDOUT_SINGLELINE', 'unixfilesystem')
+
+        # Compressible members, including one larger than the 4MB read-ahead limit.
+        self.local_dir = os.path.join(self.admin.local_session_dir, 'bundle_members')
+        os.makedirs(self.local_dir)
+        words = ['alpha', 'bravo', 'charlie', 'delta', 'echo', 'foxtrot', 'golf', 'hotel']
+        rng = random.Random(4)
+        for i, size in enumerate([0, 100, 3000, 200000, 5 * 1024 * 1024] + [1000] * 20):
+            with open(os.path.join(self.local_dir, 'member{0:02d}'.format(i)), 'w') as f:
+                text = ' '.join(rng.choice(words) for _ in range(size // 4 + 1))
+                f.write(text[:size])
+
+        self.collection = self.admin.session_collection + '/bundle_members'
+        self.admin.assert_icommand(['iput', '-r', self.local_dir, self.collection])
+
+    def tearDown(self):
+        self.admin.run_icommand(['irm', '-rf', self.admin.session_collection])
+        self.admin.run_icommand(['iadmin', 'rmresc', self.resource])
+        shutil.rmtree(self.vault, ignore_errors=True)
+        super(Test_Ibun_Bundle_Settings, self).tearDown()
+
+    def make_bundle(self, bundle_name, data_type, context):
+        self.admin.assert_icommand(['iadmin', 'modresc', self.resource, 'context', context])
+        bundle = self.admin.session_collection + '/' + bundle_name
+        self.admin.assert_icommand(['ibun', '-c', '-R', self.resource, '-D' + data_type, bundle, self.collection])
+        return bundle
+
+    def bundle_size(self, bundle_name):
+        out, _, _ = self.admin.run_icommand(['iquest', '%s',
+            "select DATA_SIZE where COLL_NAME = '{0}' and DATA_NAME = '{1}'".format(self.admin.session_collection, bundle_name)])
+        return int(out.strip())
+
+    def bundle_path(self, bundle_name):
+        out, _, _ = self.admin.run_icommand(['iquest', '%s',
+            "select DATA_PATH where COLL_NAME = '{0}' and DATA_NAME = '{1}'".format(self.admin.session_collection, bundle_name)])
+        return out.strip()
+
+    def assert_bundle_matches_local_directory(self, bundle):
+        extracted = bundle + '_extracted'
+        downloaded = os.path.join(self.admin.local_session_dir, os.path.basename(extracted))
+        try:
+            self.admin.assert_icommand(['ibun', '-x', bundle, extracted])
+            self.admin.assert_icommand(['iget', '-r', extracted + '/bundle_members', downloaded])
+            comparison = filecmp.dircmp(self.local_dir, downloaded)
+            self.assertEqual(sorted(comparison.common_files), sorted(os.listdir(self.local_dir)))
+            _, mismatch, errors = filecmp.cmpfiles(self.local_dir, downloaded, comparison.common_files, shallow=False)
+            self.assertEqual(mismatch + errors, [])
+        finally:
+            self.admin.run_icommand(['irm', '-rf', extracted])
+            shutil.rmtree(downloaded, ignore_errors=True)
+
+    def test_bundle_reader_threads_is_read_from_the_context_of_the_bundle_resource(self):
+        for threads in ['1', '4']:
+            bundle = self.make_bundle('threads_' + threads + '.tar', 'tar', 'bundle_reader_threads=' + threads)
+            self.assert_bundle_matches_local_directory(bundle)
+
+        # Both bundles hold the same members in the same order.
+        self.assertEqual(self.bundle_size('threads_1.tar'), self.bundle_size('threads_4.tar'))
+        self.assertTrue(filecmp.cmp(self.bundle_path('threads_1.tar'), self.bundle_path('threads_4.tar'), shallow=False))
+
+        # The member index is written next to each bundle.
+        for bundle_name in ['threads_1.tar', 'threads_4.tar']:
+            self.assertTrue(os.path.exists(self.bundle_path(bundle_name) + '.irods_index'))
+
+    def test_bundle_compression_level_is_read_from_the_context_of_the_bundle_resource(self):
+        for level in ['1', '9']:
+            bundle = self.make_bundle('level_' + level + '.tar.gz', 'gzip', 'bundle_compression_level=' + level)
+            self.assert_bundle_matches_local_directory(bundle)
+
+        self.assertLess(self.bundle_size('level_9.tar.gz'), self.bundle_size('level_1.tar.gz'))
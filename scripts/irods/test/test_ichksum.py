@@ -378,3 +378,57 @@ C- {5}:
            data_object_3)
         self.assertTrue(re.match(pattern, out))
 
+
+    def test_recursive_verification_reports_problems_for_every_data_object_in_the_collection(self):
+        root_col = os.path.join(self.admin.session_collection, 'bulk_verification')
+        sub_col = os.path.join(root_col, 'sub_col')
+        self.admin.assert_icommand(['imkdir', '-p', sub_col])
+
+        # Create enough data objects to exercise the parallel workers on the server.
+        data_objects = [os.path.join(root_col if i % 2 == 0 else sub_col, 'foo' + str(i)) for i in range(20)]
+        for data_object in data_objects:
+            self.admin.assert_icommand(['istream', 'write', data_object], input='some data')
+            self.admin.assert_icommand(['irepl', '-R', self.testresc, data_object])
+
+        self.admin.assert_icommand(['ichksum', '-r', '-a', root_col], 'STDOUT', ['C- ' + root_col])
+
+        # Show that verification of a healthy collection produces no errors.
+        out, _, ec = self.admin.run_icommand(['ichksum', '-r', '-K', root_col])
+        self.assertEqual(ec, 0)
+        self.assertNotIn('ERROR', out)
+        self.assertNotIn('WARNING', out)
+
+        # Corrupt the catalog information of one replica and add a data object without checksums.
+        bad_checksum = data_objects[3]
+        self.admin.assert_icommand(['iadmin', 'modrepl', 'logical_path', bad_checksum, 'replica_number', '1', 'DATA_CHECKSUM', 'sha2:BAD_CHECKSUM'])
+
+        missing_checksum = os.path.join(sub_col, 'no_checksum')
+        self.admin.assert_icommand(['istream', 'write', missing_checksum], input='some data')
+
+        # Show that every problem is reported along with the data object it belongs to.
+        out, _, _ = self.admin.run_icommand(['ichksum', '-r', '-K', root_col])
+        self.assertIn('ERROR: Computed checksum does not match what is in the catalog for replica [1] of data object [{0}].'.format(bad_checksum), out)
+        self.assertIn('WARNING: Data object [{0}] has replicas with different checksums.'.format(bad_checksum), out)
+        self.assertIn('WARNING: No checksum available for replica [0] of data object [{0}].'.format(missing_checksum), out)
+        self.assertEqual(out.count('ERROR'), 1)
+
+    def test_recursive_verification_reports_replicas_skipped_for_every_data_object(self):
+        root_col = os.path.join(self.admin.session_collection, 'bulk_verification_skipped')
+        sub_col = os.path.join(root_col, 'sub_col')
+        self.admin.assert_icommand(['imkdir', '-p', sub_col])
+
+        data_objects = [os.path.join(root_col, 'foo'), os.path.join(sub_col, 'bar')]
+        for data_object in data_objects:
+            self.admin.assert_icommand(['istream', 'write', data_object], input='some data')
+            self.admin.assert_icommand(['irepl', '-R', self.testresc, data_object])
+
+        self.admin.assert_icommand(['ichksum', '-r', '-a', root_col], 'STDOUT', ['C- ' + root_col])
+
+        # Show that replicas that are not good are skipped and reported per data object.
+        self.admin.assert_icommand(['iadmin', 'modrepl', 'logical_path', data_objects[1], 'replica_number', '0', 'DATA_REPL_STATUS', '0'])
+
+        out, _, ec = self.admin.run_icommand(['ichksum', '-r', '-K', root_col])
+        self.assertEqual(ec, 0)
+        self.assertIn('INFO: Number of replicas skipped for data object [{0}]: 1'.format(data_objects[1]), out)
+        self.assertNotIn('data object [{0}]'.format(data_objects[0]), out)
+        self.assertNotIn('ERROR', out)
@@ -1,3 +1,5 @@
+import copy
+import filecmp
 import os
 import re
 import stat
@@ -15,6 +17,8 @@ else:
 from .resource_suite import ResourceBase
 from ..configuration import IrodsConfig
 from .. import lib
+from .. import paths
+from .. import test
 from . import session
 
 class Test_iPut_Options(ResourceBase, unittest.TestCase):
@@ -274,6 +278,119 @@ class Test_iPut_Options(ResourceBase, unittest.TestCase):
         finally:
             shutil.rmtree(dir_name, ignore_errors=True)
 
+    def test_bulk_upload_spanning_several_batches_stores_every_file(self):
+        dir_name = tempfile.mkdtemp(prefix='bulk_batches_')
+
+        # A batch holds at most 50 files, so these are uploaded in several pipelined batches.
+        file_count = 0
+        for subdir in ['a', 'b', os.path.join('b', 'c')]:
+            os.makedirs(os.path.join(dir_name, subdir))
+            for i in range(60):
+                with open(os.path.join(dir_name, subdir, 'file_{0}'.format(i)), 'w') as f:
+                    f.write('data for {0} {1}'.format(subdir, i))
+                file_count += 1
+
+        try:
+            coll_name = os.path.join(self.admin.session_collection, 'bulk_batches')
+            _, out, _ = self.admin.assert_icommand(['iput', '-v', '-rb', dir_name, coll_name], 'STDOUT', 'Bulk upload')
+            self.assertGreater(out.count('Bulk upload'), 1)
+
+            gql = "select count(DATA_ID) where COLL_NAME like '{0}%'".format(coll_name)
+            self.admin.assert_icommand(['iquest', '%s', gql], 'STDOUT_SINGLELINE', str(file_count))
+
+            self.admin.assert_icommand(['iget', '-r', coll_name, os.path.join(self.admin.local_session_dir, 'bulk_batches')])
+            with open(os.path.join(self.admin.local_session_dir, 'bulk_batches', 'b', 'c', 'file_59')) as f:
+                self.assertEqual(f.read(), 'data for {0} 59'.format(os.path.join('b', 'c')))
+        finally:
+            shutil.rmtree(dir_name, ignore_errors=True)
+
+    def test_bulk_upload_with_checksums_spanning_several_batches(self):
+        dir_name = tempfile.mkdtemp(prefix='bulk_checksum_batches_')
+
+        # More than one batch of 50 files, so that the pipelined batches carry the checksum column too.
+        file_count = 120
+        for i in range(file_count):
+            with open(os.path.join(dir_name, 'file_{0}'.format(i)), 'w') as f:
+                f.write('checksummed data {0}'.format(i))
+
+        try:
+            for option in ['-k', '-K']:
+                coll_name = os.path.join(self.admin.session_collection, 'bulk_checksum_batches' + option)
+                self.admin.assert_icommand(['iput', '-rb', option, dir_name, coll_name], 'STDOUT', [' '])
+
+                gql = "select count(DATA_ID) where COLL_NAME = '{0}' and DATA_CHECKSUM like 'sha2:%'".format(coll_name)
+                self.admin.assert_icommand(['iquest', '%s', gql], 'STDOUT_SINGLELINE', str(file_count))
+        finally:
+            shutil.rmtree(dir_name, ignore_errors=True)
+
+    @unittest.skipIf(IrodsConfig().default_rule_engine_plugin == 'irods_rule_engine_plugin-python' or test.settings.RUN_IN_TOPOLOGY, "Skip for Topology Testing")
+    def test_parallel_transfer_over_the_main_port_round_trips_a_large_file(self):
+        filename = 'main_port_transfer_file'
+        local_file = os.path.join(self.admin.local_session_dir, filename)
+        returned_file = local_file + '.returned'
+        lib.make_file(local_file, 150 * 1024 * 1024, 'arbitrary')
+
+        env_backup = copy.deepcopy(self.admin.environment_file_contents)
+        self.admin.environment_file_contents.update({'irods_parallel_transfer_mode': 'main_port'})
+
+        # every additional stream opens the data object on a connection of its own
+        config = IrodsConfig()
+        core_re_path = os.path.join(config.core_re_directory, 'core.re')
+        msg = 'main port stream opened'
+
+        try:
+            with lib.file_backed_up(core_re_path):
+                with open(core_re_path, 'a') as core_re:
+                    core_re.write('pep_api_data_obj_open_pre(*INSTANCE_NAME, *COMM, *DATAOBJINP) {{ writeLine("serverLog", "{0} [" ++ *DATAOBJINP.obj_path ++ "]"); }}\n'.format(msg))
+
+                logical_path = os.path.join(self.admin.session_collection, filename)
+                stream_msg = '{0} [{1}]'.format(msg, logical_path)
+
+                log_offset = lib.get_file_size_by_path(paths.server_log_path())
+                self.admin.assert_icommand(['iput', '-K', '-N', '4', local_file, logical_path])
+                self.admin.assert_icommand(['ils', '-L', logical_path], 'STDOUT_SINGLELINE', str(150 * 1024 * 1024))
+                lib.delayAssert(lambda: lib.log_message_occurrences_greater_than_count(msg=stream_msg, count=0, start_index=log_offset))
+
+                log_offset = lib.get_file_size_by_path(paths.server_log_path())
+                self.admin.assert_icommand(['iget', '-K', '-N', '4', logical_path, returned_file])
+                self.assertTrue(filecmp.cmp(local_file, returned_file, shallow=False))
+                lib.delayAssert(lambda: lib.log_message_occurrences_greater_than_count(msg=stream_msg, count=0, start_index=log_offset))
+        finally:
+            self.admin.environment_file_contents = env_backup
+
+    def test_interrupted_parallel_transfers_resume_to_identical_checksums(self):
+        filename = 'interrupted_transfer_file'
+        local_file = os.path.join(self.admin.local_session_dir, filename)
+        returned_file = local_file + '.returned'
+        restart_file = os.path.join(self.admin.local_session_dir, 'interrupted_transfer_restart_file')
+        logical_path = os.path.join(self.admin.session_collection, filename)
+        lib.make_file(local_file, 600 * 1024 * 1024, 'random')
+        expected_checksum = 'sha2:' + lib.file_digest(local_file, 'sha256', encoding='base64')
+
+        def interrupt_and_resume(cmd):
+            if os.path.exists(restart_file):
+                os.unlink(restart_file)
+
+            # Stop the transfer once it has recorded its progress, then resume it from the restart file.
+            self.admin.interrupt_icommand(cmd, restart_file, 1)
+            self.assertTrue(os.path.exists(restart_file))
+            self.admin.assert_icommand(cmd, 'STDOUT_SINGLELINE', 'was restarted successfully')
+
+        try:
+            interrupt_and_resume('iput -K -N 4 --lfrestart {0} {1} {2}'.format(restart_file, local_file, logical_path))
+            self.admin.assert_icommand(['ils', '-L', logical_path], 'STDOUT_SINGLELINE', str(600 * 1024 * 1024))
+            _, _, ec = self.admin.run_icommand(['ichksum', '-K', logical_path])
+            self.assertEqual(ec, 0)
+            self.admin.assert_icommand(['ils', '-L', logical_path], 'STDOUT_SINGLELINE', expected_checksum)
+
+            interrupt_and_resume('iget -N 4 --lfrestart {0} {1} {2}'.format(restart_file, logical_path, returned_file))
+            self.assertEqual(lib.file_digest(returned_file, 'sha256', encoding='base64'), expected_checksum[len('sha2:'):])
+        finally:
+            for f in [local_file, returned_file, restart_file]:
+                if os.path.exists(f):
+                    os.unlink(f)
+
+
 class Test_iPut_Options_Issue_3883(ResourceBase, unittest.TestCase):
 
     def setUp(self):
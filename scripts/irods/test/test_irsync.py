@@ -1,4 +1,5 @@
 import copy
+import filecmp
 import os
 import re
 import sys
@@ -317,3 +318,71 @@ class Test_iRsync(ResourceBase, unittest.TestCase):
 
         # sync dir to coll
         self.user0.assert_icommand("irsync -r {local_dir} i:{base_name}".format(**locals()), "STDOUT_SINGLELINE", ustrings.recurse_ok_string())
+
+    def test_irsync_r_syncs_only_differing_files_with_every_worker_count(self):
+        base_name = 'test_irsync_r_syncs_only_differing_files'
+        local_dir = os.path.join(self.testing_tmp_dir, base_name)
+        returned_dir = os.path.join(self.testing_tmp_dir, base_name + '_returned')
+        sub_dir = os.path.join(local_dir, 'subdir')
+        lib.make_dir_p(sub_dir)
+
+        files = {
+            'matching': os.path.join(local_dir, 'matching'),
+            'different_size': os.path.join(local_dir, 'different_size'),
+            'different_content': os.path.join(sub_dir, 'different_content'),
+            'matching_nested': os.path.join(sub_dir, 'matching_nested'),
+        }
+
+        def write(path, contents):
+            with open(path, 'w') as f:
+                f.write(contents)
+
+        def assert_trees_match(left, right):
+            comparison = filecmp.dircmp(left, right)
+            self.assertEqual(comparison.left_only + comparison.right_only, [])
+            for name in comparison.common_dirs:
+                assert_trees_match(os.path.join(left, name), os.path.join(right, name))
+            _, mismatch, errors = filecmp.cmpfiles(left, right, comparison.common_files, shallow=False)
+            self.assertEqual(mismatch + errors, [])
+
+        env_backup = copy.deepcopy(self.user0.environment_file_contents)
+
+        try:
+            # A single worker transfers sequentially over the main connection.
+            for workers in [1, 3]:
+                self.user0.environment_file_contents.update({'irods_rsync_transfer_workers': workers})
+
+                for name, path in files.items():
+                    write(path, name * 100)
+
+                self.user0.assert_icommand(['irsync', '-r', local_dir, 'i:' + base_name], 'STDOUT_SINGLELINE', ustrings.recurse_ok_string())
+
+                # Change two files, keeping the size of one of them, and add a third.
+                write(files['different_size'], 'changed')
+                write(files['different_content'], 'x' * len('different_content' * 100))
+                write(os.path.join(sub_dir, 'new_file'), 'new')
+
+                out, _, _ = self.user0.run_icommand(['irsync', '-v', '-r', local_dir, 'i:' + base_name])
+                for name in ['matching', 'matching_nested']:
+                    self.assertIn(name, [l.split()[0] for l in out.splitlines() if 'a match no sync required' in l])
+                for name in ['different_size', 'different_content', 'new_file']:
+                    self.assertNotIn(name, [l.split()[0] for l in out.splitlines() if 'a match no sync required' in l])
+                    self.assertIn(name, [l.split()[0] for l in out.splitlines() if l.strip()])
+
+                self.user0.assert_icommand(['iget', '-r', base_name, returned_dir])
+                assert_trees_match(local_dir, returned_dir)
+
+                # Now sync the collection back over a local copy that differs in the same ways.
+                write(os.path.join(returned_dir, 'different_size'), 'stale')
+                write(os.path.join(returned_dir, 'subdir', 'different_content'), 'y' * len('different_content' * 100))
+                os.unlink(os.path.join(returned_dir, 'subdir', 'new_file'))
+
+                self.user0.assert_icommand(['irsync', '-r', 'i:' + base_name, returned_dir])
+                assert_trees_match(local_dir, returned_dir)
+
+                shutil.rmtree(returned_dir)
+                os.unlink(os.path.join(sub_dir, 'new_file'))
+                self.user0.assert_icommand(['irm', '-rf', base_name])
+        finally:
+            self.user0.environment_file_contents = env_backup
+            shutil.rmtree(returned_dir, ignore_errors=True)
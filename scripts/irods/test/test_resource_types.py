@@ -1,4 +1,5 @@
 from __future__ import print_function
+import filecmp
 import getpass
 import hashlib
 import inspect
@@ -493,6 +494,35 @@ OUTPUT ruleExecOut
         self.admin.assert_icommand('iadmin modresc demoResc context minimum_free_space_for_create_in_bytes={0}'.format(minimum))
         self.admin.assert_icommand('iput ' + filename + ' file3')
 
+    def test_tracked_free_space_is_published_on_create(self):
+        filename = 'test_tracked_free_space_is_published_on_create.txt'
+        filesize = 3000000
+        lib.make_file(filename, filesize)
+
+        try:
+            lib.make_dir_p(self.admin.get_vault_path('demoResc'))
+            self.admin.assert_icommand('iadmin modresc demoResc freespace 0')
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context',
+                                        'free_space_refresh_interval=600;free_space_publish=on'])
+
+            self.admin.assert_icommand(['iput', filename, 'file1'])
+            free_space = psutil.disk_usage(self.admin.get_vault_path('demoResc')).free
+
+            # later creates within the refresh interval are served from the tracker
+            self.admin.assert_icommand(['iput', filename, 'file2'])
+
+            ilsresc_output = self.admin.run_icommand(['ilsresc', '-l', 'demoResc'])[0]
+            for l in ilsresc_output.splitlines():
+                if l.startswith('free space:'):
+                    ilsresc_freespace = int(l.rpartition(':')[2])
+                    break
+            else:
+                assert False, '"free space:" not found in ilsresc output:\n' + ilsresc_output
+            assert abs(free_space - ilsresc_freespace) < filesize + 4096*10, 'free_space {0}, ilsresc free space {1}'.format(free_space, ilsresc_freespace)
+
+        finally:
+            os.unlink(filename)
+
     def test_msi_update_unixfilesystem_resource_free_space_and_acPostProcForParallelTransferReceived(self):
         try:
             filename = 'test_msi_update_unixfilesystem_resource_free_space_and_acPostProcForParallelTransferReceived'
@@ -1488,6 +1518,72 @@ class Test_Resource_CompoundWithUnivmss(ChunkyDevTest, ResourceSuite, unittest.T
         if os.path.exists(filepath):
             os.unlink(filepath)
 
+    def test_iput_and_iget_with_coprocess_mode(self):
+        # local setup
+        filename = "coprocessfile.txt"
+        filepath = os.path.abspath(filename)
+        retrievedpath = filepath + ".retrieved"
+        with open(filepath, 'wt') as f:
+            print("TESTFILE -- [" + filepath + "]", file=f, end='')
+
+        try:
+            self.admin.assert_icommand("iadmin modresc archiveResc context 'univMSSInterface.sh;coprocess=on'")
+
+            # sync to archive, then trim the cache so the get must stage from the archive
+            self.admin.assert_icommand("iput " + filename)
+            self.admin.assert_icommand("itrim -n0 -N1 " + filename, 'STDOUT_SINGLELINE', "files trimmed")
+            self.admin.assert_icommand("iget -f " + filename + " " + retrievedpath)
+            self.assertTrue(filecmp.cmp(filepath, retrievedpath))
+            self.admin.assert_icommand("irm -f " + filename)
+
+        finally:
+            self.admin.assert_icommand("iadmin modresc archiveResc context univMSSInterface.sh")
+            for path in [filepath, retrievedpath]:
+                if os.path.exists(path):
+                    os.unlink(path)
+
+    def test_read_completes_before_background_stage(self):
+        filename = 'test_read_completes_before_background_stage'
+        logical_path = os.path.join(self.admin.session_collection, filename)
+        lib.make_file(filename, 8*(2**20), contents='random')
+
+        # stages the first mebibyte, then holds the stage until the read is done
+        cmd_directory = os.path.join(IrodsConfig().irods_directory, 'msiExecCmd_bin')
+        with tempfile.NamedTemporaryFile(mode='wt', dir=cmd_directory, suffix='.sh', delete=False) as script:
+            print('#!/bin/sh\n'
+                  'if [ "$1" = "stageToCache" ]; then\n'
+                  '    head -c 1048576 "$2" > "$3"\n'
+                  '    sleep 15\n'
+                  'fi\n'
+                  'exec "{0}" "$@"\n'.format(os.path.join(cmd_directory, 'univMSSInterface.sh')), file=script, end='')
+        os.chmod(script.name, 0o700)
+
+        original_context = self.admin.run_icommand(['iquest', '%s', "select RESC_CONTEXT where RESC_NAME = 'demoResc'"])[0].strip()
+        try:
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context', 'stage_mode=background'])
+            self.admin.assert_icommand(['iadmin', 'modresc', 'archiveResc', 'context', os.path.basename(script.name)])
+            self.admin.assert_icommand(['iput', filename])
+            self.admin.assert_icommand(['itrim', '-n0', '-N1', filename], 'STDOUT_SINGLELINE', "files trimmed")
+
+            # the cache replica is still intermediate (2) when the read returns
+            rule = ('msiDataObjOpen("objPath={0}++++openFlags=O_RDONLY", *fd); '
+                    'msiDataObjRead(*fd, 1024, *buf); '
+                    'foreach (*r in select DATA_REPL_STATUS where COLL_NAME = "{1}" and DATA_NAME = "{2}" and DATA_RESC_HIER = "demoResc;cacheResc") {{ '
+                    'writeLine("stdout", "status after read: " ++ *r.DATA_REPL_STATUS); }} '
+                    'msiDataObjClose(*fd, *s);').format(logical_path, self.admin.session_collection, filename)
+            self.admin.assert_icommand(['irule', '-r', 'irods_rule_engine_plugin-irods_rule_language-instance', rule, 'null', 'ruleExecOut'],
+                                       'STDOUT_SINGLELINE', 'status after read: 2')
+
+            # closing the object completes the stage
+            self.admin.assert_icommand(['ils', '-l', filename], 'STDOUT_SINGLELINE', ['cacheResc', '&'])
+        finally:
+            self.admin.assert_icommand(['irm', '-f', filename])
+            self.admin.run_icommand(['iadmin', 'modresc', 'archiveResc', 'context', 'univMSSInterface.sh'])
+            self.admin.run_icommand(['iadmin', 'modresc', 'demoResc', 'context', original_context])
+            os.unlink(script.name)
+            if os.path.exists(filename):
+                os.unlink(filename)
+
 
 class Test_Resource_Compound(ChunkyDevTest, ResourceSuite, unittest.TestCase):
     plugin_name = IrodsConfig().default_rule_engine_plugin
@@ -1545,6 +1641,30 @@ class Test_Resource_Compound(ChunkyDevTest, ResourceSuite, unittest.TestCase):
         #cleanup
         self.admin.assert_icommand(['irm', '-f', filename])
 
+    def test_iget_while_staging_in_background(self):
+        filename = 'test_iget_while_staging_in_background'
+        retrieved = filename + '.get'
+        lib.make_file(filename, 60*(2**20), contents='random')
+        original_context = self.admin.run_icommand(['iquest', '%s', "select RESC_CONTEXT where RESC_NAME = 'demoResc'"])[0].strip()
+        try:
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context', 'stage_mode=background'])
+            self.admin.assert_icommand(['iput', filename])
+
+            # trim cache replica so that the get has to stage from the archive
+            self.admin.assert_icommand(['itrim', '-n0', '-N1', filename], 'STDOUT_SINGLELINE', "files trimmed")
+
+            self.admin.assert_icommand(['iget', '-f', filename, retrieved])
+            self.assertTrue(filecmp.cmp(filename, retrieved))
+
+            # the staged cache replica is good once the get has completed
+            self.admin.assert_icommand(['ils', '-l', filename], 'STDOUT_SINGLELINE', ['cacheResc', '&'])
+        finally:
+            self.admin.assert_icommand(['irm', '-f', filename])
+            self.admin.run_icommand(['iadmin', 'modresc', 'demoResc', 'context', original_context])
+            for f in [filename, retrieved]:
+                if os.path.exists(f):
+                    os.unlink(f)
+
     def test_irsync__2976(self):
         filename = "test_irsync__2976.txt"
         filename_rsync = "test_irsync__2976.txt.rsync"
@@ -3336,6 +3456,23 @@ class Test_Resource_Replication(ChunkyDevTest, ResourceSuite, unittest.TestCase)
         #cleanup
         self.admin.assert_icommand(['irm', '-f', filename])
 
+    def test_iput_replicates_to_children_concurrently_with_fan_out_threads(self):
+        filename = 'test_iput_replicates_to_children_concurrently_with_fan_out_threads'
+        filepath = lib.create_local_testfile(filename)
+        original_context = self.admin.run_icommand(['iquest', '%s', "select RESC_CONTEXT where RESC_NAME = 'demoResc'"])[0].strip()
+        try:
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context', 'fan_out_threads=3;minimum_good_replicas=2'])
+            self.admin.assert_icommand(['iput', filepath, filename])
+            assert_number_of_replicas(self.admin, filename, filename, self.child_replication_count)
+
+            # overwriting updates every replica through the same fan-out
+            self.admin.assert_icommand(['iput', '-f', filepath, filename])
+            assert_number_of_replicas(self.admin, filename, filename, self.child_replication_count)
+        finally:
+            self.admin.run_icommand(['irm', '-f', filename])
+            self.admin.run_icommand(['iadmin', 'modresc', 'demoResc', 'context', original_context])
+            os.unlink(filepath)
+
     def test_ibun_creation_to_replication(self):
         collection_name = 'bundle_me'
         tar_name = 'bundle.tar'
@@ -3912,6 +4049,79 @@ OUTPUT ruleExecOut
         self.assertEqual(len(out.split('\n')), 3*num_data_objects_to_use + 6)
         os.unlink(filename)
 
+    def test_rebalance_with_threads_resumes_from_checkpoint(self):
+        filename = 'test_rebalance_with_threads_resumes_from_checkpoint'
+        num_data_objects_to_use = 20
+        lib.make_file(filename, 1024)
+        original_context = self.admin.run_icommand(['iquest', '%s', "select RESC_CONTEXT where RESC_NAME = 'demoResc'"])[0].strip()
+        try:
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context', 'rebalance_threads=4'])
+            for i in range(num_data_objects_to_use):
+                self.admin.assert_icommand(['iput', filename, filename + '_' + str(i)])
+                self.admin.assert_icommand(['itrim', '-S', 'demoResc', '-N1', filename + '_' + str(i)], 'STDOUT_SINGLELINE', 'Number of files trimmed = 1.')
+
+            # pretend an earlier rebalance was interrupted after updating out-of-date replicas
+            self.admin.assert_icommand(['imeta', 'add', '-R', 'demoResc', 'rebalance_checkpoint', 'create_missing_replicas:0', '09999999999'])
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'rebalance'])
+            self.admin.assert_icommand_fail(['imeta', 'ls', '-R', 'demoResc'], 'STDOUT_SINGLELINE', 'rebalance_checkpoint')
+
+            for i in range(num_data_objects_to_use):
+                assert_number_of_replicas(self.admin, filename + '_' + str(i), filename + '_' + str(i), self.child_replication_count)
+        finally:
+            self.admin.run_icommand(['imeta', 'rmw', '-R', 'demoResc', 'rebalance_checkpoint', '%', '%'])
+            self.admin.run_icommand(['iadmin', 'modresc', 'demoResc', 'context', original_context])
+            os.unlink(filename)
+
+    def test_resumed_rebalance_includes_changes_made_after_the_interruption(self):
+        filename = 'test_resumed_rebalance_includes_changes_made_after_the_interruption'
+        missing_replica = filename + '_missing'
+        stale_replica = filename + '_stale'
+        lib.make_file(filename, 1024)
+        try:
+            # pretend a rebalance was interrupted long before these objects were written
+            self.admin.assert_icommand(['imeta', 'add', '-R', 'demoResc', 'rebalance_checkpoint', 'create_missing_replicas:0', '01000000000'])
+
+            self.admin.assert_icommand(['iput', filename, missing_replica])
+            self.admin.assert_icommand(['itrim', '-S', 'demoResc', '-N1', missing_replica], 'STDOUT_SINGLELINE', 'Number of files trimmed = 1.')
+            self.admin.assert_icommand(['iput', filename, stale_replica])
+            self.update_specific_replica_for_data_objs_in_repl_hier([(stale_replica, filename)])
+
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'rebalance'])
+            self.admin.assert_icommand_fail(['imeta', 'ls', '-R', 'demoResc'], 'STDOUT_SINGLELINE', 'rebalance_checkpoint')
+
+            assert_number_of_replicas(self.admin, missing_replica, missing_replica, self.child_replication_count)
+            _, out, _ = self.admin.assert_icommand(['ils', '-l', stale_replica], 'STDOUT_SINGLELINE', stale_replica)
+            self.assertEqual(self.child_replication_count, out.count(' & '))
+        finally:
+            self.admin.run_icommand(['imeta', 'rmw', '-R', 'demoResc', 'rebalance_checkpoint', '%', '%'])
+            self.admin.run_icommand(['irm', '-f', missing_replica, stale_replica])
+            os.unlink(filename)
+
+    def test_rebalance_resumed_from_a_later_bundle_rechecks_the_earlier_bundles(self):
+        filename = 'test_rebalance_resumed_from_a_later_bundle_rechecks_the_earlier_bundles'
+        num_data_objects_to_use = 5
+        lib.make_file(filename, 1024)
+        try:
+            # pretend a rebalance was interrupted in the last bundle, long before these objects were
+            # written. each of them is missing replicas in the bundles the checkpoint says are done.
+            checkpoint = 'create_missing_replicas:{0}'.format(self.child_replication_count - 1)
+            self.admin.assert_icommand(['imeta', 'add', '-R', 'demoResc', 'rebalance_checkpoint', checkpoint, '01000000000'])
+
+            for i in range(num_data_objects_to_use):
+                self.admin.assert_icommand(['iput', filename, filename + '_' + str(i)])
+                self.admin.assert_icommand(['itrim', '-S', 'demoResc', '-N1', filename + '_' + str(i)], 'STDOUT_SINGLELINE', 'Number of files trimmed = 1.')
+
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'rebalance'])
+            self.admin.assert_icommand_fail(['imeta', 'ls', '-R', 'demoResc'], 'STDOUT_SINGLELINE', 'rebalance_checkpoint')
+
+            for i in range(num_data_objects_to_use):
+                assert_number_of_replicas(self.admin, filename + '_' + str(i), filename + '_' + str(i), self.child_replication_count)
+        finally:
+            self.admin.run_icommand(['imeta', 'rmw', '-R', 'demoResc', 'rebalance_checkpoint', '%', '%'])
+            for i in range(num_data_objects_to_use):
+                self.admin.run_icommand(['irm', '-f', filename + '_' + str(i)])
+            os.unlink(filename)
+
     def test_rebalance_batching_replica_update__3570(self):
         filename = 'test_rebalance_batching_replica_update__3570'
         default_rebalance_batch_size = 500 # from librepl.cpp
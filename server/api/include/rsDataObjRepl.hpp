@@ -5,8 +5,19 @@
 #include "dataObjInpOut.h"
 #include "objInfo.h"
 
+#include <string>
+#include <vector>
+
 int rsDataObjRepl( rsComm_t *rsComm, dataObjInp_t *dataObjInp, transferStat_t **transferStat );
 int dataObjCopy( rsComm_t *rsComm, int l1descInx );
+// Replicates each local data object in dataObjInps from its source to its destination replica
+// (ALL_KW is not supported). Returns the status of each replication in the order of dataObjInps.
+// Up to maxConcurrent copies between unixfilesystem vaults on this server run at a time. All other
+// copies (remote servers, remote zones, other resource types) run one at a time on the agent thread.
+std::vector<int> dataObjReplBatch( rsComm_t *rsComm, const std::vector<dataObjInp_t>& dataObjInps, int maxConcurrent );
+// Replicates the data object to each destination hierarchy with dataObjReplBatch. Returns the status
+// of each replication in the order of destinationHierarchies.
+std::vector<int> dataObjReplToHierarchies( rsComm_t *rsComm, const dataObjInp_t& dataObjInp, const std::vector<std::string>& destinationHierarchies, int maxConcurrent );
 int replToCacheRescOfCompObj( rsComm_t *rsComm, dataObjInp_t *dataObjInp, dataObjInfo_t *srcDataObjInfoHead, dataObjInfo_t *compObjInfo, dataObjInfo_t *oldDataObjInfo, dataObjInfo_t **outDestDataObjInfo );
 int unbunAndStageBunfileObj(rsComm_t* rsComm, const char* bunfileObjPath, char** outCacheRescName);
 int _unbunAndStageBunfileObj( rsComm_t *rsComm, dataObjInfo_t **bunfileObjInfoHead, keyValPair_t* condInput, char **outCacheRescName, int rmBunCopyFlag );
@@ -0,0 +1,50 @@
+#ifndef IRODS_RS_BULK_CHECKSUM_HPP
+#define IRODS_RS_BULK_CHECKSUM_HPP
+
+/// \file
+
+struct RsComm;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// \brief Computes or verifies the checksums of many replicas in a single request.
+///
+/// Server-side callers do not receive progress messages. Problems found along the way
+/// are added to the error stack of \p _comm.
+///
+/// \param[in] _comm       A pointer to a RsComm.
+/// \param[in] _json_input \parblock
+/// A JSON string describing the replicas to process.
+///
+/// The JSON string must have the following structure:
+/// \code{.js}
+/// {
+///   "logical_path": string,
+///   "data_objects": [string],
+///   "options": {
+///     "verify": boolean,
+///     "force": boolean,
+///     "admin": boolean,
+///     "thread_count": integer,
+///     "max_concurrent_per_resource": integer
+///   }
+/// }
+/// \endcode
+/// \endparblock
+///
+/// See ::rc_bulk_checksum for a description of each property.
+///
+/// \return An integer.
+/// \retval 0        On success.
+/// \retval Non-zero On failure.
+///
+/// \since 4.3.0
+int rs_bulk_checksum(RsComm* _comm, const char* _json_input);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // IRODS_RS_BULK_CHECKSUM_HPP
@@ -0,0 +1,45 @@
+#ifndef IRODS_RS_REMOVE_ALL_HPP
+#define IRODS_RS_REMOVE_ALL_HPP
+
+/// \file
+
+struct RsComm;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// \brief Recursively removes a collection and everything under it.
+///
+/// Server-side callers do not receive progress messages.
+///
+/// \param[in] _comm       A pointer to a RsComm.
+/// \param[in] _json_input \parblock
+/// A JSON string describing the collection to remove.
+///
+/// The JSON string must have the following structure:
+/// \code{.js}
+/// {
+///   "logical_path": string,
+///   "options": {
+///     "no_trash": boolean,
+///     "unregister": boolean
+///   }
+/// }
+/// \endcode
+/// \endparblock
+///
+/// See ::rc_remove_all for a description of each property.
+///
+/// \return An integer.
+/// \retval 0        On success.
+/// \retval Non-zero On failure.
+///
+/// \since 4.3.0
+int rs_remove_all(RsComm* _comm, const char* _json_input);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // IRODS_RS_REMOVE_ALL_HPP
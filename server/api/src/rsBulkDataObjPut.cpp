@@ -185,6 +185,10 @@ unbunBulkBuf(rsComm_t* rsComm,
 
     kvp[DATA_INCLUDED_KW] = "";
 
+    // Files of a batch are usually in the same collection. The collection is only
+    // made when it changes, rather than once per file.
+    std::string last_collection;
+
     for (int i = 0; i < attriArray->rowCnt; ++i) {
         bytesBuf_t buffer;
         if (0 == i) {
@@ -201,9 +205,13 @@ unbunBulkBuf(rsComm_t* rsComm,
         std::size_t last_slash = collString.find_last_of('/');
         collString.erase(last_slash);
 
-        if (const auto ec = rsMkCollR(rsComm, "/", collString.c_str()); ec < 0) {
-            irods::log(LOG_ERROR, fmt::format("{}: Unable to make collection [{}].", __FUNCTION__, collString));
-            return ec;
+        if (collString != last_collection) {
+            if (const auto ec = rsMkCollR(rsComm, "/", collString.c_str()); ec < 0) {
+                irods::log(LOG_ERROR, fmt::format("{}: Unable to make collection [{}].", __FUNCTION__, collString));
+                return ec;
+            }
+
+            last_collection = std::move(collString);
         }
 
         rstrcpy(dataObjInp->objPath, tmpObjPath, MAX_NAME_LEN);
@@ -228,6 +228,7 @@ preProcParaGet( rsComm_t *rsComm, int l1descInx, portalOprOut_t **portalOprOut )
 
     if ( status >= 0 ) {
         ( *portalOprOut )->l1descInx = l1descInx;
+        recordMainPortStreams( rsComm, l1descInx, GET_OPR );
     }
     clearKeyVal( &dataOprInp.condInput );
     return status;
@@ -151,6 +151,93 @@ namespace
         }
     } // update_replica_access_table
 
+    // Returns the L1 descriptor of the destination of a stage to cache for the replica which
+    // this agent is still running, or 0 if there is none. Resources which stage in the background
+    // leave that replica intermediate until the stage completes, but serve reads of the staged
+    // bytes meanwhile.
+    auto find_stage_in_flight_for_replica(const replica_proxy& _replica) -> int
+    {
+        for (int i = 3; i < NUM_L1_DESC; ++i) {
+            const auto& l1desc = L1desc[i];
+
+            if (FD_INUSE != l1desc.inuseFlag ||
+                REPLICATE_DEST != l1desc.oprType ||
+                !l1desc.dataObjInfo ||
+                !l1desc.dataObjInp) {
+                continue;
+            }
+
+            if (l1desc.dataObjInfo->dataId == _replica.data_id() &&
+                l1desc.dataObjInfo->replNum == _replica.replica_number() &&
+                getValByKey(&l1desc.dataObjInp->condInput, STAGE_OBJ_KW)) {
+                return i;
+            }
+        }
+
+        return 0;
+    } // find_stage_in_flight_for_replica
+
+    // Returns true if the client may read the replica while the stage at _stage_l1descInx is still
+    // writing it. The stage must hold the replica through the replica access table. A client which
+    // presents a replica token must present the token of the stage. Otherwise the client must be
+    // able to read the data object, whatever keywords the open carries.
+    auto may_read_while_staging(RsComm& _comm,
+                                const DataObjInp& _inp,
+                                const replica_proxy& _replica,
+                                const int _stage_l1descInx) -> bool
+    {
+        const auto& token = L1desc[_stage_l1descInx].replica_token;
+
+        if (token.empty() || !rat::contains(token, _replica.data_id(), _replica.replica_number())) {
+            return false;
+        }
+
+        if (const auto* client_token = getValByKey(&_inp.condInput, REPLICA_TOKEN_KW); client_token) {
+            return token == client_token;
+        }
+
+        DataObjInp inp{};
+        rstrcpy(inp.objPath, _inp.objPath, MAX_NAME_LEN);
+        addKeyVal(&inp.condInput, RESC_HIER_STR_KW, _replica.hierarchy().data());
+        if (const auto* ticket = getValByKey(&_inp.condInput, TICKET_KW); ticket) {
+            addKeyVal(&inp.condInput, TICKET_KW, ticket);
+        }
+        const irods::at_scope_exit clear_cond_input{[&inp] { clearKeyVal(&inp.condInput); }};
+
+        DataObjInfo* info{};
+        const int ec = getDataObjInfo(&_comm, &inp, &info, ACCESS_READ_OBJECT, 0);
+        freeAllDataObjInfo(info);
+
+        return ec >= 0;
+    } // may_read_while_staging
+
+    // Closes the replicas of a stage to cache which this agent is running in the background.
+    // The resource waits for the stage to complete before the destination replica is finalized.
+    auto complete_stage_in_flight(rsComm_t& _comm, const int _destination_l1descInx) -> int
+    {
+        const int source_l1descInx = L1desc[_destination_l1descInx].srcL1descInx;
+
+        int ec = 0;
+        for (const int l1descInx : {_destination_l1descInx, source_l1descInx}) {
+            if (l1descInx < 3 || FD_INUSE != L1desc[l1descInx].inuseFlag) {
+                continue;
+            }
+
+            openedDataObjInp_t input{};
+            input.l1descInx = l1descInx;
+            L1desc[l1descInx].oprStatus = l1descInx;
+            addKeyVal(&input.condInput, IN_PDMO_KW, L1desc[l1descInx].dataObjInfo->rescHier);
+
+            if (const int status = rsDataObjClose(&_comm, &input); status < 0 && 0 == ec) {
+                ec = status;
+            }
+
+            clearKeyVal(&input.condInput);
+        }
+
+        return ec;
+    } // complete_stage_in_flight
+
     int change_replica_status(rsComm_t& rsComm, dataObjInp_t& dataObjInp, int new_replica_status)
     {
         {
@@ -934,6 +1021,26 @@ namespace
 
             auto replica = *maybe_replica;
 
+            // Reads of a replica which this agent is still staging to cache are served as the
+            // staged bytes arrive, so they are let through to the intermediate replica as long
+            // as the client may read it. Writes must not race the stage, so it is completed first.
+            const int stage_l1descInx = INTERMEDIATE_REPLICA == replica.replica_status()
+                                      ? find_stage_in_flight_for_replica(replica)
+                                      : 0;
+            const bool read_while_staging = stage_l1descInx > 0 &&
+                                            !getWriteFlag(dataObjInp->openFlags) &&
+                                            may_read_while_staging(*rsComm, *dataObjInp, replica, stage_l1descInx);
+
+            if (stage_l1descInx > 0 && getWriteFlag(dataObjInp->openFlags)) {
+                if (const int ec = complete_stage_in_flight(*rsComm, stage_l1descInx); ec < 0) {
+                    THROW(ec, fmt::format(
+                        "[{}:{}] - failed to complete stage to cache for [{}]",
+                        __FUNCTION__, __LINE__, replica.logical_path()));
+                }
+
+                replica.replica_status(GOOD_REPLICA);
+            }
+
             // Record the current replica status so that it can be restored later.
             const auto old_replica_status = replica.replica_status();
 
@@ -941,10 +1048,10 @@ namespace
             // to see if the provided replica token will be accepted by the replica access table.
             // If not, the open request is disallowed because multiple opens of the same replica are
             // not allowed without a valid replica token.
-            const auto replica_access_granted = [&replica, &cond_input]() -> bool
+            const auto replica_access_granted = [&replica, &cond_input, read_while_staging]() -> bool
             {
                 // TODO: This should be updated to account for logical locking...
-                if (INTERMEDIATE_REPLICA != replica.replica_status()) {
+                if (INTERMEDIATE_REPLICA != replica.replica_status() || read_while_staging) {
                     return true;
                 }
 
@@ -1046,7 +1153,7 @@ namespace
             }
 
             try {
-                if (INTERMEDIATE_REPLICA == replica.replica_status()) {
+                if (INTERMEDIATE_REPLICA == replica.replica_status() && !read_while_staging) {
                     // Replica tokens only apply to write operations against intermediate replicas.
                     //
                     // There is a case where the client wants to open an existing replica for writes
@@ -1156,6 +1263,14 @@ int rsDataObjOpen(rsComm_t *rsComm, dataObjInp_t *dataObjInp)
         }
     }
 
+    // Additional streams of a resumed transfer are limited like those of a put or get.
+    // The opens made by rsDataObjPut and rsDataObjGet are skipped here; those record
+    // the streams in preProcParaPut and preProcParaGet, once the portal is set up.
+    if (fd >= minimum_valid_file_descriptor && dataObjInp->oprType != PUT_OPR && dataObjInp->oprType != GET_OPR) {
+        const auto opr_type = (dataObjInp->openFlags & O_ACCMODE) == O_RDONLY ? GET_OPR : PUT_OPR;
+        recordMainPortStreams(rsComm, fd, opr_type);
+    }
+
     return fd;
 }
 
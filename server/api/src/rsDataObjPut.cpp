@@ -634,6 +634,7 @@ int preProcParaPut(
 
     if ( status >= 0 ) {
         ( *portalOprOut )->l1descInx = l1descInx;
+        recordMainPortStreams( rsComm, l1descInx, PUT_OPR );
         L1desc[l1descInx].bytesWritten = dataOprInp.dataSize;
     }
     clearKeyVal( &dataOprInp.condInput );
@@ -38,6 +38,7 @@
 #include "rsUnbunAndRegPhyBunfile.hpp"
 #include "rsUnregDataObj.hpp"
 #include "rs_replica_close.hpp"
+#include "server_utilities.hpp"
 #include "specColl.hpp"
 #include "unbunAndRegPhyBunfile.h"
 
@@ -47,6 +48,7 @@
 #include "irods_logger.hpp"
 #include "irods_random.hpp"
 #include "irods_resource_backport.hpp"
+#include "irods_resource_constants.hpp"
 #include "irods_resource_redirect.hpp"
 #include "irods_server_api_call.hpp"
 #include "irods_server_properties.hpp"
@@ -65,9 +67,13 @@
 #include "replica_state_table.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <string_view>
+#include <thread>
 #include <vector>
 
+#include <unistd.h>
+
 #include "fmt/format.h"
 
 #include <boost/make_shared.hpp>
@@ -411,7 +417,18 @@ namespace
         return rsDataObjOpen(&_comm, &_inp);
     } // open_destination_replica
 
-    int replicate_data(RsComm& _comm, DataObjInp& _source_inp, DataObjInp& _destination_inp)
+    // The l1 descriptors of a replication which has been opened but not yet finalized.
+    struct replication_descriptors
+    {
+        int source_l1descInx{-1};
+        int destination_l1descInx{-1};
+    }; // struct replication_descriptors
+
+    int open_replicas_for_replication(
+        RsComm& _comm,
+        DataObjInp& _source_inp,
+        DataObjInp& _destination_inp,
+        replication_descriptors& _fds)
     {
         // Open source replica
         int source_l1descInx = open_source_replica(_comm, _source_inp);
@@ -445,8 +462,22 @@ namespace
         L1desc[destination_l1descInx].srcL1descInx = source_l1descInx;
         L1desc[destination_l1descInx].dataSize = source_data_obj_info.dataSize;
 
+        _fds.source_l1descInx = source_l1descInx;
+        _fds.destination_l1descInx = destination_l1descInx;
+
+        return 0;
+    } // open_replicas_for_replication
+
+    // Must run on the agent thread. The copy goes through the resource plugins, which fire
+    // policy, and may open further descriptors.
+    int copy_replica_data(RsComm& _comm, const DataObjInp& _destination_inp, const replication_descriptors& _fds)
+    {
+        const int destination_l1descInx = _fds.destination_l1descInx;
+        const auto& source_data_obj_info = *L1desc[_fds.source_l1descInx].dataObjInfo;
+        const auto& destination_data_obj_info = *L1desc[destination_l1descInx].dataObjInfo;
+
         // Copy data from source to destination
-        int status = dataObjCopy(&_comm, destination_l1descInx);
+        const int status = dataObjCopy(&_comm, destination_l1descInx);
         if (status < 0) {
             irods::log(LOG_ERROR, fmt::format(
                 "[{}:{}] - dataObjCopy failed for [{}], src:[{}], dest:[{}]; ec:[{}]",
@@ -462,6 +493,78 @@ namespace
             L1desc[destination_l1descInx].bytesWritten = destination_data_obj_info.dataSize;
         }
 
+        return status;
+    } // copy_replica_data
+
+    // Returns the descriptor of a file open in a unixfilesystem vault on this server, or -1 if
+    // the data must go through the resource plugin. Must be called on the agent thread.
+    int native_fd_for_l3desc(int _l3descInx)
+    {
+        if (_l3descInx < 3 || _l3descInx >= NUM_FILE_DESC ||
+            FileDesc[_l3descInx].inuseFlag != FD_INUSE ||
+            !FileDesc[_l3descInx].rescHier ||
+            !FileDesc[_l3descInx].rodsServerHost ||
+            FileDesc[_l3descInx].rodsServerHost->localFlag != LOCAL_HOST) {
+            return -1;
+        }
+
+        std::string resc_type;
+        if (!irods::get_resc_type_for_hier_string(FileDesc[_l3descInx].rescHier, resc_type).ok() ||
+            irods::RESOURCE_TYPE_NATIVE != resc_type) {
+            return -1;
+        }
+
+        return FileDesc[_l3descInx].fd;
+    } // native_fd_for_l3desc
+
+    // Copies a whole replica between two vault files on this server. Only the native file
+    // descriptors are used, so this may run off the agent thread.
+    int copy_native_replica_data(int _source_fd, int _destination_fd, rodsLong_t _size)
+    {
+        rodsLong_t copied = std::max<rodsLong_t>(irods::copy_file_range_in_kernel(_source_fd, _destination_fd, 0, _size), 0);
+
+        constexpr std::size_t buffer_size = 4 * 1024 * 1024;
+
+        std::vector<char> buffer;
+        while (copied < _size) {
+            if (buffer.empty()) {
+                buffer.resize(buffer_size);
+            }
+
+            const auto bytes_read = pread(_source_fd, buffer.data(), std::min<rodsLong_t>(buffer.size(), _size - copied), copied);
+            if (bytes_read < 0) {
+                return UNIX_FILE_READ_ERR - errno;
+            }
+            if (bytes_read == 0) {
+                return SYS_COPY_LEN_ERR;
+            }
+
+            for (ssize_t written = 0; written < bytes_read;) {
+                const auto n = pwrite(_destination_fd, buffer.data() + written, bytes_read - written, copied + written);
+                if (n < 0) {
+                    return UNIX_FILE_WRITE_ERR - errno;
+                }
+                written += n;
+            }
+
+            copied += bytes_read;
+        }
+
+        return 0;
+    } // copy_native_replica_data
+
+    int close_and_finalize_replication(
+        RsComm& _comm,
+        const DataObjInp& _source_inp,
+        const DataObjInp& _destination_inp,
+        const replication_descriptors& _fds,
+        int status)
+    {
+        const int source_l1descInx = _fds.source_l1descInx;
+        const int destination_l1descInx = _fds.destination_l1descInx;
+        auto& source_data_obj_info = *L1desc[source_l1descInx].dataObjInfo;
+        auto& destination_data_obj_info = *L1desc[destination_l1descInx].dataObjInfo;
+
         // Save the token for the replica access table so that it can be removed
         // in the event of a failure in close. On failure, the entry is restored,
         // but this will prevent retries of the operation as the token information
@@ -567,15 +670,33 @@ namespace
         }
 
         return status;
+    } // close_and_finalize_replication
+
+    int replicate_data(RsComm& _comm, DataObjInp& _source_inp, DataObjInp& _destination_inp)
+    {
+        replication_descriptors fds;
+        if (const int ec = open_replicas_for_replication(_comm, _source_inp, _destination_inp, fds); ec < 0) {
+            return ec;
+        }
+
+        const int status = copy_replica_data(_comm, _destination_inp, fds);
+
+        return close_and_finalize_replication(_comm, _source_inp, _destination_inp, fds, status);
     } // replicate_data
 
-    int replicate_data_object(RsComm& _comm, const DataObjInp& _inp)
+    // Resolves the source and destination replicas for _inp into _source_inp and _destination_inp
+    // and returns SYS_NOT_ALLOWED if the replication should not happen. The caller owns the
+    // condInput of both outputs.
+    int prepare_replication(
+        RsComm& _comm,
+        const DataObjInp& _inp,
+        DataObjInp& source_inp,
+        DataObjInp& destination_inp)
     {
         const auto cond_input = irods::experimental::make_key_value_proxy(_inp.condInput);
 
         // get information about source replica
-        auto source_inp = init_source_replica_input(_comm, _inp);
-        const irods::at_scope_exit free_source_cond_input{[&source_inp]() { clearKeyVal(&source_inp.condInput); }};
+        source_inp = init_source_replica_input(_comm, _inp);
         auto source_cond_input = irods::experimental::make_key_value_proxy(source_inp.condInput);
         auto source_obj = resolve_hierarchy_and_get_data_object_info(_comm, source_inp, irods::OPEN_OPERATION);
         auto& source_replica = get_replica_with_hierarchy(
@@ -606,8 +727,7 @@ namespace
         }
 
         // get information about destination replica
-        auto destination_inp = init_destination_replica_input(_comm, _inp);
-        const irods::at_scope_exit free_destination_cond_input{[&destination_inp]() { clearKeyVal(&destination_inp.condInput); }};
+        destination_inp = init_destination_replica_input(_comm, _inp);
         auto destination_cond_input = irods::experimental::make_key_value_proxy(destination_inp.condInput);
         auto destination_obj = resolve_hierarchy_and_get_data_object_info(_comm, destination_inp, irods::CREATE_OPERATION);
         try {
@@ -645,6 +765,22 @@ namespace
             source_cond_input.at(RESC_HIER_STR_KW).value(),
             destination_cond_input.at(RESC_HIER_STR_KW).value()));
 
+        return 0;
+    } // prepare_replication
+
+    int replicate_data_object(RsComm& _comm, const DataObjInp& _inp)
+    {
+        DataObjInp source_inp{};
+        DataObjInp destination_inp{};
+        const irods::at_scope_exit free_cond_input{[&source_inp, &destination_inp]() {
+            clearKeyVal(&source_inp.condInput);
+            clearKeyVal(&destination_inp.condInput);
+        }};
+
+        if (const int ec = prepare_replication(_comm, _inp, source_inp, destination_inp); ec < 0) {
+            return ec;
+        }
+
         // replicate!
         const int ec = replicate_data(_comm, source_inp, destination_inp);
 
@@ -873,6 +1009,186 @@ int rsDataObjRepl( rsComm_t *rsComm, dataObjInp_t *dataObjInp, transferStat_t **
     return (status == DIRECT_ARCHIVE_ACCESS) ? 0 : status;
 } // rsDataObjRepl
 
+std::vector<int> dataObjReplBatch(
+    rsComm_t* rsComm,
+    const std::vector<dataObjInp_t>& dataObjInps,
+    int maxConcurrent)
+{
+    struct batched_replication
+    {
+        DataObjInp source_inp{};
+        DataObjInp destination_inp{};
+        replication_descriptors fds;
+        int source_fd{-1};
+        int destination_fd{-1};
+        int status{};
+    };
+
+    std::vector<batched_replication> replications(dataObjInps.size());
+    const irods::at_scope_exit free_cond_input{[&replications] {
+        for (auto& r : replications) {
+            clearKeyVal(&r.source_inp.condInput);
+            clearKeyVal(&r.destination_inp.condInput);
+        }
+    }};
+
+    // Resolve every replication before any of them is opened so that voting sees the
+    // replicas as they were before the batch started.
+    for (std::size_t i = 0; i < dataObjInps.size(); ++i) {
+        auto& r = replications[i];
+
+        DataObjInp inp = dataObjInps[i];
+        replKeyVal(&dataObjInps[i].condInput, &inp.condInput);
+        const irods::at_scope_exit free_inp_cond_input{[&inp] { clearKeyVal(&inp.condInput); }};
+        irods::experimental::make_key_value_proxy(inp.condInput)[IN_REPL_KW] = "";
+
+        try {
+            r.status = prepare_replication(*rsComm, inp, r.source_inp, r.destination_inp);
+        }
+        catch (const irods::exception& e) {
+            irods::log(LOG_ERROR, fmt::format(
+                "[{}:{}] - failed to prepare replication of [{}]; [{}], ec:[{}]",
+                __FUNCTION__, __LINE__, dataObjInps[i].objPath, e.what(), e.code()));
+
+            r.status = e.code();
+        }
+    }
+
+    // Opening, copying through the resource plugins, and finalizing all touch the catalog,
+    // the rule engine, or the descriptor tables, none of which may be used off the agent
+    // thread. Only whole-file copies between unixfilesystem vault files on this server, which
+    // need nothing but the two native file descriptors, are handed to other threads. Every
+    // other copy (another server, another zone, or any other resource type) runs on the agent
+    // thread, one at a time, while those are in flight. Copies to another server all share the
+    // agent's single connection to it, so they could not overlap anyway.
+    std::vector<std::size_t> native_copies;
+    std::vector<std::size_t> serial_copies;
+
+    for (std::size_t i = 0; i < replications.size(); ++i) {
+        auto& r = replications[i];
+        if (r.status < 0) {
+            continue;
+        }
+
+        try {
+            r.status = open_replicas_for_replication(*rsComm, r.source_inp, r.destination_inp, r.fds);
+        }
+        catch (const irods::exception& e) {
+            irods::log(LOG_ERROR, fmt::format(
+                "[{}:{}] - failed to open replicas of [{}]; [{}], ec:[{}]",
+                __FUNCTION__, __LINE__, dataObjInps[i].objPath, e.what(), e.code()));
+
+            r.status = e.code();
+        }
+
+        if (r.status < 0) {
+            continue;
+        }
+
+        const auto& source = L1desc[r.fds.source_l1descInx];
+        const auto& destination = L1desc[r.fds.destination_l1descInx];
+
+        if (maxConcurrent > 1 && !source.remoteZoneHost && !destination.remoteZoneHost && source.dataObjInfo->dataSize > 0) {
+            r.source_fd = native_fd_for_l3desc(source.l3descInx);
+            r.destination_fd = native_fd_for_l3desc(destination.l3descInx);
+        }
+
+        if (r.source_fd >= 0 && r.destination_fd >= 0) {
+            native_copies.push_back(i);
+        }
+        else {
+            serial_copies.push_back(i);
+        }
+    }
+
+    std::atomic<std::size_t> next_copy{0};
+    const auto copy_native = [&] {
+        for (auto n = next_copy++; n < native_copies.size(); n = next_copy++) {
+            auto& r = replications[native_copies[n]];
+            r.status = copy_native_replica_data(r.source_fd, r.destination_fd, L1desc[r.fds.source_l1descInx].dataObjInfo->dataSize);
+        }
+    };
+
+    const auto thread_count = std::min<std::size_t>(std::max(maxConcurrent, 1), native_copies.size());
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back(copy_native);
+    }
+
+    for (const auto i : serial_copies) {
+        auto& r = replications[i];
+        try {
+            r.status = copy_replica_data(*rsComm, r.destination_inp, r.fds);
+        }
+        catch (const irods::exception& e) {
+            r.status = e.code();
+        }
+        catch (const std::exception&) {
+            r.status = SYS_INTERNAL_ERR;
+        }
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (const auto i : native_copies) {
+        auto& r = replications[i];
+        auto& destination = L1desc[r.fds.destination_l1descInx];
+        if (r.status < 0) {
+            irods::log(LOG_ERROR, fmt::format(
+                "[{}:{}] - failed to copy [{}] to [{}]; ec:[{}]",
+                __FUNCTION__, __LINE__, dataObjInps[i].objPath, destination.dataObjInfo->rescHier, r.status));
+
+            destination.bytesWritten = r.status;
+        }
+        else {
+            destination.bytesWritten = destination.dataObjInfo->dataSize;
+        }
+    }
+
+    std::vector<int> statuses;
+    statuses.reserve(replications.size());
+
+    for (std::size_t i = 0; i < replications.size(); ++i) {
+        auto& r = replications[i];
+        if (r.fds.destination_l1descInx > 0) {
+            r.status = close_and_finalize_replication(*rsComm, r.source_inp, r.destination_inp, r.fds, r.status);
+        }
+
+        if (r.status < 0 && SYS_NOT_ALLOWED != r.status) {
+            irods::log(LOG_ERROR, fmt::format(
+                "[{}:{}] - failed to replicate [{}]; ec:[{}]",
+                __FUNCTION__, __LINE__, dataObjInps[i].objPath, r.status));
+        }
+
+        statuses.push_back(r.status);
+    }
+
+    return statuses;
+} // dataObjReplBatch
+
+std::vector<int> dataObjReplToHierarchies(
+    rsComm_t* rsComm,
+    const dataObjInp_t& dataObjInp,
+    const std::vector<std::string>& destinationHierarchies,
+    int maxConcurrent)
+{
+    std::vector<dataObjInp_t> inputs(destinationHierarchies.size(), dataObjInp);
+    const irods::at_scope_exit free_cond_input{[&inputs] {
+        for (auto& inp : inputs) {
+            clearKeyVal(&inp.condInput);
+        }
+    }};
+
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        replKeyVal(&dataObjInp.condInput, &inputs[i].condInput);
+        irods::experimental::make_key_value_proxy(inputs[i].condInput)[DEST_RESC_HIER_STR_KW] = destinationHierarchies[i];
+    }
+
+    return dataObjReplBatch(rsComm, inputs, maxConcurrent);
+} // dataObjReplToHierarchies
+
 int dataObjCopy(rsComm_t* rsComm, int _destination_l1descInx)
 {
     int source_l1descInx = L1desc[_destination_l1descInx].srcL1descInx;
@@ -0,0 +1,25 @@
+#include "rs_remove_all.hpp"
+
+#include "api_plugin_number.h"
+#include "rodsErrorTable.h"
+
+#include "irods_server_api_call.hpp"
+
+#include <cstring>
+
+auto rs_remove_all(RsComm* _comm, const char* _json_input) -> int
+{
+    if (!_json_input) {
+        return SYS_INVALID_INPUT_PARAM;
+    }
+
+    bytesBuf_t input{};
+    input.buf = const_cast<char*>(_json_input);
+    input.len = static_cast<int>(std::strlen(_json_input));
+
+    // A null output tells the API not to stream progress messages. There is no client
+    // on the other end of the connection waiting for them.
+    collOprStat_t** output{};
+
+    return irods::server_api_call_without_policy(REMOVE_ALL_APN, _comm, &input, output);
+}
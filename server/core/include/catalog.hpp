@@ -26,6 +26,24 @@ namespace irods::experimental::catalog
     auto execute_transaction(
         nanodbc::connection& _db_conn,
         std::function<int(nanodbc::transaction&)> _func) -> int;
+
+    /// \brief Checks whether this process has written to the catalog
+    ///
+    /// Every transaction run through execute_transaction() counts as a write. The database
+    /// plugin keeps the read-only queries of such a process on the primary, because a read
+    /// replica may not have caught up with the write yet.
+    ///
+    /// \returns True if execute_transaction() has been called by this process
+    ///
+    /// \since 4.3.0
+    auto catalog_modified() noexcept -> bool;
+
+    /// \brief Checks whether R_OBJT_ACCESS_EFFECTIVE must be maintained alongside R_OBJT_ACCESS
+    ///
+    /// \returns The value of "db_effective_access_index" in the database plugin configuration
+    ///
+    /// \since 4.3.0
+    auto effective_access_index_enabled() -> bool;
 } // namespace irods::experimental::catalog
 
 #endif // #ifndef IRODS_CATALOG_HPP
@@ -110,6 +110,10 @@ namespace irods {
     const std::string DATABASE_OP_CHECK_AND_GET_OBJ_ID( "database_check_and_get_obj_id" );
     const std::string DATABASE_OP_GET_RCS( "database_get_rcs" );
     const std::string DATABASE_OP_GET_REPL_LIST_FOR_LEAF_BUNDLES( "database_get_repl_list_for_leaf_bundles" );
+
+/// =-=-=-=-=-=-=-
+/// @brief name of the shared memory segment holding the catalog connection leases
+    const std::string CATALOG_CONNECTION_LEASES_SHM_NAME( "irods_catalog_connection_leases" );
 }; // namespace irods
 
 #endif // __IRODS_DATABASE_CONSTANTS_HPP__
@@ -81,6 +81,8 @@ getL1descIndexByDataObjInfo( const dataObjInfo_t * dataObjInfo );
 int
 getNumThreads( rsComm_t *rsComm, rodsLong_t dataSize, int inpNumThr,
                keyValPair_t *condInput, char *destRescName, char *srcRescName, int oprType );
+void
+recordMainPortStreams( rsComm_t *rsComm, int l1descInx, int oprType );
 int
 initDataOprInp( dataOprInp_t *dataOprInp, int l1descInx, int oprType );
 int
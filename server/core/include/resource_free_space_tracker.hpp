@@ -0,0 +1,94 @@
+#ifndef IRODS_RESOURCE_FREE_SPACE_TRACKER_HPP
+#define IRODS_RESOURCE_FREE_SPACE_TRACKER_HPP
+
+/// \file
+
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <ctime>
+
+namespace irods::experimental::resource_free_space_tracker
+{
+    /// Initializes the resource free space tracker.
+    ///
+    /// This function should only be called on startup of the server.
+    ///
+    /// \param[in] _shm_name The name of the shared memory to create.
+    /// \param[in] _shm_size The size of the shared memory to allocate in bytes.
+    ///
+    /// \since 4.3.0
+    auto init(const std::string_view _shm_name = "irods_resource_free_space_tracker",
+              std::size_t _shm_size = 100'000) -> void;
+
+    /// Cleans up any resources created via init().
+    ///
+    /// This function must be called from the same process that called init().
+    ///
+    /// \since 4.3.0
+    auto deinit() noexcept -> void;
+
+    /// Returns the tracked free space of a resource.
+    ///
+    /// \param[in] _resource_name    The name of the resource.
+    /// \param[in] _refresh_interval The number of seconds a measurement stays valid.
+    ///
+    /// \return The free space in bytes, or an empty optional if the resource is not
+    ///         tracked or its last measurement is older than \p _refresh_interval.
+    ///
+    /// \since 4.3.0
+    auto lookup(std::string_view _resource_name, std::time_t _refresh_interval) -> std::optional<std::int64_t>;
+
+    /// Claims the refresh of the free space measurement of a resource.
+    ///
+    /// Only one process at a time holds the claim. The others should keep using the last
+    /// measurement, which lookup() returns for any refresh interval until a new one is
+    /// recorded. A claim is released by update() or release_refresh(). A claim that is
+    /// never released expires after \p _claim_timeout seconds.
+    ///
+    /// \param[in] _resource_name The name of the resource.
+    /// \param[in] _claim_timeout The number of seconds after which a claim expires.
+    ///
+    /// \return A boolean indicating whether the caller now holds the claim.
+    ///
+    /// \since 4.3.0
+    auto try_claim_refresh(std::string_view _resource_name, std::time_t _claim_timeout) -> bool;
+
+    /// Releases a claim taken by try_claim_refresh() without recording a measurement.
+    ///
+    /// \param[in] _resource_name The name of the resource.
+    ///
+    /// \since 4.3.0
+    auto release_refresh(std::string_view _resource_name) -> void;
+
+    /// Records a new free space measurement for a resource.
+    ///
+    /// This also releases any claim on the refresh of the resource.
+    ///
+    /// Resource names that do not fit in the tracker are ignored.
+    ///
+    /// \param[in] _resource_name The name of the resource.
+    /// \param[in] _free_bytes    The measured free space in bytes.
+    ///
+    /// \since 4.3.0
+    auto update(std::string_view _resource_name, std::int64_t _free_bytes) -> void;
+
+    /// Decrements the tracked free space of a resource by the number of bytes written.
+    ///
+    /// The free space never drops below zero. Does nothing if the resource is not tracked.
+    ///
+    /// \param[in] _resource_name The name of the resource.
+    /// \param[in] _bytes         The number of bytes written to the resource.
+    ///
+    /// \since 4.3.0
+    auto consume(std::string_view _resource_name, std::int64_t _bytes) -> void;
+
+    /// Stops tracking a resource.
+    ///
+    /// \param[in] _resource_name The name of the resource.
+    ///
+    /// \since 4.3.0
+    auto erase(std::string_view _resource_name) -> void;
+} // namespace irods::experimental::resource_free_space_tracker
+
+#endif // IRODS_RESOURCE_FREE_SPACE_TRACKER_HPP
@@ -0,0 +1,81 @@
+#ifndef IRODS_SERVER_LOAD_DIGEST_CACHE_HPP
+#define IRODS_SERVER_LOAD_DIGEST_CACHE_HPP
+
+/// \file
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <ctime>
+
+namespace irods::experimental::server_load_digest_cache
+{
+    /// Holds the most recent load information reported for a single resource.
+    ///
+    /// \since 4.3.0
+    struct load_entry
+    {
+        std::string resource_name;
+        int load_factor;
+        std::time_t create_time;
+    }; // struct load_entry
+
+    /// Initializes the server load digest cache.
+    ///
+    /// This function should only be called on startup of the server.
+    ///
+    /// \param[in] _shm_name The name of the shared memory to create.
+    /// \param[in] _shm_size The size of the shared memory to allocate in bytes.
+    ///
+    /// \since 4.3.0
+    auto init(const std::string_view _shm_name = "irods_server_load_digest_cache",
+              std::size_t _shm_size = 1'000'000) -> void;
+
+    /// Cleans up any resources created via init().
+    ///
+    /// This function must be called from the same process that called init().
+    ///
+    /// \since 4.3.0
+    auto deinit() noexcept -> void;
+
+    /// Returns the cached load information.
+    ///
+    /// \return An empty optional if the cache has never been populated.
+    ///
+    /// \since 4.3.0
+    auto entries() -> std::optional<std::vector<load_entry>>;
+
+    /// Asks the cache whether the calling agent should refresh the load information.
+    ///
+    /// At most one agent is granted the refresh per interval. A granted refresh that is
+    /// never followed by a call to update() expires after \p _refresh_interval seconds so
+    /// that another agent may take it over.
+    ///
+    /// \param[in] _refresh_interval The number of seconds the cached information stays fresh.
+    ///
+    /// \return A boolean value.
+    /// \retval true  If the caller must fetch the load information and call update().
+    /// \retval false Otherwise.
+    ///
+    /// \since 4.3.0
+    auto claim_refresh(std::time_t _refresh_interval) -> bool;
+
+    /// Replaces the cached load information and marks the cache as fresh.
+    ///
+    /// Entries whose resource name does not fit in the cache are skipped.
+    ///
+    /// \param[in] _entries The load information to store.
+    ///
+    /// \since 4.3.0
+    auto update(const std::vector<load_entry>& _entries) -> void;
+
+    /// Removes all cached load information.
+    ///
+    /// The next call to claim_refresh() will be granted.
+    ///
+    /// \since 4.3.0
+    auto clear() -> void;
+} // namespace irods::experimental::server_load_digest_cache
+
+#endif // IRODS_SERVER_LOAD_DIGEST_CACHE_HPP
@@ -3,6 +3,7 @@
 
 /// \file
 
+#include <cstdint>
 #include <string_view>
 
 struct RsComm;
@@ -35,6 +36,43 @@ namespace irods
     ///
     /// \since 4.2.9
     auto contains_session_variables(const std::string_view _rule_text) -> bool;
+
+    /// Replaces the contents of one file with a reflink to the contents of another.
+    ///
+    /// The files must be on the same filesystem and the filesystem must support
+    /// reflinks (e.g. XFS with reflink=1, Btrfs). No data is copied.
+    ///
+    /// \param[in] _src_fd The file descriptor of the source, open for reading.
+    /// \param[in] _dst_fd The file descriptor of the destination, open for writing.
+    ///
+    /// \return A boolean value.
+    /// \retval true  If the destination now shares the extents of the source.
+    /// \retval false If a reflink is not possible and the caller should copy the data.
+    ///
+    /// \since 4.3.0
+    auto reflink_file(int _src_fd, int _dst_fd) -> bool;
+
+    /// Copies a range of bytes between two files without passing the data through user space.
+    ///
+    /// The range is copied with copy_file_range(2) at the same offset in both files, and
+    /// the file offsets of the descriptors are not changed. If \p _threads is greater than
+    /// one, the range is split into that many parts which are copied concurrently.
+    ///
+    /// \param[in] _src_fd  The file descriptor of the source, open for reading.
+    /// \param[in] _dst_fd  The file descriptor of the destination, open for writing.
+    /// \param[in] _offset  The offset of the range in both files.
+    /// \param[in] _size    The number of bytes to copy.
+    /// \param[in] _threads The number of parts to copy concurrently.
+    ///
+    /// \return The number of bytes at the start of the range which were copied. A value
+    ///         less than \p _size means the caller should copy the rest with read and write.
+    ///
+    /// \since 4.3.0
+    auto copy_file_range_in_kernel(int _src_fd,
+                                   int _dst_fd,
+                                   std::int64_t _offset,
+                                   std::int64_t _size,
+                                   int _threads = 1) -> std::int64_t;
 } // namespace irods
 
 #endif // IRODS_SERVER_UTILITIES_HPP
@@ -10,24 +10,19 @@
 #include "fmt/format.h"
 #include "nanodbc/nanodbc.h"
 
+#include <atomic>
 #include <fstream>
 #include <functional>
 #include <stdexcept>
 
-namespace irods::experimental::catalog {
+namespace
+{
+    // Set by the first transaction of this process. See catalog_modified().
+    std::atomic<bool> g_catalog_modified{false};
 
-    auto new_database_connection() -> std::tuple<std::string, nanodbc::connection>
+    auto read_server_config() -> nlohmann::json
     {
-        using log       = irods::experimental::log;
-        using json      = nlohmann::json;
-
-        const std::string dsn = [] {
-            if (const char* dsn = std::getenv("irodsOdbcDSN"); dsn) {
-                return dsn;
-            }
-
-            return "iRODS Catalog";
-        }();
+        using log = irods::experimental::log;
 
         std::string config_path;
 
@@ -38,13 +33,34 @@ namespace irods::experimental::catalog {
 
         log::database::trace("Reading server configuration ...");
 
-        json config;
+        nlohmann::json config;
 
         {
             std::ifstream config_file{config_path};
             config_file >> config;
         }
 
+        return config;
+    } // read_server_config
+} // anonymous namespace
+
+namespace irods::experimental::catalog {
+
+    auto new_database_connection() -> std::tuple<std::string, nanodbc::connection>
+    {
+        using log       = irods::experimental::log;
+        using json      = nlohmann::json;
+
+        const std::string dsn = [] {
+            if (const char* dsn = std::getenv("irodsOdbcDSN"); dsn) {
+                return dsn;
+            }
+
+            return "iRODS Catalog";
+        }();
+
+        const json config = read_server_config();
+
         try {
             const auto& db_plugin_config = config.at(irods::CFG_PLUGIN_CONFIGURATION_KW).at(irods::PLUGIN_TYPE_DATABASE);
             const auto& db_instance = db_plugin_config.front();
@@ -87,8 +103,40 @@ namespace irods::experimental::catalog {
         nanodbc::connection& _db_conn,
         std::function<int(nanodbc::transaction&)> _func) -> int
     {
+        g_catalog_modified = true;
+
         nanodbc::transaction trans{_db_conn};
         return _func(trans);
     } // execute_transaction
 
+    auto catalog_modified() noexcept -> bool
+    {
+        return g_catalog_modified;
+    } // catalog_modified
+
+    auto effective_access_index_enabled() -> bool
+    {
+        // The configuration is read once per process. Changing the option requires
+        // a server restart, just like the rest of the database plugin configuration.
+        static const bool enabled = [] {
+            using log = irods::experimental::log;
+
+            try {
+                const auto config = read_server_config();
+                const auto& db_instance = config.at(irods::CFG_PLUGIN_CONFIGURATION_KW).at(irods::PLUGIN_TYPE_DATABASE).front();
+
+                if (const auto iter = db_instance.find(irods::CFG_DB_EFFECTIVE_ACCESS_INDEX_KW); iter != db_instance.end()) {
+                    return iter->get<bool>();
+                }
+            }
+            catch (const std::exception& e) {
+                log::database::error(e.what());
+            }
+
+            return false;
+        }();
+
+        return enabled;
+    } // effective_access_index_enabled
+
 } // namespace irods::experimental::catalog
@@ -65,6 +65,9 @@ char *__loc1;
 #include "irods_random.hpp"
 #include "irods_resource_manager.hpp"
 #include "irods_default_paths.hpp"
+#include "irods_resource_backport.hpp"
+#include "irods_resource_constants.hpp"
+#include "server_utilities.hpp"
 using leaf_bundle_t = irods::resource_manager::leaf_bundle_t;
 
 #include <iomanip>
@@ -1497,6 +1500,31 @@ int remLocCopy(rsComm_t *rsComm, dataCopyInp_t *dataCopyInp)
     return 0;
 } // remLocCopy
 
+namespace
+{
+    // Returns the descriptor of a file open in a unixfilesystem vault on this
+    // server, which may be given to the kernel directly, or -1 if the data must
+    // go through the resource plugin.
+    int native_fd_for_l3desc( int _l3descInx )
+    {
+        if ( _l3descInx < 3 || _l3descInx >= NUM_FILE_DESC ||
+             FileDesc[_l3descInx].inuseFlag != FD_INUSE ||
+             !FileDesc[_l3descInx].rescHier ||
+             !FileDesc[_l3descInx].rodsServerHost ||
+             FileDesc[_l3descInx].rodsServerHost->localFlag != LOCAL_HOST ) {
+            return -1;
+        }
+
+        std::string resc_type;
+        if ( !irods::get_resc_type_for_hier_string( FileDesc[_l3descInx].rescHier, resc_type ).ok() ||
+             irods::RESOURCE_TYPE_NATIVE != resc_type ) {
+            return -1;
+        }
+
+        return FileDesc[_l3descInx].fd;
+    }
+} // anonymous namespace
+
 int
 sameHostCopy( rsComm_t *rsComm, dataCopyInp_t *dataCopyInp ) {
     dataOprInp_t *dataOprInp;
@@ -1529,6 +1557,20 @@ sameHostCopy( rsComm_t *rsComm, dataCopyInp_t *dataCopyInp ) {
         return SYS_INVALID_PORTAL_OPR;
     }
 
+    // =-=-=-=-=-=-=-
+    // a whole file copied between vaults on one filesystem which supports
+    // reflinks needs no data copied at all
+    if ( dataOprInp->offset == 0 && dataSize > 0 ) {
+        const int src_fd = native_fd_for_l3desc( dataOprInp->srcL3descInx );
+        const int dest_fd = native_fd_for_l3desc( dataOprInp->destL3descInx );
+        struct stat src_stat;
+        if ( src_fd >= 0 && dest_fd >= 0 &&
+             fstat( src_fd, &src_stat ) == 0 && src_stat.st_size == dataSize &&
+             irods::reflink_file( src_fd, dest_fd ) ) {
+            return 0;
+        }
+    }
+
     memset( myInput, 0, sizeof( myInput ) );
 
     size0 = dataOprInp->dataSize / numThreads;
@@ -1646,9 +1688,27 @@ sameHostPartialCopy( portalTransferInp_t *myInput ) {
     srcL3descInx = myInput->srcFd;
     myInput->bytesWritten = 0;
 
-    if ( myInput->offset != 0 ) {
+    // =-=-=-=-=-=-=-
+    // let the kernel copy the range between vaults on this server, copying
+    // whatever it could not through the buffer below
+    const int src_fd = native_fd_for_l3desc( srcL3descInx );
+    const int dest_fd = native_fd_for_l3desc( destL3descInx );
+    if ( src_fd >= 0 && dest_fd >= 0 && myInput->size > 0 ) {
+        myInput->bytesWritten = irods::copy_file_range_in_kernel(
+                                    src_fd, dest_fd, myInput->offset, myInput->size );
+        if ( myInput->bytesWritten == myInput->size ) {
+            if ( myInput->threadNum > 0 ) {
+                _l3Close( myInput->rsComm, destL3descInx );
+                _l3Close( myInput->rsComm, srcL3descInx );
+            }
+            return;
+        }
+    }
+
+    const rodsLong_t startOffset = myInput->offset + myInput->bytesWritten;
+    if ( startOffset != 0 ) {
         myOffset = _l3Lseek( myInput->rsComm, destL3descInx,
-                             myInput->offset, SEEK_SET );
+                             startOffset, SEEK_SET );
         if ( myOffset < 0 ) {
             myInput->status = myOffset;
             rodsLog( LOG_NOTICE,
@@ -1661,7 +1721,7 @@ sameHostPartialCopy( portalTransferInp_t *myInput ) {
             return;
         }
         myOffset = _l3Lseek( myInput->rsComm, srcL3descInx,
-                             myInput->offset, SEEK_SET );
+                             startOffset, SEEK_SET );
         if ( myOffset < 0 ) {
             myInput->status = myOffset;
             rodsLog( LOG_NOTICE,
@@ -1685,7 +1745,7 @@ sameHostPartialCopy( portalTransferInp_t *myInput ) {
 
     buf = malloc( trans_buff_size );
 
-    toCopy = myInput->size;
+    toCopy = myInput->size - myInput->bytesWritten;
 
     while ( toCopy > 0 ) {
         int toRead;
@@ -30,6 +30,8 @@
 #include "get_hier_from_leaf_id.h"
 #include "key_value_proxy.hpp"
 
+#include <algorithm>
+
 int
 initL1desc() {
     memset( L1desc, 0, sizeof( L1desc ) );
@@ -477,6 +479,32 @@ getNumThreads( rsComm_t *rsComm, rodsLong_t dataSize, int inpNumThr,
     }
 }
 
+/* recordMainPortStreams - decide how many streams to the main port a client
+ * may use for the transfer on l1descInx when it asked with MAIN_PORT_STREAMS_KW.
+ * The limit of acSetNumThreads and the server applies; the result is kept as the
+ * number of threads of the open data object.
+ */
+
+void
+recordMainPortStreams( rsComm_t *rsComm, int l1descInx, int oprType ) {
+    dataObjInp_t *dataObjInp = L1desc[l1descInx].dataObjInp;
+    dataObjInfo_t *dataObjInfo = L1desc[l1descInx].dataObjInfo;
+    if ( dataObjInp == NULL || dataObjInfo == NULL ||
+            L1desc[l1descInx].remoteZoneHost != NULL ) {
+        return;
+    }
+
+    char *wanted = getValByKey( &dataObjInp->condInput, MAIN_PORT_STREAMS_KW );
+    if ( wanted == NULL ) {
+        return;
+    }
+
+    const rodsLong_t dataSize = std::max( L1desc[l1descInx].dataSize, dataObjInfo->dataSize );
+    int streams = getNumThreads( rsComm, dataSize, atoi( wanted ), &dataObjInp->condInput,
+                                 dataObjInfo->rescHier, NULL, oprType );
+    dataObjInp->numThreads = std::max( 1, std::min( streams, MAX_NUM_CONFIG_TRAN_THR ) );
+}
+
 int
 initDataOprInp( dataOprInp_t *dataOprInp, int l1descInx, int oprType ) {
     dataObjInfo_t *dataObjInfo;
@@ -0,0 +1,224 @@
+#include "resource_free_space_tracker.hpp"
+
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/allocators/allocator.hpp>
+#include <boost/interprocess/containers/vector.hpp>
+#include <boost/interprocess/sync/named_upgradable_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/interprocess/sync/sharable_lock.hpp>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace irods::experimental::resource_free_space_tracker
+{
+    namespace
+    {
+        namespace bi = boost::interprocess;
+
+        // Matches NAME_LEN, the maximum length of a resource name (including the null byte).
+        constexpr std::size_t max_resource_name_size = 64;
+
+        struct tracked_resource
+        {
+            char resource_name[max_resource_name_size];
+            std::int64_t free_bytes;
+            std::time_t last_refresh;   // 0 until the first measurement is recorded.
+            std::time_t refresh_claimed; // 0 unless a process is refreshing the measurement.
+        }; // struct tracked_resource
+
+        // clang-format off
+        using segment_manager_type = bi::managed_shared_memory::segment_manager;
+        using entry_allocator_type = bi::allocator<tracked_resource, segment_manager_type>;
+        using entry_container_type = bi::vector<tracked_resource, entry_allocator_type>;
+        // clang-format on
+
+        //
+        // Global Variables
+        //
+
+        // The following variables define the names of shared memory objects and other properties.
+        std::string g_segment_name;
+        std::size_t g_segment_size;
+        std::string g_mutex_name;
+
+        // On initialization, holds the PID of the process that initialized the tracker.
+        // This ensures that only the process that initialized the system can deinitialize it.
+        pid_t g_owner_pid;
+
+        // The following are pointers to the shared memory objects.
+        // Allocating on the heap allows us to know when the tracker is constructed/destructed.
+        std::unique_ptr<bi::managed_shared_memory> g_segment;
+        std::unique_ptr<entry_allocator_type> g_allocator;
+        std::unique_ptr<bi::named_upgradable_mutex> g_mutex;
+        entry_container_type* g_entries;
+
+        auto is_initialized() noexcept -> bool
+        {
+            return g_segment && g_mutex && g_entries;
+        } // is_initialized
+
+        auto find(std::string_view _resource_name) -> entry_container_type::iterator
+        {
+            return std::find_if(g_entries->begin(), g_entries->end(), [_resource_name](const tracked_resource& _e) {
+                return _resource_name == _e.resource_name;
+            });
+        } // find
+
+        // The caller must hold the mutex exclusively.
+        auto find_or_insert(std::string_view _resource_name) -> entry_container_type::iterator
+        {
+            if (auto iter = find(_resource_name); iter != g_entries->end()) {
+                return iter;
+            }
+
+            tracked_resource e{};
+            std::memcpy(e.resource_name, _resource_name.data(), _resource_name.size());
+            return g_entries->insert(g_entries->end(), e);
+        } // find_or_insert
+    } // anonymous namespace
+
+    auto init(const std::string_view _shm_name, std::size_t _shm_size) -> void
+    {
+        if (getpid() == g_owner_pid) {
+            return;
+        }
+
+        g_segment_name = _shm_name;
+        g_segment_size = _shm_size;
+        g_mutex_name = g_segment_name + "_mutex";
+
+        bi::named_upgradable_mutex::remove(g_mutex_name.data());
+        bi::shared_memory_object::remove(g_segment_name.data());
+
+        g_owner_pid = getpid();
+        g_segment = std::make_unique<bi::managed_shared_memory>(bi::create_only, g_segment_name.data(), g_segment_size);
+        g_allocator = std::make_unique<entry_allocator_type>(g_segment->get_segment_manager());
+        g_mutex = std::make_unique<bi::named_upgradable_mutex>(bi::create_only, g_mutex_name.data());
+        g_entries = g_segment->construct<entry_container_type>(bi::anonymous_instance)(*g_allocator);
+    } // init
+
+    auto deinit() noexcept -> void
+    {
+        // Only allow the process that called init() to remove the shared memory.
+        if (getpid() != g_owner_pid) {
+            return;
+        }
+
+        try {
+            g_owner_pid = 0;
+
+            if (g_segment && g_entries) {
+                g_segment->destroy_ptr(g_entries);
+                g_entries = nullptr;
+            }
+
+            // clang-format off
+            if (g_mutex)     { g_mutex.reset(); }
+            if (g_allocator) { g_allocator.reset(); }
+            if (g_segment)   { g_segment.reset(); }
+            // clang-format on
+
+            bi::named_upgradable_mutex::remove(g_mutex_name.data());
+            bi::shared_memory_object::remove(g_segment_name.data());
+        }
+        catch (...) {}
+    } // deinit
+
+    auto lookup(std::string_view _resource_name, std::time_t _refresh_interval) -> std::optional<std::int64_t>
+    {
+        if (!is_initialized()) {
+            return std::nullopt;
+        }
+
+        bi::sharable_lock lk{*g_mutex};
+
+        if (auto iter = find(_resource_name); iter != g_entries->end() && iter->last_refresh > 0) {
+            if (std::time(nullptr) - iter->last_refresh < _refresh_interval) {
+                return iter->free_bytes;
+            }
+        }
+
+        return std::nullopt;
+    } // lookup
+
+    auto try_claim_refresh(std::string_view _resource_name, std::time_t _claim_timeout) -> bool
+    {
+        // Without the tracker, every caller measures for itself.
+        if (!is_initialized() || _resource_name.size() >= max_resource_name_size) {
+            return true;
+        }
+
+        bi::scoped_lock lk{*g_mutex};
+
+        auto iter = find_or_insert(_resource_name);
+        const auto now = std::time(nullptr);
+
+        if (iter->refresh_claimed > 0 && now - iter->refresh_claimed < _claim_timeout) {
+            return false;
+        }
+
+        iter->refresh_claimed = now;
+
+        return true;
+    } // try_claim_refresh
+
+    auto release_refresh(std::string_view _resource_name) -> void
+    {
+        if (!is_initialized()) {
+            return;
+        }
+
+        bi::scoped_lock lk{*g_mutex};
+
+        if (auto iter = find(_resource_name); iter != g_entries->end()) {
+            iter->refresh_claimed = 0;
+        }
+    } // release_refresh
+
+    auto update(std::string_view _resource_name, std::int64_t _free_bytes) -> void
+    {
+        if (!is_initialized() || _resource_name.size() >= max_resource_name_size) {
+            return;
+        }
+
+        bi::scoped_lock lk{*g_mutex};
+
+        auto iter = find_or_insert(_resource_name);
+
+        iter->free_bytes = _free_bytes;
+        iter->last_refresh = std::time(nullptr);
+        iter->refresh_claimed = 0;
+    } // update
+
+    auto consume(std::string_view _resource_name, std::int64_t _bytes) -> void
+    {
+        if (!is_initialized() || _bytes <= 0) {
+            return;
+        }
+
+        bi::scoped_lock lk{*g_mutex};
+
+        if (auto iter = find(_resource_name); iter != g_entries->end()) {
+            iter->free_bytes = std::max<std::int64_t>(0, iter->free_bytes - _bytes);
+        }
+    } // consume
+
+    auto erase(std::string_view _resource_name) -> void
+    {
+        if (!is_initialized()) {
+            return;
+        }
+
+        bi::scoped_lock lk{*g_mutex};
+
+        if (auto iter = find(_resource_name); iter != g_entries->end()) {
+            g_entries->erase(iter);
+        }
+    } // erase
+} // namespace irods::experimental::resource_free_space_tracker
@@ -1,6 +1,7 @@
 #include "irods_at_scope_exit.hpp"
 #include "irods_configuration_keywords.hpp"
 #include "irods_configuration_parser.hpp"
+#include "irods_database_constants.hpp"
 #include "irods_get_full_path_for_config_file.hpp"
 #include "rcMisc.h"
 #include "rodsErrorTable.h"
@@ -23,6 +24,8 @@
 #include "sockCommNetworkInterface.hpp"
 #include "irods_random.hpp"
 #include "replica_access_table.hpp"
+#include "server_load_digest_cache.hpp"
+#include "resource_free_space_tracker.hpp"
 #include "irods_logger.hpp"
 #include "hostname_cache.hpp"
 #include "dns_cache.hpp"
@@ -35,6 +38,7 @@
 #include <arpa/inet.h>
 
 #include <boost/filesystem.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/convenience.hpp>
 #include <boost/range/iterator_range.hpp>
@@ -52,6 +56,7 @@
 
 // clang-format off
 namespace ix   = irods::experimental;
+namespace bi   = boost::interprocess;
 namespace hnc  = irods::experimental::net::hostname_cache;
 namespace dnsc = irods::experimental::net::dns_cache;
 // clang-format on
@@ -344,6 +349,19 @@ int main(int argc, char** argv)
     ix::replica_access_table::init();
     irods::at_scope_exit deinit_replica_access_table{[] { ix::replica_access_table::deinit(); }};
 
+    ix::server_load_digest_cache::init();
+    irods::at_scope_exit deinit_server_load_digest_cache{[] { ix::server_load_digest_cache::deinit(); }};
+
+    ix::resource_free_space_tracker::init();
+    irods::at_scope_exit deinit_resource_free_space_tracker{[] { ix::resource_free_space_tracker::deinit(); }};
+
+    // The agents of a catalog service provider create the catalog connection leases on first use.
+    // A server that stopped without removing them would hand stale leases to the next one.
+    bi::shared_memory_object::remove(irods::CATALOG_CONNECTION_LEASES_SHM_NAME.data());
+    irods::at_scope_exit remove_catalog_connection_leases{[] {
+        bi::shared_memory_object::remove(irods::CATALOG_CONNECTION_LEASES_SHM_NAME.data());
+    }};
+
     remove_leftover_rulebase_pid_files();
 
     irods::parse_and_store_hosts_configuration_file_as_json();
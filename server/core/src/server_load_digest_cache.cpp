@@ -0,0 +1,214 @@
+#include "server_load_digest_cache.hpp"
+
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/allocators/allocator.hpp>
+#include <boost/interprocess/containers/vector.hpp>
+#include <boost/interprocess/sync/named_upgradable_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/interprocess/sync/sharable_lock.hpp>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <memory>
+
+namespace irods::experimental::server_load_digest_cache
+{
+    namespace
+    {
+        namespace bi = boost::interprocess;
+
+        // Matches NAME_LEN, the maximum length of a resource name (including the null byte).
+        constexpr std::size_t max_resource_name_size = 64;
+
+        // The representation of a load_entry in shared memory.
+        struct shm_load_entry
+        {
+            char resource_name[max_resource_name_size];
+            int load_factor;
+            std::time_t create_time;
+        }; // struct shm_load_entry
+
+        // clang-format off
+        using segment_manager_type  = bi::managed_shared_memory::segment_manager;
+        using entry_allocator_type  = bi::allocator<shm_load_entry, segment_manager_type>;
+        using entry_container_type  = bi::vector<shm_load_entry, entry_allocator_type>;
+        // clang-format on
+
+        // Tracks the freshness of the cached entries.
+        struct refresh_state
+        {
+            bool populated;
+            std::time_t last_refresh;
+            std::time_t refresh_claimed_at;
+        }; // struct refresh_state
+
+        //
+        // Global Variables
+        //
+
+        // The following variables define the names of shared memory objects and other properties.
+        std::string g_segment_name;
+        std::size_t g_segment_size;
+        std::string g_mutex_name;
+
+        // On initialization, holds the PID of the process that initialized the cache.
+        // This ensures that only the process that initialized the system can deinitialize it.
+        pid_t g_owner_pid;
+
+        // The following are pointers to the shared memory objects.
+        // Allocating on the heap allows us to know when the cache is constructed/destructed.
+        std::unique_ptr<bi::managed_shared_memory> g_segment;
+        std::unique_ptr<entry_allocator_type> g_allocator;
+        std::unique_ptr<bi::named_upgradable_mutex> g_mutex;
+        entry_container_type* g_entries;
+        refresh_state* g_state;
+
+        auto is_initialized() noexcept -> bool
+        {
+            return g_segment && g_mutex && g_entries && g_state;
+        } // is_initialized
+    } // anonymous namespace
+
+    auto init(const std::string_view _shm_name, std::size_t _shm_size) -> void
+    {
+        if (getpid() == g_owner_pid) {
+            return;
+        }
+
+        g_segment_name = _shm_name;
+        g_segment_size = _shm_size;
+        g_mutex_name = g_segment_name + "_mutex";
+
+        bi::named_upgradable_mutex::remove(g_mutex_name.data());
+        bi::shared_memory_object::remove(g_segment_name.data());
+
+        g_owner_pid = getpid();
+        g_segment = std::make_unique<bi::managed_shared_memory>(bi::create_only, g_segment_name.data(), g_segment_size);
+        g_allocator = std::make_unique<entry_allocator_type>(g_segment->get_segment_manager());
+        g_mutex = std::make_unique<bi::named_upgradable_mutex>(bi::create_only, g_mutex_name.data());
+        g_entries = g_segment->construct<entry_container_type>(bi::anonymous_instance)(*g_allocator);
+        g_state = g_segment->construct<refresh_state>(bi::anonymous_instance)(refresh_state{false, 0, 0});
+    } // init
+
+    auto deinit() noexcept -> void
+    {
+        // Only allow the process that called init() to remove the shared memory.
+        if (getpid() != g_owner_pid) {
+            return;
+        }
+
+        try {
+            g_owner_pid = 0;
+
+            if (g_segment) {
+                // clang-format off
+                if (g_entries) { g_segment->destroy_ptr(g_entries); }
+                if (g_state)   { g_segment->destroy_ptr(g_state); }
+                // clang-format on
+            }
+
+            g_entries = nullptr;
+            g_state = nullptr;
+
+            // clang-format off
+            if (g_mutex)     { g_mutex.reset(); }
+            if (g_allocator) { g_allocator.reset(); }
+            if (g_segment)   { g_segment.reset(); }
+            // clang-format on
+
+            bi::named_upgradable_mutex::remove(g_mutex_name.data());
+            bi::shared_memory_object::remove(g_segment_name.data());
+        }
+        catch (...) {}
+    } // deinit
+
+    auto entries() -> std::optional<std::vector<load_entry>>
+    {
+        if (!is_initialized()) {
+            return std::nullopt;
+        }
+
+        bi::sharable_lock lk{*g_mutex};
+
+        if (!g_state->populated) {
+            return std::nullopt;
+        }
+
+        std::vector<load_entry> result;
+        result.reserve(g_entries->size());
+
+        for (auto&& e : *g_entries) {
+            result.push_back({e.resource_name, e.load_factor, e.create_time});
+        }
+
+        return result;
+    } // entries
+
+    auto claim_refresh(std::time_t _refresh_interval) -> bool
+    {
+        // Without shared memory, every caller is on its own.
+        if (!is_initialized()) {
+            return true;
+        }
+
+        bi::scoped_lock lk{*g_mutex};
+
+        const auto now = std::time(nullptr);
+
+        if (g_state->populated && now - g_state->last_refresh < _refresh_interval) {
+            return false;
+        }
+
+        // Another agent is already refreshing the cache.
+        if (g_state->refresh_claimed_at > 0 && now - g_state->refresh_claimed_at < _refresh_interval) {
+            return false;
+        }
+
+        g_state->refresh_claimed_at = now;
+
+        return true;
+    } // claim_refresh
+
+    auto update(const std::vector<load_entry>& _entries) -> void
+    {
+        if (!is_initialized()) {
+            return;
+        }
+
+        bi::scoped_lock lk{*g_mutex};
+
+        g_entries->clear();
+        g_entries->reserve(_entries.size());
+
+        for (auto&& e : _entries) {
+            if (e.resource_name.size() >= max_resource_name_size) {
+                continue;
+            }
+
+            shm_load_entry shm_entry{};
+            std::strncpy(shm_entry.resource_name, e.resource_name.data(), max_resource_name_size - 1);
+            shm_entry.load_factor = e.load_factor;
+            shm_entry.create_time = e.create_time;
+
+            g_entries->push_back(shm_entry);
+        }
+
+        g_state->populated = true;
+        g_state->last_refresh = std::time(nullptr);
+        g_state->refresh_claimed_at = 0;
+    } // update
+
+    auto clear() -> void
+    {
+        if (!is_initialized()) {
+            return;
+        }
+
+        bi::scoped_lock lk{*g_mutex};
+
+        g_entries->clear();
+        *g_state = refresh_state{false, 0, 0};
+    } // clear
+} // namespace irods::experimental::server_load_digest_cache
@@ -6,7 +6,19 @@
 #define IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
 #include "filesystem.hpp"
 
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+
+#ifdef __linux__
+#  include <linux/fs.h>
+#endif
+
+#include <algorithm>
 #include <regex>
+#include <thread>
+#include <vector>
 
 namespace irods
 {
@@ -39,5 +51,84 @@ namespace irods
 
         return std::regex_search(_rule_text.data(), session_vars_pattern);
     }
+
+    auto reflink_file(int _src_fd, int _dst_fd) -> bool
+    {
+#ifdef FICLONE
+        return ioctl(_dst_fd, FICLONE, _src_fd) == 0;
+#else
+        return false;
+#endif
+    }
+
+    auto copy_file_range_in_kernel(int _src_fd,
+                                   int _dst_fd,
+                                   std::int64_t _offset,
+                                   std::int64_t _size,
+                                   int _threads) -> std::int64_t
+    {
+#ifdef SYS_copy_file_range
+        // Copies one part of the range, stopping at the first error. Filesystems
+        // which cannot copy between the two files (e.g. EXDEV, ENOSYS, EOPNOTSUPP)
+        // fail before any data is copied.
+        const auto copy_part = [_src_fd, _dst_fd](std::int64_t _part_offset, std::int64_t _part_size) -> std::int64_t {
+            loff_t src_offset = _part_offset;
+            loff_t dst_offset = _part_offset;
+            std::int64_t copied = 0;
+
+            while (copied < _part_size) {
+                const auto n = syscall(SYS_copy_file_range, _src_fd, &src_offset, _dst_fd, &dst_offset, _part_size - copied, 0);
+
+                if (n < 0 && EINTR == errno) {
+                    continue;
+                }
+
+                if (n <= 0) {
+                    break;
+                }
+
+                copied += n;
+            }
+
+            return copied;
+        };
+
+        const auto parts = std::max<std::int64_t>(std::min<std::int64_t>(_threads, _size), 1);
+
+        if (1 == parts) {
+            return copy_part(_offset, _size);
+        }
+
+        const auto part_size = _size / parts;
+        std::vector<std::int64_t> copied(parts);
+        std::vector<std::thread> threads;
+
+        for (std::int64_t i = 0; i < parts; ++i) {
+            const auto size = (i == parts - 1) ? _size - part_size * i : part_size;
+            threads.emplace_back([&copy_part, &copied, i, offset = _offset + part_size * i, size] {
+                copied[i] = copy_part(offset, size);
+            });
+        }
+
+        for (auto&& t : threads) {
+            t.join();
+        }
+
+        // Only the bytes before the first incomplete part are known to be copied.
+        std::int64_t total = 0;
+
+        for (std::int64_t i = 0; i < parts; ++i) {
+            total += copied[i];
+
+            if (copied[i] < ((i == parts - 1) ? _size - part_size * i : part_size)) {
+                break;
+            }
+        }
+
+        return total;
+#else
+        return 0;
+#endif
+    }
 } // namespace irods
 
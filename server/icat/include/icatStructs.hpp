@@ -32,6 +32,7 @@ typedef struct {
     char databasePassword[DB_PASSWORD_LEN];  /* password for accessing the db */
     int         databaseType;     /* DB type, DB_TYPE_POSTGRES, etc */
     char        database_plugin_type[ DB_TYPENAME_LEN ];
+    char        odbcEntryName[ DB_TYPENAME_LEN ]; /* ODBC entry (DSN) to connect to, if not the default */
 } icatSessionStruct;
 
 
@@ -162,6 +162,51 @@ TEST_CASE("filesystem")
         REQUIRE(fs::client::remove_all(conn, sandbox / "col2", {true, false, false, true, false}));
     }
 
+    SECTION("remove a collection tree containing data objects")
+    {
+        // The sibling's name would match the tree if LIKE wildcards were not escaped.
+        const auto tree = sandbox / "tree_%";
+        const auto sibling = sandbox / "treeX_%";
+
+        REQUIRE(fs::client::create_collections(conn, tree / "a/b"));
+        REQUIRE(fs::client::create_collection(conn, sibling));
+
+        std::vector<fs::path> data_objects;
+
+        for (auto&& collection : {tree, tree / "a", tree / "a/b", sibling}) {
+            for (int i = 0; i < 3; ++i) {
+                data_objects.push_back(collection / fmt::format("data_object.{}", i));
+                default_transport tp{conn};
+                odstream{tp, data_objects.back()} << "remove_all";
+            }
+        }
+
+        std::vector<std::string> physical_paths;
+
+        for (auto&& collection : {tree, tree / "a", tree / "a/b"}) {
+            const auto gql = fmt::format("select DATA_PATH where COLL_NAME = '{}'", collection.c_str());
+
+            for (auto&& row : irods::query{static_cast<rcComm_t*>(conn), gql}) {
+                physical_paths.push_back(row[0]);
+            }
+        }
+
+        REQUIRE(physical_paths.size() == 9);
+        REQUIRE(fs::client::remove_all(conn, tree, fs::remove_options::no_trash) > 0);
+
+        REQUIRE_FALSE(fs::client::exists(conn, tree));
+
+        for (auto&& p : physical_paths) {
+            REQUIRE_FALSE(boost::filesystem::exists(p));
+        }
+
+        REQUIRE(fs::client::exists(conn, sibling));
+
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(fs::client::exists(conn, sibling / fmt::format("data_object.{}", i)));
+        }
+    }
+
     SECTION("existence checking")
     {
         REQUIRE(fs::client::exists(conn, sandbox));
@@ -171,6 +216,66 @@ TEST_CASE("filesystem")
         REQUIRE_FALSE(fs::client::exists(fs::client::status(conn, sandbox / "bogus")));
     }
 
+    SECTION("metadata and status cache")
+    {
+        namespace cache = fs::client::cache;
+
+        cache::enable({100, std::chrono::minutes{1}});
+        irods::at_scope_exit disable_cache{[] { cache::disable(); }};
+        cache::reset_statistics();
+
+        const auto p = sandbox / "cached.txt";
+
+        {
+            default_transport tp{conn};
+            odstream{tp, p} << "cached";
+        }
+
+        // The first lookup is a miss and populates the cache.
+        REQUIRE(fs::client::is_data_object(conn, p));
+        REQUIRE(cache::statistics().hits == 0);
+
+        REQUIRE(fs::client::exists(conn, p));
+        REQUIRE(fs::client::is_data_object(fs::client::status(conn, p)));
+        REQUIRE(cache::statistics().hits == 2);
+
+        // Mutating operations invalidate the path.
+        const fs::metadata md{"cache_attr", "cache_value", "cache_units"};
+        REQUIRE(fs::client::get_metadata(conn, p).empty());
+        fs::client::set_metadata(conn, p, md);
+
+        const auto avus = fs::client::get_metadata(conn, p);
+        REQUIRE(avus.size() == 1);
+        REQUIRE(avus[0].attribute == md.attribute);
+
+        const auto renamed = sandbox / "cached_renamed.txt";
+        fs::client::rename(conn, p, renamed);
+        REQUIRE_FALSE(fs::client::exists(conn, p));
+        REQUIRE(fs::client::exists(conn, renamed));
+
+        // Collection iteration populates the cache in bulk.
+        cache::clear();
+        cache::reset_statistics();
+
+        for (auto&& e : fs::client::collection_iterator{conn, sandbox}) {
+            static_cast<void>(e);
+        }
+
+        REQUIRE(fs::client::is_data_object(conn, renamed));
+        REQUIRE(cache::statistics().hits == 1);
+        REQUIRE(cache::statistics().misses == 0);
+
+        REQUIRE(fs::client::remove(conn, renamed, fs::remove_options::no_trash));
+        REQUIRE_FALSE(fs::client::exists(conn, renamed));
+
+        // The least recently used entries are evicted when the cache is full.
+        cache::enable({1, std::chrono::minutes{1}});
+        REQUIRE(fs::client::exists(conn, sandbox));
+        REQUIRE(fs::client::exists(conn, sandbox.parent_path()));
+        REQUIRE(cache::statistics().entries == 1);
+        REQUIRE(cache::statistics().evictions > 0);
+    }
+
     SECTION("equivalence checking")
     {
         const auto p = sandbox / ".." / *std::rbegin(sandbox);
@@ -432,6 +537,50 @@ TEST_CASE("filesystem")
             REQUIRE(expected_entries == entries);
         }
 
+        SECTION("recursive collection iterator with bulk listing")
+        {
+            constexpr auto bulk_listing = fs::client::collection_options::bulk_listing;
+
+            std::vector<std::string> entries;
+
+            for (fs::client::recursive_collection_iterator iter{conn, sandbox, bulk_listing}, end; iter != end; ++iter) {
+                entries.push_back(iter->path().string());
+
+                // Members of a collection must be at a greater depth than the collection.
+                REQUIRE(iter.depth() == (iter->path().parent_path() == sandbox ? 0 : 1));
+            }
+
+            std::sort(std::begin(entries), std::end(entries));
+
+            // The sorted list of paths that the "entries" vector must match.
+            const std::vector expected_entries{
+                col1.string(),
+                (col1 / "f1.txt").string(),
+                (col1 / "f2.txt").string(),
+                (col1 / "f3.txt").string(),
+                col2.string(),
+                (sandbox / "f1.txt").string(),
+                (sandbox / "f2.txt").string(),
+                (sandbox / "f3.txt").string()
+            };
+
+            REQUIRE(expected_entries == entries);
+
+            // Skipping a collection must skip everything under it.
+            entries.clear();
+
+            for (fs::client::recursive_collection_iterator iter{conn, sandbox, bulk_listing}, end; iter != end; ++iter) {
+                entries.push_back(iter->path().string());
+
+                if (iter->path() == col1) {
+                    iter.disable_recursion_pending();
+                }
+            }
+
+            REQUIRE(std::find(std::begin(entries), std::end(entries), (col1 / "f1.txt").string()) == std::end(entries));
+            REQUIRE(entries.size() == 5);
+        }
+
         // Clean-up.
         REQUIRE(fs::client::remove(conn, sandbox / "f1.txt", fs::remove_options::no_trash));
         REQUIRE(fs::client::remove(conn, sandbox / "f2.txt", fs::remove_options::no_trash));
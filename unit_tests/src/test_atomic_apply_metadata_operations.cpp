@@ -8,11 +8,14 @@
 #include "connection_pool.hpp"
 #include "filesystem/path.hpp"
 #include "irods_at_scope_exit.hpp"
+#include "irods_query.hpp"
 
 #include "json.hpp"
+#include "fmt/format.h"
 
 #include <cstdlib>
 #include <string>
+#include <vector>
 
 namespace fs = irods::experimental::filesystem;
 
@@ -258,6 +261,112 @@ TEST_CASE("atomic_apply_metadata_operations")
         REQUIRE(json_error_string == "{}"s);
     }
 
+    SECTION("database errors report the operation that failed")
+    {
+        // R_META_MAIN.meta_attr_unit holds at most 250 characters.
+        const auto ops = json::array({
+            {
+                {"operation", "add"},
+                {"attribute", "the_attr"},
+                {"value", "the_val"}
+            },
+            {
+                {"operation", "add"},
+                {"attribute", "the_attr"},
+                {"value", "the_val"},
+                {"units", std::string(300, 'u')}
+            }
+        });
+
+        const auto json_input = json{
+            {"entity_name", user_home},
+            {"entity_type", "collection"},
+            {"operations", ops}
+        }.dump();
+
+        char* json_error_string{};
+        irods::at_scope_exit free_memory{[&json_error_string] { std::free(json_error_string); }};
+
+        REQUIRE(rc_atomic_apply_metadata_operations(conn_ptr, json_input.c_str(), &json_error_string) != 0);
+        REQUIRE(contains_error_information(json_error_string));
+
+        const auto err_info = json::parse(json_error_string);
+        REQUIRE(err_info.at("operation_index").get<int>() == 1);
+        REQUIRE(err_info.at("operation") == ops[1]);
+
+        // Nothing was applied.
+        const auto gql = fmt::format("select META_COLL_ATTR_NAME where COLL_NAME = '{}'", user_home);
+        REQUIRE(irods::query{conn_ptr, gql}.size() == 0);
+    }
+
+    SECTION("large batches and repeated AVUs produce the same result as sequential operations")
+    {
+        constexpr auto avu_count = 250;
+
+        auto operations = json::array();
+
+        for (int i = 0; i < avu_count; ++i) {
+            operations.push_back({
+                {"operation", "add"},
+                {"attribute", "batch_attr"},
+                {"value", std::to_string(i)},
+                {"units", "batch_units"}
+            });
+        }
+
+        // The last operation on an AVU determines whether it remains attached.
+        operations.push_back({{"operation", "remove"}, {"attribute", "batch_attr"}, {"value", "0"}, {"units", "batch_units"}});
+        operations.push_back({{"operation", "remove"}, {"attribute", "batch_attr"}, {"value", "1"}, {"units", "batch_units"}});
+        operations.push_back({{"operation", "add"}, {"attribute", "batch_attr"}, {"value", "1"}, {"units", "batch_units"}});
+        operations.push_back({{"operation", "add"}, {"attribute", "batch_attr"}, {"value", "2"}, {"units", "batch_units"}});
+
+        const auto json_input = json{
+            {"entity_name", user_home},
+            {"entity_type", "collection"},
+            {"operations", operations}
+        }.dump();
+
+        char* json_error_string{};
+        irods::at_scope_exit free_memory{[&json_error_string] { std::free(json_error_string); }};
+
+        REQUIRE(rc_atomic_apply_metadata_operations(conn_ptr, json_input.c_str(), &json_error_string) == 0);
+        REQUIRE(json_error_string == "{}"s);
+
+        const auto gql = fmt::format("select count(META_COLL_ATTR_VALUE) where COLL_NAME = '{}' and META_COLL_ATTR_NAME = 'batch_attr'",
+                                     user_home);
+
+        for (auto&& row : irods::query{conn_ptr, gql}) {
+            REQUIRE(row[0] == std::to_string(avu_count - 1));
+        }
+
+        // Clean up.
+        operations = json::array();
+
+        for (int i = 0; i < avu_count; ++i) {
+            operations.push_back({
+                {"operation", "remove"},
+                {"attribute", "batch_attr"},
+                {"value", std::to_string(i)},
+                {"units", "batch_units"}
+            });
+        }
+
+        const auto cleanup_input = json{
+            {"entity_name", user_home},
+            {"entity_type", "collection"},
+            {"operations", operations}
+        }.dump();
+
+        char* cleanup_error_string{};
+        irods::at_scope_exit free_cleanup_memory{[&cleanup_error_string] { std::free(cleanup_error_string); }};
+
+        REQUIRE(rc_atomic_apply_metadata_operations(conn_ptr, cleanup_input.c_str(), &cleanup_error_string) == 0);
+
+        for (auto&& row : irods::query{conn_ptr, gql}) {
+            REQUIRE(row[0] == "0");
+        }
+    }
+
     SECTION("users")
     {
         const auto json_input = json{
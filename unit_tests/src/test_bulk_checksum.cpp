@@ -0,0 +1,204 @@
+#include "catch.hpp"
+
+#include "bulk_checksum.h"
+#include "client_connection.hpp"
+#include "dataObjChksum.h"
+#include "data_object_proxy.hpp"
+#include "dstream.hpp"
+#include "filesystem.hpp"
+#include "irods_at_scope_exit.hpp"
+#include "key_value_proxy.hpp"
+#include "modDataObjMeta.h"
+#include "replica_proxy.hpp"
+#include "rodsClient.h"
+#include "transport/default_transport.hpp"
+
+#include "json.hpp"
+#include "fmt/format.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ix = irods::experimental;
+namespace fs = irods::experimental::filesystem;
+namespace io = irods::experimental::io;
+
+using json = nlohmann::json;
+
+namespace
+{
+    auto write_data_object(RcComm& _comm, const fs::path& _path, const std::string& _contents) -> void
+    {
+        io::client::default_transport tp{_comm};
+        io::odstream{tp, _path} << _contents;
+    }
+
+    auto checksum_in_catalog(RcComm& _comm, const fs::path& _path) -> std::string
+    {
+        auto [data_object, lm] = ix::data_object::make_data_object_proxy(_comm, _path);
+        return std::string{data_object.replicas().front().checksum()};
+    }
+
+    // Computes the checksum of the first replica with rcDataObjChksum and records it.
+    auto compute_checksum(RcComm& _comm, const fs::path& _path) -> std::string
+    {
+        DataObjInp input{};
+        std::strcpy(input.objPath, _path.c_str());
+        ix::key_value_proxy kvp{input.condInput};
+        irods::at_scope_exit free_memory{[&kvp] { kvp.clear(); }};
+        kvp[FORCE_CHKSUM_KW] = "";
+
+        char* checksum{};
+        REQUIRE(rcDataObjChksum(&_comm, &input, &checksum) == 0);
+        irods::at_scope_exit free_checksum{[&checksum] { std::free(checksum); }};
+
+        return checksum;
+    }
+
+    auto set_checksum_in_catalog(RcComm& _comm, const fs::path& _path, const std::string& _checksum) -> void
+    {
+        auto [data_object, lm] = ix::data_object::make_data_object_proxy(_comm, _path);
+        const auto& replica = data_object.replicas().front();
+
+        DataObjInfo info{};
+        std::strcpy(info.objPath, _path.c_str());
+        std::strcpy(info.rescHier, replica.hierarchy().data());
+        info.replNum = replica.replica_number();
+
+        KeyValPair reg_params{};
+        irods::at_scope_exit free_memory{[&reg_params] { clearKeyVal(&reg_params); }};
+        addKeyVal(&reg_params, CHKSUM_KW, _checksum.c_str());
+
+        modDataObjMeta_t input{&info, &reg_params};
+        REQUIRE(rcModDataObjMeta(&_comm, &input) == 0);
+    }
+
+    auto bulk_checksum(RcComm& _comm, const json& _input) -> int
+    {
+        return rc_bulk_checksum(&_comm, _input.dump().c_str(), 0);
+    }
+} // anonymous namespace
+
+TEST_CASE("bulk_checksum")
+{
+    using namespace std::chrono_literals;
+
+    load_client_api_plugins();
+
+    ix::client_connection conn;
+    RcComm& comm = static_cast<RcComm&>(conn);
+
+    rodsEnv env;
+    _getRodsEnv(env);
+
+    const auto sandbox = fs::path{env.rodsHome} / "test_bulk_checksum";
+
+    if (!fs::client::exists(comm, sandbox)) {
+        REQUIRE(fs::client::create_collection(comm, sandbox));
+    }
+
+    irods::at_scope_exit remove_sandbox{[&sandbox] {
+        ix::client_connection conn;
+        REQUIRE(fs::client::remove_all(static_cast<RcComm&>(conn), sandbox, fs::remove_options::no_trash));
+    }};
+
+    // Enough data objects for the workers to be used.
+    std::vector<fs::path> data_objects;
+
+    for (int i = 0; i < 10; ++i) {
+        data_objects.push_back(sandbox / fmt::format("data_object.{}", i));
+        write_data_object(comm, data_objects.back(), fmt::format("contents of data object {}", i));
+    }
+
+    SECTION("compute records missing checksums and keeps existing ones")
+    {
+        set_checksum_in_catalog(comm, data_objects[0], "sha2:kept");
+
+        REQUIRE(bulk_checksum(comm, {{"logical_path", sandbox.c_str()}, {"options", {{"thread_count", 4}}}}) == 0);
+
+        REQUIRE(checksum_in_catalog(comm, data_objects[0]) == "sha2:kept");
+
+        for (std::size_t i = 1; i < data_objects.size(); ++i) {
+            const auto checksum = checksum_in_catalog(comm, data_objects[i]);
+            REQUIRE_FALSE(checksum.empty());
+            REQUIRE(checksum == compute_checksum(comm, data_objects[i]));
+        }
+    }
+
+    SECTION("force replaces existing checksums")
+    {
+        for (auto&& p : data_objects) {
+            set_checksum_in_catalog(comm, p, "sha2:replaced");
+        }
+
+        REQUIRE(bulk_checksum(comm, {{"logical_path", sandbox.c_str()}, {"options", {{"force", true}, {"thread_count", 4}}}}) == 0);
+
+        for (auto&& p : data_objects) {
+            const auto checksum = checksum_in_catalog(comm, p);
+            REQUIRE(checksum != "sha2:replaced");
+            REQUIRE(checksum == compute_checksum(comm, p));
+        }
+    }
+
+    SECTION("only the data objects in the manifest are checksummed")
+    {
+        const std::vector<std::string> manifest{data_objects[1].string(), data_objects[3].string()};
+
+        REQUIRE(bulk_checksum(comm, {{"data_objects", manifest}}) == 0);
+
+        for (std::size_t i = 0; i < data_objects.size(); ++i) {
+            const bool listed = i == 1 || i == 3;
+            REQUIRE(checksum_in_catalog(comm, data_objects[i]).empty() == !listed);
+        }
+    }
+
+    SECTION("thread counts beyond the server maximum are clamped")
+    {
+        const json options{{"thread_count", 1000000}, {"max_concurrent_per_resource", 1000000}};
+        REQUIRE(bulk_checksum(comm, {{"logical_path", sandbox.c_str()}, {"options", options}}) == 0);
+
+        for (auto&& p : data_objects) {
+            REQUIRE_FALSE(checksum_in_catalog(comm, p).empty());
+        }
+    }
+
+    SECTION("replicas modified during checksumming are not overwritten")
+    {
+        // Checksumming the large data object keeps the request busy while the small one changes.
+        const auto large_object = sandbox / "large_object";
+
+        {
+            const std::string chunk(1024 * 1024, 'x');
+            io::client::default_transport tp{comm};
+            io::odstream out{tp, large_object};
+
+            for (int i = 0; i < 256; ++i) {
+                out.write(chunk.data(), chunk.size());
+            }
+        }
+
+        // Modification times are recorded in seconds.
+        std::this_thread::sleep_for(1s);
+
+        const auto& modified_object = data_objects[0];
+
+        std::thread request{[&sandbox] {
+            ix::client_connection conn;
+            bulk_checksum(static_cast<RcComm&>(conn), {{"logical_path", sandbox.c_str()}, {"options", {{"thread_count", 1}}}});
+        }};
+
+        std::this_thread::sleep_for(250ms);
+        write_data_object(comm, modified_object, "new contents written while checksumming");
+
+        request.join();
+
+        // The checksum of the old contents must not have been recorded for the new ones.
+        if (const auto checksum = checksum_in_catalog(comm, modified_object); !checksum.empty()) {
+            REQUIRE(checksum == compute_checksum(comm, modified_object));
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#include "catch.hpp"
+
+#include "irods_catalog_connection_broker.hpp"
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+
+namespace ccb = irods::experimental::catalog_connection_broker;
+
+namespace
+{
+    // Keeps the leases of this test apart from those of a running server.
+    constexpr const char* shm_name = "irods_unit_test_catalog_connection_leases";
+
+    // Waits for a lease in a child process and returns the pid of the child. The child
+    // exits with 0 if the lease was granted without running into the timeout.
+    auto acquire_in_child() -> pid_t
+    {
+        const auto pid = fork();
+
+        if (pid == 0) {
+            const auto before = ccb::stats().leases_granted_after_timeout;
+            ccb::acquire();
+            const auto timed_out = ccb::stats().leases_granted_after_timeout != before;
+            ccb::release();
+            _exit(timed_out ? 1 : 0);
+        }
+
+        return pid;
+    }
+
+    auto wait_for_exit_code(pid_t _pid) -> int
+    {
+        int status = 0;
+        waitpid(_pid, &status, 0);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+} // anonymous namespace
+
+TEST_CASE("catalog_connection_broker")
+{
+    using namespace std::chrono_literals;
+
+    ccb::remove_shared_memory(shm_name);
+
+    SECTION("disabled broker grants nothing")
+    {
+        ccb::configure(0, 0, shm_name);
+        REQUIRE_FALSE(ccb::enabled());
+
+        ccb::acquire();
+        REQUIRE_FALSE(ccb::holds_lease());
+    }
+
+    SECTION("leases are counted")
+    {
+        ccb::configure(1, 30, shm_name);
+        REQUIRE(ccb::enabled());
+
+        const auto before = ccb::stats();
+
+        ccb::acquire();
+        REQUIRE(ccb::holds_lease());
+        REQUIRE(ccb::stats().leases_held == before.leases_held + 1);
+        REQUIRE(ccb::stats().leases_granted == before.leases_granted + 1);
+
+        ccb::release();
+        REQUIRE_FALSE(ccb::holds_lease());
+        REQUIRE(ccb::stats().leases_held == before.leases_held);
+    }
+
+    SECTION("waiting agents are served when a lease is released")
+    {
+        ccb::configure(1, 30, shm_name);
+        ccb::acquire();
+
+        const auto child = acquire_in_child();
+
+        // The child queues up behind the lease held by this process.
+        const auto deadline = std::chrono::steady_clock::now() + 10s;
+        while (!ccb::agents_waiting() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(10ms);
+        }
+
+        REQUIRE(ccb::agents_waiting());
+
+        ccb::release();
+        REQUIRE(wait_for_exit_code(child) == 0);
+        REQUIRE_FALSE(ccb::agents_waiting());
+    }
+
+    SECTION("waiting agents connect anyway after the timeout")
+    {
+        ccb::configure(1, 1, shm_name);
+        ccb::acquire();
+
+        const auto child = acquire_in_child();
+        REQUIRE(wait_for_exit_code(child) == 1);
+
+        ccb::release();
+    }
+
+    SECTION("leases of agents which exited are reclaimed")
+    {
+        ccb::configure(1, 30, shm_name);
+
+        // The child exits while holding its lease.
+        const auto pid = fork();
+        if (pid == 0) {
+            ccb::acquire();
+            _exit(0);
+        }
+        REQUIRE(wait_for_exit_code(pid) == 0);
+
+        const auto before = ccb::stats().leases_granted_after_timeout;
+        ccb::acquire();
+        REQUIRE(ccb::holds_lease());
+        REQUIRE(ccb::stats().leases_granted_after_timeout == before);
+        ccb::release();
+    }
+
+    ccb::remove_shared_memory(shm_name);
+}
@@ -0,0 +1,196 @@
+#include "catch.hpp"
+
+#include "catalog.hpp"
+#include "icatDefines.h"
+#include "irods_at_scope_exit.hpp"
+#include "irods_configuration_keywords.hpp"
+#include "irods_get_full_path_for_config_file.hpp"
+#include "low_level_odbc.hpp"
+
+#include "json.hpp"
+#include "nanodbc/nanodbc.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+namespace ic = irods::experimental::catalog;
+
+namespace
+{
+    // Connects a session the way the database plugin does, using the credentials
+    // from server_config.json.
+    auto connect(icatSessionStruct& _icss) -> void
+    {
+        std::string config_path;
+        REQUIRE(irods::get_full_path_for_config_file("server_config.json", config_path).ok());
+
+        nlohmann::json config;
+        std::ifstream{config_path} >> config;
+
+        const auto& db_plugin_config = config.at(irods::CFG_PLUGIN_CONFIGURATION_KW).at(irods::PLUGIN_TYPE_DATABASE);
+        const auto& db_instance_name = db_plugin_config.items().begin().key();
+        const auto& db_instance = db_plugin_config.front();
+
+        std::snprintf(_icss.databaseUsername, DB_USERNAME_LEN, "%s",
+                      db_instance.at(irods::CFG_DB_USERNAME_KW).get<std::string>().c_str());
+        std::snprintf(_icss.databasePassword, DB_PASSWORD_LEN, "%s",
+                      db_instance.at(irods::CFG_DB_PASSWORD_KW).get<std::string>().c_str());
+
+        _icss.databaseType = DB_TYPE_POSTGRES;
+
+        if (db_instance_name == "mysql") {
+            _icss.databaseType = DB_TYPE_MYSQL;
+        }
+        else if (db_instance_name == "oracle") {
+            _icss.databaseType = DB_TYPE_ORACLE;
+        }
+
+        REQUIRE(cllOpenEnv(&_icss) == 0);
+        REQUIRE(cllConnect(&_icss) == 0);
+        _icss.status = 1;
+    }
+
+    auto disconnect(icatSessionStruct& _icss) -> void
+    {
+        cllDisconnect(&_icss);
+        cllCloseEnv(&_icss);
+    }
+
+    auto count_specific_queries(icatSessionStruct& _icss, const std::string& _alias) -> int
+    {
+        const auto sql = "select count(*) from R_SPECIFIC_QUERY where alias = '" + _alias + "'";
+
+        int stmt{};
+        REQUIRE(cllExecSqlWithResult(&_icss, &stmt, sql.c_str()) == 0);
+        irods::at_scope_exit free_statement{[&_icss, &stmt] { cllFreeStatement(&_icss, stmt); }};
+
+        REQUIRE(cllGetRow(&_icss, stmt) == 0);
+
+        auto* statement = _icss.stmtPtr[stmt];
+        REQUIRE(statement->numOfCols == 1);
+
+        return std::atoi(statement->resultValue[0]);
+    }
+
+    // Mirrors the choice made by the database plugin for read-only queries.
+    auto read_only_session(icatSessionStruct& _primary, icatSessionStruct& _replica) -> icatSessionStruct&
+    {
+        return cllReadsMayUseReplica(1) ? _replica : _primary;
+    }
+} // anonymous namespace
+
+// This test case must run first. Once the process has written to the catalog, reads
+// never go to the replica again.
+TEST_CASE("reads after a nanodbc transaction go to the primary")
+{
+    // Both sessions connect to the same database. The "replica" session does not see
+    // changes the primary session has not committed, just like a lagging replica.
+    icatSessionStruct primary{};
+    icatSessionStruct replica{};
+    connect(primary);
+    connect(replica);
+
+    irods::at_scope_exit disconnect_sessions{[&primary, &replica] {
+        disconnect(replica);
+        disconnect(primary);
+    }};
+
+    REQUIRE_FALSE(ic::catalog_modified());
+    REQUIRE(cllReadsMayUseReplica(1));
+    REQUIRE(&read_only_session(primary, replica) == &replica);
+
+    const std::string alias = "test_catalog_pending_writes_nanodbc";
+
+    auto [db_instance_name, db_conn] = ic::new_database_connection();
+
+    irods::at_scope_exit remove_specific_query{[&db_conn, &alias] {
+        nanodbc::transaction trans{db_conn};
+        nanodbc::statement stmt{db_conn};
+        prepare(stmt, "delete from R_SPECIFIC_QUERY where alias = ?");
+        stmt.bind(0, alias.c_str());
+        nanodbc::execute(stmt);
+        trans.commit();
+    }};
+
+    ic::execute_transaction(db_conn, [&](auto& _trans) {
+        nanodbc::statement stmt{db_conn};
+        prepare(stmt, "insert into R_SPECIFIC_QUERY (alias, sqlStr, create_ts) values (?, 'select 1', '0')");
+        stmt.bind(0, alias.c_str());
+        nanodbc::execute(stmt);
+        _trans.commit();
+        return 0;
+    });
+
+    REQUIRE(ic::catalog_modified());
+    REQUIRE_FALSE(cllReadsMayUseReplica(1));
+
+    // The plugin can still be configured to let reads lag behind the writes.
+    REQUIRE(cllReadsMayUseReplica(0));
+
+    REQUIRE(&read_only_session(primary, replica) == &primary);
+    REQUIRE(count_specific_queries(read_only_session(primary, replica), alias) == 1);
+}
+
+TEST_CASE("uncommitted writes are read from the primary")
+{
+    icatSessionStruct primary{};
+    icatSessionStruct replica{};
+    connect(primary);
+    connect(replica);
+
+    irods::at_scope_exit disconnect_sessions{[&primary, &replica] {
+        disconnect(replica);
+        disconnect(primary);
+    }};
+
+    const std::string alias = "test_catalog_pending_writes_odbc";
+    const auto insert = "insert into R_SPECIFIC_QUERY (alias, sqlStr, create_ts) values ('" + alias + "', 'select 1', '0')";
+
+    REQUIRE(cllExecSqlNoResult(&primary, insert.c_str()) == 0);
+    REQUIRE(cllGetPendingWriteCount() == 1);
+
+    // Even with read-your-writes disabled, the replica cannot see the uncommitted row.
+    REQUIRE_FALSE(cllReadsMayUseReplica(0));
+    REQUIRE(count_specific_queries(replica, alias) == 0);
+    REQUIRE(count_specific_queries(read_only_session(primary, replica), alias) == 1);
+
+    REQUIRE(cllExecSqlNoResult(&primary, "rollback") == 0);
+    REQUIRE(cllGetPendingWriteCount() == 0);
+    REQUIRE(count_specific_queries(primary, alias) == 0);
+}
+
+// The session is never connected. The statements fail to execute, but they are
+// counted before they are sent to the database.
+TEST_CASE("catalog pending write accounting")
+{
+    icatSessionStruct icss{};
+    icss.databaseType = DB_TYPE_POSTGRES;
+
+    REQUIRE(cllGetPendingWriteCount() == 0);
+
+    const auto writes_in_session = cllGetSessionWriteCount();
+
+    SECTION("writes are pending until they are committed")
+    {
+        cllExecSqlNoResult(&icss, "insert into R_TEST values (1)");
+        cllExecSqlNoResult(&icss, "update R_TEST set x = 2");
+        REQUIRE(cllGetPendingWriteCount() == 2);
+        REQUIRE(cllGetSessionWriteCount() == writes_in_session + 2);
+
+        cllExecSqlNoResult(&icss, "commit");
+        REQUIRE(cllGetPendingWriteCount() == 0);
+        REQUIRE(cllGetSessionWriteCount() == writes_in_session + 2);
+    }
+
+    SECTION("writes are no longer pending after a rollback")
+    {
+        cllExecSqlNoResult(&icss, "delete from R_TEST");
+        REQUIRE(cllGetPendingWriteCount() == 1);
+
+        cllExecSqlNoResult(&icss, "rollback");
+        REQUIRE(cllGetPendingWriteCount() == 0);
+        REQUIRE(cllGetSessionWriteCount() == writes_in_session + 1);
+    }
+}
@@ -8,12 +8,14 @@
 #include "replica.hpp"
 #include "rodsClient.h"
 #include "transport/default_transport.hpp"
+#include "transport/async_transport.hpp"
 
 #include <boost/filesystem.hpp>
 #include <fmt/format.h>
 
 #include <chrono>
 #include <string_view>
+#include <vector>
 
 #include <unistd.h>
 
@@ -303,6 +305,156 @@ TEST_CASE("dstream", "[iostreams]")
         ds.read(buf, 2);
         REQUIRE(std::string_view(buf, 2) == "cd");
     }
+
+    SECTION("stream buffer size is configurable")
+    {
+        const auto path = sandbox / "data_object.txt";
+        const std::string message(10'000, 'x');
+
+        {
+            io::client::native_transport tp{conn};
+            io::odstream out{tp, path};
+            REQUIRE(out.rdbuf()->pubsetbuf(nullptr, 1024 * 1024));
+            REQUIRE(out.rdbuf()->buffer_size() == 1024 * 1024);
+            out << message;
+        }
+
+        REQUIRE(irods::experimental::replica::replica_size<rcComm_t>(conn, path, 0) == message.size());
+
+        io::client::native_transport tp{conn};
+        io::idstream in{tp, path};
+        REQUIRE_FALSE(in.rdbuf()->pubsetbuf(nullptr, 0));
+        REQUIRE(in.rdbuf()->pubsetbuf(nullptr, 100));
+
+        std::string contents;
+        std::getline(in, contents);
+        REQUIRE(contents == message);
+    }
+
+    SECTION("async transport reads ahead and writes behind")
+    {
+        const auto path = sandbox / "data_object.txt";
+
+        std::string expected;
+        for (int i = 0; i < 100'000; ++i) {
+            expected += std::to_string(i) + ',';
+        }
+
+        // The async transport needs a connection of its own.
+        auto async_conn = conn_pool->get_connection();
+
+        {
+            io::client::native_transport tp{async_conn};
+            io::async_transport atp{tp, 64 * 1024, 4};
+            io::odstream out{atp, path};
+            REQUIRE(out);
+            out << expected;
+            out.close();
+            REQUIRE(out);
+        }
+
+        REQUIRE(irods::experimental::replica::replica_size<rcComm_t>(conn, path, 0) == expected.size());
+
+        io::client::native_transport tp{async_conn};
+        io::async_transport atp{tp, 64 * 1024, 4};
+        io::idstream in{atp, path};
+        REQUIRE(in);
+
+        std::string contents;
+        std::getline(in, contents);
+        REQUIRE(contents == expected);
+
+        // Seeking discards the data read ahead.
+        in.clear();
+        in.seekg(100);
+
+        char buf[10]{};
+        in.read(buf, sizeof(buf));
+        REQUIRE(std::string_view(buf, sizeof(buf)) == std::string_view{expected}.substr(100, sizeof(buf)));
+
+        // Seeking within the data read ahead keeps it, in both directions.
+        for (auto pos : {50'000, 20'000, 60'000}) {
+            in.seekg(pos);
+            in.read(buf, sizeof(buf));
+            REQUIRE(std::string_view(buf, sizeof(buf)) == std::string_view{expected}.substr(pos, sizeof(buf)));
+        }
+    }
+}
+
+// Hidden by default. Run with: irods_dstream "[benchmark]"
+TEST_CASE("dstream throughput", "[.][benchmark]")
+{
+    load_client_api_plugins();
+
+    auto conn_pool = irods::make_connection_pool(2);
+
+    rodsEnv env;
+    _getRodsEnv(env);
+
+    const auto sandbox = fs::path{env.rodsHome} / "unit_testing_sandbox";
+    auto conn = conn_pool->get_connection();
+
+    if (!fs::client::exists(conn, sandbox)) {
+        REQUIRE(fs::client::create_collection(conn, sandbox));
+    }
+
+    irods::at_scope_exit remove_sandbox{[&conn, &sandbox] {
+        REQUIRE(fs::client::remove_all(conn, sandbox, fs::remove_options::no_trash));
+    }};
+
+    constexpr std::int64_t object_size = 256 * 1024 * 1024;
+    constexpr std::int64_t block_size = 64 * 1024;
+
+    const auto path = sandbox / "benchmark_data_object";
+    const std::vector<char> block(block_size, 'x');
+
+    // Streams the object through "_stream" using blocks smaller than the stream buffer
+    // and reports the throughput.
+    const auto measure = [&](std::string_view _label, auto&& _stream, auto&& _io) {
+        REQUIRE(_stream);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (std::int64_t i = 0; i < object_size / block_size; ++i) {
+            _io(_stream);
+        }
+
+        _stream.close();
+        REQUIRE(_stream);
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        fmt::print("{:<40} {:>10.2f} MB/s\n", _label, object_size / elapsed.count() / (1024 * 1024));
+    };
+
+    const auto write_block = [&block](auto& _out) { _out.write(block.data(), block.size()); };
+    const auto read_block = [](auto& _in) {
+        char buf[block_size];
+        _in.read(buf, sizeof(buf));
+    };
+
+    for (auto buffer_size : {4 * 1024, 4 * 1024 * 1024}) {
+        io::client::native_transport tp{conn};
+
+        io::odstream out{tp, path};
+        out.rdbuf()->pubsetbuf(nullptr, buffer_size);
+        measure(fmt::format("write, {} byte buffer", buffer_size), out, write_block);
+
+        io::idstream in{tp, path};
+        in.rdbuf()->pubsetbuf(nullptr, buffer_size);
+        measure(fmt::format("read, {} byte buffer", buffer_size), in, read_block);
+    }
+
+    {
+        auto async_conn = conn_pool->get_connection();
+        io::client::native_transport tp{async_conn};
+        io::async_transport atp{tp, 4 * 1024 * 1024, 4};
+
+        io::odstream out{atp, path};
+        measure("write, async transport", out, write_block);
+
+        io::idstream in{atp, path};
+        measure("read, async transport", in, read_block);
+    }
 }
 
 auto get_hostname() noexcept -> std::string
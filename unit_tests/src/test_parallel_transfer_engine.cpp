@@ -183,6 +183,34 @@ TEST_CASE("parallel transfer engine")
         auto conn = conn_pool->get_connection();
         REQUIRE(irods::experimental::replica::replica_size<rcComm_t>(conn, data_object.c_str(), 0) == local_file_size);
     }
+
+    SECTION("small chunks with adaptive channel count")
+    {
+        namespace fs = boost::filesystem;
+
+        const auto local_file_size = fs::file_size(local_file);
+        const auto total_bytes_to_transfer = static_cast<std::int64_t>(local_file_size);
+        const auto chunk_size = 1_mb + 1; // Forces a short last chunk.
+
+        io::parallel_transfer_engine_builder<std::fstream, io::managed_dstream>
+            builder{fstream_fac, dstream_fac, io::close_stream<io::managed_dstream>, total_bytes_to_transfer};
+
+        auto transfer = builder.number_of_channels(stream_count)
+                               .chunk_size(chunk_size)
+                               .adapt_channel_count(true)
+                               .build();
+
+        transfer.wait();
+
+        REQUIRE(transfer.success());
+        REQUIRE(transfer.errors().empty());
+        REQUIRE(transfer.number_of_chunks() == (total_bytes_to_transfer + chunk_size - 1) / chunk_size);
+        REQUIRE(transfer.completed_chunks() == transfer.number_of_chunks());
+
+        // Verify the size of the sink file.
+        auto conn = conn_pool->get_connection();
+        REQUIRE(irods::experimental::replica::replica_size<rcComm_t>(conn, data_object.c_str(), 0) == local_file_size);
+    }
 }
 
 auto create_local_file(const boost::filesystem::path& _p, std::size_t _size) noexcept -> bool
@@ -0,0 +1,85 @@
+#include "catch.hpp"
+
+#include "resource_free_space_tracker.hpp"
+#include "irods_at_scope_exit.hpp"
+
+#include <string>
+
+namespace fst = irods::experimental::resource_free_space_tracker;
+
+TEST_CASE("resource_free_space_tracker")
+{
+    fst::init("irods_resource_free_space_tracker_test", 100'000);
+    irods::at_scope_exit cleanup{[] { fst::deinit(); }};
+
+    // Untracked resources have no free space information.
+    REQUIRE_FALSE(fst::lookup("resc_a", 60));
+
+    fst::update("resc_a", 1000);
+
+    SECTION("measurements are visible until they expire")
+    {
+        REQUIRE(fst::lookup("resc_a", 60).value_or(-1) == 1000);
+        REQUIRE_FALSE(fst::lookup("resc_a", 0));
+        REQUIRE_FALSE(fst::lookup("resc_b", 60));
+    }
+
+    SECTION("writes are subtracted from the tracked free space")
+    {
+        fst::consume("resc_a", 400);
+        REQUIRE(fst::lookup("resc_a", 60).value_or(-1) == 600);
+
+        // The free space never becomes negative.
+        fst::consume("resc_a", 1000);
+        REQUIRE(fst::lookup("resc_a", 60).value_or(-1) == 0);
+
+        // Consuming from an untracked resource does not start tracking it.
+        fst::consume("resc_b", 100);
+        REQUIRE_FALSE(fst::lookup("resc_b", 60));
+    }
+
+    SECTION("a new measurement replaces the tracked free space")
+    {
+        fst::consume("resc_a", 400);
+        fst::update("resc_a", 5000);
+        REQUIRE(fst::lookup("resc_a", 60).value_or(-1) == 5000);
+    }
+
+    SECTION("erased resources are no longer tracked")
+    {
+        fst::erase("resc_a");
+        REQUIRE_FALSE(fst::lookup("resc_a", 60));
+    }
+
+    SECTION("only one caller at a time holds the refresh claim")
+    {
+        REQUIRE(fst::try_claim_refresh("resc_a", 60));
+        REQUIRE_FALSE(fst::try_claim_refresh("resc_a", 60));
+
+        // Recording a measurement releases the claim.
+        fst::update("resc_a", 2000);
+        REQUIRE(fst::try_claim_refresh("resc_a", 60));
+
+        fst::release_refresh("resc_a");
+        REQUIRE(fst::try_claim_refresh("resc_a", 60));
+
+        // Claims that are never released expire.
+        REQUIRE(fst::try_claim_refresh("resc_a", 0));
+    }
+
+    SECTION("claiming the refresh of an untracked resource does not start tracking it")
+    {
+        REQUIRE(fst::try_claim_refresh("resc_b", 60));
+        REQUIRE_FALSE(fst::lookup("resc_b", 60));
+
+        fst::update("resc_b", 3000);
+        REQUIRE(fst::lookup("resc_b", 60).value_or(-1) == 3000);
+    }
+
+    SECTION("resource names that do not fit are ignored")
+    {
+        const std::string long_name(100, 'x');
+        fst::update(long_name, 1000);
+        REQUIRE_FALSE(fst::lookup(long_name, 60));
+    }
+}
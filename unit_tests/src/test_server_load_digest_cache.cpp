@@ -0,0 +1,60 @@
+#include "catch.hpp"
+
+#include "server_load_digest_cache.hpp"
+#include "irods_at_scope_exit.hpp"
+
+#include <string>
+#include <vector>
+
+namespace sldc = irods::experimental::server_load_digest_cache;
+
+TEST_CASE("server_load_digest_cache")
+{
+    sldc::init("irods_server_load_digest_cache_test", 100'000);
+    irods::at_scope_exit cleanup{[] { sldc::deinit(); }};
+
+    // An empty cache has nothing to offer and must be refreshed.
+    REQUIRE_FALSE(sldc::entries());
+    REQUIRE(sldc::claim_refresh(60));
+
+    // Only one caller is granted the refresh while it is in progress.
+    REQUIRE_FALSE(sldc::claim_refresh(60));
+
+    const std::vector<sldc::load_entry> digest{
+        {"resc_a", 10, 1'600'000'000},
+        {"resc_b", 90, 1'600'000'100},
+        {std::string(100, 'x'), 50, 1'600'000'200}
+    };
+
+    sldc::update(digest);
+
+    SECTION("entries reflect the last update")
+    {
+        const auto entries = sldc::entries();
+        REQUIRE(entries);
+
+        // The resource name that does not fit in shared memory is skipped.
+        REQUIRE(entries->size() == 2);
+
+        for (std::size_t i = 0; i < entries->size(); ++i) {
+            CHECK((*entries)[i].resource_name == digest[i].resource_name);
+            CHECK((*entries)[i].load_factor == digest[i].load_factor);
+            CHECK((*entries)[i].create_time == digest[i].create_time);
+        }
+    }
+
+    SECTION("fresh cache is not refreshed until the interval elapses")
+    {
+        REQUIRE_FALSE(sldc::claim_refresh(60));
+
+        // A zero-second interval makes the cache stale immediately.
+        REQUIRE(sldc::claim_refresh(0));
+    }
+
+    SECTION("clear empties the cache")
+    {
+        sldc::clear();
+        REQUIRE_FALSE(sldc::entries());
+        REQUIRE(sldc::claim_refresh(60));
+    }
+}
@@ -0,0 +1,101 @@
+#include "catch.hpp"
+
+#include "server_utilities.hpp"
+#include "irods_at_scope_exit.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+    auto read_file(const fs::path& _p) -> std::string
+    {
+        std::ifstream in{_p.c_str(), std::ios::binary};
+        return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    }
+} // anonymous namespace
+
+TEST_CASE("copy_file_range_in_kernel")
+{
+    const auto sandbox = fs::temp_directory_path() / fs::unique_path("irods_server_utilities_%%%%-%%%%");
+    REQUIRE(fs::create_directory(sandbox));
+    irods::at_scope_exit remove_sandbox{[&sandbox] { fs::remove_all(sandbox); }};
+
+    std::string contents(3 * 1024 * 1024 + 17, '\0');
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> dist{0, 255};
+    for (auto& c : contents) {
+        c = static_cast<char>(dist(gen));
+    }
+
+    const auto src_path = sandbox / "src";
+    std::ofstream{src_path.c_str(), std::ios::binary}.write(contents.data(), contents.size());
+
+    const int src_fd = open(src_path.c_str(), O_RDONLY);
+    REQUIRE(src_fd >= 0);
+    irods::at_scope_exit close_src{[src_fd] { close(src_fd); }};
+
+    const auto size = static_cast<std::int64_t>(contents.size());
+
+    for (int threads : {1, 4}) {
+        DYNAMIC_SECTION("copy the whole file using " << threads << " thread(s)")
+        {
+            const auto dst_path = sandbox / "dst";
+            const int dst_fd = open(dst_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+            REQUIRE(dst_fd >= 0);
+
+            // Filesystems which do not support copy_file_range copy nothing, leaving
+            // the caller to copy the rest. Either way, the offsets must not move.
+            const auto copied = irods::copy_file_range_in_kernel(src_fd, dst_fd, 0, size, threads);
+            CHECK(copied >= 0);
+            CHECK(copied <= size);
+            CHECK(lseek(src_fd, 0, SEEK_CUR) == 0);
+            CHECK(lseek(dst_fd, 0, SEEK_CUR) == 0);
+            close(dst_fd);
+
+            CHECK(read_file(dst_path) == contents.substr(0, copied));
+        }
+    }
+
+    SECTION("copy a range at an offset")
+    {
+        const auto dst_path = sandbox / "dst";
+        const int dst_fd = open(dst_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        REQUIRE(dst_fd >= 0);
+
+        constexpr std::int64_t offset = 1024 * 1024 + 3;
+        constexpr std::int64_t length = 4096;
+        const auto copied = irods::copy_file_range_in_kernel(src_fd, dst_fd, offset, length);
+        close(dst_fd);
+
+        if (copied > 0) {
+            const auto result = read_file(dst_path);
+            REQUIRE(result.size() == static_cast<std::size_t>(offset + copied));
+            CHECK(result.substr(offset) == contents.substr(offset, copied));
+        }
+    }
+
+    SECTION("reflink the whole file")
+    {
+        const auto dst_path = sandbox / "dst";
+        const int dst_fd = open(dst_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        REQUIRE(dst_fd >= 0);
+
+        // Reflinks are only supported by some filesystems (e.g. XFS, Btrfs).
+        const auto cloned = irods::reflink_file(src_fd, dst_fd);
+        close(dst_fd);
+
+        if (cloned) {
+            CHECK(read_file(dst_path) == contents);
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#include "catch.hpp"
+
+#include "client_connection.hpp"
+#include "irods_at_scope_exit.hpp"
+#include "irods_error_enum_matcher.hpp"
+#include "irods_exception.hpp"
+#include "irods_query.hpp"
+#include "rodsClient.h"
+#include "rodsErrorTable.h"
+#include "shared_memory_object.hpp"
+
+#include "fmt/format.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Every agent caches the specific queries it resolved. A single connection is kept open
+// across the queries below so that they are served by the same agent and hit its cache,
+// while the specific queries are added and removed by other agents through iadmin.
+//
+// The agents count their cache hits in shared memory. This test must run on the catalog
+// provider as the service account to read that counter.
+
+namespace
+{
+    const std::string alias = "irods_unit_test_specific_query_cache";
+    const std::string first_sql = "select coll_name from R_COLL_MAIN where coll_name = '/'";
+    const std::string second_sql = "select zone_name from R_ZONE_MAIN where zone_type_name = 'local'";
+
+    auto run_specific_query(RcComm& _comm, const std::string& _sql_or_alias) -> std::vector<std::string>
+    {
+        using query_type = irods::query<RcComm>;
+
+        std::vector<std::string> rows;
+
+        for (auto&& row : query_type{&_comm, _sql_or_alias, nullptr, {}, 0, 0, query_type::SPECIFIC}) {
+            rows.push_back(row[0]);
+        }
+
+        return rows;
+    }
+
+    auto add_specific_query(const std::string& _sql) -> void
+    {
+        REQUIRE(std::system(fmt::format(R"(iadmin asq "{}" {})", _sql, alias).c_str()) == 0);
+    }
+
+    auto remove_specific_query() -> void
+    {
+        REQUIRE(std::system(fmt::format("iadmin rsq {}", alias).c_str()) == 0);
+    }
+
+    auto cache_hits() -> std::uint64_t
+    {
+        irods::experimental::interprocess::shared_memory_object<std::uint64_t> hits{"irods_specific_query_cache_hits"};
+        return hits.atomic_exec([](auto& _hits) { return _hits; });
+    }
+} // anonymous namespace
+
+TEST_CASE("specific query cache")
+{
+    load_client_api_plugins();
+
+    rodsEnv env;
+    _getRodsEnv(env);
+
+    add_specific_query(first_sql);
+
+    bool query_exists = true;
+
+    irods::at_scope_exit remove_query{[&query_exists] {
+        if (query_exists) {
+            remove_specific_query();
+        }
+    }};
+
+    irods::experimental::client_connection conn;
+    RcComm& comm = static_cast<RcComm&>(conn);
+
+    SECTION("repeated queries are answered from the cache")
+    {
+        const auto hits_before = cache_hits();
+
+        // The first query of each kind resolves the SQL and caches it. The others are cache hits.
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(run_specific_query(comm, alias) == std::vector<std::string>{"/"});
+            REQUIRE(run_specific_query(comm, first_sql) == std::vector<std::string>{"/"});
+        }
+
+        // Other agents may hit their caches in the meantime.
+        REQUIRE(cache_hits() - hits_before >= 4);
+    }
+
+    SECTION("a specific query redefined by another agent invalidates the cache")
+    {
+        REQUIRE(run_specific_query(comm, alias) == std::vector<std::string>{"/"});
+
+        remove_specific_query();
+        add_specific_query(second_sql);
+
+        REQUIRE(run_specific_query(comm, alias) == std::vector<std::string>{env.rodsZone});
+    }
+
+    SECTION("a specific query removed by another agent invalidates the cache")
+    {
+        REQUIRE(run_specific_query(comm, alias) == std::vector<std::string>{"/"});
+        REQUIRE(run_specific_query(comm, first_sql) == std::vector<std::string>{"/"});
+
+        remove_specific_query();
+        query_exists = false;
+
+        const auto error_code = [&comm](const std::string& _sql_or_alias) -> long long {
+            try {
+                run_specific_query(comm, _sql_or_alias);
+            }
+            catch (const irods::exception& e) {
+                return e.code();
+            }
+
+            return 0;
+        };
+
+        CHECK_THAT(error_code(alias), equals_irods_error(CAT_UNKNOWN_SPECIFIC_QUERY));
+        CHECK_THAT(error_code(first_sql), equals_irods_error(CAT_UNKNOWN_SPECIFIC_QUERY));
+    }
+}
@@ -0,0 +1,84 @@
+#include "catch.hpp"
+
+#include "client_connection.hpp"
+#include "connection_pool.hpp"
+#include "dstream.hpp"
+#include "filesystem.hpp"
+#include "irods_at_scope_exit.hpp"
+#include "rodsClient.h"
+#include "transport/default_transport.hpp"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+namespace fs = irods::experimental::filesystem;
+namespace io = irods::experimental::io;
+
+// Measures the time to the first byte of a small member of a mounted tar file.
+// Hidden by default. Run with: irods_tar_member_latency "[benchmark]"
+TEST_CASE("tar member first-byte latency", "[.][benchmark]")
+{
+    load_client_api_plugins();
+
+    rodsEnv env;
+    _getRodsEnv(env);
+
+    const auto sandbox = fs::path{env.rodsHome} / "tar_member_latency_sandbox";
+    const auto members = sandbox / "members";
+    const auto bundle = sandbox / "members.tar";
+    const auto mount_point = sandbox / "mounted";
+
+    auto conn_pool = irods::make_connection_pool();
+
+    {
+        auto conn = conn_pool->get_connection();
+        REQUIRE(fs::client::create_collections(conn, members));
+
+        // 256 members of 4MB followed by the 4KB member that is read.
+        io::client::native_transport tp{conn};
+        const std::vector<char> large(4 * 1024 * 1024, 'x');
+
+        for (int i = 0; i < 256; ++i) {
+            io::odstream out{tp, members / fmt::format("large_{:03}", i)};
+            out.write(large.data(), large.size());
+        }
+
+        io::odstream out{tp, members / "small"};
+        out.write(large.data(), 4 * 1024);
+    }
+
+    REQUIRE(std::system(fmt::format("ibun -c {} {}", bundle.c_str(), members.c_str()).c_str()) == 0);
+    REQUIRE(std::system(fmt::format("imkdir {}", mount_point.c_str()).c_str()) == 0);
+    REQUIRE(std::system(fmt::format("imcoll -m tar {} {}", bundle.c_str(), mount_point.c_str()).c_str()) == 0);
+
+    irods::at_scope_exit clean_up{[&] {
+        std::system(fmt::format("imcoll -U {}", mount_point.c_str()).c_str());
+        auto conn = conn_pool->get_connection();
+        fs::client::remove_all(conn, sandbox, fs::remove_options::no_trash);
+    }};
+
+    const auto member = mount_point / "members" / "small";
+
+    // Opens the member and reads its first byte over "_conn".
+    const auto time_to_first_byte = [&member](rcComm_t& _conn) {
+        const auto start = std::chrono::steady_clock::now();
+
+        io::client::native_transport tp{_conn};
+        io::idstream in{tp, member};
+        REQUIRE(in);
+        REQUIRE(in.get() == 'x');
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // A new agent builds the member index on its first open. Later opens in the
+    // same agent reuse it.
+    for (int i = 0; i < 3; ++i) {
+        irods::experimental::client_connection conn;
+        fmt::print("{:<40} {:>10.2f} ms\n", "first open in a new agent", time_to_first_byte(conn));
+        fmt::print("{:<40} {:>10.2f} ms\n", "second open in the same agent", time_to_first_byte(conn));
+    }
+}
@@ -0,0 +1,115 @@
+#include "catch.hpp"
+
+#include "connection_pool.hpp"
+#include "dstream.hpp"
+#include "filesystem.hpp"
+#include "irods_at_scope_exit.hpp"
+#include "rodsClient.h"
+#include "transport/default_transport.hpp"
+#include "unit_test_utils.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace fs = irods::experimental::filesystem;
+namespace io = irods::experimental::io;
+
+// Compares a unixfilesystem resource with and without async_io=on.
+// Hidden by default. Run with: irods_unixfilesystem_async_io "[benchmark]"
+TEST_CASE("unixfilesystem async_io throughput", "[.][benchmark]")
+{
+    load_client_api_plugins();
+
+    const auto hostname = unit_test_utils::get_hostname();
+
+    for (const auto* context : {"", "async_io=on"}) {
+        const auto vault = unit_test_utils::create_resource_vault("irods_unit_testing_async_io_vault");
+        const auto cmd = fmt::format(R"(iadmin mkresc ut_async_io_resc unixfilesystem {}:{} "{}")", hostname, vault, context);
+        REQUIRE(std::system(cmd.data()) == 0);
+
+        // A new connection pool must be used so that the resource manager within
+        // the agents can see the new resource.
+        auto conn_pool = irods::make_connection_pool();
+        auto conn = conn_pool->get_connection();
+
+        rodsEnv env;
+        _getRodsEnv(env);
+
+        const auto path = fs::path{env.rodsHome} / "async_io_benchmark_data_object";
+
+        irods::at_scope_exit remove_resource{[&conn, &path] {
+            fs::client::remove(conn, path, fs::remove_options::no_trash);
+            REQUIRE(std::system("iadmin rmresc ut_async_io_resc") == 0);
+        }};
+
+        constexpr std::int64_t object_size = 256 * 1024 * 1024;
+        constexpr std::int64_t block_size = 64 * 1024;
+        constexpr std::int64_t block_count = object_size / block_size;
+
+        std::vector<char> block(block_size, 'x');
+
+        // Visits every block of the object once, either in order or shuffled.
+        std::vector<std::int64_t> sequential(block_count);
+        std::iota(std::begin(sequential), std::end(sequential), 0);
+        auto random = sequential;
+        std::shuffle(std::begin(random), std::end(random), std::mt19937{42});
+
+        const auto measure = [&](std::string_view _label, auto& _stream, const auto& _order, auto&& _io) {
+            REQUIRE(_stream);
+
+            const auto start = std::chrono::steady_clock::now();
+
+            for (auto i : _order) {
+                _io(_stream, i * block_size);
+            }
+
+            _stream.close();
+            REQUIRE(_stream);
+
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            fmt::print("{:<12} {:<40} {:>10.2f} MB/s\n", *context ? context : "default", _label,
+                       object_size / elapsed.count() / (1024 * 1024));
+        };
+
+        const auto write_block = [&block](auto& _out, std::int64_t _offset) {
+            _out.seekp(_offset);
+            _out.write(block.data(), block.size());
+        };
+
+        const auto read_block = [&block](auto& _in, std::int64_t _offset) {
+            _in.seekg(_offset);
+            _in.read(block.data(), block.size());
+        };
+
+        io::client::native_transport tp{conn};
+        const auto resource = io::root_resource_name{"ut_async_io_resc"};
+
+        {
+            io::odstream out{tp, path, resource};
+            measure("sequential write", out, sequential, write_block);
+        }
+
+        {
+            io::idstream in{tp, path, resource};
+            measure("sequential read", in, sequential, read_block);
+        }
+
+        {
+            io::odstream out{tp, path, resource, std::ios_base::in | std::ios_base::out};
+            measure("random write", out, random, write_block);
+        }
+
+        {
+            io::idstream in{tp, path, resource};
+            measure("random read", in, random, read_block);
+        }
+    }
+}